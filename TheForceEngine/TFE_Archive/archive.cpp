@@ -6,6 +6,7 @@
 #include "labArchive.h"
 #include "zipArchive.h"
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_System/hash.h>
 #include <assert.h>
 #include <string>
 #include <map>
@@ -24,6 +25,13 @@ static const char* c_archiveExt[ARCHIVE_COUNT]=
 	"ZIP", // ARCHIVE_ZIP
 };
 
+bool Archive::s_memoryMapping = true;
+
+void Archive::enableMemoryMapping(bool enable)
+{
+	s_memoryMapping = enable;
+}
+
 ArchiveType Archive::getArchiveTypeFromName(const char* path)
 {
 	const size_t len = strlen(path);
@@ -180,3 +188,75 @@ void Archive::deleteCustomArchive(Archive* archive)
 	}
 	delete archive;
 }
+
+void Archive::buildNameIndex()
+{
+	clearNameIndex();
+
+	const u32 count = getFileCount();
+	if (!count) { return; }
+
+	// Keep the load factor at or below 50%.
+	u32 tableSize = 16;
+	while (tableSize < count * 2) { tableSize <<= 1; }
+	m_nameIndex.assign(tableSize, INVALID_FILE);
+
+	const u32 mask = tableSize - 1;
+	for (u32 i = 0; i < count; i++)
+	{
+		const char* name = getFileName(i);
+		if (!name) { continue; }
+
+		u32 slot = TFE_Hash::hashStringNoCase32(name) & mask;
+		while (m_nameIndex[slot] != INVALID_FILE)
+		{
+			// Duplicate names resolve to the first entry, matching the previous linear search.
+			if (strcasecmp(name, getFileName(m_nameIndex[slot])) == 0) { break; }
+			slot = (slot + 1) & mask;
+		}
+		if (m_nameIndex[slot] == INVALID_FILE)
+		{
+			m_nameIndex[slot] = i;
+		}
+	}
+
+	// The directory changed, so any cached file paths may now be stale.
+	TFE_Paths::clearFilePathCache();
+}
+
+void Archive::clearNameIndex()
+{
+	m_nameIndex.clear();
+}
+
+u32 Archive::findFileIndex(const char* file)
+{
+	if (!file) { return INVALID_FILE; }
+	if (m_nameIndex.empty())
+	{
+		// The index was never built, fall back to a linear search.
+		const u32 count = getFileCount();
+		for (u32 i = 0; i < count; i++)
+		{
+			const char* name = getFileName(i);
+			if (name && strcasecmp(file, name) == 0)
+			{
+				return i;
+			}
+		}
+		return INVALID_FILE;
+	}
+
+	const u32 mask = u32(m_nameIndex.size()) - 1;
+	u32 slot = TFE_Hash::hashStringNoCase32(file) & mask;
+	while (m_nameIndex[slot] != INVALID_FILE)
+	{
+		const u32 index = m_nameIndex[slot];
+		if (strcasecmp(file, getFileName(index)) == 0)
+		{
+			return index;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return INVALID_FILE;
+}
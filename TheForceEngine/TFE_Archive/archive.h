@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/paths.h>
@@ -29,6 +30,8 @@ public:
 	static void deleteCustomArchive(Archive* archive);
 
 	static ArchiveType getArchiveTypeFromName(const char* path);
+	// Archives that support it map the archive file into memory when opened and read file data from the mapping.
+	static void enableMemoryMapping(bool enable);
 	
 	// Public Archive API
 public:
@@ -60,6 +63,9 @@ public:
 	virtual size_t readFile(void *data, size_t size) = 0;
 	virtual bool seekFile(s32 offset, s32 origin = SEEK_SET) = 0;
 	virtual size_t getLocInFile() = 0;
+	// Returns a read-only view of the file data if the archive is memory mapped, otherwise null.
+	// The view stays valid until the archive is closed.
+	virtual const u8* getFileData(u32 index) { return nullptr; }
 
 	// Directory
 	virtual u32 getFileCount() = 0;
@@ -71,9 +77,20 @@ public:
 
 	// Shared Private State
 protected:
+	// Case-insensitive file name lookup, shared by all archive types.
+	// The index should be rebuilt whenever the directory changes (open, addFile).
+	void buildNameIndex();
+	void clearNameIndex();
+	u32  findFileIndex(const char* file);
+
+	static bool s_memoryMapping;
+
 	ArchiveType m_type;
 	char m_name[TFE_MAX_PATH];
 	char m_archivePath[TFE_MAX_PATH];
 
 	s32 m_fileOffset;
+
+	// Open addressing hash table of file indices, INVALID_FILE marks an empty slot.
+	std::vector<u32> m_nameIndex;
 };
@@ -76,6 +76,12 @@ bool GobArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	buildNameIndex();
+
+	if (s_memoryMapping)
+	{
+		mapArchive();
+	}
 
 	return true;
 }
@@ -83,9 +89,11 @@ bool GobArchive::open(const char *archivePath)
 void GobArchive::close()
 {
 	m_file.close();
+	m_mapping.close();
 	m_archiveOpen = false;
 	delete[] m_fileList.entries;
 	m_fileList.entries = nullptr;
+	clearNameIndex();
 }
 
 // File Access
@@ -93,18 +101,17 @@ bool GobArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
+	// Reads come from the mapping when the archive is mapped, so there is no need to open the file.
+	const bool useFile = !m_mapping.isOpen();
+	if (useFile) { m_file.open(m_archivePath, Stream::MODE_READ); }
 	m_curFile = -1;
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
+	const u32 index = findFileIndex(file);
+	if (index != INVALID_FILE)
 	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = s32(i);
-			break;
-		}
+		m_curFile = s32(index);
 	}
 
 	if (m_curFile == -1)
@@ -112,7 +119,7 @@ bool GobArchive::openFile(const char *file)
 		m_file.close();
 		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
 	}
-	else
+	else if (useFile)
 	{
 		m_file.seek(m_fileList.entries[m_curFile].IX);
 	}
@@ -125,8 +132,11 @@ bool GobArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_fileList.entries[m_curFile].IX);
+	if (!m_mapping.isOpen())
+	{
+		m_file.open(m_archivePath, Stream::MODE_READ);
+		m_file.seek(m_fileList.entries[m_curFile].IX);
+	}
 	return true;
 }
 
@@ -141,14 +151,7 @@ u32 GobArchive::getFileIndex(const char* file)
 	if (!m_archiveOpen) { return INVALID_FILE; }
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool GobArchive::fileExists(const char *file)
@@ -157,14 +160,7 @@ bool GobArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool GobArchive::fileExists(u32 index)
@@ -184,6 +180,16 @@ size_t GobArchive::readFile(void *data, size_t size)
 	if (m_curFile < 0) { return false; }
 	if (size == 0) { size = m_fileList.entries[m_curFile].LEN; }
 	const size_t sizeToRead = std::min(size, (size_t)m_fileList.entries[m_curFile].LEN);
+	if (m_mapping.isOpen())
+	{
+		// Clamp the read to the end of the file.
+		const size_t len = m_fileList.entries[m_curFile].LEN;
+		const size_t offset = (size_t)m_fileOffset;
+		const size_t bytesRead = offset < len ? std::min(sizeToRead, len - offset) : 0;
+		memcpy(data, m_mapping.getData() + m_fileList.entries[m_curFile].IX + offset, bytesRead);
+		m_fileOffset += (s32)bytesRead;
+		return bytesRead;
+	}
 
 	u32 bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
 	m_fileOffset += (s32)sizeToRead;
@@ -217,7 +223,10 @@ bool GobArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
+	if (!m_mapping.isOpen())
+	{
+		m_file.seek(m_fileList.entries[m_curFile].IX + m_fileOffset);
+	}
 	return true;
 }
 
@@ -226,6 +235,30 @@ size_t GobArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* GobArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || !m_mapping.isOpen() || index >= getFileCount()) { return nullptr; }
+	return m_mapping.getData() + m_fileList.entries[index].IX;
+}
+
+void GobArchive::mapArchive()
+{
+	if (!m_mapping.open(m_archivePath)) { return; }
+
+	// Fall back to file reads if the directory doesn't fit in the file.
+	const size_t size = m_mapping.getSize();
+	const u32 count = getFileCount();
+	for (u32 i = 0; i < count; i++)
+	{
+		if ((size_t)m_fileList.entries[i].IX + (size_t)m_fileList.entries[i].LEN > size)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Archive", "\"%s\" is truncated, it will not be memory mapped.", m_archivePath);
+			m_mapping.close();
+			return;
+		}
+	}
+}
+
 // Directory
 u32 GobArchive::getFileCount()
 {
@@ -254,6 +287,10 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		return;
 	}
 	const size_t len = file.getSize();
+	// The archive is rewritten below, so it cannot stay mapped.
+	const bool wasMapped = m_mapping.isOpen();
+	m_mapping.close();
+
 	const u32 newId = m_fileList.MASTERN;
 	m_fileList.MASTERN++;
 	GOB_Entry_t* newEntries = new GOB_Entry_t[m_fileList.MASTERN];
@@ -266,6 +303,7 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 	newFile->LEN = u32(len);
 	strcpy(newFile->NAME, fileName);
 	m_header.MASTERX += newFile->LEN;
+	buildNameIndex();
 
 	// Read all of the file data.
 	std::vector<std::vector<u8>> fileData(m_fileList.MASTERN);
@@ -297,4 +335,9 @@ void GobArchive::addFile(const char* fileName, const char* filePath)
 		m_file.writeBuffer(m_fileList.entries, sizeof(GOB_Entry_t), m_fileList.MASTERN);
 		m_file.close();
 	}
+
+	if (wasMapped)
+	{
+		mapArchive();
+	}
 }
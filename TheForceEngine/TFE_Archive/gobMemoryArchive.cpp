@@ -49,6 +49,7 @@ bool GobMemoryArchive::open(const u8* buffer, size_t size)
 	m_fileList.entries = (GobArchive::GOB_Entry_t*)(readBuffer);
 
 	m_archiveOpen = true;
+	buildNameIndex();
 
 	return true;
 }
@@ -58,6 +59,7 @@ void GobMemoryArchive::close()
 	m_archiveOpen = false;
 	free((void*)m_buffer);
 	m_buffer = nullptr;
+	clearNameIndex();
 }
 
 // File Access
@@ -69,13 +71,10 @@ bool GobMemoryArchive::openFile(const char *file)
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
+	const u32 index = findFileIndex(file);
+	if (index != INVALID_FILE)
 	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
+		m_curFile = s32(index);
 	}
 
 	if (m_curFile == -1)
@@ -110,14 +109,7 @@ u32 GobMemoryArchive::getFileIndex(const char* file)
 	if (!m_archiveOpen) { return INVALID_FILE; }
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool GobMemoryArchive::fileExists(const char *file)
@@ -126,14 +118,7 @@ bool GobMemoryArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool GobMemoryArchive::fileExists(u32 index)
@@ -196,6 +181,12 @@ size_t GobMemoryArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* GobMemoryArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || index >= getFileCount()) { return nullptr; }
+	return m_buffer + m_fileList.entries[index].IX;
+}
+
 // Directory
 u32 GobMemoryArchive::getFileCount()
 {
@@ -36,16 +36,23 @@ bool LabArchive::open(const char *archivePath)
 	m_file.close();
 		
 	strcpy(m_archivePath, archivePath);
-	
+	buildNameIndex();
+
+	if (s_memoryMapping)
+	{
+		mapArchive();
+	}
 	return true;
 }
 
 void LabArchive::close()
 {
 	m_file.close();
+	m_mapping.close();
 	m_archiveOpen = false;
 	delete[] m_entries;
 	delete[] m_stringTable;
+	clearNameIndex();
 }
 
 // File Access
@@ -53,18 +60,17 @@ bool LabArchive::openFile(const char *file)
 {
 	if (!m_archiveOpen) { return false; }
 
-	m_file.open(m_archivePath, Stream::MODE_READ);
+	// Reads come from the mapping when the archive is mapped, so there is no need to open the file.
+	const bool useFile = !m_mapping.isOpen();
+	if (useFile) { m_file.open(m_archivePath, Stream::MODE_READ); }
 	m_curFile = -1;
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
+	const u32 index = findFileIndex(file);
+	if (index != INVALID_FILE)
 	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
+		m_curFile = s32(index);
 	}
 
 	if (m_curFile == -1)
@@ -72,7 +78,7 @@ bool LabArchive::openFile(const char *file)
 		m_file.close();
 		TFE_System::logWrite(LOG_ERROR, "GOB", "Failed to load \"%s\" from \"%s\"", file, m_archivePath);
 	}
-	else
+	else if (useFile)
 	{
 		m_file.seek(m_entries[m_curFile].dataOffset);
 	}
@@ -85,8 +91,11 @@ bool LabArchive::openFile(u32 index)
 
 	m_curFile = s32(index);
 	m_fileOffset = 0;
-	m_file.open(m_archivePath, Stream::MODE_READ);
-	m_file.seek(m_entries[m_curFile].dataOffset);
+	if (!m_mapping.isOpen())
+	{
+		m_file.open(m_archivePath, Stream::MODE_READ);
+		m_file.seek(m_entries[m_curFile].dataOffset);
+	}
 	return true;
 }
 
@@ -102,14 +111,7 @@ u32 LabArchive::getFileIndex(const char* file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool LabArchive::fileExists(const char *file)
@@ -118,14 +120,7 @@ bool LabArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_header.fileCount; i++)
-	{
-		if (strcasecmp(file, &m_stringTable[m_entries[i].nameOffset]) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool LabArchive::fileExists(u32 index)
@@ -145,6 +140,16 @@ size_t LabArchive::readFile(void *data, size_t size)
 	if (m_curFile < 0) { return false; }
 	if (size == 0) { size = m_entries[m_curFile].len; }
 	const size_t sizeToRead = std::min(size, (size_t)m_entries[m_curFile].len);
+	if (m_mapping.isOpen())
+	{
+		// Clamp the read to the end of the file.
+		const size_t len = m_entries[m_curFile].len;
+		const size_t offset = (size_t)m_fileOffset;
+		const size_t bytesRead = offset < len ? std::min(sizeToRead, len - offset) : 0;
+		memcpy(data, m_mapping.getData() + m_entries[m_curFile].dataOffset + offset, bytesRead);
+		m_fileOffset += (s32)bytesRead;
+		return bytesRead;
+	}
 
 	size_t bytesRead = m_file.readBuffer(data, (u32)sizeToRead);
 	m_fileOffset += (s32)sizeToRead;
@@ -178,7 +183,10 @@ bool LabArchive::seekFile(s32 offset, s32 origin)
 		return false;
 	}
 
-	m_file.seek(m_entries[m_curFile].dataOffset + m_fileOffset);
+	if (!m_mapping.isOpen())
+	{
+		m_file.seek(m_entries[m_curFile].dataOffset + m_fileOffset);
+	}
 	return true;
 }
 
@@ -187,6 +195,30 @@ size_t LabArchive::getLocInFile()
 	return m_fileOffset;
 }
 
+const u8* LabArchive::getFileData(u32 index)
+{
+	if (!m_archiveOpen || !m_mapping.isOpen() || index >= getFileCount()) { return nullptr; }
+	return m_mapping.getData() + m_entries[index].dataOffset;
+}
+
+void LabArchive::mapArchive()
+{
+	if (!m_mapping.open(m_archivePath)) { return; }
+
+	// Fall back to file reads if the directory doesn't fit in the file.
+	const size_t size = m_mapping.getSize();
+	const u32 count = getFileCount();
+	for (u32 i = 0; i < count; i++)
+	{
+		if ((size_t)m_entries[i].dataOffset + (size_t)m_entries[i].len > size)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Archive", "\"%s\" is truncated, it will not be memory mapped.", m_archivePath);
+			m_mapping.close();
+			return;
+		}
+	}
+}
+
 // Directory
 u32 LabArchive::getFileCount()
 {
@@ -1,6 +1,7 @@
 #pragma once
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/mappedFile.h>
 #include <TFE_FileSystem/paths.h>
 #include "archive.h"
 
@@ -28,6 +29,7 @@ public:
 	size_t readFile(void *data, size_t size) override;
 	bool seekFile(s32 offset, s32 origin = SEEK_SET) override;
 	size_t getLocInFile() override;
+	const u8* getFileData(u32 index) override;
 
 	// Directory
 	u32 getFileCount() override;
@@ -38,6 +40,8 @@ public:
 	void addFile(const char* fileName, const char* filePath) override;
 
 private:
+	void mapArchive();
+
 	#pragma pack(push)
 	#pragma pack(1)
 	struct LAB_Header_t
@@ -58,6 +62,7 @@ private:
 	#pragma pack(pop)
 
 	FileStream m_file;
+	MappedFile m_mapping;
 	bool m_archiveOpen;
 
 	LAB_Header_t m_header;
@@ -62,6 +62,7 @@ bool LfdArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_file.close();
+	buildNameIndex();
 
 	return true;
 }
@@ -76,6 +77,7 @@ void LfdArchive::close()
 		delete[] m_fileList.entries;
 		m_fileList.entries = nullptr;
 	}
+	clearNameIndex();
 }
 
 // File Access
@@ -88,13 +90,10 @@ bool LfdArchive::openFile(const char *file)
 	m_fileOffset = 0;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
+	const u32 index = findFileIndex(file);
+	if (index != INVALID_FILE)
 	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			m_curFile = i;
-			break;
-		}
+		m_curFile = s32(index);
 	}
 
 	if (m_curFile == -1)
@@ -132,14 +131,7 @@ u32 LfdArchive::getFileIndex(const char* file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 bool LfdArchive::fileExists(const char *file)
@@ -148,14 +140,7 @@ bool LfdArchive::fileExists(const char *file)
 	m_curFile = -1;
 
 	//search for this file.
-	for (u32 i = 0; i < m_fileList.MASTERN; i++)
-	{
-		if (strcasecmp(file, m_fileList.entries[i].NAME) == 0)
-		{
-			return true;
-		}
-	}
-	return false;
+	return findFileIndex(file) != INVALID_FILE;
 }
 
 bool LfdArchive::fileExists(u32 index)
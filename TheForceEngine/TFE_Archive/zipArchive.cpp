@@ -86,6 +86,7 @@ bool ZipArchive::open(const char *archivePath)
 
 	strcpy(m_archivePath, archivePath);
 	m_fileHandle = nullptr;
+	buildNameIndex();
 
 	return true;
 }
@@ -110,6 +111,7 @@ void ZipArchive::close()
 	delete[] m_entries;
 	m_entries = nullptr;
 	m_curFile = INVALID_FILE;
+	clearNameIndex();
 }
 
 // File Access
@@ -195,14 +197,7 @@ bool ZipArchive::fileExists(u32 index)
 
 u32 ZipArchive::getFileIndex(const char* file)
 {
-	for (s32 i = 0; i < m_entryCount; i++)
-	{
-		if (strcasecmp(file, m_entries[i].name.c_str()) == 0)
-		{
-			return i;
-		}
-	}
-	return INVALID_FILE;
+	return findFileIndex(file);
 }
 
 size_t ZipArchive::getFileLength()
@@ -1,6 +1,7 @@
 #include "assetSystem.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/filestream.h>
 
 namespace TFE_AssetSystem
 {
@@ -111,4 +112,94 @@ namespace TFE_AssetSystem
 		}
 		return false;
 	}
+
+	static Archive* findArchiveFile(const char* defaultArchive, ArchiveType type, const char* filename, u32& index)
+	{
+		// First try the custom Archive, if there is one.
+		if (s_customArchive)
+		{
+			index = s_customArchive->getFileIndex(filename);
+			if (index != INVALID_FILE)
+			{
+				return s_customArchive;
+			}
+		}
+
+		// Otherwise use the specified GOB archive.
+		char gobPath[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_SOURCE_DATA, defaultArchive, gobPath);
+		Archive* archive = Archive::getArchive(type, defaultArchive, gobPath);
+		if (!archive)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Archive", "Cannot open source archive file \"%s\"", gobPath);
+			return nullptr;
+		}
+
+		index = archive->getFileIndex(filename);
+		if (index == INVALID_FILE)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Archive", "Failed to load \"%s\" from \"%s\"", filename, gobPath);
+			return nullptr;
+		}
+		return archive;
+	}
+
+	// Returns the file data in place if the archive is memory mapped, otherwise reads it into the buffer.
+	static const u8* mapArchiveFile(Archive* archive, u32 index, std::vector<u8>& buffer, size_t& size)
+	{
+		const u8* data = archive->getFileData(index);
+		if (data)
+		{
+			size = archive->getFileLength(index);
+			return data;
+		}
+
+		size = 0;
+		if (!archive->openFile(index))
+		{
+			return nullptr;
+		}
+		size = archive->getFileLength();
+		buffer.resize(size);
+		archive->readFile(buffer.data(), size);
+		archive->closeFile();
+		return buffer.data();
+	}
+
+	const u8* mapAssetFromArchive(const char* defaultArchive, ArchiveType type, const char* filename, std::vector<u8>& buffer, size_t& size)
+	{
+		u32 index;
+		Archive* archive = findArchiveFile(defaultArchive, type, filename, index);
+		if (!archive)
+		{
+			size = 0;
+			return nullptr;
+		}
+		return mapArchiveFile(archive, index, buffer, size);
+	}
+
+	const u8* mapAssetFromArchive(const char* defaultArchive, const char* filename, std::vector<u8>& buffer, size_t& size)
+	{
+		return mapAssetFromArchive(defaultArchive, Archive::getArchiveTypeFromName(defaultArchive), filename, buffer, size);
+	}
+
+	const u8* mapAssetFile(const FilePath* filePath, std::vector<u8>& buffer, size_t& size)
+	{
+		if (filePath->archive)
+		{
+			return mapArchiveFile(filePath->archive, filePath->index, buffer, size);
+		}
+
+		FileStream file;
+		if (!file.open(filePath, Stream::MODE_READ))
+		{
+			size = 0;
+			return nullptr;
+		}
+		size = file.getSize();
+		buffer.resize(size);
+		file.readBuffer(buffer.data(), (u32)size);
+		file.close();
+		return buffer.data();
+	}
 }
@@ -17,4 +17,10 @@ namespace TFE_AssetSystem
 	bool readAssetFromArchive(const char* defaultArchive, ArchiveType type, const char* filename, std::vector<char>& buffer);
 	bool readAssetFromArchive(const char* defaultArchive, const char* filename, std::vector<u8>& buffer);
 	bool readAssetFromArchive(const char* defaultArchive, const char* filename, std::vector<char>& buffer);
+
+	// Returns the asset data, which points directly into the archive if it is memory mapped. Otherwise the asset
+	// is read into the buffer. The data is only valid until the buffer is reused or the archive is closed.
+	const u8* mapAssetFromArchive(const char* defaultArchive, ArchiveType type, const char* filename, std::vector<u8>& buffer, size_t& size);
+	const u8* mapAssetFromArchive(const char* defaultArchive, const char* filename, std::vector<u8>& buffer, size_t& size);
+	const u8* mapAssetFile(const FilePath* filePath, std::vector<u8>& buffer, size_t& size);
 }
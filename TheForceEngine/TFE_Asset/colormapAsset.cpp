@@ -41,14 +41,16 @@ namespace TFE_ColorMap
 		}
 
 		// It doesn't exist yet, try to load the colormap.
-		if (TFE_AssetSystem::readAssetFromArchive(c_defaultGob, ARCHIVE_GOB, name, s_buffer))
+		size_t size;
+		const u8* data = TFE_AssetSystem::mapAssetFromArchive(c_defaultGob, ARCHIVE_GOB, name, s_buffer, size);
+		if (data)
 		{
 			// Create the font.
 			ColorMap* colormap = new ColorMap;
 			// We should be able to read the whole file in.
-			if (s_buffer.size() >= sizeof(ColorMap))
+			if (size >= sizeof(ColorMap))
 			{
-				memcpy(colormap, s_buffer.data(), sizeof(ColorMap));
+				memcpy(colormap, data, sizeof(ColorMap));
 			}
 
 			s_colormaps[name] = colormap;
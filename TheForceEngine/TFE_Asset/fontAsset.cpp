@@ -48,20 +48,22 @@ namespace TFE_Font
 		}
 
 		// It doesn't exist yet, try to load the font.
-		if (!TFE_AssetSystem::readAssetFromArchive(c_defaultGob, ARCHIVE_GOB, name, s_buffer))
+		size_t size;
+		const u8* fileData = TFE_AssetSystem::mapAssetFromArchive(c_defaultGob, ARCHIVE_GOB, name, s_buffer, size);
+		if (!fileData)
 		{
 			return nullptr;
 		}
 
 		// Create the font.
 		FontTFE* font = new FontTFE;
-		const FNT_Header* header = (FNT_Header*)s_buffer.data();
+		const FNT_Header* header = (const FNT_Header*)fileData;
 		font->startChar = header->First;
 		font->endChar = header->Last;
 		font->charCount = (header->Last - header->First) + 1;
 		font->height = header->height;
 
-		const u8* data = s_buffer.data() + sizeof(FNT_Header);
+		const u8* data = fileData + sizeof(FNT_Header);
 		u32 totalImageSize = 0;
 		for (s32 i = 0; i < (s32)font->charCount; i++)
 		{
@@ -71,7 +73,7 @@ namespace TFE_Font
 		}
 		font->imageData = new u8[totalImageSize];
 
-		data = s_buffer.data() + sizeof(FNT_Header);
+		data = fileData + sizeof(FNT_Header);
 		u32 offset = 0;
 		font->maxWidth = 0;
 		for (s32 i = 0; i < (s32)font->charCount; i++)
@@ -115,7 +117,9 @@ namespace TFE_Font
 		}
 
 		// It doesn't exist yet, try to load the palette.
-		if (!TFE_AssetSystem::readAssetFromArchive(archivePath, name, s_buffer))
+		size_t size;
+		const u8* fileData = TFE_AssetSystem::mapAssetFromArchive(archivePath, name, s_buffer, size);
+		if (!fileData)
 		{
 			return nullptr;
 		}
@@ -123,7 +127,7 @@ namespace TFE_Font
 		// Create the font.
 		FontTFE* font = new FontTFE;
 		memset(font, 0, sizeof(FontTFE));
-		FontHeader* header = (FontHeader*)s_buffer.data();
+		const FontHeader* header = (const FontHeader*)fileData;
 		
 		font->startChar = (u8)header->first;
 		font->endChar = (u8)header->last;
@@ -132,7 +136,7 @@ namespace TFE_Font
 
 		//character widths.
 		const s32 count = font->charCount;
-		const u8* data = s_buffer.data() + sizeof(FontHeader);
+		const u8* data = fileData + sizeof(FontHeader);
 		u32 pixelCount = 0u;
 		// Why is the data invalid? - only the font height seems to work.
 		for (s32 i = 0; i < count; i++, data++)
@@ -145,7 +149,7 @@ namespace TFE_Font
 
 		font->imageData = new u8[pixelCount];
 		u32 imageOffset = 0u;
-		const u8* srcBitmap = s_buffer.data() + sizeof(FontHeader) + header->last;
+		const u8* srcBitmap = fileData + sizeof(FontHeader) + header->last;
 		for (s32 i = 0; i < count; i++)
 		{
 			const u8 width = font->width[i];
@@ -17,6 +17,10 @@ namespace TFE_GmidAsset
 	typedef std::map<std::string, GMidiAsset*> GMidMap;
 	static GMidMap s_gmidAssets;
 	static std::vector<u8> s_buffer;
+	// The GMID being parsed, either a view into a memory mapped archive or s_buffer.
+	// There is no terminating zero after the data, so parseGMidi() keeps every read inside the file.
+	static const u8* s_fileData = nullptr;
+	static size_t s_fileSize = 0;
 
 	bool parseGMidi(GMidiAsset* midi);
 
@@ -34,15 +38,11 @@ namespace TFE_GmidAsset
 			return nullptr;
 		}
 
-		FileStream gmidAsset;
-		if (!gmidAsset.open(&filePath, Stream::MODE_READ))
+		s_fileData = TFE_AssetSystem::mapAssetFile(&filePath, s_buffer, s_fileSize);
+		if (!s_fileData)
 		{
 			return nullptr;
 		}
-		size_t size = gmidAsset.getSize();
-		s_buffer.resize(size + 1);
-		gmidAsset.readBuffer(s_buffer.data(), (u32)size);
-		gmidAsset.close();
 
 		GMidiAsset* midi = new GMidiAsset;
 		if (!parseGMidi(midi))
@@ -77,49 +77,72 @@ namespace TFE_GmidAsset
 		u32 size;
 	};
 
-	void readChunk(const u8*& buffer, GmdChunk* chunk)
+	// The readers below return zero and move the buffer to the end if there is not enough data left.
+	bool readChunk(const u8*& buffer, const u8* end, GmdChunk* chunk)
 	{
+		if (end - buffer < 8)
+		{
+			buffer = end;
+			return false;
+		}
 		memcpy(&chunk->type, buffer, 4);
 		buffer += 4;
 		chunk->size = (u32)buffer[3] | ((u32)buffer[2] << 8u) | ((u32)buffer[1] << 16u) | ((u32)buffer[0] << 24u);
 		buffer += 4;
+		return true;
 	}
 
-	u32 readU32(const u8*& buffer)
+	u32 readU32(const u8*& buffer, const u8* end)
 	{
+		if (end - buffer < 4)
+		{
+			buffer = end;
+			return 0;
+		}
 		const u32 value = (u32)buffer[3] | ((u32)buffer[2] << 8u) | ((u32)buffer[1] << 16u) | ((u32)buffer[0] << 24u);
 		buffer += 4;
 
 		return value;
 	}
 
-	u32 readU24(const u8*& buffer)
+	u32 readU24(const u8*& buffer, const u8* end)
 	{
+		if (end - buffer < 3)
+		{
+			buffer = end;
+			return 0;
+		}
 		const u32 value = (u32)buffer[2] | ((u32)buffer[1] << 8u) | ((u32)buffer[0] << 16u);
 		buffer += 3;
 
 		return value;
 	}
 
-	u32 readU16(const u8*& buffer)
+	u32 readU16(const u8*& buffer, const u8* end)
 	{
+		if (end - buffer < 2)
+		{
+			buffer = end;
+			return 0;
+		}
 		const u32 value = (u32)buffer[1] | ((u32)buffer[0] << 8u);
 		buffer += 2;
 
 		return value;
 	}
 
-	u32 readU8(const u8*& buffer)
+	u32 readU8(const u8*& buffer, const u8* end)
 	{
+		if (buffer >= end) { return 0; }
 		const u32 value = (u32)buffer[0];
 		buffer++;
 		return value;
 	}
 
-	u32 readVariableLength(const u8*& buffer)
+	u32 readVariableLength(const u8*& buffer, const u8* end)
 	{
 		u32 value = 0u;
-		for (u32 i = 0; i < 4; i++)
+		for (u32 i = 0; i < 4 && buffer < end; i++)
 		{
 			const u8 partial = *buffer;
 			buffer++;
@@ -162,15 +185,14 @@ namespace TFE_GmidAsset
 
 	bool parseGMidi(GMidiAsset* midi)
 	{
-		const u8* buffer = s_buffer.data();
-		const u32 size = (u32)s_buffer.size();
+		const u8* buffer = s_fileData;
+		const u32 size = (u32)s_fileSize;
 		const u8* end = buffer + size;
 
 		// Read the header.
 		GmdChunk header;
-		readChunk(buffer, &header);
 		// Check the header type and make sure it is correct.
-		if (header.type != c_MIDI) { return false; }
+		if (!readChunk(buffer, end, &header) || header.type != c_MIDI) { return false; }
 
 		u32 tick = 0;
 		u32 trackIndex = 0;
@@ -182,7 +204,7 @@ namespace TFE_GmidAsset
 		{
 			// Read each chunk in order.
 			GmdChunk chunk;
-			readChunk(buffer, &chunk);
+			readChunk(buffer, end, &chunk);
 			
 			// Sometimes there is a bad chunk at the end, so detect that case.
 			if (buffer >= end)
@@ -191,6 +213,7 @@ namespace TFE_GmidAsset
 			}
 
 			const u8* chunkData = buffer;
+			const u8* chunkDataEnd = chunk.size < u32(end - buffer) ? buffer + chunk.size : end;
 			switch (chunk.type)
 			{
 				case c_MDpg:
@@ -198,9 +221,9 @@ namespace TFE_GmidAsset
 				} break;
 				case c_MThd:
 				{
-					const u32 format = readU16(chunkData);
-					midi->trackCount = readU16(chunkData);
-					const u32 division = readU16(chunkData);
+					const u32 format = readU16(chunkData, chunkDataEnd);
+					midi->trackCount = readU16(chunkData, chunkDataEnd);
+					const u32 division = readU16(chunkData, chunkDataEnd);
 					if (division & 0x8000)
 					{
 						assert(0);
@@ -225,11 +248,10 @@ namespace TFE_GmidAsset
 				} break;
 				case c_MTrk:
 				{
-					const u8* chunkDataEnd = chunkData + chunk.size;
 					while (chunkData < chunkDataEnd && curTrack)
 					{
-						u32 deltaTime = readVariableLength(chunkData);
-						u8  midiEvent = readU8(chunkData);
+						u32 deltaTime = readVariableLength(chunkData, chunkDataEnd);
+						u8  midiEvent = readU8(chunkData, chunkDataEnd);
 
 						tick += deltaTime;
 						if (midiEvent == 0)
@@ -244,16 +266,19 @@ namespace TFE_GmidAsset
 						else if (midiEvent == 0xff)
 						{
 							// Meta Event
-							const MetaType metaType = (MetaType)readU8(chunkData);
-							const u32 metaLength = readVariableLength(chunkData);
+							const MetaType metaType = (MetaType)readU8(chunkData, chunkDataEnd);
+							const u32 metaLength = readVariableLength(chunkData, chunkDataEnd);
 							const u8* eventData  = chunkData;
+							// The event runs past the end of the track.
+							if (metaLength > u32(chunkDataEnd - eventData)) { break; }
 
 							if (metaType == META_SEQ_NAME || metaType == META_TEXT_EVENT || metaType == META_MARKER_TEXT)
 							{
 								char text[256];
 								assert(metaLength < 256);
-								memcpy(text, eventData, metaLength);
-								text[metaLength] = 0;
+								const u32 textLength = std::min(metaLength, 255u);
+								memcpy(text, eventData, textLength);
+								text[textLength] = 0;
 
 								if (metaType == META_SEQ_NAME)
 								{
@@ -264,12 +289,12 @@ namespace TFE_GmidAsset
 									addMidiMarker(curTrack, tick, text);
 								}
 							}
-							else if (metaType == META_TEMPO)
+							else if (metaType == META_TEMPO && metaLength >= 3)
 							{
 								// microseconds per quarter note (i.e. seconds per note = microsec / 1,000,000)
 								// 1 - 16777215
 								// 500,000 = 120 beats per minute
-								u32 tempo = readU24(eventData);
+								u32 tempo = readU24(eventData, chunkDataEnd);
 								f64 msPerTick = 0.001 * (f64)tempo / (f64)ticksPerQuarterNote;
 
 								// TODO: Is storing ms per tick in float form good enough?
@@ -283,7 +308,7 @@ namespace TFE_GmidAsset
 									addTempoEvent(curTrack, tick, (f32)msPerTick);
 								}
 							}
-							else if (metaType == META_TIME_SIG)
+							else if (metaType == META_TIME_SIG && metaLength >= 4)
 							{
 								u32 num = eventData[0];
 								u32 denom = 1u << (u32)eventData[1];
@@ -318,13 +343,13 @@ namespace TFE_GmidAsset
 						else if (midiEvent == 0xf0 || midiEvent == 0xf7)
 						{
 							// SysEx Event
-							const u32 size = readVariableLength(chunkData);
-							if (*chunkData == DARK_FORCES_SYSEX)
+							const u32 size = readVariableLength(chunkData, chunkDataEnd);
+							if (chunkData < chunkDataEnd && *chunkData == DARK_FORCES_SYSEX)
 							{
 								// addSysExEvent(curTrack, tick, *(chunkData+1), size - 3, (const char*)chunkData + 2);
 							}
-							while (*chunkData != 0xf7) { chunkData++; }
-							assert(*chunkData == 0xf7);
+							while (chunkData < chunkDataEnd && *chunkData != 0xf7) { chunkData++; }
+							if (chunkData >= chunkDataEnd) { break; }
 							chunkData++;
 						}
 						else if (midiEvent & 0x80)
@@ -334,8 +359,8 @@ namespace TFE_GmidAsset
 							const u32 evtChannel = midiEvent & 0x0f;
 							const u32 midiEvtLen = (evtType == MID_PROGRAM_CHANGE || evtType == MID_CHANNEL_PRESSURE) ? 1 : 2;
 																					
-							const u8 data1 = readU8(chunkData);
-							const u8 data2 = midiEvtLen > 1 ? readU8(chunkData) : 0;
+							const u8 data1 = readU8(chunkData, chunkDataEnd);
+							const u8 data2 = midiEvtLen > 1 ? readU8(chunkData, chunkDataEnd) : 0;
 
 							addMidiEvent(curTrack, tick, evtType, evtChannel, data1, data2);
 						}
@@ -353,7 +378,7 @@ namespace TFE_GmidAsset
 				}
 			}
 
-			buffer += chunk.size;
+			buffer = chunkDataEnd;
 		}
 
 		return midi->trackCount > 0;
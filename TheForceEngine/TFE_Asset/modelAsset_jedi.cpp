@@ -10,6 +10,7 @@
 
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Level/levelPreload.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 // TODO: dependency on JediRenderer, this should be refactored...
 #include <TFE_Jedi/Renderer/rlimits.h>
@@ -167,7 +168,7 @@ namespace TFE_Model_Jedi
 	// Remove 3DO limits.
 	static std::vector<vec2> s_tmpVtx;
 
-	bool parseModel(JediModel* model, const char* name, AssetPool pool);
+	bool parseModel(JediModel* model, const char* name, AssetPool pool, const char* data, size_t len);
 
 	JediModel* get(const char* name, AssetPool pool)
 	{
@@ -178,20 +179,36 @@ namespace TFE_Model_Jedi
 		}
 
 		// It doesn't exist yet, try to load the model.
+		// TFE: Use the data read by the level preload, if available.
+		const TFE_Jedi::LevelPreloadFile* preloaded = TFE_Jedi::levelPreload_getFile(name);
 		FilePath filePath;
-		if (!TFE_Paths::getFilePath(name, &filePath))
+		const char* data;
+		size_t dataSize;
+		if (preloaded)
 		{
-			return nullptr;
+			filePath = preloaded->filePath;
+			data = (const char*)preloaded->data.data();
+			dataSize = preloaded->data.size();
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		else
 		{
-			return nullptr;
+			if (!TFE_Paths::getFilePath(name, &filePath))
+			{
+				return nullptr;
+			}
+			FileStream file;
+			if (!file.open(&filePath, Stream::MODE_READ))
+			{
+				return nullptr;
+			}
+			size_t len = file.getSize();
+			s_buffer.resize(len);
+			file.readBuffer(s_buffer.data(), u32(len));
+			file.close();
+
+			data = s_buffer.data();
+			dataSize = s_buffer.size();
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
 			
 		s_memRegion = (pool == POOL_GAME) ? s_gameRegion : s_levelRegion;
 		JediModel* model = (JediModel*)model_alloc(sizeof(JediModel));
@@ -200,7 +217,7 @@ namespace TFE_Model_Jedi
 		////////////////////////////////////////////////////////////////
 		// Load and parse the model.
 		////////////////////////////////////////////////////////////////
-		if (!parseModel(model, name, pool))
+		if (!parseModel(model, name, pool, data, dataSize))
 		{
 			return nullptr;
 		}
@@ -361,10 +378,9 @@ namespace TFE_Model_Jedi
 		polygon->indices = (s32*)model_alloc(vertexCount * sizeof(s32));
 	}
 	
-	bool parseModel(JediModel* model, const char* name, AssetPool pool)
+	bool parseModel(JediModel* model, const char* name, AssetPool pool, const char* data, size_t len)
 	{
-		if (s_buffer.empty()) { return false; }
-		const size_t len = s_buffer.size();
+		if (!len) { return false; }
 
 		model->isBridge = 0;
 		model->vertexCount = 0;
@@ -393,8 +409,7 @@ namespace TFE_Model_Jedi
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), len);
-		const char* fileBuffer = s_buffer.data();
+		parser.init(data, len);
 		parser.addCommentString("#");
 
 		// For now just do what the original code does.
@@ -37,14 +37,15 @@ namespace TFE_Palette
 		}
 
 		// It doesn't exist yet, try to load the palette.
-		if (!TFE_AssetSystem::readAssetFromArchive(c_defaultGob, ARCHIVE_GOB, name, s_buffer))
+		size_t size;
+		const u8* src = TFE_AssetSystem::mapAssetFromArchive(c_defaultGob, ARCHIVE_GOB, name, s_buffer, size);
+		if (!src)
 		{
 			return nullptr;
 		}
 
 		// Then convert from 24 bit color to 32 bit color.
 		Palette256* pal = new Palette256;
-		u8* src = s_buffer.data();
 		for (u32 i = 0; i < 256; i++, src+=3)
 		{
 			pal->colors[i] = CONV_6bitTo8bit(src[0]) | (CONV_6bitTo8bit(src[1]) << 8) | (CONV_6bitTo8bit(src[2]) << 16) | (0xff << 24);
@@ -63,14 +64,15 @@ namespace TFE_Palette
 		}
 
 		// It doesn't exist yet, try to load the palette.
-		if (!TFE_AssetSystem::readAssetFromArchive(archivePath, name, s_buffer))
+		size_t size;
+		const u8* src = TFE_AssetSystem::mapAssetFromArchive(archivePath, name, s_buffer, size);
+		if (!src)
 		{
 			return nullptr;
 		}
 
 		// Then convert from 24 bit color to 32 bit color.
 		Palette256* pal = new Palette256;
-		u8* src = s_buffer.data();
 
 		s32 first = (s32)src[0];
 		s32 last  = (s32)src[1];
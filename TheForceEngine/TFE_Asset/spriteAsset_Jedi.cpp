@@ -8,6 +8,7 @@
 #include <TFE_Asset/assetSystem.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/Level/robject.h>
+#include <TFE_Jedi/Level/levelPreload.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <TFE_Settings/settings.h>
 // TODO: dependency on JediRenderer, this should be refactored...
@@ -107,22 +108,36 @@ namespace TFE_Sprite_Jedi
 		}
 
 		// It doesn't exist yet, try to load the frame.
+		// TFE: Use the data read by the level preload, if available.
+		const TFE_Jedi::LevelPreloadFile* preloaded = TFE_Jedi::levelPreload_getFile(name);
 		FilePath filePath;
-		if (!TFE_Paths::getFilePath(name, &filePath))
+		const u8* data;
+		size_t dataSize;
+		if (preloaded)
 		{
-			return nullptr;
+			filePath = preloaded->filePath;
+			data = preloaded->data.data();
+			dataSize = preloaded->data.size();
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		else
 		{
-			return nullptr;
-		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
+			if (!TFE_Paths::getFilePath(name, &filePath))
+			{
+				return nullptr;
+			}
+			FileStream file;
+			if (!file.open(&filePath, Stream::MODE_READ))
+			{
+				return nullptr;
+			}
+			size_t len = file.getSize();
+			s_buffer.resize(len);
+			file.readBuffer(s_buffer.data(), u32(len));
+			file.close();
 
-		const u8* data = s_buffer.data();
+			data = s_buffer.data();
+			dataSize = s_buffer.size();
+		}
 
 		// Determine ahead of time how much we need to allocate.
 		const WaxFrame* base_frame = (WaxFrame*)data;
@@ -131,10 +146,10 @@ namespace TFE_Sprite_Jedi
 
 		// This is a "load in place" format in the original code.
 		// We are going to allocate new memory and copy the data.
-		u8* assetPtr = (u8*)malloc(s_buffer.size() + columnSize);
+		u8* assetPtr = (u8*)malloc(dataSize + columnSize);
 		JediFrame* asset = (JediFrame*)assetPtr;
 		
-		memcpy(asset, data, s_buffer.size());
+		memcpy(asset, data, dataSize);
 
 		WaxFrame* frame = asset;
 		WaxCell* cell = WAX_CellPtr(asset, frame);
@@ -158,7 +173,7 @@ namespace TFE_Sprite_Jedi
 		}
 		else
 		{
-			u32* columns = (u32*)((u8*)asset + s_buffer.size());
+			u32* columns = (u32*)((u8*)asset + dataSize);
 			// Local pointer.
 			cell->columnOffset = u32((u8*)columns - (u8*)asset);
 			// Calculate column offsets.
@@ -392,23 +407,38 @@ namespace TFE_Sprite_Jedi
 		}
 
 		// It doesn't exist yet, try to load the frame.
+		// TFE: Use the data read by the level preload, if available.
+		const TFE_Jedi::LevelPreloadFile* preloaded = TFE_Jedi::levelPreload_getFile(name);
 		FilePath filePath;
-		if (!TFE_Paths::getFilePath(name, &filePath))
+		const u8* data;
+		size_t dataSize;
+		if (preloaded)
 		{
-			return nullptr;
+			filePath = preloaded->filePath;
+			data = preloaded->data.data();
+			dataSize = preloaded->data.size();
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		else
 		{
-			return nullptr;
+			if (!TFE_Paths::getFilePath(name, &filePath))
+			{
+				return nullptr;
+			}
+			FileStream file;
+			if (!file.open(&filePath, Stream::MODE_READ))
+			{
+				return nullptr;
+			}
+			size_t len = file.getSize();
+			s_buffer.resize(len);
+			file.readBuffer(s_buffer.data(), u32(len));
+			file.close();
+
+			data = s_buffer.data();
+			dataSize = s_buffer.size();
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
 
-		u8* data = s_buffer.data();
-		Wax* srcWax = (Wax*)data;
+		const Wax* srcWax = (const Wax*)data;
 		
 		// every animation is filled out until the end, so no animations = no wax.
 		if (!srcWax->animOffsets[0])
@@ -418,8 +448,7 @@ namespace TFE_Sprite_Jedi
 		s_cellOffsets.clear();
 
 		// First determine the size to allocate (note that this will overallocate a bit because cells are shared).
-		u32 cellId = 0;
-		u32 sizeToAlloc = sizeof(JediWax) + (u32)s_buffer.size();
+		u32 sizeToAlloc = sizeof(JediWax) + (u32)dataSize;
 		const s32* animOffset = srcWax->animOffsets;
 		for (s32 animIdx = 0; animIdx < 32 && animOffset[animIdx]; animIdx++)
 		{
@@ -431,18 +460,12 @@ namespace TFE_Sprite_Jedi
 				const s32* frameOffset = view->frameOffsets;
 				for (s32 f = 0; f < 32 && frameOffset[f]; f++)
 				{
-					WaxFrame* frame = (WaxFrame*)(data + frameOffset[f]);
-					WaxCell* cell = frame->cellOffset ? (WaxCell*)(data + frame->cellOffset) : nullptr;
-					bool unique = cell && isUniqueCell(frame->cellOffset);
-					if (unique && cell->compressed == 0)
+					const WaxFrame* frame = (const WaxFrame*)(data + frameOffset[f]);
+					const WaxCell* cell = frame->cellOffset ? (const WaxCell*)(data + frame->cellOffset) : nullptr;
+					if (cell && isUniqueCell(frame->cellOffset) && cell->compressed == 0)
 					{
 						sizeToAlloc += cell->sizeX * sizeof(u32);
 					}
-					if (unique)
-					{
-						cell->id = cellId;
-						cellId++;
-					}
 				}
 			}
 		}
@@ -450,7 +473,14 @@ namespace TFE_Sprite_Jedi
 		// Allocate and copy the data (this is a "copy in place" format... mostly.
 		JediWax* asset = (JediWax*)malloc(sizeToAlloc);
 		Wax* dstWax = asset;
-		memcpy(dstWax, srcWax, s_buffer.size());
+		memcpy(dstWax, srcWax, dataSize);
+
+		// TFE: Number the unique cells in the copy, so the source data is left untouched.
+		for (size_t i = 0; i < s_cellOffsets.size(); i++)
+		{
+			WaxCell* cell = (WaxCell*)((u8*)asset + s_cellOffsets[i]);
+			cell->id = u32(i);
+		}
 
 		// Loop through animation list until we reach 32 (maximum count) or a null animation.
 		// This means that animations are contiguous.
@@ -512,7 +542,7 @@ namespace TFE_Sprite_Jedi
 							}
 							else
 							{
-								u32* columns = (u32*)((u8*)asset + s_buffer.size() + cellOffsetPtr);
+								u32* columns = (u32*)((u8*)asset + dataSize + cellOffsetPtr);
 								cellOffsetPtr += dstCell->sizeX * sizeof(u32);
 
 								// Local pointer.
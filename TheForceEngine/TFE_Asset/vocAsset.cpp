@@ -19,6 +19,10 @@ namespace TFE_VocAsset
 	static VocMap s_vocAssets;
 	static VocList s_vocAssetList;
 	static std::vector<u8> s_buffer;
+	// The VOC being parsed, either a view into a memory mapped archive or s_buffer.
+	// It is not zero terminated, so parseVoc() checks every read against the end.
+	static const u8* s_fileData = nullptr;
+	static size_t s_fileSize = 0;
 
 	bool parseVoc(SoundBuffer* voc);
 
@@ -30,17 +34,8 @@ namespace TFE_VocAsset
 			return false;
 		}
 
-		FileStream vocAsset;
-		if (!vocAsset.open(&filePath, Stream::MODE_READ))
-		{
-			return false;
-		}
-		size_t size = vocAsset.getSize();
-		s_buffer.resize(size + 1);
-		vocAsset.readBuffer(s_buffer.data(), (u32)size);
-		vocAsset.close();
-
-		return true;
+		s_fileData = TFE_AssetSystem::mapAssetFile(&filePath, s_buffer, s_fileSize);
+		return s_fileData != nullptr;
 	}
 	
 	SoundBuffer* get(const char* name)
@@ -297,10 +292,10 @@ namespace TFE_VocAsset
 
 	bool parseVoc(SoundBuffer* voc)
 	{
-		if (s_buffer.empty() || !voc) { return false; }
+		if (!s_fileData || s_fileSize < sizeof(VocHeader) || !voc) { return false; }
 
-		const size_t len = s_buffer.size();
-		const u8* buffer = s_buffer.data();
+		const size_t len = s_fileSize;
+		const u8* buffer = s_fileData;
 		const u8* end = buffer + len;
 		memset(voc, 0, sizeof(SoundBuffer));
 		voc->type = SOUND_DATA_8BIT;
@@ -310,7 +305,8 @@ namespace TFE_VocAsset
 		buffer += sizeof(VocHeader);
 
 		// Parse blocks.
-		buffer = s_buffer.data() + header->datablockOffset;
+		if (header->datablockOffset >= len) { return false; }
+		buffer = s_fileData + header->datablockOffset;
 		while (buffer < end)
 		{
 			const BlockType type = BlockType(*buffer); buffer++;
@@ -318,13 +314,17 @@ namespace TFE_VocAsset
 			// TODO: Figure out what type = 170 means; for now abort.
 			if (type == VOC_TERMINATOR || type > VOC_END_REPEAT) { break; }
 			// All other blocks have a 3 byte size (up to 16MB).
+			if (end - buffer < 3) { break; }
 			const u32 blockLen = buffer[0] | (buffer[1] << 8u) | (buffer[2] << 16u);
 			buffer += 3;
+			// Stop at a truncated block rather than reading past the end of the file.
+			if (blockLen > u32(end - buffer)) { break; }
 			// Block parsing.
 			switch (type)
 			{
 				case VOC_SOUND_DATA:
 				{
+					if (blockLen < 2) { break; }
 					const s32 sampleRate = 1000000 / (256 - (s32)buffer[0]);
 					const u8  codec = buffer[1];
 					const u8* soundData = &buffer[2];
@@ -332,17 +332,20 @@ namespace TFE_VocAsset
 				} break;
 				case VOC_SOUND_CONTINUE:
 				{
+					if (blockLen < 2) { break; }
 					const u8* soundData = &buffer[2];
-					continueSoundData(voc, soundData, blockLen);
+					continueSoundData(voc, soundData, blockLen - 2);
 				} break;
 				case VOC_SILENCE:
 				{
+					if (blockLen < 3) { break; }
 					const u16 silenceLen = *((u16*)buffer);
 					const s32 sampleRate = 1000000 / (256 - (s32)buffer[2]);
 					addSilence(voc, sampleRate, silenceLen);
 				} break;
 				case VOC_MARKER:
 				{
+					if (blockLen < 2) { break; }
 					const u16 markerId = *((u16*)buffer);
 					addMarker(voc, markerId);
 				} break;
@@ -352,6 +355,7 @@ namespace TFE_VocAsset
 				} break;
 				case VOC_REPEAT:
 				{
+					if (blockLen < 2) { break; }
 					const u16 repeatCount = *((u16*)buffer);
 					loopStart(voc, repeatCount);
 				} break;
@@ -2,14 +2,16 @@
 #include "audioSystem.h"
 #include "audioDevice.h"
 #include "midiPlayer.h"
-#include <SDL_mutex.h>
 #include <TFE_System/system.h>
 #include <TFE_System/math.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_FrontEndUI/console.h>
 #include <TFE_System/profiler.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
 #include <assert.h>
 #include <algorithm>
+#include <vector>
 
 // Comment out the desired sigmoid function and comment all of the others.
 //#define AUDIO_SIGMOID_CLIP 1
@@ -31,13 +33,14 @@ enum SoundSourceFlags
 	SND_FLAG_FINISHED = (1 << 4),
 };
 
+// Client side source state, only accessed by the client (game) thread.
 struct SoundSource
 {
 	SoundType type;
 	f32 volume;
-	u32 sampleIndex;
 	u32 flags;
 	s32 slot;
+	u32 playId;		// Incremented every time the source is (re)started, used to discard stale finished events.
 
 	// Sound data.
 	const SoundBuffer* buffer;
@@ -48,6 +51,17 @@ struct SoundSource
 	s32 finishedArg = 0;
 };
 
+// Mixer side source state, only accessed by the audio thread.
+// The client copy is forwarded through the command queue whenever it changes.
+struct MixSource
+{
+	const SoundBuffer* buffer;
+	f32 volume;
+	u32 sampleIndex;
+	u32 flags;
+	u32 playId;
+};
+
 namespace TFE_Audio
 {
 	static const f32 c_channelLimit  = 1.0f;
@@ -60,22 +74,90 @@ namespace TFE_Audio
 		AUDIO_FRAME_SIZE = 1024,
 		AUDIO_CALLBACK_BUFFER_SIZE = 256,	// 256
 		BUFFERED_SILENT_FRAME_COUNT = 16,
+		AUDIO_COMMAND_COUNT = 1024,		// Must be a power of two.
+		AUDIO_EVENT_COUNT = 256,		// Must be a power of two.
+	};
+
+	// Single producer, single consumer ring of commands.
+	// The producer only writes 'writeIndex' and the consumer only writes 'readIndex', so neither side ever waits on the other.
+	struct AudioCommand
+	{
+		AudioCommandFunc func;
+		u8 data[AUDIO_COMMAND_DATA_SIZE];
+	};
+
+	struct AudioCommandRing
+	{
+		AudioCommand* entries;
+		u32 count;
+		atomic_u32 writeIndex;
+		atomic_u32 readIndex;
+	};
+
+	// A command that did not fit in its ring, only touched by the thread that queued it.
+	struct HeldCommand
+	{
+		AudioCommand cmd;
+		u32 coalesceKey;
+	};
+
+	// Each thread that queues commands gets its own ring, so every ring has a single producer.
+	enum AudioProducer
+	{
+		PRODUCER_CLIENT = 0,	// The thread that called init(), which is the game thread.
+		PRODUCER_MIDI,			// Every other thread, which is the iMuse MIDI thread.
+		PRODUCER_COUNT
+	};
+
+	struct AudioCommandQueue
+	{
+		AudioCommandRing ring;
+		std::vector<HeldCommand> held;
+	};
+
+	struct SourceCommand
+	{
+		s32 slot;
+		u32 playId;
+		f32 volume;
+		bool looping;
+		const SoundBuffer* buffer;
 	};
 
 	// Client volume controls, ranging from [0, 1]
-	static f32 s_soundFxVolume = 1.0f;
+	static atomic_f32 s_soundFxVolume(1.0f);
 
+	// Client state.
 	static u32 s_sourceCount;
 	static SoundSource s_sources[MAX_SOUND_SOURCES];
-	static SDL_mutex* s_mutex;
-	static bool s_paused = false;
 	static bool s_nullDevice = false;
-	static volatile s32 s_silentAudioFrames = 0;
 
+	// Shared state.
+	static atomic_bool s_paused(false);
+	static atomic_bool s_deviceActive(false);
+	static atomic_s32  s_silentAudioFrames(0);
 	static AudioUpsampleFilter s_upsampleFilter = AUF_DEFAULT;
+
+	// Client and MIDI thread -> audio thread commands and audio thread -> client events.
+	static AudioCommand s_commandEntries[PRODUCER_COUNT][AUDIO_COMMAND_COUNT];
+	static AudioCommand s_eventEntries[AUDIO_EVENT_COUNT];
+	static AudioCommandQueue s_commands[PRODUCER_COUNT];
+	static AudioCommandRing s_events;
+	static SDL_threadID s_clientThreadId = 0;
+	// Posted by the audio thread once it has run the queued commands, while the client waits in flushCommands().
+	static SDL_sem* s_flushSemaphore = nullptr;
+	static atomic_bool s_flushWaiting(false);
+
+	// Audio thread state.
+	static MixSource s_mixSources[MAX_SOUND_SOURCES];
+	static u32 s_mixSourceCount = 0;
 	static AudioThreadCallback s_audioThreadCallback = nullptr;
 
 	static void audioCallback(void*, unsigned char*, int);
+	static void initCommandRing(AudioCommandRing* ring, AudioCommand* entries, u32 count);
+	static void runCommands(AudioCommandRing* ring);
+	static void runHeldCommands(AudioCommandQueue* queue);
+	static void cmdStopAllSources(const void* data);
 	void setSoundVolumeConsole(const ConsoleArgList& args);
 	void getSoundVolumeConsole(const ConsoleArgList& args);
 
@@ -116,19 +198,26 @@ namespace TFE_Audio
 			return false;
 		}
 
-		bool audStream = TFE_AudioDevice::startOutput(audioCallback, nullptr, AUDIO_CHANNEL_COUNT, AUDIO_FREQ);
-		if (!audStream)
+		// Start with the mixer in the same (empty) state as the client.
+		for (s32 p = 0; p < PRODUCER_COUNT; p++)
 		{
-			TFE_System::logWrite(LOG_ERROR, "Audio", "Cannot start audio stream.");
-			s_nullDevice = true;
-			return false;
+			initCommandRing(&s_commands[p].ring, s_commandEntries[p], AUDIO_COMMAND_COUNT);
+			s_commands[p].held.clear();
 		}
+		initCommandRing(&s_events, s_eventEntries, AUDIO_EVENT_COUNT);
+		s_clientThreadId = SDL_ThreadID();
+		if (!s_flushSemaphore)
+		{
+			s_flushSemaphore = SDL_CreateSemaphore(0);
+		}
+		cmdStopAllSources(nullptr);
+		s_deviceActive = true;
 
-		s_mutex = SDL_CreateMutex();
-		if (!s_mutex)
+		bool audStream = TFE_AudioDevice::startOutput(audioCallback, nullptr, AUDIO_CHANNEL_COUNT, AUDIO_FREQ);
+		if (!audStream)
 		{
-			TFE_System::logWrite(LOG_ERROR, "Audio", "Cannot init SDL_mutex.");
-			TFE_AudioDevice::destroy();
+			TFE_System::logWrite(LOG_ERROR, "Audio", "Cannot start audio stream.");
+			s_deviceActive = false;
 			s_nullDevice = true;
 			return false;
 		}
@@ -145,21 +234,34 @@ namespace TFE_Audio
 		stopAllSounds();
 
 		TFE_AudioDevice::destroy();
-		SDL_DestroyMutex(s_mutex);
+		// The audio thread is gone, so any commands it did not get to are run here.
+		s_deviceActive = false;
+		for (s32 p = 0; p < PRODUCER_COUNT; p++)
+		{
+			runCommands(&s_commands[p].ring);
+			runHeldCommands(&s_commands[p]);
+		}
+		s_events.readIndex.store(s_events.writeIndex.load());
+
+		if (s_flushSemaphore)
+		{
+			SDL_DestroySemaphore(s_flushSemaphore);
+			s_flushSemaphore = nullptr;
+		}
 	}
 
 	void stopAllSounds()
 	{
 		if (s_nullDevice) { return; }
 
-		SDL_LockMutex(s_mutex);
 		s_sourceCount = 0u;
 		memset(s_sources, 0, sizeof(SoundSource) * MAX_SOUND_SOURCES);
 		for (s32 i = 0; i < MAX_SOUND_SOURCES; i++)
 		{
 			s_sources[i].slot = i;
 		}
-		SDL_UnlockMutex(s_mutex);
+		queueCommand(cmdStopAllSources);
+		flushCommands();
 	}
 
 	void selectDevice(s32 id)
@@ -198,16 +300,12 @@ namespace TFE_Audio
 
 	void pause()
 	{
-		SDL_LockMutex(s_mutex);
 		s_paused = true;
-		SDL_UnlockMutex(s_mutex);
 	}
 
 	void resume()
 	{
-		SDL_LockMutex(s_mutex);
 		s_paused = false;
-		SDL_UnlockMutex(s_mutex);
 	}
 
 	// Really the buffered audio will continue to process so time advances properly.
@@ -218,13 +316,18 @@ namespace TFE_Audio
 		s_silentAudioFrames = BUFFERED_SILENT_FRAME_COUNT;
 	}
 		
+	static void cmdSetAudioThreadCallback(const void* data)
+	{
+		s_audioThreadCallback = *(const AudioThreadCallback*)data;
+	}
+
 	void setAudioThreadCallback(AudioThreadCallback callback)
 	{
 		if (s_nullDevice) { return; }
 
-		SDL_LockMutex(s_mutex);
-		s_audioThreadCallback = callback;
-		SDL_UnlockMutex(s_mutex);
+		queueCommand(cmdSetAudioThreadCallback, &callback, sizeof(AudioThreadCallback));
+		// Once this returns, the previous callback is no longer running and will not be called again.
+		flushCommands();
 	}
 
 	const OutputDeviceInfo* getOutputDeviceList(s32& count, s32& curOutput)
@@ -232,16 +335,265 @@ namespace TFE_Audio
 		return TFE_AudioDevice::getOutputDeviceList(count, curOutput);
 	}
 
-	void lock()
+	//////////////////////////////////////////////////
+	// Command Queue
+	//////////////////////////////////////////////////
+	static void initCommandRing(AudioCommandRing* ring, AudioCommand* entries, u32 count)
 	{
-		if (s_nullDevice) { return; }
-		SDL_LockMutex(s_mutex);
+		ring->entries = entries;
+		ring->count = count;
+		ring->writeIndex = 0;
+		ring->readIndex = 0;
 	}
 
-	void unlock()
+	static bool ringPush(AudioCommandRing* ring, AudioCommandFunc func, const void* data, u32 size)
 	{
-		if (s_nullDevice) { return; }
-		SDL_UnlockMutex(s_mutex);
+		assert(size <= AUDIO_COMMAND_DATA_SIZE);
+		const u32 writeIndex = ring->writeIndex.load(std::memory_order_relaxed);
+		if (writeIndex - ring->readIndex.load(std::memory_order_acquire) >= ring->count)
+		{
+			return false;
+		}
+
+		AudioCommand* cmd = &ring->entries[writeIndex & (ring->count - 1)];
+		cmd->func = func;
+		if (size) { memcpy(cmd->data, data, size); }
+		ring->writeIndex.store(writeIndex + 1, std::memory_order_release);
+		return true;
+	}
+
+	static bool ringConsumed(const AudioCommandRing* ring, u32 target)
+	{
+		return s32(target - ring->readIndex.load(std::memory_order_acquire)) <= 0;
+	}
+
+	static void runCommands(AudioCommandRing* ring)
+	{
+		u32 readIndex = ring->readIndex.load(std::memory_order_relaxed);
+		const u32 writeIndex = ring->writeIndex.load(std::memory_order_acquire);
+		for (; readIndex != writeIndex; readIndex++)
+		{
+			const AudioCommand* cmd = &ring->entries[readIndex & (ring->count - 1)];
+			cmd->func(cmd->data);
+			ring->readIndex.store(readIndex + 1, std::memory_order_release);
+		}
+	}
+
+	static AudioCommandQueue* getProducerQueue()
+	{
+		return &s_commands[SDL_ThreadID() == s_clientThreadId ? PRODUCER_CLIENT : PRODUCER_MIDI];
+	}
+
+	// The ring only fills up if the audio thread has stalled. Rather than wait for it while the game or music
+	// stalls too, the command is held until there is room. A held command with the same function and key is
+	// replaced instead, so repeated parameter changes only send the latest value.
+	static void holdCommand(AudioCommandQueue* queue, AudioCommandFunc func, const void* data, u32 size, u32 coalesceKey)
+	{
+		if (queue->held.empty())
+		{
+			TFE_System::logWrite(LOG_WARNING, "Audio", "Audio command queue is full, holding commands until the audio thread catches up.");
+		}
+
+		HeldCommand* held = nullptr;
+		for (size_t i = 0; coalesceKey && i < queue->held.size(); i++)
+		{
+			if (queue->held[i].cmd.func == func && queue->held[i].coalesceKey == coalesceKey)
+			{
+				held = &queue->held[i];
+				break;
+			}
+		}
+		if (!held)
+		{
+			queue->held.push_back({});
+			held = &queue->held.back();
+		}
+		held->cmd.func = func;
+		held->coalesceKey = coalesceKey;
+		if (size) { memcpy(held->cmd.data, data, size); }
+	}
+
+	// Moves held commands into the ring in order, returns true once none are left.
+	static bool pushHeldCommands(AudioCommandQueue* queue)
+	{
+		size_t pushed = 0;
+		const size_t count = queue->held.size();
+		while (pushed < count && ringPush(&queue->ring, queue->held[pushed].cmd.func, queue->held[pushed].cmd.data, AUDIO_COMMAND_DATA_SIZE))
+		{
+			pushed++;
+		}
+		if (pushed)
+		{
+			queue->held.erase(queue->held.begin(), queue->held.begin() + pushed);
+		}
+		return queue->held.empty();
+	}
+
+	static void runHeldCommands(AudioCommandQueue* queue)
+	{
+		const size_t count = queue->held.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			queue->held[i].cmd.func(queue->held[i].cmd.data);
+		}
+		queue->held.clear();
+	}
+
+	bool queueCommand(AudioCommandFunc func, const void* data, u32 size, u32 coalesceKey)
+	{
+		if (!func || size > AUDIO_COMMAND_DATA_SIZE) { return false; }
+
+		// Without an audio thread, the command can be run immediately.
+		if (!s_deviceActive)
+		{
+			func(data);
+			return true;
+		}
+
+		// Commands held earlier go first, so the audio thread still sees them in order.
+		AudioCommandQueue* queue = getProducerQueue();
+		if (!pushHeldCommands(queue) || !ringPush(&queue->ring, func, data, size))
+		{
+			holdCommand(queue, func, data, size, coalesceKey);
+		}
+		return true;
+	}
+
+	void submitHeldCommands()
+	{
+		if (!s_deviceActive) { return; }
+
+		AudioCommandQueue* queue = getProducerQueue();
+		if (!queue->held.empty())
+		{
+			pushHeldCommands(queue);
+		}
+	}
+
+	bool queueEvent(AudioCommandFunc func, const void* data, u32 size)
+	{
+		if (!func || size > AUDIO_COMMAND_DATA_SIZE) { return false; }
+		return ringPush(&s_events, func, data, size);
+	}
+
+	void flushCommands()
+	{
+		// Only the client frees data that the mixer reads. The MIDI thread may hold a lock the audio thread waits on,
+		// so it never waits here.
+		if (!s_deviceActive || !s_flushSemaphore || SDL_ThreadID() != s_clientThreadId) { return; }
+
+		// Wait for the commands the MIDI thread has queued so far as well, since they may stop voices using the data.
+		AudioCommandQueue* client = &s_commands[PRODUCER_CLIENT];
+		const u32 midiTarget = s_commands[PRODUCER_MIDI].ring.writeIndex.load(std::memory_order_acquire);
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		s_flushWaiting = true;
+		while (s_deviceActive)
+		{
+			const bool clientHeld = !pushHeldCommands(client);
+			const u32 clientTarget = client->ring.writeIndex.load(std::memory_order_relaxed);
+			if (!clientHeld && ringConsumed(&client->ring, clientTarget) && ringConsumed(&s_commands[PRODUCER_MIDI].ring, midiTarget))
+			{
+				break;
+			}
+			// Give up eventually in case the device has stopped calling back.
+			if (TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) > 0.5)
+			{
+				TFE_System::logWrite(LOG_WARNING, "Audio", "Timed out waiting for the audio thread to process commands.");
+				break;
+			}
+			// Sleep until the audio thread has run another batch of commands.
+			SDL_SemWaitTimeout(s_flushSemaphore, 10);
+		}
+		s_flushWaiting = false;
+	}
+
+	void update()
+	{
+		submitHeldCommands();
+		runCommands(&s_events);
+	}
+
+	//////////////////////////////////////////////////
+	// Source Commands - run on the audio thread.
+	//////////////////////////////////////////////////
+	static void cmdStopAllSources(const void* data)
+	{
+		memset(s_mixSources, 0, sizeof(MixSource) * MAX_SOUND_SOURCES);
+		s_mixSourceCount = 0u;
+	}
+
+	static void cmdPlaySource(const void* data)
+	{
+		const SourceCommand* cmd = (const SourceCommand*)data;
+		MixSource* mix = &s_mixSources[cmd->slot];
+		mix->buffer = cmd->buffer;
+		mix->volume = cmd->volume;
+		mix->sampleIndex = 0u;
+		mix->playId = cmd->playId;
+		mix->flags = SND_FLAG_PLAYING | (cmd->looping ? SND_FLAG_LOOPING : 0);
+		s_mixSourceCount = std::max(s_mixSourceCount, u32(cmd->slot + 1));
+	}
+
+	static void cmdStopSource(const void* data)
+	{
+		const SourceCommand* cmd = (const SourceCommand*)data;
+		MixSource* mix = &s_mixSources[cmd->slot];
+		mix->flags = 0u;
+		mix->buffer = nullptr;
+	}
+
+	static void cmdSetSourceVolume(const void* data)
+	{
+		const SourceCommand* cmd = (const SourceCommand*)data;
+		s_mixSources[cmd->slot].volume = cmd->volume;
+	}
+
+	static void cmdSetSourceBuffer(const void* data)
+	{
+		const SourceCommand* cmd = (const SourceCommand*)data;
+		MixSource* mix = &s_mixSources[cmd->slot];
+		mix->sampleIndex = 0u;
+		mix->buffer = cmd->buffer;
+	}
+
+	static void queueSourceCommand(AudioCommandFunc func, const SoundSource* source, u32 coalesceKey = 0)
+	{
+		SourceCommand cmd;
+		cmd.slot = source->slot;
+		cmd.playId = source->playId;
+		cmd.volume = source->volume;
+		cmd.looping = (source->flags & SND_FLAG_LOOPING) != 0u;
+		cmd.buffer = source->buffer;
+		queueCommand(func, &cmd, sizeof(SourceCommand), coalesceKey);
+	}
+
+	// Runs on the client thread once the mixer has reached the end of a non-looping sound.
+	static void eventSourceFinished(const void* data)
+	{
+		const SourceCommand* cmd = (const SourceCommand*)data;
+		SoundSource* source = &s_sources[cmd->slot];
+		if (!(source->flags & SND_FLAG_PLAYING) || source->playId != cmd->playId)
+		{
+			return;
+		}
+
+		source->flags = 0;
+		source->buffer = nullptr;
+		if (source->finishedCallback)
+		{
+			source->finishedCallback(source->finishedUserData, source->finishedArg);
+		}
+
+		// Shrink the number of sources until an active source is found.
+		const s32 end = (s32)s_sourceCount - 1;
+		for (s32 s = end; s >= 0; s--)
+		{
+			if (s_sources[s].flags&SND_FLAG_ACTIVE)
+			{
+				break;
+			}
+			s_sourceCount--;
+		}
 	}
 
 	// One shot, play and forget. Only do this if the client needs no control until stopAllSounds() is called.
@@ -250,7 +602,6 @@ namespace TFE_Audio
 	{
 		if (!buffer || s_nullDevice) { return false; }
 
-		SDL_LockMutex(s_mutex);
 		// Find the first inactive source.
 		SoundSource* snd = s_sources;
 		SoundSource* newSource = nullptr;
@@ -278,12 +629,12 @@ namespace TFE_Audio
 			}
 			newSource->volume = type == SOUND_3D ? 0.0f : volume;
 			newSource->buffer = buffer;
-			newSource->sampleIndex = 0u;
+			newSource->playId++;
 			newSource->finishedCallback = finishedCallback;
 			newSource->finishedUserData = cbUserData;
 			newSource->finishedArg = cbArg;
+			queueSourceCommand(cmdPlaySource, newSource);
 		}
-		SDL_UnlockMutex(s_mutex);
 
 		return newSource != nullptr;
 	}
@@ -294,7 +645,6 @@ namespace TFE_Audio
 		if (!buffer || s_nullDevice) { return nullptr; }
 		assert(volume >= 0.0f && volume <= 1.0f);
 
-		SDL_LockMutex(s_mutex);
 		// Find the first inactive source.
 		SoundSource* snd = s_sources;
 		SoundSource* newSource = nullptr;
@@ -318,11 +668,9 @@ namespace TFE_Audio
 			newSource->flags = SND_FLAG_ACTIVE;
 			newSource->volume = volume;
 			newSource->buffer = buffer;
-			newSource->sampleIndex = 0u;
 			newSource->finishedCallback = callback;
 			newSource->finishedUserData = userData;
 		}
-		SDL_UnlockMutex(s_mutex);
 
 		return newSource;
 	}
@@ -356,45 +704,45 @@ namespace TFE_Audio
 			return;
 		}
 		
-		SDL_LockMutex(s_mutex);
-			source->flags |= SND_FLAG_PLAYING;
-			if (looping) { source->flags |= SND_FLAG_LOOPING; }
-			source->sampleIndex = 0u;
-		SDL_UnlockMutex(s_mutex);
+		source->flags |= SND_FLAG_PLAYING;
+		if (looping) { source->flags |= SND_FLAG_LOOPING; }
+		source->playId++;
+		queueSourceCommand(cmdPlaySource, source);
 	}
 
 	void stopSource(SoundSource* source)
 	{
 		if (!source || s_nullDevice) { return; }
-		SDL_LockMutex(s_mutex);
-			source->flags &= ~SND_FLAG_PLAYING;
-		SDL_UnlockMutex(s_mutex);
+		source->flags &= ~SND_FLAG_PLAYING;
+		queueSourceCommand(cmdStopSource, source);
+		// Callers may free the sound buffer once the source is stopped, so wait until the mixer is done with it.
+		flushCommands();
 	}
 	
 	void freeSource(SoundSource* source)
 	{
 		if (!source || s_nullDevice) { return; }
-		SDL_LockMutex(s_mutex);
-			source->flags &= ~SND_FLAG_PLAYING;
-			source->flags &= ~SND_FLAG_ACTIVE;
-			source->buffer = nullptr;
-		SDL_UnlockMutex(s_mutex);
+		source->flags &= ~SND_FLAG_PLAYING;
+		source->flags &= ~SND_FLAG_ACTIVE;
+		source->buffer = nullptr;
+		queueSourceCommand(cmdStopSource, source);
+		flushCommands();
 	}
 
 	void setSourceVolume(SoundSource* source, f32 volume)
 	{
 		if (s_nullDevice) { return; }
 		source->volume = std::max(0.0f, std::min(1.0f, volume));
+		// Volume changes to the same playback can be merged if the queue is full.
+		queueSourceCommand(cmdSetSourceVolume, source, ((source->playId << 7) | u32(source->slot)) + 1);
 	}
 
 	// This will restart the sound and change the buffer.
 	void setSourceBuffer(SoundSource* source, const SoundBuffer* buffer)
 	{
 		if (s_nullDevice) { return; }
-		SDL_LockMutex(s_mutex);
-			source->sampleIndex = 0u;
-			source->buffer = buffer;
-		SDL_UnlockMutex(s_mutex);
+		source->buffer = buffer;
+		queueSourceCommand(cmdSetSourceBuffer, source);
 	}
 
 	bool isSourcePlaying(SoundSource* source)
@@ -413,31 +761,30 @@ namespace TFE_Audio
 	static const f32 c_scale[] = { 2.0f / 255.0f, 2.0f / 65535.0f, 1.0f };
 	static const f32 c_offset[] = { -1.0f, -1.0f, 0.0f };
 
+	// Let the client know about finished sources, the callbacks are called from update().
+	// If the event queue is full, the source stays finished and is reported on the next callback instead.
 	void cleanupSources()
 	{
-		// call any finished callbacks.
-		for (u32 s = 0; s < s_sourceCount; s++)
+		MixSource* mix = s_mixSources;
+		for (u32 s = 0; s < s_mixSourceCount; s++, mix++)
 		{
-			if (s_sources[s].flags&SND_FLAG_FINISHED)
+			if (!(mix->flags&SND_FLAG_FINISHED)) { continue; }
+
+			SourceCommand event;
+			memset(&event, 0, sizeof(SourceCommand));
+			event.slot = s32(s);
+			event.playId = mix->playId;
+			if (queueEvent(eventSourceFinished, &event, sizeof(SourceCommand)))
 			{
-				s_sources[s].flags = 0;
-				s_sources[s].buffer = nullptr;
-				if (s_sources[s].finishedCallback)
-				{
-					s_sources[s].finishedCallback(s_sources[s].finishedUserData, s_sources[s].finishedArg);
-				}
+				mix->flags = 0;
+				mix->buffer = nullptr;
 			}
 		}
 
-		const s32 end = (s32)s_sourceCount - 1;
-		//shrink the number of sources until an active source is found.
-		for (s32 s = end; s >= 0; s--)
+		// Shrink the number of mixer sources until a used source is found.
+		while (s_mixSourceCount && !s_mixSources[s_mixSourceCount - 1].flags)
 		{
-			if (s_sources[s].flags&SND_FLAG_ACTIVE)
-			{
-				break;
-			}
-			s_sourceCount--;
+			s_mixSourceCount--;
 		}
 	}
 		
@@ -467,16 +814,27 @@ namespace TFE_Audio
 
 		// First clear samples
 		memset(buffer, 0, bufferSize);
-			   
-		SDL_LockMutex(s_mutex);
+
+		// Apply the client and MIDI thread changes queued since the last callback.
+		for (s32 p = 0; p < PRODUCER_COUNT; p++)
+		{
+			runCommands(&s_commands[p].ring);
+		}
+		if (s_flushWaiting)
+		{
+			SDL_SemPost(s_flushSemaphore);
+		}
+		const bool paused = s_paused;
+		const s32 silentAudioFrames = s_silentAudioFrames;
+
 		// Then call the audio thread callback
-		if (s_audioThreadCallback && !s_paused)
+		if (s_audioThreadCallback && !paused)
 		{
 			static f32 callbackBuffer[(AUDIO_CALLBACK_BUFFER_SIZE + 2)*AUDIO_CHANNEL_COUNT];	// 256 stereo + oversampling.
 			s_audioThreadCallback(callbackBuffer, AUDIO_CALLBACK_BUFFER_SIZE, s_soundFxVolume * c_soundHeadroom);
 			// The audio buffer is 1/4 as large as it should be.
 			// This means that in-between samples must be interpolated.
-			if (!s_silentAudioFrames)
+			if (!silentAudioFrames)
 			{
 				if (s_upsampleFilter == AUF_NONE)
 				{
@@ -492,8 +850,8 @@ namespace TFE_Audio
 		// Then loop through the sources.
 		// Note: this is no longer used by Dark Forces. However I decided to keep direct sound support around
 		// so it can be used for tools.
-		SoundSource* snd = s_sources;
-		for (u32 s = 0; s < s_sourceCount && !s_paused; s++, snd++)
+		MixSource* snd = s_mixSources;
+		for (u32 s = 0; s < s_mixSourceCount && !paused; s++, snd++)
 		{
 			if (!(snd->flags&SND_FLAG_PLAYING)) { continue; }
 			assert(snd->buffer->data);
@@ -554,16 +912,14 @@ namespace TFE_Audio
 				snd->sampleIndex = sIndex;
 			}
 		}
-		// Cleanup sound sources while we are still in the mutex.
 		cleanupSources();
 		
 		// Handle midi synthesis results.
-		if (!s_paused)
+		if (!paused)
 		{
-			TFE_MidiPlayer::synthesizeMidi((f32*)outputBuffer, frames, !s_silentAudioFrames);
+			TFE_MidiPlayer::synthesizeMidi((f32*)outputBuffer, frames, !silentAudioFrames);
 		}
-		if (s_silentAudioFrames > 0) { s_silentAudioFrames--; }
-		SDL_UnlockMutex(s_mutex);
+		if (silentAudioFrames > 0) { s_silentAudioFrames--; }
 
 		// Handle out of range audio samples.
 		buffer = (f32*)outputBuffer;
@@ -615,7 +971,7 @@ namespace TFE_Audio
 	void getSoundVolumeConsole(const ConsoleArgList& args)
 	{
 		char res[256];
-		sprintf(res, "Sound Volume: %2.3f", s_soundFxVolume);
+		sprintf(res, "Sound Volume: %2.3f", s_soundFxVolume.load());
 		TFE_Console::addToHistory(res);
 	}
 }
@@ -47,6 +47,11 @@ enum SoundType
 
 typedef void(*SoundFinishedCallback)(void* userData, s32 arg);
 typedef void(*AudioThreadCallback)(f32* buffer, u32 bufferSize, f32 systemVolume);
+// Command or event function, data is a copy of the data passed in when it was queued.
+typedef void(*AudioCommandFunc)(const void* data);
+
+// Maximum size of the data copied with each command or event.
+#define AUDIO_COMMAND_DATA_SIZE 64
 
 namespace TFE_Audio
 {
@@ -70,12 +75,27 @@ namespace TFE_Audio
 	void pause();
 	void resume();
 
-	void lock();
-	void unlock();
-
 	void bufferedAudioClear();
 
+	// The audio thread callback is changed on the audio thread, once this returns the previous callback will no longer be called.
 	void setAudioThreadCallback(AudioThreadCallback callback = nullptr);
+
+	// The client never shares state with the audio thread directly, instead changes are sent as commands through a lock-free queue.
+	// The game and iMuse MIDI threads each have their own queue. Commands run on the audio thread, in the order each thread
+	// queued them, before the next buffer is mixed. If there is no audio thread, the command is run immediately.
+	// If the queue is full, the command is held and sent later. A held command with the same function and a non-zero
+	// coalesceKey is replaced, so use a key that identifies the voice or source for commands that only set parameters.
+	bool queueCommand(AudioCommandFunc func, const void* data = nullptr, u32 size = 0, u32 coalesceKey = 0);
+	// Sends the commands the calling thread had to hold back, called regularly by each thread that queues commands.
+	void submitHeldCommands();
+	// Waits until every command queued so far has run. This is only required before freeing memory that the audio thread may read.
+	// Only the game thread waits, calls from other threads return immediately.
+	void flushCommands();
+	// Events are queued by the audio thread (from commands or the audio thread callback) and run on the main thread in update().
+	// Returns false if the event queue is full, in which case the event should be retried later.
+	bool queueEvent(AudioCommandFunc func, const void* data = nullptr, u32 size = 0);
+	// Runs the queued events and the finished callbacks of sound sources, called once per frame on the main thread.
+	void update();
 	const OutputDeviceInfo* getOutputDeviceList(s32& count, s32& curOutput);
 
 	// One shot, play and forget. Only do this if the client needs no control until stopAllSounds() is called.
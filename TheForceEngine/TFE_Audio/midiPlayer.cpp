@@ -1,6 +1,7 @@
 #include "midiPlayer.h"
 #include "midiDevice.h"
 #include "audioDevice.h"
+#include "audioSystem.h"
 #ifdef BUILD_SYSMIDI
 #include "systemMidiDevice.h"
 #endif
@@ -41,7 +42,16 @@ namespace TFE_MidiPlayer
 		f32 newVolume;
 	};
 
-	enum { MAX_MIDI_CMD = 256 };
+	enum
+	{
+		MAX_MIDI_CMD = 256,
+		// Render ahead, see setRenderAhead().
+		RENDER_SAMPLE_RATE = 44100,			// Matches the audio system output rate.
+		RENDER_BLOCK_FRAMES = 64,			// Stereo frames rendered per sequencer step, ~1.5ms.
+		RENDER_BLOCKS_PER_LOCK = 8,			// Limits how long the midi thread mutex is held while rendering.
+		RENDER_RING_FRAMES = 131072,		// Must be a power of two and larger than the maximum render ahead.
+		RENDER_AHEAD_MAX_MS = 2000,
+	};
 	static MidiCmd s_midiCmdBuffer[MAX_MIDI_CMD];
 	static u32 s_midiCmdCount = 0;
 	static f64 s_maxNoteLength = 16.0;		// defaults to 16 seconds.
@@ -70,6 +80,16 @@ namespace TFE_MidiPlayer
 	static std::vector<f32> s_sampleBuffer;
 	static f32* s_sampleBufferPtr = nullptr;
 
+	// Render ahead ring buffer: written by the midi thread and read by the audio thread.
+	// Positions are in stereo frames and only ever increase (wrapping at 2^32).
+	static f32 s_renderRing[RENDER_RING_FRAMES * 2];
+	static atomic_u32  s_renderWrite(0);
+	static atomic_u32  s_renderRead(0);
+	static atomic_u32  s_renderSkipTo(0);			// When s_renderSkip is set, the reader jumps to this position.
+	static atomic_bool s_renderSkip(false);
+	static atomic_bool s_renderAheadActive(false);	// Set by the midi thread when the audio thread should read from the ring.
+	static atomic_u32  s_renderAheadFrames(0);		// Requested render ahead, 0 = render in the audio callback.
+
 	// Hanging note detection.
 	struct Instrument
 	{
@@ -80,6 +100,8 @@ namespace TFE_MidiPlayer
 	static f64 s_curNoteTime = 0.0;
 
 	int midiUpdateFunc(void* userData);
+	void renderAhead_discard();
+	bool renderAhead_update(bool isPaused);
 	void stopAllNotes();
 	void changeVolume();
 	void allocateMidiDevice(MidiDeviceType type);
@@ -148,6 +170,7 @@ namespace TFE_MidiPlayer
 		TFE_Settings_Sound* soundSettings = TFE_Settings::getSoundSettings();
 		setVolume(soundSettings->musicVolume);
 		setMaximumNoteLength();
+		setRenderAhead(soundSettings->musicRenderAhead);
 
 		return res && s_thread;
 	}
@@ -254,6 +277,12 @@ namespace TFE_MidiPlayer
 		s_maxNoteLength = f64(dt);
 	}
 
+	void setRenderAhead(s32 milliseconds)
+	{
+		milliseconds = std::max(0, std::min((s32)RENDER_AHEAD_MAX_MS, milliseconds));
+		s_renderAheadFrames = u32(milliseconds) * RENDER_SAMPLE_RATE / 1000;
+	}
+
 	void pauseThread()
 	{
 		if (!s_tPaused && s_midiThreadMutex)
@@ -307,6 +336,29 @@ namespace TFE_MidiPlayer
 
 	void synthesizeMidi(f32* buffer, u32 stereoSampleCount, bool updateBuffer)
 	{
+		// The midi thread has already rendered the audio, so just copy what is available.
+		if (s_renderAheadActive)
+		{
+			u32 readPos = s_renderRead.load(std::memory_order_relaxed);
+			if (s_renderSkip.exchange(false))
+			{
+				readPos = s_renderSkipTo.load();
+			}
+			const u32 available = s_renderWrite.load(std::memory_order_acquire) - readPos;
+			const u32 frameCount = std::min(available, stereoSampleCount);
+			if (updateBuffer)
+			{
+				for (u32 i = 0; i < frameCount; i++, buffer += 2)
+				{
+					const f32* src = &s_renderRing[((readPos + i) & (RENDER_RING_FRAMES - 1)) * 2];
+					buffer[0] += src[0];
+					buffer[1] += src[1];
+				}
+			}
+			s_renderRead.store(readPos + frameCount, std::memory_order_release);
+			return;
+		}
+
 		// In some cases, such as when using the System Midi Device, the midi audio is generated externally so
 		// rendering is not required.
 		SDL_LockMutex(s_deviceChangeMutex);  // Make sure we don't synthesize when the device is being changed.
@@ -495,6 +547,7 @@ namespace TFE_MidiPlayer
 						localTimeCallback = 0;
 						isPaused = true;
 						stopAllNotes();
+						renderAhead_discard();
 					} break;
 					case MIDI_RESUME:
 					{
@@ -509,6 +562,7 @@ namespace TFE_MidiPlayer
 					case MIDI_STOP_NOTES:
 					{
 						stopAllNotes();
+						renderAhead_discard();
 						// Reset callback time.
 						localTimeCallback = 0;
 						s_midiCallback.accumulator = 0.0;
@@ -517,8 +571,15 @@ namespace TFE_MidiPlayer
 			}
 			s_midiCmdCount = 0;
 
+			// When rendering ahead, the callback is driven by the rendered audio instead of the system clock.
+			bool ringFull = false;
+			if (renderAhead_update(isPaused))
+			{
+				ringFull = s_renderWrite.load() - s_renderRead.load() >= s_renderAheadFrames.load();
+				localTimeCallback = 0;
+			}
 			// Process the midi callback, if it exists.
-			if (s_midiCallback.callback && !isPaused)
+			else if (s_midiCallback.callback && !isPaused)
 			{
 				s_midiCallback.accumulator += TFE_System::updateThreadLocal(&localTimeCallback);
 				while (s_midiCallback.callback && s_midiCallback.accumulator >= s_midiCallback.timeStep)
@@ -533,12 +594,85 @@ namespace TFE_MidiPlayer
 			}
 
 			SDL_UnlockMutex(s_midiThreadMutex);
+			// Wave sound commands from iMuse that did not fit in the audio queue.
+			TFE_Audio::submitHeldCommands();
 			runThread = s_runMusicThread.load();
+
+			// Nothing to do until the audio thread consumes some of the rendered audio.
+			if (ringFull)
+			{
+				TFE_System::sleep(1);
+			}
 		};
 		
 		return 0;
 	}
 
+	//////////////////////////////////////////////////
+	// Render Ahead
+	// The sequencer and synthesizer run on the midi thread, ahead of the audio thread, so the cost of
+	// synthesis never lands in the audio callback. Midi events are sample accurate to the render block
+	// but changes made by the game are heard after the render ahead time.
+	//////////////////////////////////////////////////
+
+	// Drop audio that was rendered ahead, so stopped notes are not heard after the fact.
+	void renderAhead_discard()
+	{
+		if (!s_renderAheadActive) { return; }
+		s_renderSkipTo = s_renderWrite.load();
+		s_renderSkip = true;
+	}
+
+	// Renders ahead if enabled and possible, returns false if the audio should be rendered in the audio callback instead.
+	bool renderAhead_update(bool isPaused)
+	{
+		const u32 targetFrames = s_renderAheadFrames.load();
+		SDL_LockMutex(s_deviceChangeMutex);
+		const bool canRender = targetFrames > 0 && s_midiDevice && s_midiDevice->canRender();
+		if (canRender != s_renderAheadActive.load())
+		{
+			// Start from an empty ring either way.
+			s_renderRead = s_renderWrite.load();
+			s_renderSkip = false;
+			s_renderAheadActive = canRender;
+		}
+		if (!canRender)
+		{
+			SDL_UnlockMutex(s_deviceChangeMutex);
+			return false;
+		}
+
+		const f64 blockTime = f64(RENDER_BLOCK_FRAMES) / f64(RENDER_SAMPLE_RATE);
+		for (s32 b = 0; b < RENDER_BLOCKS_PER_LOCK; b++)
+		{
+			const u32 writePos = s_renderWrite.load(std::memory_order_relaxed);
+			if (writePos - s_renderRead.load(std::memory_order_acquire) + RENDER_BLOCK_FRAMES > targetFrames)
+			{
+				break;
+			}
+
+			// Send the midi events that are due during this block.
+			if (s_midiCallback.callback && !isPaused)
+			{
+				s_midiCallback.accumulator += blockTime;
+				while (s_midiCallback.callback && s_midiCallback.accumulator >= s_midiCallback.timeStep)
+				{
+					s_midiCallback.callback();
+					s_midiCallback.accumulator -= s_midiCallback.timeStep;
+					s_curNoteTime += s_midiCallback.timeStep;
+				}
+				detectHangingNotes();
+			}
+
+			// RENDER_RING_FRAMES is a multiple of the block size, so blocks never wrap.
+			f32* out = &s_renderRing[(writePos & (RENDER_RING_FRAMES - 1)) * 2];
+			s_midiDevice->render(out, RENDER_BLOCK_FRAMES);
+			s_renderWrite.store(writePos + RENDER_BLOCK_FRAMES, std::memory_order_release);
+		}
+		SDL_UnlockMutex(s_deviceChangeMutex);
+		return true;
+	}
+
 	// Console Functions
 	void setMusicVolumeConsole(const ConsoleArgList& args)
 	{
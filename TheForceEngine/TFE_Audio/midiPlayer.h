@@ -23,6 +23,9 @@ namespace TFE_MidiPlayer
 	void setVolume(f32 volume);
 	// Set the maximum length in seconds that a note is allowed to play for in seconds.
 	void setMaximumNoteLength(f32 dt = 16.0f);
+	// Render music this far ahead on the midi thread instead of synthesizing it in the audio callback.
+	// 0 = synthesize in the audio callback, the maximum is 2000 ms. Only applies to devices that can render.
+	void setRenderAhead(s32 milliseconds);
 
 	// Send a direct midi message.
 	// Note: this should be called from the midi thread.
@@ -7,6 +7,7 @@
 #include "../sound.h"
 #include "animTables.h"
 #include "actorModule.h"
+#include "actorVisibility.h"
 #include "mousebot.h"
 #include "dragon.h"
 #include "bobaFett.h"
@@ -70,6 +71,8 @@ namespace TFE_DarkForces
 		s_istate.objCollisionEnabled = JTRUE;
 		list_clear(s_physicsActors);
 
+		actorVisibility_clear();
+
 		// Clear specific actor state.
 		mousebot_clear();
 		welder_clear();
@@ -1608,7 +1611,7 @@ namespace TFE_DarkForces
 		obj->entityFlags |= ETFLAG_SMART_OBJ;
 	}
 
-	JBool actor_canSeeObject(SecObject* actorObj, SecObject* obj)
+	JBool actor_traceLineOfSight(SecObject* actorObj, SecObject* obj)
 	{
 		vec3_fixed p0 = { actorObj->posWS.x, actorObj->posWS.y - actorObj->worldHeight, actorObj->posWS.z };
 		vec3_fixed p1 = { obj->posWS.x, obj->posWS.y, obj->posWS.z };
@@ -1624,6 +1627,16 @@ namespace TFE_DarkForces
 		vec3_fixed p2 = { obj->posWS.x, obj->posWS.y - obj->worldHeight, obj->posWS.z };
 		return collision_canHitObject(actorObj->sector, obj->sector, p0, p2, 0);
 	}
+
+	JBool actor_canSeeObject(SecObject* actorObj, SecObject* obj)
+	{
+		// TFE: Player visibility is cached, since many actors query it every tick.
+		if (obj == s_playerObject)
+		{
+			return actorVisibility_canSeePlayer(actorObj, actor_traceLineOfSight);
+		}
+		return actor_traceLineOfSight(actorObj, obj);
+	}
 	   
 	JBool actor_canSeeObjFromDist(SecObject* actorObj, SecObject* obj)
 	{
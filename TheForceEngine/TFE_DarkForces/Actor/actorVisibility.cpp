@@ -0,0 +1,228 @@
+#include <unordered_map>
+#include <vector>
+
+#include "actorVisibility.h"
+#include <TFE_DarkForces/player.h>
+#include <TFE_Jedi/Level/rsector.h>
+#include <TFE_Jedi/Level/rwall.h>
+#include <TFE_Jedi/Level/levelData.h>
+
+using namespace TFE_Jedi;
+
+namespace TFE_DarkForces
+{
+	struct VisibilityEntry
+	{
+		RSector* sector;
+		vec3_fixed pos;
+		fixed16_16 height;
+		JBool canSee;
+	};
+
+	// Level and player state the cached results were computed with.
+	struct VisibilityState
+	{
+		u32 geometryVersion;
+		RSector* sectorList;
+		RSector* playerSector;
+		vec3_fixed playerPos;
+		fixed16_16 playerHeight;
+	};
+
+	static VisibilityState s_visState = { 0 };
+	static JBool s_visStateValid = JFALSE;
+	// Sectors that adjoin each sector, so adjoins without a matching adjoin on the other side are followed backward too.
+	// Entries for sector i are s_reverseAdjoins[s_reverseStart[i]] to s_reverseAdjoins[s_reverseStart[i + 1] - 1].
+	static std::vector<u32> s_reverseStart;
+	static std::vector<RSector*> s_reverseAdjoins;
+	// Sectors with a stamp equal to s_reachStamp connect to the player's sector.
+	static std::vector<u32> s_sectorReachStamp;
+	static std::vector<RSector*> s_reachQueue;
+	static u32 s_reachStamp = 0;
+	static std::unordered_map<SecObject*, VisibilityEntry> s_visEntries;
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	// A trace passes through an adjoin only if the hit height is within both sectors,
+	// so adjoins where the vertical openings do not overlap are closed.
+	static JBool adjoinIsOpen(const RSector* sector, const RSector* next)
+	{
+		const fixed16_16 ceilHeight  = max(sector->ceilingHeight, next->ceilingHeight);
+		const fixed16_16 floorHeight = min(sector->floorHeight, next->floorHeight);
+		return ceilHeight <= floorHeight ? JTRUE : JFALSE;
+	}
+
+	static JBool sectorInRange(const RSector* sector)
+	{
+		return sector->index >= 0 && u32(sector->index) < s_levelState.sectorCount ? JTRUE : JFALSE;
+	}
+
+	static void buildReverseAdjoins()
+	{
+		const u32 sectorCount = s_levelState.sectorCount;
+		s_reverseStart.assign(sectorCount + 1, 0);
+		s_reverseAdjoins.clear();
+
+		// Count the adjoins that lead into each sector, then fill them in.
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->nextSector && sectorInRange(wall->nextSector))
+				{
+					s_reverseStart[wall->nextSector->index + 1]++;
+				}
+			}
+		}
+		for (u32 s = 0; s < sectorCount; s++)
+		{
+			s_reverseStart[s + 1] += s_reverseStart[s];
+		}
+		s_reverseAdjoins.resize(s_reverseStart[sectorCount]);
+
+		std::vector<u32> fillIndex(s_reverseStart.begin(), s_reverseStart.end() - 1);
+		sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->nextSector && sectorInRange(wall->nextSector))
+				{
+					s_reverseAdjoins[fillIndex[wall->nextSector->index]++] = sector;
+				}
+			}
+		}
+	}
+
+	static void addReachableSector(RSector* sector, RSector* next)
+	{
+		if (!sectorInRange(next) || s_sectorReachStamp[next->index] == s_reachStamp || !adjoinIsOpen(sector, next))
+		{
+			return;
+		}
+		s_sectorReachStamp[next->index] = s_reachStamp;
+		s_reachQueue.push_back(next);
+	}
+
+	// Adjoins are followed in both directions, so one-way adjoins in custom levels cannot hide a sector the player can be seen from.
+	static void computeReachableSectors(RSector* playerSector)
+	{
+		const u32 sectorCount = s_levelState.sectorCount;
+		if (s_sectorReachStamp.size() < sectorCount)
+		{
+			s_sectorReachStamp.resize(sectorCount, 0);
+		}
+		s_reachStamp++;
+		if (s_reachStamp == 0)
+		{
+			std::fill(s_sectorReachStamp.begin(), s_sectorReachStamp.end(), 0u);
+			s_reachStamp = 1;
+		}
+
+		s_reachQueue.clear();
+		s_reachQueue.push_back(playerSector);
+		s_sectorReachStamp[playerSector->index] = s_reachStamp;
+		for (size_t i = 0; i < s_reachQueue.size(); i++)
+		{
+			RSector* sector = s_reachQueue[i];
+			RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->nextSector)
+				{
+					addReachableSector(sector, wall->nextSector);
+				}
+			}
+
+			const u32 end = s_reverseStart[sector->index + 1];
+			for (u32 r = s_reverseStart[sector->index]; r < end; r++)
+			{
+				addReachableSector(sector, s_reverseAdjoins[r]);
+			}
+		}
+	}
+
+	// The reachable sectors only depend on the level geometry and the player's sector, while the traced results
+	// also depend on the player's position. Nothing depends on the tick, so results carry over while nothing moves.
+	static void updateState(SecObject* player)
+	{
+		const JBool levelMatches = s_visStateValid && s_visState.geometryVersion == s_sectorGeometryVersion &&
+			s_visState.sectorList == s_levelState.sectors;
+		const JBool sectorMatches = levelMatches && s_visState.playerSector == player->sector;
+		if (sectorMatches && s_visState.playerPos.x == player->posWS.x && s_visState.playerPos.y == player->posWS.y &&
+			s_visState.playerPos.z == player->posWS.z && s_visState.playerHeight == player->worldHeight)
+		{
+			return;
+		}
+		s_visEntries.clear();
+
+		if (!levelMatches)
+		{
+			buildReverseAdjoins();
+		}
+		if (!sectorMatches)
+		{
+			computeReachableSectors(player->sector);
+		}
+
+		s_visState.geometryVersion = s_sectorGeometryVersion;
+		s_visState.sectorList = s_levelState.sectors;
+		s_visState.playerSector = player->sector;
+		s_visState.playerPos = player->posWS;
+		s_visState.playerHeight = player->worldHeight;
+		s_visStateValid = JTRUE;
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+	void actorVisibility_clear()
+	{
+		s_visStateValid = JFALSE;
+		s_visEntries.clear();
+		s_reverseStart.clear();
+		s_reverseAdjoins.clear();
+		s_sectorReachStamp.clear();
+		s_reachQueue.clear();
+		s_reachStamp = 0;
+	}
+
+	JBool actorVisibility_canSeePlayer(SecObject* obj, VisibilityTraceFunc trace)
+	{
+		SecObject* player = s_playerObject;
+		// The control sector is not part of the sector list.
+		if (!player || !player->sector || !obj->sector || !sectorInRange(player->sector) || !sectorInRange(obj->sector))
+		{
+			return trace(obj, player);
+		}
+		updateState(player);
+
+		if (s_sectorReachStamp[obj->sector->index] != s_reachStamp)
+		{
+			return JFALSE;
+		}
+
+		std::unordered_map<SecObject*, VisibilityEntry>::iterator iEntry = s_visEntries.find(obj);
+		if (iEntry != s_visEntries.end())
+		{
+			const VisibilityEntry* entry = &iEntry->second;
+			if (entry->sector == obj->sector && entry->height == obj->worldHeight &&
+				entry->pos.x == obj->posWS.x && entry->pos.y == obj->posWS.y && entry->pos.z == obj->posWS.z)
+			{
+				return entry->canSee;
+			}
+		}
+
+		VisibilityEntry entry;
+		entry.sector = obj->sector;
+		entry.pos = obj->posWS;
+		entry.height = obj->worldHeight;
+		entry.canSee = trace(obj, player);
+		s_visEntries[obj] = entry;
+		return entry.canSee;
+	}
+}  // namespace TFE_DarkForces
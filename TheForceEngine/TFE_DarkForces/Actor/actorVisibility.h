@@ -0,0 +1,25 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Dark Forces
+// Added for TFE: caches the player visibility queries made by the AI.
+//
+// When the player changes sectors, the sectors that connect to the
+// player's sector through open adjoins are found, following adjoins
+// in both directions. A line of sight can only reach the player
+// through those adjoins, so actors in any other sector are rejected
+// without tracing. Traced results are kept per actor object and
+// reused while the actor, the player and the level geometry stay the
+// same, across ticks. The results match uncached tracing.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Level/robject.h>
+
+namespace TFE_DarkForces
+{
+	// Traces the line of sight from the object to the target.
+	typedef JBool(*VisibilityTraceFunc)(SecObject* obj, SecObject* target);
+
+	void  actorVisibility_clear();
+	// Returns true if the object can see the player, calling trace() only when the result is not cached.
+	JBool actorVisibility_canSeePlayer(SecObject* obj, VisibilityTraceFunc trace);
+}  // namespace TFE_DarkForces
@@ -4,6 +4,7 @@
 #include <TFE_A11y/accessibility.h>
 #include <TFE_Game/igame.h>
 #include <TFE_Jedi/IMuse/imuse.h>
+#include <TFE_Audio/audioSystem.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_System/system.h>
@@ -108,6 +109,9 @@ namespace TFE_DarkForces
 			{
 				stopSound(sound);
 			}
+			// TFE: The mixer reads the sound through its id until the stop has run on the audio thread.
+			// This also covers stops queued by the iMuse MIDI thread, such as fades that end the sound.
+			TFE_Audio::flushCommands();
 
 			if (isDiscardSoundData(sound) && sound->data)
 			{
@@ -2,6 +2,7 @@
 #include "scriptTexture.h"
 #include <TFE_ForceScript/ScriptAPI-Shared/scriptMath.h>
 #include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/sectorEdges.h>
 #include <angelscript.h>
 
 using namespace TFE_Jedi;
@@ -139,6 +140,7 @@ namespace TFE_DarkForces
 			sector_setupWallDrawFlags(sector);
 			sector_setupWallDrawFlags(lvlWall->nextSector);
 		}
+		s_sectorGeometryVersion++;
 	}
 	void setMirror(s32 id, ScriptWall* wall)
 	{
@@ -160,6 +162,7 @@ namespace TFE_DarkForces
 			sector_setupWallDrawFlags(lvlWall->nextSector);
 		}
 		sector_setupWallDrawFlags(sector);
+		s_sectorGeometryVersion++;
 	}
 	void setWallLight(f32 light, ScriptWall* wall)
 	{
@@ -216,6 +219,9 @@ namespace TFE_DarkForces
 			lvlWall->w1->z = floatToFixed16(vtx.y);
 		}
 		sector->dirtyFlags |= (SDF_VERTICES | SDF_WALL_SHAPE);
+		sectorEdges_markDirty(sector);
+		// Moved vertices change the cached AI visibility results, the same as INF wall moves.
+		s_sectorGeometryVersion++;
 	}
 
 	void ScriptWall::registerType()
@@ -48,6 +48,7 @@
 #include <TFE_Archive/gobMemoryArchive.h>
 #include <TFE_Jedi/Level/rfont.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelPreload.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Renderer/jediRenderer.h>
@@ -222,6 +223,7 @@ namespace TFE_DarkForces
 	};
 	static RunGameState   s_runGameState = {};
 	static SharedGameState s_sharedState = {};
+	static f64 s_simStepInterval = 0.0;
 				
 	/////////////////////////////////////////////
 	// Forward Declarations
@@ -240,6 +242,7 @@ namespace TFE_DarkForces
 	void freeAllMidi();
 	void pauseLevelSound();
 	void resumeLevelSound();
+	void updateSimulationRate();
 
 	/////////////////////////////////////////////
 	// API
@@ -305,7 +308,8 @@ namespace TFE_DarkForces
 		sound_open(s_gameRegion);
 
 		TFE_Jedi::task_setDefaults();
-		TFE_Jedi::task_setMinStepInterval(1.0f / f32(TICKS_PER_SECOND));
+		s_simStepInterval = 0.0;
+		updateSimulationRate();
 		TFE_Jedi::setupInitCameraAndLights();
 		config_startup();
 		gameStartup();
@@ -360,6 +364,7 @@ namespace TFE_DarkForces
 		cutsceneFilm_reset();
 		lsystem_destroy();
 		bitmap_clearAll();
+		levelPreload_destroy();
 		
 		// Clear paths and archives.
 		TFE_Paths::clearSearchPaths();
@@ -563,9 +568,18 @@ namespace TFE_DarkForces
 		}  // Inner Loop
 	}  // Outer Loop
 	****************************************************/
+	void DarkForces::drawInterpolatedFrame()
+	{
+		if (TFE_Settings::getGameSettings()->df_interpolateFrames)
+		{
+			mission_drawInterpolatedFrame(TFE_Jedi::task_getStepAlpha());
+		}
+	}
+
 	void DarkForces::loopGame()
 	{
 		updateTime();
+		updateSimulationRate();
 				
 		switch (s_runGameState.state)
 		{
@@ -851,6 +865,19 @@ namespace TFE_DarkForces
 	/////////////////////////////////////////////
 	// Internal Implementation
 	/////////////////////////////////////////////
+	// TFE: Frames are drawn between simulation steps when interpolation is enabled, so the steps can run at a lower, fixed rate.
+	void updateSimulationRate()
+	{
+		const TFE_Settings_Game* gameSettings = TFE_Settings::getGameSettings();
+		const s32 stepsPerSecond = gameSettings->df_interpolateFrames ? clamp(gameSettings->df_simulationRate, 30, TICKS_PER_SECOND) : TICKS_PER_SECOND;
+		const f64 interval = 1.0 / f64(stepsPerSecond);
+		if (interval != s_simStepInterval)
+		{
+			s_simStepInterval = interval;
+			TFE_Jedi::task_setMinStepInterval(interval);
+		}
+	}
+
 	void printGameInfo()
 	{
 		TFE_System::logWrite(LOG_MSG, "Game", "Dark Forces Version: %d.%d (Build %d)", 1, 0, 1);
@@ -17,6 +17,7 @@ namespace TFE_DarkForces
 		void restartMusic() override;
 		void exitGame() override;
 		void loopGame() override;
+		void drawInterpolatedFrame() override;
 		bool serializeGameState(Stream* stream, const char* filename, bool writeState) override;
 		bool canSave() override;
 		bool isPaused() override;
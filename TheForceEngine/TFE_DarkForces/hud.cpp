@@ -588,13 +588,14 @@ namespace TFE_DarkForces
 		}
 	}
 
-	void hud_drawGpu()
+	// TFE: update is JFALSE for frames drawn between simulation steps, which must not advance the HUD animations.
+	void hud_drawGpu(JBool update)
 	{
-		if (s_rightHudMove)
+		if (update && s_rightHudMove)
 		{
 			s_rightHudMove--;
 		}
-		if (s_leftHudMove)
+		if (update && s_leftHudMove)
 		{
 			s_leftHudMove--;
 		}
@@ -837,7 +838,7 @@ namespace TFE_DarkForces
 			s_rightHudShow = 4;
 		}
 
-		if (s_rightHudShow)
+		if (update && s_rightHudShow)
 		{
 			if (s_rightHudVertAnim > s_rightHudVertTarget)
 			{
@@ -853,7 +854,7 @@ namespace TFE_DarkForces
 				s_rightHudShow--;
 			}
 		}
-		if (s_leftHudShow)
+		if (update && s_leftHudShow)
 		{
 			if (s_leftHudVertAnim > s_leftHudVertTarget)
 			{
@@ -886,7 +887,7 @@ namespace TFE_DarkForces
 		screenGPU_setIndexedColors(HUD_COLORS_COUNT, colors);
 	}
 		
-	void hud_drawAndUpdate(u8* framebuffer)
+	static void hud_drawInternal(u8* framebuffer, JBool update)
 	{
 		// Handle the case where the HUD has not been loaded.
 		if (!s_hudStatusL || !s_hudStatusR) { return; }
@@ -905,18 +906,18 @@ namespace TFE_DarkForces
 		// TFE Note: drawing the HUD when GPU rendering is enabled is a bit different, since we can just draw all of the items scaled.
 		if (TFE_Jedi::getSubRenderer() == TSR_CLASSIC_GPU)
 		{
-			hud_drawGpu();
+			hud_drawGpu(update);
 			return;
 		}
 
 		// Clear the 3D view while the HUD positions are being animated.
 		if (s_rightHudMove || s_leftHudMove)
 		{
-			if (s_rightHudMove)
+			if (update && s_rightHudMove)
 			{
 				s_rightHudMove--;
 			}
-			if (s_leftHudMove)
+			if (update && s_leftHudMove)
 			{
 				s_leftHudMove--;
 			}
@@ -1101,7 +1102,7 @@ namespace TFE_DarkForces
 				s_prevSuperchageHud = s_superChargeHud;
 			}
 
-			if (s_rightHudShow || screenRect->bot >= 160)
+			if (update && (s_rightHudShow || screenRect->bot >= 160))
 			{
 				if (s_rightHudVertAnim > s_rightHudVertTarget)
 				{
@@ -1117,7 +1118,7 @@ namespace TFE_DarkForces
 					s_rightHudShow--;
 				}
 			}
-			if (s_leftHudShow || screenRect->bot >= 160)
+			if (update && (s_leftHudShow || screenRect->bot >= 160))
 			{
 				if (s_leftHudVertAnim > s_leftHudVertTarget)
 				{
@@ -1202,6 +1203,16 @@ namespace TFE_DarkForces
 		}
 	}
 
+	void hud_drawAndUpdate(u8* framebuffer)
+	{
+		hud_drawInternal(framebuffer, JTRUE);
+	}
+
+	void hud_draw(u8* framebuffer)
+	{
+		hud_drawInternal(framebuffer, JFALSE);
+	}
+
 	///////////////////////////////////////////
 	// Internal Implementation
 	///////////////////////////////////////////
@@ -29,6 +29,8 @@ namespace TFE_DarkForces
 
 	void hud_drawMessage(u8* framebuffer);
 	void hud_drawAndUpdate(u8* framebuffer);
+	// TFE: Draws the HUD without advancing its animations, for frames rendered between simulation steps.
+	void hud_draw(u8* framebuffer);
 	void hud_drawElementToScreen(OffScreenBuffer* elem, ScreenRect* rect, s32 x0, s32 y0, u8* framebuffer);
 	void hud_drawElementToScreenScaled(OffScreenBuffer* elem, ScreenRect* rect, s32 x0, s32 y0, fixed16_16 xScale, fixed16_16 yScale, u8* framebuffer);
 
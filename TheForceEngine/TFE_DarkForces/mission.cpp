@@ -23,6 +23,7 @@
 #include <TFE_Jedi/Level/rtexture.h>
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/levelInterp.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Renderer/rlimits.h>
 #include <TFE_Jedi/Renderer/jediRenderer.h>
@@ -205,6 +206,19 @@ namespace TFE_DarkForces
 		logic_spawnEnemy(args[1].c_str(), args[2].c_str());
 	}
 
+	void console_benchCollision(const ConsoleArgList& args)
+	{
+		const s32 actorCount = args.size() > 1 ? atoi(args[1].c_str()) : 500;
+		const s32 queryCount = args.size() > 2 ? atoi(args[2].c_str()) : 1000;
+		collision_benchmark(actorCount, queryCount);
+	}
+
+	void console_benchPointInSector(const ConsoleArgList& args)
+	{
+		const s32 queryCount = args.size() > 1 ? atoi(args[1].c_str()) : 100000;
+		sector_benchmarkPointInside(queryCount);
+	}
+
 	void mission_createDisplay()
 	{
 		vfb_setResolution(320, 200);
@@ -393,6 +407,8 @@ namespace TFE_DarkForces
 			// TFE-specific
 			mission_addCheatCommands();
 			CCMD("spawnEnemy", console_spawnEnemy, 2, "spawnEnemy(waxName, enemyTypeName) - spawns an enemy 8 units away in the player direction. Example: spawnEnemy offcfin.wax i_officer");
+			CCMD("benchCollision", console_benchCollision, 0, "benchCollision [actorCount] [queryCount] - times explosion range queries with and without the broadphase using temporary actors.");
+			CCMD("benchPointInSector", console_benchPointInSector, 0, "benchPointInSector [queryCount] - times point in sector tests with and without the edge tables and compares the results.");
 
 			// Make sure the loading screen is displayed for at least 1 second.
 			if (!s_loadingFromSave)
@@ -542,6 +558,41 @@ namespace TFE_DarkForces
 			vfb_swap();
 		}
 	}
+
+	// TFE: Draws a frame between simulation steps, blending from the state of the previous step towards the current step.
+	// Nothing that advances the game (input, timers, HUD animations, vision effects) is run here.
+	void mission_drawInterpolatedFrame(f64 alpha)
+	{
+		if (!s_mainTask || s_missionMode != MISSION_MODE_MAIN || s_gamePaused || !s_playerEye || escapeMenu_isOpen() || pda_isOpen())
+		{
+			return;
+		}
+
+		s_framebuffer = vfb_getCpuBuffer();
+		TFE_Jedi::beginRender();
+
+		const JBool blended = levelInterp_begin(floatToFixed16(f32(alpha)));
+		player_setupCamera();
+		drawWorld(s_framebuffer, s_playerEye->sector, s_levelColorMap, s_lightSourceRamp);
+		if (blended)
+		{
+			levelInterp_end();
+			// Restore the camera, which the simulation also reads.
+			player_setupCamera();
+		}
+
+		weapon_draw(s_framebuffer, (DrawRect*)vfb_getScreenRect(VFB_RECT_UI));
+		if (s_drawAutomap)
+		{
+			automap_draw(s_framebuffer);
+		}
+		hud_draw(s_framebuffer);
+		hud_drawMessage(s_framebuffer);
+		handlePaletteFx();
+
+		TFE_Jedi::endRender();
+		vfb_swap();
+	}
 		
 	void mission_mainTaskFunc(MessageType msg)
 	{
@@ -582,7 +633,21 @@ namespace TFE_DarkForces
 					updateScreensize();
 					if (s_playerEye)
 					{
+						// TFE: Capture the state produced by this step, and draw the blend between the previous step and this one
+						// so frames drawn between steps continue smoothly from this one.
+						JBool blended = JFALSE;
+						if (TFE_Settings::getGameSettings()->df_interpolateFrames)
+						{
+							levelInterp_capture();
+							blended = levelInterp_begin(floatToFixed16(f32(task_getStepAlpha())));
+							if (blended) { player_setupCamera(); }
+						}
 						drawWorld(s_framebuffer, s_playerEye->sector, s_levelColorMap, s_lightSourceRamp);
+						if (blended)
+						{
+							levelInterp_end();
+							player_setupCamera();
+						}
 					}
 					weapon_draw(s_framebuffer, (DrawRect*)vfb_getScreenRect(VFB_RECT_UI));
 					handleVisionFx();
@@ -4,6 +4,7 @@
 #include "grid3d.h"
 #include "gizmo.h"
 #include <TFE_System/math.h>
+#include <TFE_System/hash.h>
 #include <TFE_Editor/editor.h>
 #include <TFE_Editor/editorMath.h>
 #include <TFE_Editor/editorConfig.h>
@@ -131,6 +132,14 @@ namespace LevelEditor
 	static std::vector<Vec2f> s_bufferVec2;
 	static std::vector<Vec3f> s_bufferVec3;
 
+	struct SectorDrawCache
+	{
+		Tri3dBatch batch;
+		u64 key = 0;
+		bool valid = false;
+	};
+	static std::vector<SectorDrawCache> s_sectorDrawCache;
+
 	SectorDrawMode s_sectorDrawMode = SDM_WIREFRAME;
 	Vec2i s_viewportSize = { 0 };
 	Vec3f s_viewportPos = { 0 };
@@ -197,6 +206,7 @@ namespace LevelEditor
 		grid3d_destroy();
 		TFE_RenderShared::line3d_destroy();
 		s_viewportRt = 0;
+		viewport_clearSectorCache();
 	}
 
 	void viewport_render(EditorView view, u32 flags)
@@ -2311,6 +2321,388 @@ namespace LevelEditor
 		return u32(colorSum.x * 255.0f) | (u32(colorSum.y * 255.0f) << 8) | (u32(colorSum.z * 255.0f) << 16) | (u32(alpha * 255.0f) << 24);
 	}
 				
+	/////////////////////////////////////////////////////
+	// Retained 3D sector geometry
+	/////////////////////////////////////////////////////
+	// The walls, floor and ceiling of each sector are captured into a batch that is
+	// only rebuilt when something it was built from changes.
+	void drawSectorGeometry3D(EditorSector* sector)
+	{
+		// Sector lighting.
+		const u32 colorIndex = (s_editFlags & LEF_FULLBRIGHT) && s_sectorDrawMode != SDM_LIGHTING ? 31 : sector->ambient;
+
+		// Walls, backfaces are culled on the GPU.
+		const s32 wallCount = (s32)sector->walls.size();
+		EditorWall* wall = sector->walls.data();
+		for (s32 w = 0; w < wallCount; w++, wall++)
+		{
+			const Vec2f& v0 = sector->vtx[wall->idx[0]];
+			const Vec2f& v1 = sector->vtx[wall->idx[1]];
+
+			s32 wallColorIndex = (s32)colorIndex;
+			if (wallColorIndex < 31)
+			{
+				wallColorIndex = std::max(0, std::min(31, wallColorIndex + wall->wallLight));
+			}
+
+			u32 wallColor = 0xff1a0f0d;
+			if (sector_isLocked(sector))
+			{
+				wallColor = (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL) ? SCOLOR_LOCKED_TEXTURE : SCOLOR_LOCKED;
+			}
+			else if (s_sectorDrawMode == SDM_GROUP_COLOR)
+			{
+				wallColor = sector_getGroupColor(sector);
+			}
+			else if (s_sectorDrawMode != SDM_WIREFRAME)
+			{
+				wallColor = c_sectorTexClr[wallColorIndex];
+			}
+											
+			// Wall Parts
+			const Vec2f wallOffset = { v1.x - v0.x, v1.z - v0.z };
+			const f32 wallLengthTexels = sqrtf(wallOffset.x*wallOffset.x + wallOffset.z*wallOffset.z) * 8.0f;
+			const f32 sectorHeight = sector->ceilHeight - sector->floorHeight;
+			const bool flipHorz = (wall->flags[0] & WF1_FLIP_HORIZ) != 0u;
+			Vec2f uvCorners[2];
+
+			if (wall->adjoinId < 0)
+			{
+				Vec3f corners[] = { {v0.x, sector->ceilHeight,  v0.z},
+									{v1.x, sector->floorHeight, v1.z} };
+
+				if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
+				{
+					const EditorTexture* tex = calculateTextureCoords(wall, &wall->tex[WP_MID], wallLengthTexels, sectorHeight, flipHorz, uvCorners);
+					TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_OPAQUE, corners, uvCorners, wallColor, tex ? tex->frames[0] : nullptr);
+				}
+				else
+				{
+					TFE_RenderShared::triDraw3d_addQuadColored(TRIMODE_OPAQUE, corners, wallColor);
+				}
+
+				// Sign?
+				if (wall->tex[WP_SIGN].texIndex >= 0 && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
+				{
+					const EditorTexture* tex = calculateSignTextureCoords(wall, &wall->tex[WP_MID], &wall->tex[WP_SIGN], wallLengthTexels, sectorHeight, false, uvCorners);
+					if (tex)
+					{
+						TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_CLAMP, corners, uvCorners, wallColor, tex->frames[0]);
+					}
+				}
+			}
+			else
+			{
+				EditorSector* next = &s_level.sectors[wall->adjoinId];
+				bool botSign = false;
+				// Bottom
+				if (next->floorHeight > sector->floorHeight)
+				{
+					bool sky = (sector->flags[0] & SEC_FLAGS1_PIT) != 0 &&
+						       (next->flags[0] & SEC_FLAGS1_EXT_FLOOR_ADJ) != 0;
+
+					const f32 botHeight = next->floorHeight - sector->floorHeight;
+					Vec3f corners[] = { {v0.x, next->floorHeight,   v0.z},
+										{v1.x, sector->floorHeight, v1.z} };
+					if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
+					{
+						LevelTexture* texPtr = sky ? &sector->floorTex : &wall->tex[WP_BOT];
+						if (texPtr->texIndex < 0)
+						{
+							texPtr->texIndex = getTextureIndex("DEFAULT.BM");
+						}
+						const EditorTexture* tex = calculateTextureCoords(wall, texPtr, wallLengthTexels, botHeight, flipHorz, uvCorners);
+						TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_OPAQUE, corners, uvCorners, wallColor, tex->frames[0], sky);
+					}
+					else
+					{
+						TFE_RenderShared::triDraw3d_addQuadColored(TRIMODE_OPAQUE, corners, wallColor);
+					}
+
+					// Sign?
+					if (wall->tex[WP_SIGN].texIndex >= 0 && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
+					{
+						const EditorTexture* tex = calculateSignTextureCoords(wall, &wall->tex[WP_BOT], &wall->tex[WP_SIGN], wallLengthTexels, botHeight, false, uvCorners);
+						TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_CLAMP, corners, uvCorners, wallColor, tex->frames[0]);
+						botSign = true;
+					}
+				}
+				// Top
+				if (next->ceilHeight < sector->ceilHeight)
+				{
+					bool sky = (sector->flags[0] & SEC_FLAGS1_EXTERIOR) != 0 &&
+						       (next->flags[0] & SEC_FLAGS1_EXT_ADJ) != 0;
+
+					const f32 topHeight = sector->ceilHeight - next->ceilHeight;
+					Vec3f corners[] = { {v0.x, sector->ceilHeight, v0.z},
+									    {v1.x, next->ceilHeight,   v1.z} };
+
+					if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
+					{
+						const LevelTexture* texPtr = sky ? &sector->ceilTex : &wall->tex[WP_TOP];
+						const EditorTexture* tex = calculateTextureCoords(wall, texPtr, wallLengthTexels, topHeight, flipHorz, uvCorners);
+						TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_OPAQUE, corners, uvCorners, wallColor, tex ? tex->frames[0] : nullptr, sky);
+					}
+					else
+					{
+						TFE_RenderShared::triDraw3d_addQuadColored(TRIMODE_OPAQUE, corners, wallColor);
+					}
+
+					// Sign?
+					if (!botSign && wall->tex[WP_SIGN].texIndex >= 0 && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
+					{
+						const EditorTexture* tex = calculateSignTextureCoords(wall, &wall->tex[WP_TOP], &wall->tex[WP_SIGN], wallLengthTexels, topHeight, false, uvCorners);
+						if (tex) { TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_CLAMP, corners, uvCorners, wallColor, tex->frames[0]); }
+					}
+				}
+				// Mid only for mask textures.
+				if (next && (wall->flags[0] & WF1_ADJ_MID_TEX) && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
+				{
+					Vec3f corners[] = { {v0.x, min(next->ceilHeight, sector->ceilHeight), v0.z},
+										{v1.x, max(next->floorHeight, sector->floorHeight), v1.z} };
+
+					const EditorTexture* tex = calculateTextureCoords(wall, &wall->tex[WP_MID], wallLengthTexels, fabsf(corners[1].y - corners[0].y), flipHorz, uvCorners);
+					if (tex) { TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_BLEND, corners, uvCorners, wallColor, tex->frames[0]); }
+				}
+			}
+		}
+
+		// Draw the floor and ceiling.
+		u32 floorColor = 0xff402020;
+		if (sector_isLocked(sector))
+		{
+			floorColor = (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL) ? SCOLOR_LOCKED_TEXTURE : SCOLOR_LOCKED;
+		}
+		else if (s_sectorDrawMode == SDM_GROUP_COLOR)
+		{
+			floorColor = sector_getGroupColor(sector);
+		}
+		else if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL || s_sectorDrawMode == SDM_LIGHTING)
+		{
+			floorColor = c_sectorTexClr[colorIndex];
+		}
+
+		const u32 idxCount = (u32)sector->poly.triIdx.size();
+		const u32 vtxCount = (u32)sector->poly.triVtx.size();
+		const Vec2f* triVtx = sector->poly.triVtx.data();
+
+		s_bufferVec3.resize(vtxCount * 2);
+		Vec3f* vtxDataFlr = s_bufferVec3.data();
+		Vec3f* vtxDataCeil = vtxDataFlr + vtxCount;
+
+		s_bufferVec2.resize(vtxCount * 2);
+		Vec2f* uvFlr = s_bufferVec2.data();
+		Vec2f* uvCeil = uvFlr + vtxCount;
+
+		EditorTexture* floorTex = getTexture(sector->floorTex.texIndex);
+		EditorTexture* ceilTex  = getTexture(sector->ceilTex.texIndex);
+		const Vec2f& floorOffset = sector->floorTex.offset;
+		const Vec2f& ceilOffset = sector->ceilTex.offset;
+
+		for (u32 v = 0; v < vtxCount; v++)
+		{
+			vtxDataFlr[v] = { triVtx[v].x, sector->floorHeight, triVtx[v].z };
+			vtxDataCeil[v] = { triVtx[v].x, sector->ceilHeight,  triVtx[v].z };
+		}
+					
+		if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
+		{
+			for (u32 v = 0; v < vtxCount; v++)
+			{
+				computeFlatUv(&triVtx[v], &floorOffset, &uvFlr[v]);
+				computeFlatUv(&triVtx[v], &ceilOffset, &uvCeil[v]);
+			}
+		}
+
+		// Both flats are added, the GPU culls the side facing away from the camera.
+		bool showGridOnFlats = !(s_gridFlags & GFLAG_OVER);
+		if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
+		{
+			bool sky = (sector->flags[0] & SEC_FLAGS1_PIT) != 0;
+			triDraw3d_addTextured(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataFlr, uvFlr, sector->poly.triIdx.data(), floorColor, false, floorTex ? floorTex->frames[0] : nullptr, showGridOnFlats, sky);
+		}
+		else
+		{
+			triDraw3d_addColored(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataFlr, sector->poly.triIdx.data(), floorColor, false, showGridOnFlats);
+		}
+
+		if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
+		{
+			bool sky = (sector->flags[0] & SEC_FLAGS1_EXTERIOR) != 0;
+			triDraw3d_addTextured(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataCeil, uvCeil, sector->poly.triIdx.data(), floorColor, true, ceilTex ? ceilTex->frames[0]: nullptr, showGridOnFlats, sky);
+		}
+		else
+		{
+			triDraw3d_addColored(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataCeil, sector->poly.triIdx.data(), floorColor, true, showGridOnFlats);
+		}
+	}
+
+	// Key of everything drawSectorGeometry3D() reads: the draw settings, the sector and the heights of the adjoined sectors.
+	// Edits are detected by comparing keys, which is much cheaper than building the geometry.
+	// The hashed data is made only of 32-bit fields, so it is hashed a word at a time.
+	u64 computeSectorDrawKey(EditorSector* sector)
+	{
+		const u32 state[] =
+		{
+			(u32)s_sectorDrawMode, s_editFlags & LEF_FULLBRIGHT, s_gridFlags & GFLAG_OVER, sector_isLocked(sector) ? 1u : 0u, sector_getGroupColor(sector),
+			(u32)sector->vtx.size(), (u32)sector->walls.size(), (u32)sector->poly.triVtx.size(), (u32)sector->poly.triIdx.size()
+		};
+		u64 key = TFE_Hash::hash64Words(TFE_Hash::c_fnv64Offset, state, sizeof(state));
+		key = TFE_Hash::hash64Words(key, &s_grid.origin, sizeof(Vec2f));
+		key = TFE_Hash::hash64Words(key, s_grid.axis, sizeof(Vec2f) * 2);
+
+		key = TFE_Hash::hash64Words(key, &sector->floorTex, sizeof(LevelTexture));
+		key = TFE_Hash::hash64Words(key, &sector->ceilTex, sizeof(LevelTexture));
+		key = TFE_Hash::hash64Words(key, &sector->floorHeight, sizeof(f32));
+		key = TFE_Hash::hash64Words(key, &sector->ceilHeight, sizeof(f32));
+		key = TFE_Hash::hash64Words(key, &sector->ambient, sizeof(u32));
+		key = TFE_Hash::hash64Words(key, sector->flags, sizeof(u32) * 3);
+		key = TFE_Hash::hash64Words(key, sector->vtx.data(), sizeof(Vec2f) * sector->vtx.size());
+		key = TFE_Hash::hash64Words(key, sector->walls.data(), sizeof(EditorWall) * sector->walls.size());
+		key = TFE_Hash::hash64Words(key, sector->poly.triVtx.data(), sizeof(Vec2f) * sector->poly.triVtx.size());
+		key = TFE_Hash::hash64Words(key, sector->poly.triIdx.data(), sizeof(s32) * sector->poly.triIdx.size());
+
+		const s32 count = (s32)s_level.sectors.size();
+		const s32 wallCount = (s32)sector->walls.size();
+		const EditorWall* wall = sector->walls.data();
+		for (s32 w = 0; w < wallCount; w++, wall++)
+		{
+			if (wall->adjoinId < 0 || wall->adjoinId >= count) { continue; }
+			const EditorSector* next = &s_level.sectors[wall->adjoinId];
+			key = TFE_Hash::hash64Words(key, &next->floorHeight, sizeof(f32));
+			key = TFE_Hash::hash64Words(key, &next->ceilHeight, sizeof(f32));
+			key = TFE_Hash::hash64Words(key, &next->flags[0], sizeof(u32));
+		}
+		return key;
+	}
+
+	void buildSectorDrawCache(EditorSector* sector, SectorDrawCache* cache)
+	{
+		TFE_RenderShared::triDraw3d_beginCapture();
+		drawSectorGeometry3D(sector);
+		// An incomplete batch is rebuilt the next time it is drawn.
+		cache->valid = TFE_RenderShared::triDraw3d_endCapture(&cache->batch);
+		// Computed after building, since building may assign default textures.
+		cache->key = computeSectorDrawKey(sector);
+	}
+
+	void viewport_clearSectorCache()
+	{
+		s_sectorDrawCache.clear();
+	}
+
+	SectorGeometryTiming viewport_benchmarkSectorGeometry(s32 iterations)
+	{
+		SectorGeometryTiming timing = {};
+		iterations = std::max(iterations, 1);
+
+		const s32 count = (s32)s_level.sectors.size();
+		s_sectorDrawCache.resize(count);
+		TFE_RenderShared::triDraw3d_begin(&s_grid);
+		timing.sectorCount = count;
+
+		// Build every sector, the per-frame cost before the geometry was retained.
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			for (s32 s = 0; s < count; s++)
+			{
+				buildSectorDrawCache(&s_level.sectors[s], &s_sectorDrawCache[s]);
+			}
+		}
+		timing.buildMs = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - start) / f64(iterations);
+
+		// Check every sector for changes, the per-frame cost when nothing changed.
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			for (s32 s = 0; s < count; s++)
+			{
+				if (computeSectorDrawKey(&s_level.sectors[s]) != s_sectorDrawCache[s].key)
+				{
+					timing.changedCount++;
+				}
+			}
+		}
+		timing.validateMs = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - start) / f64(iterations);
+
+		// Copy every batch into the draw list, which needs the 3D viewport buffers.
+		start = TFE_System::getCurrentTimeInTicks();
+		for (s32 i = 0; i < iterations; i++)
+		{
+			TFE_RenderShared::triDraw3d_begin(&s_grid);
+			for (s32 s = 0; s < count; s++)
+			{
+				TFE_RenderShared::triDraw3d_addBatch(&s_sectorDrawCache[s].batch);
+			}
+		}
+		timing.addMs = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - start) / f64(iterations);
+		TFE_RenderShared::triDraw3d_begin(&s_grid);
+
+		for (s32 s = 0; s < count; s++)
+		{
+			timing.triangleCount += (s32)s_sectorDrawCache[s].batch.indices.size() / 3;
+		}
+		return timing;
+	}
+
+	// Planes bounding the 3D view, with positive distances outside.
+	// Returns the plane count, which is 0 if the viewport has no size yet.
+	s32 computeViewFrustum3d(Vec4f* planes)
+	{
+		if (s_viewportSize.x <= 0 || s_viewportSize.z <= 0) { return 0; }
+
+		const Vec3f dir[] =
+		{
+			edit_viewportCoordToWorldDir3d({ 0, 0 }),
+			edit_viewportCoordToWorldDir3d({ s_viewportSize.x, 0 }),
+			edit_viewportCoordToWorldDir3d({ s_viewportSize.x, s_viewportSize.z }),
+			edit_viewportCoordToWorldDir3d({ 0, s_viewportSize.z }),
+		};
+		const Vec3f center = edit_viewportCoordToWorldDir3d({ s_viewportSize.x / 2, s_viewportSize.z / 2 });
+
+		// Behind the camera.
+		planes[0] = { -center.x, -center.y, -center.z, TFE_Math::dot(&center, &s_camera.pos) };
+		// Sides, oriented so the view center is inside.
+		for (s32 i = 0; i < 4; i++)
+		{
+			Vec3f nrm = TFE_Math::cross(&dir[i], &dir[(i + 1) & 3]);
+			nrm = TFE_Math::normalize(&nrm);
+			if (TFE_Math::dot(&nrm, &center) > 0.0f)
+			{
+				nrm = { -nrm.x, -nrm.y, -nrm.z };
+			}
+			planes[i + 1] = { nrm.x, nrm.y, nrm.z, -TFE_Math::dot(&nrm, &s_camera.pos) };
+		}
+		return 5;
+	}
+
+	bool sectorInFrustum3d(const EditorSector* sector, s32 planeCount, const Vec4f* planes)
+	{
+		// The walls never extend past the sector floor and ceiling, but lines are offset by a small bias.
+		const f32 bias = 1.0f / 256.0f;
+		const Vec3f bounds[] =
+		{
+			{ sector->bounds[0].x - bias, std::min(sector->floorHeight, sector->ceilHeight) - bias, sector->bounds[0].z - bias },
+			{ sector->bounds[1].x + bias, std::max(sector->floorHeight, sector->ceilHeight) + bias, sector->bounds[1].z + bias }
+		};
+		for (s32 p = 0; p < planeCount; p++)
+		{
+			// Outside if the corner closest to the inside is outside.
+			const Vec3f corner =
+			{
+				planes[p].x > 0.0f ? bounds[0].x : bounds[1].x,
+				planes[p].y > 0.0f ? bounds[0].y : bounds[1].y,
+				planes[p].z > 0.0f ? bounds[0].z : bounds[1].z,
+			};
+			if (planes[p].x*corner.x + planes[p].y*corner.y + planes[p].z*corner.z + planes[p].w > 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
 	void renderLevel3D()
 	{
 		viewport_updateRail();
@@ -2352,8 +2744,13 @@ namespace LevelEditor
 			selection_getSurface(0, curSector, curFeatureIndex, &curPart);
 		}
 
+		// Sectors outside of the view are skipped.
+		Vec4f frustum[5];
+		const s32 frustumPlaneCount = computeViewFrustum3d(frustum);
+
 		const f32 width = 2.5f;
 		const size_t count = s_level.sectors.size();
+		s_sectorDrawCache.resize(count);
 		EditorSector* sector = s_level.sectors.data();
 		for (size_t s = 0; s < count; s++, sector++)
 		{
@@ -2372,252 +2769,32 @@ namespace LevelEditor
 				visObj[visObjCount++] = obj;
 			}
 
+			if (!sectorInFrustum3d(sector, frustumPlaneCount, frustum)) { continue; }
 			Highlight highlight = sector_isLocked(sector) ? HL_LOCKED : HL_NONE;
 
-			// Sector lighting.
-			const u32 colorIndex = (s_editFlags & LEF_FULLBRIGHT) && s_sectorDrawMode != SDM_LIGHTING ? 31 : sector->ambient;
-
-			// Floor/ceiling line bias.
-			f32 bias = 1.0f / 1024.0f;
-			f32 floorBias = (s_camera.pos.y >= sector->floorHeight) ?  bias : -bias;
-			f32 ceilBias  = (s_camera.pos.y <= sector->ceilHeight)  ? -bias :  bias;
-
 			// Draw lines.
 			const s32 wallCount = (s32)sector->walls.size();
-			const Vec2f* vtx = sector->vtx.data();
 			EditorWall* wall = sector->walls.data();
 			for (s32 w = 0; w < wallCount; w++, wall++)
 			{
 				// Skip hovered or selected walls.
-				bool skipLines = false;
 				if (s_editMode == LEDIT_WALL && ((hoveredSector == sector && hoveredFeatureIndex == w) ||
 					selection_action(SA_CHECK_INCLUSION, sector, w)))
 				{
-					skipLines = true;
+					continue;
 				}
 
 				EditorSector* next = (wall->adjoinId < 0 || wall->adjoinId >= (s32)count) ? nullptr : &s_level.sectors[wall->adjoinId];
-				const Vec2f& v0 = sector->vtx[wall->idx[0]];
-				const Vec2f& v1 = sector->vtx[wall->idx[1]];
-
-				if (!skipLines)
-				{
-					drawWallLines3D(sector, next, wall, width, highlight, true);
-				}
-
-				s32 wallColorIndex = (s32)colorIndex;
-				if (wallColorIndex < 31)
-				{
-					wallColorIndex = std::max(0, std::min(31, wallColorIndex + wall->wallLight));
-				}
-
-				u32 wallColor = 0xff1a0f0d;
-				if (sector_isLocked(sector))
-				{
-					wallColor = (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL) ? SCOLOR_LOCKED_TEXTURE : SCOLOR_LOCKED;
-				}
-				else if (s_sectorDrawMode == SDM_GROUP_COLOR)
-				{
-					wallColor = sector_getGroupColor(sector);
-				}
-				else if (s_sectorDrawMode != SDM_WIREFRAME)
-				{
-					wallColor = c_sectorTexClr[wallColorIndex];
-				}
-												
-				// Wall Parts
-				const Vec2f wallOffset = { v1.x - v0.x, v1.z - v0.z };
-				const f32 wallLengthTexels = sqrtf(wallOffset.x*wallOffset.x + wallOffset.z*wallOffset.z) * 8.0f;
-				const f32 sectorHeight = sector->ceilHeight - sector->floorHeight;
-				const bool flipHorz = (wall->flags[0] & WF1_FLIP_HORIZ) != 0u;
-				Vec2f uvCorners[2];
-
-				// Skip backfacing walls.
-				const Vec2f cameraOffset = { v0.x - s_camera.pos.x, v0.z - s_camera.pos.z };
-				const f32 facing = -wallOffset.z * cameraOffset.x + wallOffset.x * cameraOffset.z;
-				if (facing < 0.0f) { continue; }
-
-				if (wall->adjoinId < 0)
-				{
-					Vec3f corners[] = { {v0.x, sector->ceilHeight,  v0.z},
-										{v1.x, sector->floorHeight, v1.z} };
-
-					if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
-					{
-						const EditorTexture* tex = calculateTextureCoords(wall, &wall->tex[WP_MID], wallLengthTexels, sectorHeight, flipHorz, uvCorners);
-						TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_OPAQUE, corners, uvCorners, wallColor, tex ? tex->frames[0] : nullptr);
-					}
-					else
-					{
-						TFE_RenderShared::triDraw3d_addQuadColored(TRIMODE_OPAQUE, corners, wallColor);
-					}
-
-					// Sign?
-					if (wall->tex[WP_SIGN].texIndex >= 0 && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
-					{
-						const EditorTexture* tex = calculateSignTextureCoords(wall, &wall->tex[WP_MID], &wall->tex[WP_SIGN], wallLengthTexels, sectorHeight, false, uvCorners);
-						if (tex)
-						{
-							TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_CLAMP, corners, uvCorners, wallColor, tex->frames[0]);
-						}
-					}
-				}
-				else
-				{
-					EditorSector* next = &s_level.sectors[wall->adjoinId];
-					bool botSign = false;
-					// Bottom
-					if (next->floorHeight > sector->floorHeight)
-					{
-						bool sky = (sector->flags[0] & SEC_FLAGS1_PIT) != 0 &&
-							       (next->flags[0] & SEC_FLAGS1_EXT_FLOOR_ADJ) != 0;
-
-						const f32 botHeight = next->floorHeight - sector->floorHeight;
-						Vec3f corners[] = { {v0.x, next->floorHeight,   v0.z},
-											{v1.x, sector->floorHeight, v1.z} };
-						if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
-						{
-							LevelTexture* texPtr = sky ? &sector->floorTex : &wall->tex[WP_BOT];
-							if (texPtr->texIndex < 0)
-							{
-								texPtr->texIndex = getTextureIndex("DEFAULT.BM");
-							}
-							const EditorTexture* tex = calculateTextureCoords(wall, texPtr, wallLengthTexels, botHeight, flipHorz, uvCorners);
-							TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_OPAQUE, corners, uvCorners, wallColor, tex->frames[0], sky);
-						}
-						else
-						{
-							TFE_RenderShared::triDraw3d_addQuadColored(TRIMODE_OPAQUE, corners, wallColor);
-						}
-
-						// Sign?
-						if (wall->tex[WP_SIGN].texIndex >= 0 && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
-						{
-							const EditorTexture* tex = calculateSignTextureCoords(wall, &wall->tex[WP_BOT], &wall->tex[WP_SIGN], wallLengthTexels, botHeight, false, uvCorners);
-							TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_CLAMP, corners, uvCorners, wallColor, tex->frames[0]);
-							botSign = true;
-						}
-					}
-					// Top
-					if (next->ceilHeight < sector->ceilHeight)
-					{
-						bool sky = (sector->flags[0] & SEC_FLAGS1_EXTERIOR) != 0 &&
-							       (next->flags[0] & SEC_FLAGS1_EXT_ADJ) != 0;
-
-						const f32 topHeight = sector->ceilHeight - next->ceilHeight;
-						Vec3f corners[] = { {v0.x, sector->ceilHeight, v0.z},
-										    {v1.x, next->ceilHeight,   v1.z} };
-
-						if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
-						{
-							const LevelTexture* texPtr = sky ? &sector->ceilTex : &wall->tex[WP_TOP];
-							const EditorTexture* tex = calculateTextureCoords(wall, texPtr, wallLengthTexels, topHeight, flipHorz, uvCorners);
-							TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_OPAQUE, corners, uvCorners, wallColor, tex ? tex->frames[0] : nullptr, sky);
-						}
-						else
-						{
-							TFE_RenderShared::triDraw3d_addQuadColored(TRIMODE_OPAQUE, corners, wallColor);
-						}
-
-						// Sign?
-						if (!botSign && wall->tex[WP_SIGN].texIndex >= 0 && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
-						{
-							const EditorTexture* tex = calculateSignTextureCoords(wall, &wall->tex[WP_TOP], &wall->tex[WP_SIGN], wallLengthTexels, topHeight, false, uvCorners);
-							if (tex) { TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_CLAMP, corners, uvCorners, wallColor, tex->frames[0]); }
-						}
-					}
-					// Mid only for mask textures.
-					if (next && (wall->flags[0] & WF1_ADJ_MID_TEX) && (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL))
-					{
-						Vec3f corners[] = { {v0.x, min(next->ceilHeight, sector->ceilHeight), v0.z},
-											{v1.x, max(next->floorHeight, sector->floorHeight), v1.z} };
-
-						const EditorTexture* tex = calculateTextureCoords(wall, &wall->tex[WP_MID], wallLengthTexels, fabsf(corners[1].y - corners[0].y), flipHorz, uvCorners);
-						if (tex) { TFE_RenderShared::triDraw3d_addQuadTextured(TRIMODE_BLEND, corners, uvCorners, wallColor, tex->frames[0]); }
-					}
-				}
+				drawWallLines3D(sector, next, wall, width, highlight, true);
 			}
 
-			// Draw the floor and ceiling.
-			u32 floorColor = 0xff402020;
-			if (sector_isLocked(sector))
+			// Walls and flats, rebuilt only when the sector changes.
+			SectorDrawCache* cache = &s_sectorDrawCache[s];
+			if (!cache->valid || cache->key != computeSectorDrawKey(sector))
 			{
-				floorColor = (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL) ? SCOLOR_LOCKED_TEXTURE : SCOLOR_LOCKED;
-			}
-			else if (s_sectorDrawMode == SDM_GROUP_COLOR)
-			{
-				floorColor = sector_getGroupColor(sector);
-			}
-			else if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL || s_sectorDrawMode == SDM_LIGHTING)
-			{
-				floorColor = c_sectorTexClr[colorIndex];
-			}
-
-			const u32 idxCount = (u32)sector->poly.triIdx.size();
-			const u32 vtxCount = (u32)sector->poly.triVtx.size();
-			const Vec2f* triVtx = sector->poly.triVtx.data();
-
-			s_bufferVec3.resize(vtxCount * 2);
-			Vec3f* vtxDataFlr = s_bufferVec3.data();
-			Vec3f* vtxDataCeil = vtxDataFlr + vtxCount;
-
-			s_bufferVec2.resize(vtxCount * 2);
-			Vec2f* uvFlr = s_bufferVec2.data();
-			Vec2f* uvCeil = uvFlr + vtxCount;
-
-			EditorTexture* floorTex = getTexture(sector->floorTex.texIndex);
-			EditorTexture* ceilTex  = getTexture(sector->ceilTex.texIndex);
-			const Vec2f& floorOffset = sector->floorTex.offset;
-			const Vec2f& ceilOffset = sector->ceilTex.offset;
-
-			for (u32 v = 0; v < vtxCount; v++)
-			{
-				vtxDataFlr[v] = { triVtx[v].x, sector->floorHeight, triVtx[v].z };
-				vtxDataCeil[v] = { triVtx[v].x, sector->ceilHeight,  triVtx[v].z };
-			}
-						
-			if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
-			{
-				for (u32 v = 0; v < vtxCount; v++)
-				{
-					computeFlatUv(&triVtx[v], &floorOffset, &uvFlr[v]);
-					computeFlatUv(&triVtx[v], &ceilOffset, &uvCeil[v]);
-				}
-			}
-
-			bool showGridOnFlats = !(s_gridFlags & GFLAG_OVER);
-			if (s_camera.pos.y > sector->floorHeight)
-			{
-				if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
-				{
-					bool sky = (sector->flags[0] & SEC_FLAGS1_PIT) != 0;
-					triDraw3d_addTextured(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataFlr, uvFlr, sector->poly.triIdx.data(), floorColor, false, floorTex ? floorTex->frames[0] : nullptr, showGridOnFlats, sky);
-				}
-				else if (s_sectorDrawMode == SDM_LIGHTING)
-				{
-					triDraw3d_addColored(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataFlr, sector->poly.triIdx.data(), floorColor, false, showGridOnFlats);
-				}
-				else
-				{
-					triDraw3d_addColored(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataFlr, sector->poly.triIdx.data(), floorColor, false, showGridOnFlats);
-				}
-			}
-			if (s_camera.pos.y < sector->ceilHeight)
-			{
-				if (s_sectorDrawMode == SDM_TEXTURED_FLOOR || s_sectorDrawMode == SDM_TEXTURED_CEIL)
-				{
-					bool sky = (sector->flags[0] & SEC_FLAGS1_EXTERIOR) != 0;
-					triDraw3d_addTextured(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataCeil, uvCeil, sector->poly.triIdx.data(), floorColor, true, ceilTex ? ceilTex->frames[0]: nullptr, showGridOnFlats, sky);
-				}
-				else if (s_sectorDrawMode == SDM_LIGHTING)
-				{
-					triDraw3d_addColored(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataCeil, sector->poly.triIdx.data(), floorColor, true, showGridOnFlats);
-				}
-				else
-				{
-					triDraw3d_addColored(TRIMODE_OPAQUE, idxCount, vtxCount, vtxDataCeil, sector->poly.triIdx.data(), floorColor, true, showGridOnFlats);
-				}
+				buildSectorDrawCache(sector, cache);
 			}
+			TFE_RenderShared::triDraw3d_addBatch(&cache->batch);
 		}
 
 		// Draw objects.
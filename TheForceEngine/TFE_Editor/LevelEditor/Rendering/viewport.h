@@ -40,6 +40,22 @@ namespace LevelEditor
 	void viewport_clearRail();
 	void viewport_setRail(const Vec3f* rail, s32 dirCount = 1, Vec3f* moveDir = nullptr);
 
+	struct SectorGeometryTiming
+	{
+		s32 sectorCount;
+		s32 triangleCount;
+		s32 changedCount;	// sectors whose key changed after building, should be 0.
+		f64 buildMs;		// build every sector.
+		f64 validateMs;		// check every sector for changes.
+		f64 addMs;			// add every cached sector to the draw list.
+	};
+
+	// Free the cached 3D sector geometry, called when a level is loaded.
+	void viewport_clearSectorCache();
+	// Time the CPU side of the 3D sector geometry over every sector of the level, averaged over the iterations.
+	// Nothing is drawn, only the add step needs the 3D viewport buffers.
+	SectorGeometryTiming viewport_benchmarkSectorGeometry(s32 iterations);
+
 	// Compute the bounding planes for an object based on the viewport and object transform.
 	void viewport_computeEntityBoundingPlanes(const EditorSector* sector, const EditorObject* obj, Vec4f* boundingPlanes);
 
@@ -705,6 +705,7 @@ namespace LevelEditor
 			// Get the ID and then erase it from the level.
 			s32 delId = sector->id;
 			s_level.sectors.erase(s_level.sectors.begin() + delId);
+			sectorTree_invalidate(&s_level.sectorTree);
 
 			// Update Sector IDs
 			const s32 levSectorCount = (s32)s_level.sectors.size();
@@ -530,6 +530,7 @@ namespace LevelEditor
 
 		// Then erase the sector.
 		s_level.sectors.erase(s_level.sectors.begin() + sectorId);
+		sectorTree_invalidate(&s_level.sectorTree);
 
 		// Finally fix-up any references.
 		sectorCount = (s32)s_level.sectors.size();
@@ -1774,6 +1775,16 @@ namespace LevelEditor
 			{
 				edit_cleanSectors(false);
 			}
+			if (ImGui::MenuItem("Benchmark 3D Geometry", NULL, (bool*)NULL))
+			{
+				const SectorGeometryTiming timing = viewport_benchmarkSectorGeometry(16);
+				LE_INFO("3D geometry: %d sectors, %d triangles. Build: %0.3fms, Validate: %0.3fms, Add: %0.3fms.",
+					timing.sectorCount, timing.triangleCount, timing.buildMs, timing.validateMs, timing.addMs);
+				if (timing.changedCount)
+				{
+					LE_WARNING("3D geometry: %d sector keys changed without an edit.", timing.changedCount);
+				}
+			}
 			ImGui::Separator();
 			if (ImGui::MenuItem("Find Sector", getShortcutKeyComboText(SHORTCUT_FIND_SECTOR), (bool*)NULL))
 			{
@@ -25,6 +25,7 @@
 #include <TFE_Editor/EditorAsset/editorSprite.h>
 #include <TFE_Editor/AssetBrowser/assetBrowser.h>
 #include <TFE_Editor/LevelEditor/Rendering/grid.h>
+#include <TFE_Editor/LevelEditor/Rendering/viewport.h>
 #include <TFE_Archive/zipArchive.h>
 #include <TFE_Jedi/Level/rwall.h>
 #include <TFE_Jedi/Level/rsector.h>
@@ -99,6 +100,8 @@ namespace LevelEditor
 	static EditorLevel s_curSnapshot;
 
 	EditorLevel s_level = {};
+	// Candidate sectors from the last sector tree query, valid until the next query.
+	static std::vector<s32> s_sectorCandidates;
 
 	extern AssetList s_levelTextureList;
 
@@ -536,6 +539,9 @@ namespace LevelEditor
 		selection_clearHovered();
 		s_featureTex = {};
 
+		// Clear the cached 3D geometry, which references the textures of the previous level.
+		viewport_clearSectorCache();
+
 		// Clear notes.
 		s_level.notes.clear();
 		levelSetClean();
@@ -672,6 +678,7 @@ namespace LevelEditor
 			return false;
 		}
 		level->sectors.resize(sectorCount);
+		sectorTree_invalidate(&level->sectorTree);
 
 		u32 mainId = groups_getMainId();
 		EditorSector* sector = level->sectors.data();
@@ -973,6 +980,7 @@ namespace LevelEditor
 		u32 sectorCount;
 		file.read(&sectorCount);
 		s_level.sectors.resize(sectorCount);
+		sectorTree_invalidate(&s_level.sectorTree);
 		EditorSector* sector = s_level.sectors.data();
 		for (u32 i = 0; i < sectorCount; i++, sector++)
 		{
@@ -3629,6 +3637,9 @@ namespace LevelEditor
 		sector->bounds[1] = { poly.bounds[1].x, 0.0f, poly.bounds[1].z };
 		sector->bounds[0].y = min(sector->floorHeight, sector->ceilHeight);
 		sector->bounds[1].y = max(sector->floorHeight, sector->ceilHeight);
+
+		// Refit the sector in the spatial queries.
+		sectorTree_update(&s_level.sectorTree, s_level.sectors.data(), (s32)s_level.sectors.size(), sector);
 	}
 
 	// Update the sector itself from the sector's polygon.
@@ -3637,6 +3648,28 @@ namespace LevelEditor
 		// TODO
 	}
 
+	// Get the sectors whose XZ bounds may contain the point, in level order.
+	static const std::vector<s32>& getCandidateSectorsPt(Vec2f pos, f32 padding = 0.0f)
+	{
+		sectorTree_queryPoint(&s_level.sectorTree, s_level.sectors.data(), (s32)s_level.sectors.size(), pos, padding, &s_sectorCandidates);
+		return s_sectorCandidates;
+	}
+
+	// Get the sectors whose XZ bounds may overlap the bounds, in level order.
+	static const std::vector<s32>& getCandidateSectorsBounds(const Vec3f* bounds, f32 padding)
+	{
+		const Vec2f bounds2d[] = { { bounds[0].x - padding, bounds[0].z - padding }, { bounds[1].x + padding, bounds[1].z + padding } };
+		sectorTree_queryBounds(&s_level.sectorTree, s_level.sectors.data(), (s32)s_level.sectors.size(), bounds2d, &s_sectorCandidates);
+		return s_sectorCandidates;
+	}
+
+	// Get the sectors whose XZ bounds may be crossed by the segment, in level order.
+	static const std::vector<s32>& getCandidateSectorsSegment(Vec2f p0, Vec2f p1)
+	{
+		sectorTree_querySegment(&s_level.sectorTree, s_level.sectors.data(), (s32)s_level.sectors.size(), p0, p1, &s_sectorCandidates);
+		return s_sectorCandidates;
+	}
+
 	s32 findSectorByName(const char* name, s32 excludeId)
 	{
 		if (s_level.sectors.empty() || !name || name[0] == 0) { return -1; }
@@ -3657,11 +3690,13 @@ namespace LevelEditor
 	{
 		if (s_level.sectors.empty()) { return nullptr; }
 
-		const s32 sectorCount = (s32)s_level.sectors.size();
+		const std::vector<s32>& candidates = getCandidateSectorsPt(pos);
+		const s32 candidateCount = (s32)candidates.size();
 		EditorSector* sectors = s_level.sectors.data();
 
-		for (s32 i = 0; i < sectorCount; i++)
+		for (s32 c = 0; c < candidateCount; c++)
 		{
+			const s32 i = candidates[c];
 			if (!sector_isInteractable(&sectors[i]) || !sector_onActiveLayer(&sectors[i])) { continue; }
 			if (TFE_Polygon::pointInsidePolygon(&sectors[i].poly, pos))
 			{
@@ -3675,8 +3710,8 @@ namespace LevelEditor
 	{
 		if (s_level.sectors.empty()) { return nullptr; }
 
-		const s32 sectorCount = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
+		const std::vector<s32>& candidates = getCandidateSectorsPt(pos);
+		const s32 candidateCount = (s32)candidates.size();
 
 		EditorSector* firstHit = nullptr;
 		EditorSector* closestInside = nullptr;
@@ -3684,8 +3719,9 @@ namespace LevelEditor
 		f32 distFromFloorInside = FLT_MAX;
 		f32 distFromFloorOutside = FLT_MAX;
 
-		for (s32 i = 0; i < sectorCount; i++, sector++)
+		for (s32 c = 0; c < candidateCount; c++)
 		{
+			EditorSector* sector = &s_level.sectors[candidates[c]];
 			if (!sector_isInteractable(sector) || !sector_onActiveLayer(sector)) { continue; }
 			if (TFE_Polygon::pointInsidePolygon(&sector->poly, pos))
 			{
@@ -3910,8 +3946,6 @@ namespace LevelEditor
 	{
 		EditorLevel* level = &s_level;
 		if (level->sectors.empty()) { return false; }
-		const s32 sectorCount = (s32)level->sectors.size();
-		EditorSector* sector = level->sectors.data();
 
 		f32 maxDist  = ray->maxDist;
 		Vec3f origin = ray->origin;
@@ -3919,6 +3953,11 @@ namespace LevelEditor
 		Vec2f p1xz = { origin.x + ray->dir.x * maxDist, origin.z + ray->dir.z * maxDist };
 		Vec2f dirxz = { ray->dir.x, ray->dir.z };
 
+		// Every wall, floor and ceiling hit is on the ray segment and inside of the sector bounds on the XZ plane.
+		// Objects are only tested if the sector was hit.
+		const std::vector<s32>& candidates = getCandidateSectorsSegment(p0xz, p1xz);
+		const s32 candidateCount = (s32)candidates.size();
+
 		f32 overallClosestHit = FLT_MAX;
 		hitInfo->hitSectorId = -1;
 		hitInfo->hitWallId = -1;
@@ -3927,14 +3966,12 @@ namespace LevelEditor
 		hitInfo->hitPos = { 0 };
 		hitInfo->dist = FLT_MAX;
 
-		// Loop through sectors in the world.
-		for (s32 s = 0; s < sectorCount; s++, sector++)
+		// Loop through the sectors that the ray can hit.
+		for (s32 c = 0; c < candidateCount; c++)
 		{
+			EditorSector* sector = &level->sectors[candidates[c]];
 			if (!sector_isInteractable(sector) || !sector_onActiveLayer(sector)) { continue; }
 
-			// Check the bounds.
-			//if (!rayHitAABB(ray, sector->bounds)) { continue; }
-
 			// Now check against the walls.
 			const u32 wallCount = (u32)sector->walls.size();
 			const EditorWall* wall = sector->walls.data();
@@ -4262,10 +4299,11 @@ namespace LevelEditor
 
 	EditorSector* findSector3d(Vec3f pos)
 	{
-		const size_t sectorCount = s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
-		for (size_t s = 0; s < sectorCount; s++, sector++)
+		const std::vector<s32>& candidates = getCandidateSectorsPt({ pos.x, pos.z });
+		const size_t candidateCount = candidates.size();
+		for (size_t c = 0; c < candidateCount; c++)
 		{
+			EditorSector* sector = &s_level.sectors[candidates[c]];
 			if (isPointInsideSector3d(sector, pos))
 			{
 				return sector;
@@ -4304,16 +4342,16 @@ namespace LevelEditor
 		return closestId;
 	}
 
-	// TODO: Spatial data structure to handle cases where there are 10k, 100k, etc. sectors.
 	bool getOverlappingSectorsPt(const Vec3f* pos, SectorList* result, f32 padding)
 	{
 		if (!pos || !result) { return false; }
 
 		result->clear();
-		const s32 count = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
-		for (s32 i = 0; i < count; i++, sector++)
+		const std::vector<s32>& candidates = getCandidateSectorsPt({ pos->x, pos->z }, padding);
+		const s32 count = (s32)candidates.size();
+		for (s32 i = 0; i < count; i++)
 		{
+			EditorSector* sector = &s_level.sectors[candidates[i]];
 			if (!sector_isInteractable(sector) || !sector_onActiveLayer(sector)) { continue; }
 			// The position has to be within the bounds of the sector.
 			// TODO: Increase the bounds range?
@@ -4336,10 +4374,11 @@ namespace LevelEditor
 
 		result->clear();
 		const f32 padding = 0.1f;
-		const s32 count = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
-		for (s32 i = 0; i < count; i++, sector++)
+		const std::vector<s32>& candidates = getCandidateSectorsBounds(bounds, padding);
+		const s32 count = (s32)candidates.size();
+		for (s32 i = 0; i < count; i++)
 		{
+			EditorSector* sector = &s_level.sectors[candidates[i]];
 			if (boundsOverlap3D(sector->bounds, bounds, padding)) // Add padding for sectors that are just touching.
 			{
 				result->push_back(sector);
@@ -5153,14 +5192,15 @@ namespace LevelEditor
 	// Find a sector based on DF rules.
 	EditorSector* findSectorDf(const Vec3f pos)
 	{
-		const s32 count = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
+		const std::vector<s32>& candidates = getCandidateSectorsPt({ pos.x, pos.z });
+		const s32 count = (s32)candidates.size();
 		EditorSector* foundSector = nullptr;
 		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (s32 i = 0; i < count; i++, sector++)
+		for (s32 i = 0; i < count; i++)
 		{
+			EditorSector* sector = &s_level.sectors[candidates[i]];
 			if (pos.y <= sector->ceilHeight && pos.y >= sector->floorHeight)
 			{
 				const f32 sectorMaxX = sector->bounds[1].x;
@@ -5191,14 +5231,15 @@ namespace LevelEditor
 	// Find a sector based on DF rules.
 	EditorSector* findSectorDf(const Vec2f pos)
 	{
-		const s32 count = (s32)s_level.sectors.size();
-		EditorSector* sector = s_level.sectors.data();
+		const std::vector<s32>& candidates = getCandidateSectorsPt(pos);
+		const s32 count = (s32)candidates.size();
 		EditorSector* foundSector = nullptr;
 		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (s32 i = 0; i < count; i++, sector++)
+		for (s32 i = 0; i < count; i++)
 		{
+			EditorSector* sector = &s_level.sectors[candidates[i]];
 			const f32 sectorMaxX = sector->bounds[1].x;
 			const f32 sectorMinX = sector->bounds[0].x;
 			const f32 sectorMaxZ = sector->bounds[1].z;
@@ -11,6 +11,7 @@
 #include "groups.h"
 #include "note.h"
 #include "featureId.h"
+#include "sectorTree.h"
 #include <TFE_Editor/EditorAsset/editorAsset.h>
 #include <TFE_Editor/EditorAsset/editorTexture.h>
 #include <TFE_Editor/editorProject.h>
@@ -219,6 +220,9 @@ namespace LevelEditor
 		// Level bounds.
 		Vec3f bounds[2] = { 0 };
 		s32 layerRange[2] = { 0 };
+
+		// Derived (don't serialize).
+		SectorTree sectorTree;
 	};
 
 	// Collision
@@ -4,6 +4,7 @@
 #include <TFE_System/system.h>
 #include <TFE_Editor/LevelEditor/levelEditor.h>
 #include <TFE_Editor/LevelEditor/levelEditorData.h>
+#include <TFE_Editor/editorConfig.h>
 #include <TFE_Archive/zstdCompression.h>
 #include <TFE_System/system.h>
 #include <assert.h>
@@ -53,6 +54,7 @@ namespace LevelEditor
 	void levHistory_init()
 	{
 		history_init(level_unpackSnapshot, level_createSnapshot);
+		history_enableDeltaSnapshots((s_editorConfig.levelEditorFlags & LEVEDITOR_FLAG_DELTA_HISTORY) != 0);
 
 		history_registerCommand(LCmd_Sector_Snapshot, cmd_applySectorSnapshot);
 		history_registerCommand(LCmd_Sector_Wall_Snapshot, cmd_applySectorWallSnapshot);
@@ -0,0 +1,399 @@
+#include "sectorTree.h"
+#include "levelEditorData.h"
+#include <TFE_Jedi/Math/core_math.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace TFE_Jedi;
+
+namespace LevelEditor
+{
+	// Leaf bounds are padded by this amount, so small edits do not change the tree
+	// and the epsilons used by the exact tests are covered.
+	static const f32 c_leafMargin = 0.5f;
+	// Rebuild once this many leaves have been moved (or the sector count / 2 if larger),
+	// since reinserting leaves does not keep the tree balanced.
+	static const s32 c_minRebuildCount = 64;
+
+	static std::vector<s32> s_stack;
+	static std::vector<s32> s_buildList;
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static bool getSectorBounds(const EditorSector* sector, Vec2f* bounds, f32 margin)
+	{
+		bounds[0] = { sector->bounds[0].x - margin, sector->bounds[0].z - margin };
+		bounds[1] = { sector->bounds[1].x + margin, sector->bounds[1].z + margin };
+		// Sectors without vertices have inverted bounds.
+		return bounds[0].x <= bounds[1].x && bounds[0].z <= bounds[1].z;
+	}
+
+	static void boundsUnion(const Vec2f* a, const Vec2f* b, Vec2f* result)
+	{
+		result[0] = { std::min(a[0].x, b[0].x), std::min(a[0].z, b[0].z) };
+		result[1] = { std::max(a[1].x, b[1].x), std::max(a[1].z, b[1].z) };
+	}
+
+	static bool boundsContain(const Vec2f* outer, const Vec2f* inner)
+	{
+		return inner[0].x >= outer[0].x && inner[0].z >= outer[0].z && inner[1].x <= outer[1].x && inner[1].z <= outer[1].z;
+	}
+
+	static f32 boundsPerimeter(const Vec2f* bounds)
+	{
+		return 2.0f * ((bounds[1].x - bounds[0].x) + (bounds[1].z - bounds[0].z));
+	}
+
+	static bool isLeaf(const SectorTreeNode* node)
+	{
+		return node->child[0] < 0;
+	}
+
+	static s32 allocNode(SectorTree* tree)
+	{
+		s32 index;
+		if (tree->freeList >= 0)
+		{
+			index = tree->freeList;
+			tree->freeList = tree->nodes[index].child[1];
+		}
+		else
+		{
+			index = (s32)tree->nodes.size();
+			tree->nodes.push_back({});
+		}
+		SectorTreeNode* node = &tree->nodes[index];
+		node->parent = -1;
+		node->child[0] = -1;
+		node->child[1] = -1;
+		node->sectorId = -1;
+		return index;
+	}
+
+	static void freeNode(SectorTree* tree, s32 index)
+	{
+		// The free list is linked through child[1].
+		tree->nodes[index].child[1] = tree->freeList;
+		tree->freeList = index;
+	}
+
+	static void refitAncestors(SectorTree* tree, s32 index)
+	{
+		while (index >= 0)
+		{
+			SectorTreeNode* node = &tree->nodes[index];
+			boundsUnion(tree->nodes[node->child[0]].bounds, tree->nodes[node->child[1]].bounds, node->bounds);
+			index = node->parent;
+		}
+	}
+
+	// Insert a leaf next to the sibling with the lowest cost, using the perimeter as the surface area heuristic.
+	static void insertLeaf(SectorTree* tree, s32 leaf)
+	{
+		if (tree->root < 0)
+		{
+			tree->root = leaf;
+			tree->nodes[leaf].parent = -1;
+			return;
+		}
+
+		const Vec2f* leafBounds = tree->nodes[leaf].bounds;
+		s32 index = tree->root;
+		while (!isLeaf(&tree->nodes[index]))
+		{
+			const SectorTreeNode* node = &tree->nodes[index];
+			Vec2f combined[2];
+			boundsUnion(node->bounds, leafBounds, combined);
+			const f32 combinedPerimeter = boundsPerimeter(combined);
+
+			// Cost of creating a new parent for this node and the leaf.
+			const f32 cost = 2.0f * combinedPerimeter;
+			// Minimum cost of pushing the leaf further down the tree.
+			const f32 inheritanceCost = 2.0f * (combinedPerimeter - boundsPerimeter(node->bounds));
+
+			f32 childCost[2];
+			for (s32 c = 0; c < 2; c++)
+			{
+				const SectorTreeNode* child = &tree->nodes[node->child[c]];
+				Vec2f childCombined[2];
+				boundsUnion(child->bounds, leafBounds, childCombined);
+				childCost[c] = boundsPerimeter(childCombined) + inheritanceCost;
+				if (!isLeaf(child))
+				{
+					childCost[c] -= boundsPerimeter(child->bounds);
+				}
+			}
+
+			if (cost < childCost[0] && cost < childCost[1]) { break; }
+			index = childCost[0] < childCost[1] ? node->child[0] : node->child[1];
+		}
+
+		// Create a new parent for the sibling and the leaf.
+		const s32 sibling = index;
+		const s32 oldParent = tree->nodes[sibling].parent;
+		const s32 newParent = allocNode(tree);
+		SectorTreeNode* parent = &tree->nodes[newParent];
+		parent->parent = oldParent;
+		parent->child[0] = sibling;
+		parent->child[1] = leaf;
+		boundsUnion(tree->nodes[sibling].bounds, tree->nodes[leaf].bounds, parent->bounds);
+		tree->nodes[sibling].parent = newParent;
+		tree->nodes[leaf].parent = newParent;
+
+		if (oldParent >= 0)
+		{
+			SectorTreeNode* grandParent = &tree->nodes[oldParent];
+			grandParent->child[grandParent->child[0] == sibling ? 0 : 1] = newParent;
+			refitAncestors(tree, oldParent);
+		}
+		else
+		{
+			tree->root = newParent;
+		}
+	}
+
+	static void removeLeaf(SectorTree* tree, s32 leaf)
+	{
+		if (leaf == tree->root)
+		{
+			tree->root = -1;
+			return;
+		}
+
+		// Replace the parent with the sibling.
+		const s32 parent = tree->nodes[leaf].parent;
+		const s32 grandParent = tree->nodes[parent].parent;
+		const s32 sibling = tree->nodes[parent].child[0] == leaf ? tree->nodes[parent].child[1] : tree->nodes[parent].child[0];
+		if (grandParent >= 0)
+		{
+			SectorTreeNode* node = &tree->nodes[grandParent];
+			node->child[node->child[0] == parent ? 0 : 1] = sibling;
+			tree->nodes[sibling].parent = grandParent;
+			refitAncestors(tree, grandParent);
+		}
+		else
+		{
+			tree->root = sibling;
+			tree->nodes[sibling].parent = -1;
+		}
+		freeNode(tree, parent);
+	}
+
+	// Top-down build, splitting the leaves at the median along the longest axis of their centers.
+	static s32 buildRange(SectorTree* tree, s32* leaves, s32 count, s32 parentIndex)
+	{
+		if (count == 1)
+		{
+			tree->nodes[leaves[0]].parent = parentIndex;
+			return leaves[0];
+		}
+
+		Vec2f center[2] = { { FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX } };
+		for (s32 i = 0; i < count; i++)
+		{
+			const Vec2f* bounds = tree->nodes[leaves[i]].bounds;
+			const f32 cx = bounds[0].x + bounds[1].x;
+			const f32 cz = bounds[0].z + bounds[1].z;
+			center[0] = { std::min(center[0].x, cx), std::min(center[0].z, cz) };
+			center[1] = { std::max(center[1].x, cx), std::max(center[1].z, cz) };
+		}
+		const bool splitX = (center[1].x - center[0].x) >= (center[1].z - center[0].z);
+		const std::vector<SectorTreeNode>& nodes = tree->nodes;
+		const s32 mid = count / 2;
+		std::nth_element(leaves, leaves + mid, leaves + count, [&nodes, splitX](s32 a, s32 b)
+		{
+			const Vec2f* ba = nodes[a].bounds;
+			const Vec2f* bb = nodes[b].bounds;
+			return splitX ? (ba[0].x + ba[1].x < bb[0].x + bb[1].x) : (ba[0].z + ba[1].z < bb[0].z + bb[1].z);
+		});
+
+		const s32 index = allocNode(tree);
+		const s32 child0 = buildRange(tree, leaves, mid, index);
+		const s32 child1 = buildRange(tree, leaves + mid, count - mid, index);
+		SectorTreeNode* node = &tree->nodes[index];
+		node->parent = parentIndex;
+		node->child[0] = child0;
+		node->child[1] = child1;
+		boundsUnion(tree->nodes[child0].bounds, tree->nodes[child1].bounds, node->bounds);
+		return index;
+	}
+
+	static void build(SectorTree* tree, const EditorSector* sectors, s32 sectorCount)
+	{
+		tree->nodes.clear();
+		tree->root = -1;
+		tree->freeList = -1;
+		tree->reinsertCount = 0;
+		tree->dirty = false;
+		tree->leaf.assign(sectorCount, -1);
+
+		s_buildList.clear();
+		for (s32 s = 0; s < sectorCount; s++)
+		{
+			Vec2f bounds[2];
+			if (!getSectorBounds(&sectors[s], bounds, c_leafMargin)) { continue; }
+
+			const s32 leaf = allocNode(tree);
+			SectorTreeNode* node = &tree->nodes[leaf];
+			node->bounds[0] = bounds[0];
+			node->bounds[1] = bounds[1];
+			node->sectorId = s;
+			tree->leaf[s] = leaf;
+			s_buildList.push_back(leaf);
+		}
+		if (!s_buildList.empty())
+		{
+			tree->root = buildRange(tree, s_buildList.data(), (s32)s_buildList.size(), -1);
+		}
+	}
+
+	static void sync(SectorTree* tree, const EditorSector* sectors, s32 sectorCount)
+	{
+		if (tree->dirty || (s32)tree->leaf.size() != sectorCount)
+		{
+			build(tree, sectors, sectorCount);
+		}
+	}
+
+	static bool segmentOverlap(const Vec2f* bounds, Vec2f p0, Vec2f delta)
+	{
+		f32 t0 = 0.0f, t1 = 1.0f;
+		for (s32 axis = 0; axis < 2; axis++)
+		{
+			const f32 p  = axis ? p0.z : p0.x;
+			const f32 d  = axis ? delta.z : delta.x;
+			const f32 b0 = axis ? bounds[0].z : bounds[0].x;
+			const f32 b1 = axis ? bounds[1].z : bounds[1].x;
+			if (fabsf(d) < FLT_EPSILON)
+			{
+				if (p < b0 || p > b1) { return false; }
+				continue;
+			}
+
+			const f32 scale = 1.0f / d;
+			f32 ta = (b0 - p) * scale;
+			f32 tb = (b1 - p) * scale;
+			if (ta > tb) { std::swap(ta, tb); }
+			t0 = std::max(t0, ta);
+			t1 = std::min(t1, tb);
+			if (t0 > t1) { return false; }
+		}
+		return true;
+	}
+
+	enum QueryType
+	{
+		QUERY_BOUNDS = 0,
+		QUERY_SEGMENT,
+	};
+
+	static void query(SectorTree* tree, QueryType type, const Vec2f* shape, std::vector<s32>* result)
+	{
+		result->clear();
+		if (tree->root < 0) { return; }
+
+		const Vec2f delta = { shape[1].x - shape[0].x, shape[1].z - shape[0].z };
+		s_stack.clear();
+		s_stack.push_back(tree->root);
+		while (!s_stack.empty())
+		{
+			const SectorTreeNode* node = &tree->nodes[s_stack.back()];
+			s_stack.pop_back();
+
+			const Vec2f* bounds = node->bounds;
+			bool overlap;
+			if (type == QUERY_BOUNDS)
+			{
+				overlap = shape[0].x <= bounds[1].x && shape[1].x >= bounds[0].x && shape[0].z <= bounds[1].z && shape[1].z >= bounds[0].z;
+			}
+			else
+			{
+				overlap = segmentOverlap(bounds, shape[0], delta);
+			}
+			if (!overlap) { continue; }
+
+			if (isLeaf(node))
+			{
+				result->push_back(node->sectorId);
+			}
+			else
+			{
+				s_stack.push_back(node->child[0]);
+				s_stack.push_back(node->child[1]);
+			}
+		}
+		// Keep the level order, so the results match a linear search.
+		std::sort(result->begin(), result->end());
+	}
+
+	/////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////
+	void sectorTree_invalidate(SectorTree* tree)
+	{
+		tree->dirty = true;
+	}
+
+	void sectorTree_update(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, const EditorSector* sector)
+	{
+		// Nothing to refit if the tree will be rebuilt anyway.
+		if (tree->dirty) { return; }
+		if ((s32)tree->leaf.size() != sectorCount)
+		{
+			tree->dirty = true;
+			return;
+		}
+		// Ignore sectors outside of the level list, such as snapshots and sectors that are still being built.
+		if (!sectors || sector < sectors || sector >= sectors + sectorCount) { return; }
+
+		const s32 id = s32(sector - sectors);
+		Vec2f tight[2];
+		const bool hasArea = getSectorBounds(sector, tight, 0.0f);
+		s32 leaf = tree->leaf[id];
+		if (leaf >= 0)
+		{
+			// The padded bounds still contain the sector, so the tree does not need to change.
+			if (hasArea && boundsContain(tree->nodes[leaf].bounds, tight)) { return; }
+
+			removeLeaf(tree, leaf);
+			freeNode(tree, leaf);
+			tree->leaf[id] = -1;
+		}
+		if (!hasArea) { return; }
+
+		leaf = allocNode(tree);
+		SectorTreeNode* node = &tree->nodes[leaf];
+		getSectorBounds(sector, node->bounds, c_leafMargin);
+		node->sectorId = id;
+		insertLeaf(tree, leaf);
+		tree->leaf[id] = leaf;
+
+		tree->reinsertCount++;
+		if (tree->reinsertCount > std::max(c_minRebuildCount, sectorCount / 2))
+		{
+			tree->dirty = true;
+		}
+	}
+
+	void sectorTree_queryPoint(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, Vec2f pt, f32 padding, std::vector<s32>* result)
+	{
+		sync(tree, sectors, sectorCount);
+		const Vec2f bounds[] = { { pt.x - padding, pt.z - padding }, { pt.x + padding, pt.z + padding } };
+		query(tree, QUERY_BOUNDS, bounds, result);
+	}
+
+	void sectorTree_queryBounds(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, const Vec2f bounds[2], std::vector<s32>* result)
+	{
+		sync(tree, sectors, sectorCount);
+		query(tree, QUERY_BOUNDS, bounds, result);
+	}
+
+	void sectorTree_querySegment(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, Vec2f p0, Vec2f p1, std::vector<s32>* result)
+	{
+		sync(tree, sectors, sectorCount);
+		const Vec2f segment[] = { p0, p1 };
+		query(tree, QUERY_SEGMENT, segment, result);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Editor
+// A system built to view and edit Dark Forces data files.
+// The viewing aspect needs to be put in place at the beginning
+// in order to properly test elements in isolation without having
+// to "play" the game as intended.
+//////////////////////////////////////////////////////////////////////
+// Dynamic AABB tree over the sector bounds on the XZ plane, used to
+// find candidate sectors for the spatial queries without looping over
+// every sector in the level.
+//
+// Leaves store the sector bounds padded by a margin, so small edits
+// can be refit without changing the tree. Queries are conservative:
+// callers still run their exact tests on the returned sectors.
+// Heights are not stored since they change often and the callers
+// already test them.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <vector>
+
+namespace LevelEditor
+{
+	struct EditorSector;
+
+	struct SectorTreeNode
+	{
+		Vec2f bounds[2];	// (x,z) bounds, padded for leaves.
+		s32 parent;
+		s32 child[2];		// -1 for leaves.
+		s32 sectorId;		// leaves only.
+	};
+
+	struct SectorTree
+	{
+		std::vector<SectorTreeNode> nodes;
+		std::vector<s32> leaf;			// leaf node for each sector, or -1 if the sector has no area.
+		s32 root = -1;
+		s32 freeList = -1;
+		s32 reinsertCount = 0;			// leaves moved since the last build, the tree is rebuilt when this grows too large.
+		bool dirty = true;
+	};
+
+	// Rebuild the whole tree before the next query, called when sectors are added, removed or re-ordered.
+	void sectorTree_invalidate(SectorTree* tree);
+	// Refit the sector leaf after its bounds change.
+	void sectorTree_update(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, const EditorSector* sector);
+
+	// Queries fill the result with the ids of the sectors whose (padded) bounds pass the test, in ascending order.
+	void sectorTree_queryPoint(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, Vec2f pt, f32 padding, std::vector<s32>* result);
+	void sectorTree_queryBounds(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, const Vec2f bounds[2], std::vector<s32>* result);
+	void sectorTree_querySegment(SectorTree* tree, const EditorSector* sectors, s32 sectorCount, Vec2f p0, Vec2f p1, std::vector<s32>* result);
+}
@@ -6,6 +6,7 @@
 #include "hotkeys.h"
 #include <TFE_Editor/editor.h>
 #include <TFE_Editor/editorConfig.h>
+#include <TFE_Editor/history.h>
 #include <TFE_Input/input.h>
 #include <TFE_System/math.h>
 #include <TFE_Ui/ui.h>
@@ -114,6 +115,8 @@ namespace LevelEditor
 		ImGui::Separator();
 
 		optionCheckbox("New Sectors use DEFAULT texture", &s_editorConfig.levelEditorFlags, LEVEDITOR_FLAG_ALWAYS_USE_DEFTEX, 300);
+		optionCheckbox("Store Undo Snapshots as Deltas", &s_editorConfig.levelEditorFlags, LEVEDITOR_FLAG_DELTA_HISTORY, 300);
+		history_enableDeltaSnapshots((s_editorConfig.levelEditorFlags & LEVEDITOR_FLAG_DELTA_HISTORY) != 0);
 		
 		ImGui::Separator();
 		optionSliderEditFloat("Curve Segment Size", "%.2f", &s_editorConfig.curve_segmentSize, 0.1f, 100.0f, 0.1f);
@@ -23,6 +23,7 @@ namespace TFE_Editor
 		// Empty space for related flags.
 		LEVEDITOR_FLAG_INVERT_Y = FLAG_BIT(10),
 		LEVEDITOR_FLAG_ALWAYS_USE_DEFTEX = FLAG_BIT(11),
+		LEVEDITOR_FLAG_DELTA_HISTORY = FLAG_BIT(12),
 	};
 
 	struct EditorConfig
@@ -12,6 +12,10 @@ namespace TFE_Editor
 	enum
 	{
 		CMD_MAX_DEPTH = 64,
+		// Maximum number of deltas between full snapshots, which bounds the replay cost.
+		SNAPSHOT_KEYFRAME_INTERVAL = 8,
+		// Granularity used when searching for changed data between snapshots.
+		SNAPSHOT_DELTA_BLOCK = 64,
 	};
 
 	struct Snapshot
@@ -20,6 +24,9 @@ namespace TFE_Editor
 		u32 uncompressedSize;
 		u32 compressedSize; // if zero, then uncompressed.
 		std::vector<u8> compressedData;
+		// Delta snapshots store the dirty ranges relative to the base snapshot, keyframes have a baseId of -1.
+		s32 baseId;
+		s32 keyDistance;
 	};
 
 	struct CommandHeader
@@ -45,6 +52,14 @@ namespace TFE_Editor
 	u32 s_curBufferAddr = 0;
 	u32 s_curSnapshot = 0;
 
+	// Delta snapshots.
+	bool s_deltaSnapshots = false;
+	s32 s_deltaBaseId = -1;
+	std::vector<u8> s_deltaBuffer;
+	// Uncompressed data of the most recently created or restored snapshot, only kept while delta snapshots are enabled.
+	s32 s_snapshotCacheId = -1;
+	std::vector<u8> s_snapshotCache;
+
 	void history_init(UnpackSnapshotFunc snapshotUnpackFunc, CreateSnapshotFunc createSnapshotFunc)
 	{
 		s_snapshotUnpack = snapshotUnpackFunc;
@@ -71,6 +86,9 @@ namespace TFE_Editor
 		s_curPosInHistory = 0;
 		s_curBufferAddr = 0;
 		s_curSnapshot = 0;
+		s_deltaBaseId = -1;
+		s_snapshotCacheId = -1;
+		s_snapshotCache.clear();
 		// Clear the previous snapshot index.
 		if (s_snapshotUnpack)
 		{
@@ -78,6 +96,23 @@ namespace TFE_Editor
 		}
 	}
 
+	// Frees the uncompressed snapshot data, which can be as large as the level.
+	static void releaseSnapshotCache()
+	{
+		s_snapshotCacheId = -1;
+		std::vector<u8>().swap(s_snapshotCache);
+		std::vector<u8>().swap(s_deltaBuffer);
+	}
+
+	void history_enableDeltaSnapshots(bool enable)
+	{
+		s_deltaSnapshots = enable;
+		if (!enable)
+		{
+			releaseSnapshotCache();
+		}
+	}
+
 	// Register general commands and names.
 	void history_registerCommand(u16 id, CmdApplyFunc func)
 	{
@@ -150,29 +185,168 @@ namespace TFE_Editor
 		s_curBufferAddr = bufferAddr;
 	}
 		
+	void snapshot_compress(Snapshot* snapshot, u32 size, const u8* data)
+	{
+		snapshot->uncompressedSize = size;
+		if (zstd_compress(snapshot->compressedData, data, size, 4) && snapshot->compressedData.size() < size)
+		{
+			snapshot->compressedSize = (u32)snapshot->compressedData.size();
+		}
+		else
+		{
+			snapshot->compressedSize = size;
+			snapshot->compressedData.resize(size);
+			memcpy(snapshot->compressedData.data(), data, size);
+		}
+	}
+
+	bool snapshot_decompress(const Snapshot* snapshot, std::vector<u8>& output)
+	{
+		output.resize(snapshot->uncompressedSize);
+		if (snapshot->uncompressedSize > snapshot->compressedSize)
+		{
+			return zstd_decompress(output.data(), snapshot->uncompressedSize, snapshot->compressedData.data(), snapshot->compressedSize);
+		}
+		memcpy(output.data(), snapshot->compressedData.data(), snapshot->compressedSize);
+		return true;
+	}
+
+	void delta_addU32(std::vector<u8>& delta, u32 value)
+	{
+		const size_t offset = delta.size();
+		delta.resize(offset + sizeof(u32));
+		memcpy(delta.data() + offset, &value, sizeof(u32));
+	}
+
+	bool delta_isBlockDirty(const u8* base, u32 baseSize, const u8* data, u32 offset, u32 blockSize)
+	{
+		return offset + blockSize > baseSize || memcmp(base + offset, data + offset, blockSize) != 0;
+	}
+
+	// The delta holds the new size followed by a list of { offset, size, data } ranges that differ from the base.
+	// Data past the end of the base is always dirty, so the ranges and the base prefix fully describe the new data.
+	void delta_build(std::vector<u8>& delta, const u8* base, u32 baseSize, const u8* data, u32 size)
+	{
+		delta.clear();
+		delta_addU32(delta, size);
+
+		u32 offset = 0;
+		while (offset < size)
+		{
+			u32 blockSize = std::min((u32)SNAPSHOT_DELTA_BLOCK, size - offset);
+			if (!delta_isBlockDirty(base, baseSize, data, offset, blockSize))
+			{
+				offset += blockSize;
+				continue;
+			}
+
+			// Merge adjacent dirty blocks into a single range.
+			const u32 start = offset;
+			offset += blockSize;
+			while (offset < size)
+			{
+				blockSize = std::min((u32)SNAPSHOT_DELTA_BLOCK, size - offset);
+				if (!delta_isBlockDirty(base, baseSize, data, offset, blockSize)) { break; }
+				offset += blockSize;
+			}
+
+			const u32 rangeSize = offset - start;
+			delta_addU32(delta, start);
+			delta_addU32(delta, rangeSize);
+			const size_t deltaOffset = delta.size();
+			delta.resize(deltaOffset + rangeSize);
+			memcpy(delta.data() + deltaOffset, data + start, rangeSize);
+		}
+	}
+
+	// Applies the delta to data, which holds the base snapshot on input.
+	bool delta_apply(std::vector<u8>& data, const u8* delta, u32 deltaSize)
+	{
+		if (deltaSize < sizeof(u32)) { return false; }
+		u32 size, pos = 0;
+		memcpy(&size, delta, sizeof(u32));
+		pos += sizeof(u32);
+		data.resize(size);
+
+		while (pos + 2 * sizeof(u32) <= deltaSize)
+		{
+			u32 offset, rangeSize;
+			memcpy(&offset, delta + pos, sizeof(u32));
+			memcpy(&rangeSize, delta + pos + sizeof(u32), sizeof(u32));
+			pos += 2 * sizeof(u32);
+			if (offset + rangeSize > size || pos + rangeSize > deltaSize) { return false; }
+
+			memcpy(data.data() + offset, delta + pos, rangeSize);
+			pos += rangeSize;
+		}
+		return pos == deltaSize;
+	}
+
+	// Restores the uncompressed snapshot data into the snapshot cache, replaying deltas from the nearest keyframe
+	// or from the cached snapshot if it is part of the chain.
+	bool history_loadSnapshotData(s32 id)
+	{
+		if (id < 0 || id >= (s32)s_snapShots.size()) { return false; }
+		if (id == s_snapshotCacheId) { return true; }
+
+		s32 chain[SNAPSHOT_KEYFRAME_INTERVAL];
+		s32 chainCount = 0;
+		s32 curId = id;
+		while (1)
+		{
+			assert(chainCount < SNAPSHOT_KEYFRAME_INTERVAL);
+			chain[chainCount++] = curId;
+			const s32 baseId = s_snapShots[curId].baseId;
+			if (baseId < 0) { break; }
+			curId = baseId;
+			// The cache already holds the base data.
+			if (curId == s_snapshotCacheId) { break; }
+		}
+
+		// The cache is modified in place, so it is invalid until the replay is complete.
+		s_snapshotCacheId = -1;
+		for (s32 i = chainCount - 1; i >= 0; i--)
+		{
+			const Snapshot* snapshot = &s_snapShots[chain[i]];
+			if (snapshot->baseId < 0)
+			{
+				if (!snapshot_decompress(snapshot, s_snapshotCache)) { return false; }
+			}
+			else
+			{
+				if (!snapshot_decompress(snapshot, s_deltaBuffer)) { return false; }
+				if (!delta_apply(s_snapshotCache, s_deltaBuffer.data(), (u32)s_deltaBuffer.size())) { return false; }
+			}
+		}
+		s_snapshotCacheId = id;
+		return true;
+	}
+
 	// Create new commands and snapshots.
 	s32 history_createSnapshotInternal(u32 size, void* data, const char* name/*=nullptr*/)
 	{
 		u16 parentId = u16(s_curPosInHistory);
 
 		Snapshot snapshot = {};
-		snapshot.uncompressedSize = size;
+		snapshot.baseId = -1;
+		snapshot.keyDistance = 0;
+		snapshot_compress(&snapshot, size, (u8*)data);
 
-		bool useUncompressed = true;
-		if (zstd_compress(snapshot.compressedData, (u8*)data, size, 4))
+		// Store a delta against the previous snapshot instead, if it is smaller.
+		if (s_deltaSnapshots && s_deltaBaseId >= 0 && s_deltaBaseId < (s32)s_snapShots.size() &&
+			s_snapShots[s_deltaBaseId].keyDistance + 1 < SNAPSHOT_KEYFRAME_INTERVAL && history_loadSnapshotData(s_deltaBaseId))
 		{
-			if (snapshot.compressedData.size() < size)
+			delta_build(s_deltaBuffer, s_snapshotCache.data(), (u32)s_snapshotCache.size(), (u8*)data, size);
+
+			Snapshot deltaSnapshot = {};
+			deltaSnapshot.baseId = s_deltaBaseId;
+			deltaSnapshot.keyDistance = s_snapShots[s_deltaBaseId].keyDistance + 1;
+			snapshot_compress(&deltaSnapshot, (u32)s_deltaBuffer.size(), s_deltaBuffer.data());
+			if (deltaSnapshot.compressedSize < snapshot.compressedSize)
 			{
-				useUncompressed = false;
-				snapshot.compressedSize = (u32)snapshot.compressedData.size();
+				snapshot = std::move(deltaSnapshot);
 			}
 		}
-		if (useUncompressed)
-		{
-			snapshot.compressedSize = size;
-			snapshot.compressedData.resize(size);
-			memcpy(snapshot.compressedData.data(), data, size);
-		}
 
 		if (name)
 		{
@@ -187,6 +361,15 @@ namespace TFE_Editor
 		s_snapShots.push_back(std::move(snapshot));
 		s_curSnapshot = u32(id);
 
+		// The new snapshot is the base for the next delta, keep its data around so it doesn't need to be restored.
+		s_deltaBaseId = id;
+		if (s_deltaSnapshots)
+		{
+			s_snapshotCache.resize(size);
+			memcpy(s_snapshotCache.data(), data, size);
+			s_snapshotCacheId = id;
+		}
+
 		CommandHeader* header = hBuffer_createHeader();
 		header->cmdId = CMD_SNAPSHOT;
 		header->cmdName = id; // this holds the snapshot ID instead of a name for snapshots (which have their own name).
@@ -355,18 +538,14 @@ namespace TFE_Editor
 			if (cmdHeader->cmdId == CMD_SNAPSHOT)
 			{
 				const s32 id = cmdHeader->cmdName;
-				Snapshot* snapshot = &s_snapShots[id];
-				if (snapshot->uncompressedSize > snapshot->compressedSize)
+				if (history_loadSnapshotData(id))
 				{
-					s_snapshotBuffer.resize(snapshot->uncompressedSize);
-					if (zstd_decompress(s_snapshotBuffer.data(), snapshot->uncompressedSize, snapshot->compressedData.data(), snapshot->compressedSize))
-					{
-						s_snapshotUnpack(id, snapshot->uncompressedSize, s_snapshotBuffer.data());
-					}
+					s_snapshotUnpack(id, (u32)s_snapshotCache.size(), s_snapshotCache.data());
 				}
-				else
+				// Without deltas the data is not needed again.
+				if (!s_deltaSnapshots)
 				{
-					s_snapshotUnpack(id, snapshot->compressedSize, snapshot->compressedData.data());
+					releaseSnapshotCache();
 				}
 			}
 			else
@@ -430,6 +609,9 @@ namespace TFE_Editor
 		if (snapShotMin < 0xffff)
 		{
 			s_snapShots.resize(snapShotMin);
+			// Deltas only reference earlier snapshots, so the remaining snapshots are still valid.
+			if (s_deltaBaseId >= snapShotMin) { s_deltaBaseId = snapShotMin - 1; }
+			if (s_snapshotCacheId >= snapShotMin) { s_snapshotCacheId = -1; }
 		}
 		// Clear the previous snapshot index.
 		s_snapshotUnpack(-1, 0, nullptr);
@@ -462,19 +644,34 @@ namespace TFE_Editor
 	}
 
 	u32 history_getSize()
+	{
+		HistoryMemoryStats stats;
+		history_getMemoryStats(&stats);
+		return stats.commandSize + stats.keyframeSize + stats.deltaSize + stats.cacheSize;
+	}
+
+	void history_getMemoryStats(HistoryMemoryStats* stats)
 	{
 		const s32 snapshotCount = (s32)s_snapShots.size();
 		const Snapshot* snapshot = s_snapShots.data();
 
-		u32 size = (u32)s_historyBuffer.size();
+		*stats = {};
+		stats->commandSize = (u32)s_historyBuffer.size() + (u32)s_history.size() * sizeof(u32);
 		for (s32 i = 0; i < snapshotCount; i++, snapshot++)
 		{
-			size += (u32)snapshot->compressedData.size();
-			size += (u32)snapshot->name.length();
-			size += sizeof(Snapshot);
+			const u32 size = (u32)snapshot->compressedData.size() + (u32)snapshot->name.length() + sizeof(Snapshot);
+			if (snapshot->baseId < 0)
+			{
+				stats->keyframeCount++;
+				stats->keyframeSize += size;
+			}
+			else
+			{
+				stats->deltaCount++;
+				stats->deltaSize += size;
+			}
 		}
-		size += (u32)s_history.size() * sizeof(u32);
-		return size;
+		stats->cacheSize = (u32)s_snapshotCache.capacity() + (u32)s_deltaBuffer.capacity();
 	}
 
 	void history_getPrevCmdAndName(u16& cmd, u16& name)
@@ -23,6 +23,16 @@ namespace TFE_Editor
 		CMD_START = 1,
 	};
 
+	struct HistoryMemoryStats
+	{
+		u32 commandSize;		// Command headers and command data.
+		u32 keyframeCount;		// Snapshots stored in full.
+		u32 keyframeSize;
+		u32 deltaCount;			// Snapshots stored as a delta against an earlier snapshot.
+		u32 deltaSize;
+		u32 cacheSize;			// Uncompressed copy of the most recently used snapshot.
+	};
+
 	enum HistoryErrorType
 	{
 		hError_None = 0,
@@ -37,6 +47,8 @@ namespace TFE_Editor
 	void history_clear();
 	void history_removeLast();
 	HistoryErrorType history_validateCommandHeaders(s32& errorIndex, u32& badValue);
+	// When enabled, snapshots are stored as deltas against the previous snapshot with periodic keyframes.
+	void history_enableDeltaSnapshots(bool enable);
 
 	// Register general commands and names.
 	void history_registerCommand(u16 id, CmdApplyFunc func);
@@ -51,6 +63,7 @@ namespace TFE_Editor
 	void history_showBranch(s32 pos);
 	s32  history_getPos();
 	u32  history_getSize();
+	void history_getMemoryStats(HistoryMemoryStats* stats);
 	u32  history_getItemCount();
 	void history_collapseToPos(s32 pos);
 	void history_collapse();
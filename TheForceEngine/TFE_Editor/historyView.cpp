@@ -32,6 +32,13 @@ namespace TFE_Editor
 			}
 			ImGui::Text("Items: %d   Size: %0.2f %s", history_getItemCount(), f64(history_getSize()) * scale, sizeTypeStr[sizeType]);
 
+			HistoryMemoryStats stats;
+			history_getMemoryStats(&stats);
+			const f64 kbScale = 1.0 / 1024.0;
+			ImGui::Text("Commands: %0.1f KB   Cache: %0.1f KB", f64(stats.commandSize) * kbScale, f64(stats.cacheSize) * kbScale);
+			ImGui::Text("Snapshots: %u full (%0.1f KB), %u delta (%0.1f KB)", stats.keyframeCount, f64(stats.keyframeSize) * kbScale,
+				stats.deltaCount, f64(stats.deltaSize) * kbScale);
+
 			ImGui::BeginChild("##HistoryList", ImVec2(256, 512), ImGuiChildFlags_Border);
 			{
 				const u32 count = history_getItemCount();
@@ -0,0 +1,26 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Read-only memory mapped file.
+// The mapped data stays valid until the file is closed.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool open(const char* filename);
+	void close();
+
+	bool isOpen() const { return m_data != nullptr; }
+	const u8* getData() const { return m_data; }
+	size_t getSize() const { return m_size; }
+
+private:
+	const u8* m_data;
+	size_t m_size;
+	void* m_fileHandle;
+	void* m_mappingHandle;
+};
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <deque>
 #include <string>
+#include <unordered_map>
 
 namespace FileUtil {
 	extern bool existsNoCase(const char *filename);
@@ -28,6 +29,16 @@ namespace TFE_Paths
 	static std::deque<FileMapping> s_fileMappings;
 	static std::deque<std::string> s_systemPaths;	// TFE Support data paths
 
+	// Resolved getFilePath() results, keyed by the lower case file name.
+	struct CachedFilePath
+	{
+		bool found;
+		Archive* archive;
+		u32 index;
+		std::string path;
+	};
+	static std::unordered_map<std::string, CachedFilePath> s_filePathCache;
+
 	bool isPortableInstall();
 
 	void setPath(TFE_PathType pathType, const char* path)
@@ -209,6 +220,7 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_back(workpath);
+		clearFilePathCache();
 	}
 
 	void addSearchPathToHead(const char *fullPath)
@@ -227,12 +239,14 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_front(workpath);
+		clearFilePathCache();
 	}
 
 	void clearSearchPaths(void)
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		clearFilePathCache();
 	}
 
 	void clearLocalArchives(void)
@@ -240,6 +254,7 @@ namespace TFE_Paths
 		std::for_each(s_localArchives.begin(), s_localArchives.end(),
 				[](Archive *a) { Archive::freeArchive(a); });
 		s_localArchives.clear();
+		clearFilePathCache();
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -255,6 +270,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		clearFilePathCache();
 	}
 
 	void addLocalSearchPath(const char *locpath)
@@ -287,21 +303,50 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive *a)
 	{
 		s_localArchives.push_front(a);
+		clearFilePathCache();
 	}
 
 	void removeFirstArchive(void)
 	{
 		s_localArchives.pop_front();
+		clearFilePathCache();
 	}
 
 	void addLocalArchive(Archive *a)
 	{
 		s_localArchives.push_back(a);
+		clearFilePathCache();
 	}
 
 	void removeLastArchive(void)
 	{
 		s_localArchives.pop_back();
+		clearFilePathCache();
+	}
+
+	void clearFilePathCache()
+	{
+		s_filePathCache.clear();
+	}
+
+	static std::string getFilePathCacheKey(const char* fileName)
+	{
+		std::string key = fileName;
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = tolower(key[i]);
+		}
+		return key;
+	}
+
+	static bool cacheFilePath(const std::string& key, FilePath* outPath, bool found)
+	{
+		CachedFilePath& entry = s_filePathCache[key];
+		entry.found = found;
+		entry.archive = outPath->archive;
+		entry.index = outPath->index;
+		entry.path = outPath->path;
+		return found;
 	}
 
 	bool getFilePath(const char *fileName, FilePath *outPath)
@@ -321,12 +366,23 @@ namespace TFE_Paths
 			}
 		}
 
+		// Then check for previously resolved paths.
+		const std::string key = getFilePathCacheKey(fileName);
+		const auto cached = s_filePathCache.find(key);
+		if (cached != s_filePathCache.end())
+		{
+			outPath->archive = cached->second.archive;
+			outPath->index = cached->second.index;
+			strncpy(outPath->path, cached->second.path.c_str(), TFE_MAX_PATH);
+			return cached->second.found;
+		}
+
 		// Search in the local search paths before local archives: s_searchPaths.
 		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++) {
 			sprintf(fullname, "%s%s", it->c_str(), fileName);
 			if (FileUtil::existsNoCase(fullname)) {
 				strncpy(outPath->path, fullname, TFE_MAX_PATH);
-				return true;
+				return cacheFilePath(key, outPath, true);
 			}
 		}
 
@@ -336,12 +392,12 @@ namespace TFE_Paths
 			if (index != INVALID_FILE) {
 				outPath->archive = *it;
 				outPath->index = index;
-				return true;
+				return cacheFilePath(key, outPath, true);
 			}
 		}
 
 		// Finally admit defeat.
-		return false;
+		return cacheFilePath(key, outPath, false);
 	}
 
 	// Return true if we want to use a "portable" install - 
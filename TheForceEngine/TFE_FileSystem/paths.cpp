@@ -5,6 +5,7 @@
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <string>
+#include <unordered_map>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN 1
@@ -32,6 +33,16 @@ namespace TFE_Paths
 	static std::vector<std::string> s_searchPaths;
 	static std::vector<FileMapping> s_fileMappings;
 
+	// Resolved getFilePath() results, keyed by the lower case file name.
+	struct CachedFilePath
+	{
+		bool found;
+		Archive* archive;
+		u32 index;
+		std::string path;
+	};
+	static std::unordered_map<std::string, CachedFilePath> s_filePathCache;
+
 	bool insertString(char* text, const char* newFragment, const char* pattern);
 	bool isPortableInstall();
 
@@ -200,6 +211,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.push_back(fullPath);
+			clearFilePathCache();
 		}
 	}
 
@@ -219,6 +231,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.insert(s_searchPaths.begin(), fullPath);
+			clearFilePathCache();
 		}
 	}
 
@@ -226,6 +239,7 @@ namespace TFE_Paths
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		clearFilePathCache();
 	}
 
 	void clearLocalArchives()
@@ -237,6 +251,7 @@ namespace TFE_Paths
 			Archive::freeArchive(archive[i]);
 		}
 		s_localArchives.clear();
+		clearFilePathCache();
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -252,6 +267,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		clearFilePathCache();
 	}
 
 	void addLocalSearchPath(const char* localSearchPath)
@@ -284,21 +300,50 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive* archive)
 	{
 		s_localArchives.insert(s_localArchives.begin(), archive);
+		clearFilePathCache();
 	}
 
 	void removeFirstArchive()
 	{
 		s_localArchives.erase(s_localArchives.begin());
+		clearFilePathCache();
 	}
 
 	void addLocalArchive(Archive* archive)
 	{
 		s_localArchives.push_back(archive);
+		clearFilePathCache();
 	}
 
 	void removeLastArchive()
 	{
 		s_localArchives.pop_back();
+		clearFilePathCache();
+	}
+
+	void clearFilePathCache()
+	{
+		s_filePathCache.clear();
+	}
+
+	static std::string getFilePathCacheKey(const char* fileName)
+	{
+		std::string key = fileName;
+		for (size_t i = 0; i < key.length(); i++)
+		{
+			key[i] = tolower(key[i]);
+		}
+		return key;
+	}
+
+	static bool cacheFilePath(const std::string& key, FilePath* outPath, bool found)
+	{
+		CachedFilePath& entry = s_filePathCache[key];
+		entry.found = found;
+		entry.archive = outPath->archive;
+		entry.index = outPath->index;
+		entry.path = outPath->path;
+		return found;
 	}
 
 	bool getFilePath(const char* fileName, FilePath* outPath)
@@ -321,6 +366,17 @@ namespace TFE_Paths
 			}
 		}
 
+		// Then check for previously resolved paths.
+		const std::string key = getFilePathCacheKey(fileName);
+		const auto cached = s_filePathCache.find(key);
+		if (cached != s_filePathCache.end())
+		{
+			outPath->archive = cached->second.archive;
+			outPath->index = cached->second.index;
+			strncpy(outPath->path, cached->second.path.c_str(), TFE_MAX_PATH);
+			return cached->second.found;
+		}
+
 		// Search in the local search paths before local archives: s_searchPaths.
 		const size_t pathCount = s_searchPaths.size();
 		const std::string* localPath = s_searchPaths.data();
@@ -333,7 +389,7 @@ namespace TFE_Paths
 			if (file.exists(fullName))
 			{
 				strncpy(outPath->path, fullName, TFE_MAX_PATH);
-				return true;
+				return cacheFilePath(key, outPath, true);
 			}
 		}
 
@@ -349,12 +405,12 @@ namespace TFE_Paths
 			{
 				outPath->archive = *archive;
 				outPath->index = index;
-				return true;
+				return cacheFilePath(key, outPath, true);
 			}
 		}
 
 		// Finally admit defeat.
-		return false;
+		return cacheFilePath(key, outPath, false);
 	}
 		
 	bool insertString(char* text, const char* newFragment, const char* pattern)
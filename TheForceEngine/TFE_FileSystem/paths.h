@@ -54,6 +54,9 @@ namespace TFE_Paths
 	void addLocalArchiveToFront(Archive* archive);
 	void removeFirstArchive();
 	bool getFilePath(const char* fileName, FilePath* path);
+	// Resolved file paths are cached and invalidated when search paths, archives or file mappings change.
+	// Call this if files are written into a search path after they may have been queried.
+	void clearFilePathCache();
 	void getAllFilesFromSearchPaths(const char* subdirectory, const char* ext, FileList& allFiles);
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
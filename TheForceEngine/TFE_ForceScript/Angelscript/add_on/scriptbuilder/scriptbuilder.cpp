@@ -1,4 +1,5 @@
 #include <TFE_FileSystem/filestream.h>
+#include <TFE_System/hash.h>
 #include "scriptbuilder.h"
 #include <vector>
 #include <assert.h>
@@ -35,6 +36,7 @@ CScriptBuilder::CScriptBuilder()
 	pragmaParam = 0;
 
 	readStd = true;
+	sourceHash = TFE_Hash::c_fnv64Offset;
 }
 
 void CScriptBuilder::SetIncludeCallback(INCLUDECALLBACK_t callback, void *userParam)
@@ -96,6 +98,11 @@ string CScriptBuilder::GetSectionName(unsigned int idx) const
 	return *it;
 }
 
+unsigned long long CScriptBuilder::GetSourceHash() const
+{
+	return sourceHash;
+}
+
 // Returns 1 if the section was included
 // Returns 0 if the section was not included because it had already been included before
 // Returns <0 if there was an error
@@ -159,6 +166,7 @@ void CScriptBuilder::DefineWord(const char *word)
 void CScriptBuilder::ClearAll()
 {
 	includedScripts.clear();
+	sourceHash = TFE_Hash::c_fnv64Offset;
 
 #if AS_PROCESS_METADATA == 1
 	currentClass = "";
@@ -284,6 +292,10 @@ int CScriptBuilder::ProcessScriptSection(const char *script, unsigned int length
 	else
 		modifiedScript = script;
 
+	// TFE: Hash the unmodified source, used as the bytecode cache key.
+	sourceHash = TFE_Hash::hashString64(sourceHash, sectionname);
+	sourceHash = TFE_Hash::hash64(sourceHash, modifiedScript.data(), modifiedScript.size());
+
 	// First perform the checks for #if directives to exclude code that shouldn't be compiled
 	unsigned int pos = 0;
 	int nested = 0;
@@ -101,6 +101,9 @@ public:
 	unsigned int GetSectionCount() const;
 	std::string  GetSectionName(unsigned int idx) const;
 
+	// TFE: Hash of the name and source of every section processed since StartNewModule().
+	unsigned long long GetSourceHash() const;
+
 #if AS_PROCESS_METADATA == 1
 	// Get metadata declared for classes, interfaces, and enums
 	std::vector<std::string> GetMetadataForType(int typeId);
@@ -131,6 +134,7 @@ protected:
 	void OverwriteCode(int start, int len);
 
 	bool readStd;
+	unsigned long long         sourceHash;
 	asIScriptEngine           *engine;
 	asIScriptModule           *module;
 	std::string                modifiedScript;
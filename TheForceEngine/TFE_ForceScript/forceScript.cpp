@@ -6,7 +6,10 @@
 #include "float3x3.h"
 #include "float4x4.h"
 #include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_System/cacheFile.h>
 #include <TFE_FrontEndUI/frontEndUi.h>
+#include <TFE_FrontEndUI/console.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <stdint.h>
 #include <cstring>
@@ -49,7 +52,27 @@ namespace TFE_ForceScript
 
 	static s32 s_typeId[FSTYPE_COUNT] = { 0 };
 
+	// TFE: Bytecode cache.
+	enum BytecodeCacheConst : u32
+	{
+		BYTECODE_CACHE_MAGIC   = 0x43425346,	// "FSBC"
+		BYTECODE_CACHE_VERSION = 1,
+		// Every edit of a script adds a new file, so only the most recently written modules are kept.
+		BYTECODE_CACHE_MAX_FILES = 256,
+	};
+	struct BytecodeCacheStats
+	{
+		s32 hits;
+		s32 misses;
+		f64 loadTimeMs;
+		f64 compileTimeMs;
+	};
+	static bool s_bytecodeCache = true;
+	static BytecodeCacheStats s_cacheStats = { 0 };
+	static u64 s_apiHash = 0;
+
 	void serializeVariable(Stream* stream, s32 typeId, void*& varAddr, const char* name, bool allocateObjects = false);
+	void console_scriptCacheStats(const std::vector<std::string>& args);
 
 	// Script message callback.
 	void messageCallback(const asSMessageInfo* msg, void* param)
@@ -136,6 +159,10 @@ namespace TFE_ForceScript
 		s_typeId[FSTYPE_FLOAT4x4] = getFloat4x4ObjectId();
 
 		s_modules.clear();
+		updateApiHash();
+
+		CVAR_BOOL(s_bytecodeCache, "fs_bytecodeCache", CVFLAG_DO_NOT_SERIALIZE, "Load compiled scripts from the bytecode cache when the source and script API have not changed.");
+		CCMD("fs_cacheStats", console_scriptCacheStats, 0, "Show the script bytecode cache hits, misses and load/compile times.");
 	}
 
 	void destroy()
@@ -697,6 +724,252 @@ namespace TFE_ForceScript
 		s_freeThreads.clear();
 	}
 
+	/////////////////////////////////////////////
+	// TFE: Bytecode cache
+	// Compiled modules are saved to the program data directory, keyed
+	// by a hash of the script API, the access mask and every script
+	// section (including #includes). Changing any of them results in a
+	// new key, so stale bytecode is never loaded.
+	/////////////////////////////////////////////
+	class BytecodeStream : public asIBinaryStream
+	{
+	public:
+		BytecodeStream(std::vector<u8>* data, size_t readPos = 0) : m_data(data), m_readPos(readPos) {}
+
+		int Read(void* ptr, asUINT size) override
+		{
+			if (m_readPos + size > m_data->size()) { return asERROR; }
+			memcpy(ptr, m_data->data() + m_readPos, size);
+			m_readPos += size;
+			return asSUCCESS;
+		}
+
+		int Write(const void* ptr, asUINT size) override
+		{
+			const u8* bytes = (const u8*)ptr;
+			m_data->insert(m_data->end(), bytes, bytes + size);
+			return asSUCCESS;
+		}
+
+	private:
+		std::vector<u8>* m_data;
+		size_t m_readPos;
+	};
+
+	// Values are hashed as 32 bits, so the key does not depend on the integer types the API uses.
+	static u64 hashValue(u64 hash, u32 value)
+	{
+		return TFE_Hash::hashValue64(hash, value);
+	}
+
+	static u64 hashFunction(u64 hash, const asIScriptFunction* func)
+	{
+		if (!func) { return hash; }
+		hash = TFE_Hash::hashString64(hash, func->GetDeclaration(true, true, true));
+		return hashValue(hash, func->GetAccessMask());
+	}
+
+	// Hash everything registered with the engine that compiled bytecode can refer to.
+	static u64 computeApiHash()
+	{
+		u64 hash = TFE_Hash::c_fnv64Offset;
+		hash = TFE_Hash::hashString64(hash, ANGELSCRIPT_VERSION_STRING);
+		hash = hashValue(hash, u32(sizeof(void*)));
+
+		const asUINT funcCount = s_engine->GetGlobalFunctionCount();
+		for (asUINT i = 0; i < funcCount; i++)
+		{
+			hash = hashFunction(hash, s_engine->GetGlobalFunctionByIndex(i));
+		}
+
+		const asUINT propCount = s_engine->GetGlobalPropertyCount();
+		for (asUINT i = 0; i < propCount; i++)
+		{
+			const char* name = nullptr;
+			const char* nameSpace = nullptr;
+			s32 typeId = 0;
+			bool isConst = false;
+			asDWORD accessMask = 0;
+			s_engine->GetGlobalPropertyByIndex(i, &name, &nameSpace, &typeId, &isConst, nullptr, nullptr, &accessMask);
+			hash = TFE_Hash::hashString64(hash, nameSpace);
+			hash = TFE_Hash::hashString64(hash, name);
+			hash = TFE_Hash::hashString64(hash, s_engine->GetTypeDeclaration(typeId, true));
+			hash = hashValue(hash, isConst ? 1u : 0u);
+			hash = hashValue(hash, accessMask);
+		}
+
+		const asUINT typeCount = s_engine->GetObjectTypeCount();
+		for (asUINT i = 0; i < typeCount; i++)
+		{
+			const asITypeInfo* type = s_engine->GetObjectTypeByIndex(i);
+			hash = TFE_Hash::hashString64(hash, type->GetNamespace());
+			hash = TFE_Hash::hashString64(hash, type->GetName());
+			hash = hashValue(hash, u32(type->GetFlags()));
+			hash = hashValue(hash, type->GetSize());
+			hash = hashValue(hash, type->GetAccessMask());
+
+			const asUINT factoryCount = type->GetFactoryCount();
+			for (asUINT f = 0; f < factoryCount; f++)
+			{
+				hash = hashFunction(hash, type->GetFactoryByIndex(f));
+			}
+			const asUINT behaviourCount = type->GetBehaviourCount();
+			for (asUINT b = 0; b < behaviourCount; b++)
+			{
+				asEBehaviours behaviour;
+				hash = hashFunction(hash, type->GetBehaviourByIndex(b, &behaviour));
+				hash = hashValue(hash, u32(behaviour));
+			}
+			const asUINT methodCount = type->GetMethodCount();
+			for (asUINT m = 0; m < methodCount; m++)
+			{
+				hash = hashFunction(hash, type->GetMethodByIndex(m));
+			}
+			const asUINT typePropCount = type->GetPropertyCount();
+			for (asUINT p = 0; p < typePropCount; p++)
+			{
+				hash = TFE_Hash::hashString64(hash, type->GetPropertyDeclaration(p, true));
+			}
+		}
+
+		const asUINT enumCount = s_engine->GetEnumCount();
+		for (asUINT i = 0; i < enumCount; i++)
+		{
+			const asITypeInfo* enumType = s_engine->GetEnumByIndex(i);
+			hash = TFE_Hash::hashString64(hash, enumType->GetNamespace());
+			hash = TFE_Hash::hashString64(hash, enumType->GetName());
+			const asUINT valueCount = enumType->GetEnumValueCount();
+			for (asUINT v = 0; v < valueCount; v++)
+			{
+				s32 value = 0;
+				hash = TFE_Hash::hashString64(hash, enumType->GetEnumValueByIndex(v, &value));
+				hash = hashValue(hash, u32(value));
+			}
+		}
+
+		const asUINT funcdefCount = s_engine->GetFuncdefCount();
+		for (asUINT i = 0; i < funcdefCount; i++)
+		{
+			hash = hashFunction(hash, s_engine->GetFuncdefByIndex(i)->GetFuncdefSignature());
+		}
+
+		const asUINT typedefCount = s_engine->GetTypedefCount();
+		for (asUINT i = 0; i < typedefCount; i++)
+		{
+			const asITypeInfo* typeDef = s_engine->GetTypedefByIndex(i);
+			hash = TFE_Hash::hashString64(hash, typeDef->GetNamespace());
+			hash = TFE_Hash::hashString64(hash, typeDef->GetName());
+			hash = TFE_Hash::hashString64(hash, s_engine->GetTypeDeclaration(typeDef->GetTypedefTypeId(), true));
+		}
+		return hash;
+	}
+
+	void updateApiHash()
+	{
+		if (!s_engine) { return; }
+		s_apiHash = computeApiHash();
+	}
+
+	// Computes the cache key for the sections added to the builder, returns 0 if the module should not be cached.
+	// The builder hashes each section as it is loaded, so the source is not read again here.
+	static u64 computeModuleKey(const CScriptBuilder& builder, u32 accessMask)
+	{
+		if (!s_bytecodeCache) { return 0; }
+
+		const u64 sourceHash = builder.GetSourceHash();
+		u64 key = hashValue(s_apiHash, accessMask);
+		key = TFE_Hash::hash64(key, &sourceHash, sizeof(u64));
+		// Zero is reserved for "do not cache".
+		return key ? key : 1;
+	}
+
+	static void getBytecodeCacheName(u64 key, char* name)
+	{
+		snprintf(name, TFE_MAX_PATH, "%016llx.fsc", (unsigned long long)key);
+	}
+
+	// Creates the module from cached bytecode. Note this replaces any module with the same name.
+	static asIScriptModule* loadCachedModule(const char* moduleName, u32 accessMask, u64 key, bool* loadFailed)
+	{
+		*loadFailed = false;
+		if (!key) { return nullptr; }
+
+		char cacheName[TFE_MAX_PATH];
+		getBytecodeCacheName(key, cacheName);
+		std::vector<u8> data;
+		if (!TFE_CacheFile::read("ScriptCache/", cacheName, BYTECODE_CACHE_MAGIC, BYTECODE_CACHE_VERSION, key, data))
+		{
+			return nullptr;
+		}
+
+		asIScriptModule* mod = s_engine->GetModule(moduleName, asGM_ALWAYS_CREATE);
+		if (!mod) { return nullptr; }
+		mod->SetAccessMask(accessMask);
+
+		BytecodeStream stream(&data);
+		if (mod->LoadByteCode(&stream) < 0)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Force Script", "Cannot load cached bytecode for module '%s', recompiling.", moduleName);
+			mod->Discard();
+			*loadFailed = true;
+			return nullptr;
+		}
+		return mod;
+	}
+
+	static void saveCachedModule(asIScriptModule* mod, u64 key)
+	{
+		if (!key || !mod) { return; }
+
+		std::vector<u8> data;
+		BytecodeStream stream(&data);
+		// Keep the debug info so that script errors still report line numbers.
+		if (mod->SaveByteCode(&stream, false) < 0) { return; }
+
+		char cacheName[TFE_MAX_PATH];
+		getBytecodeCacheName(key, cacheName);
+		TFE_CacheFile::write("ScriptCache/", cacheName, BYTECODE_CACHE_MAGIC, BYTECODE_CACHE_VERSION, key, data.data(), data.size(), BYTECODE_CACHE_MAX_FILES);
+	}
+
+	// Loads the module from the cache if possible, otherwise builds it and saves the result to the cache.
+	// Returns null on a build error, or if cached bytecode failed to load (the caller should start over without the cache).
+	static asIScriptModule* buildModuleCached(CScriptBuilder& builder, const char* moduleName, u32 accessMask, u64 key, u64 startTicks, bool* loadFailed)
+	{
+		asIScriptModule* mod = loadCachedModule(moduleName, accessMask, key, loadFailed);
+		if (mod)
+		{
+			s_cacheStats.hits++;
+			s_cacheStats.loadTimeMs += TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - startTicks);
+			return mod;
+		}
+		if (*loadFailed)
+		{
+			return nullptr;
+		}
+
+		if (builder.BuildModule() < 0)
+		{
+			return nullptr;
+		}
+		mod = builder.GetModule();
+		saveCachedModule(mod, key);
+
+		s_cacheStats.misses++;
+		s_cacheStats.compileTimeMs += TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - startTicks);
+		return mod;
+	}
+
+	void console_scriptCacheStats(const std::vector<std::string>& args)
+	{
+		char line[256];
+		sprintf(line, "Script bytecode cache %s.", s_bytecodeCache ? "enabled" : "disabled");
+		TFE_Console::addToHistory(line);
+		sprintf(line, "  Hits:   %d, total load time:    %.2f ms", s_cacheStats.hits, s_cacheStats.loadTimeMs);
+		TFE_Console::addToHistory(line);
+		sprintf(line, "  Misses: %d, total compile time: %.2f ms", s_cacheStats.misses, s_cacheStats.compileTimeMs);
+		TFE_Console::addToHistory(line);
+	}
+
 	void* getEngine()
 	{
 		return s_engine;
@@ -724,8 +997,9 @@ namespace TFE_ForceScript
 		}
 	}
 				
-	ModuleHandle createModule(const char* moduleName, const char* filePath, bool allowReadFromArchive, u32 accessMask)
+	static ModuleHandle createModuleFromFile(const char* moduleName, const char* filePath, bool allowReadFromArchive, u32 accessMask, bool useCache)
 	{
+		const u64 startTicks = TFE_System::getCurrentTimeInTicks();
 		CScriptBuilder builder;
 		builder.SetReadMode(!allowReadFromArchive); // true to read from disk, false to read from the TFE filesystem.
 		s32 res = builder.StartNewModule(s_engine, moduleName);
@@ -746,21 +1020,23 @@ namespace TFE_ForceScript
 		{
 			return nullptr;
 		}
-		res = builder.BuildModule();
-		if (res < 0)
+		const u64 key = useCache ? computeModuleKey(builder, accessMask) : 0;
+		bool loadFailed;
+		mod = buildModuleCached(builder, moduleName, accessMask, key, startTicks, &loadFailed);
+		if (loadFailed)
 		{
-			return nullptr;
+			return createModuleFromFile(moduleName, filePath, allowReadFromArchive, accessMask, false);
 		}
-		mod = builder.GetModule();
 		if (mod)
 		{
 			s_modules.push_back({ moduleName, filePath, allowReadFromArchive, accessMask, mod });
 		}
 		return mod;
 	}
-					
-	ModuleHandle createModule(const char* moduleName, const char* sectionName, const char* srcCode, u32 accessMask)
+
+	static ModuleHandle createModuleFromMemory(const char* moduleName, const char* sectionName, const char* srcCode, u32 accessMask, bool useCache)
 	{
+		const u64 startTicks = TFE_System::getCurrentTimeInTicks();
 		CScriptBuilder builder;
 		s32 res = builder.StartNewModule(s_engine, moduleName);
 		if (res < 0)
@@ -780,12 +1056,24 @@ namespace TFE_ForceScript
 		{
 			return nullptr;
 		}
-		res = builder.BuildModule();
-		if (res < 0)
+		const u64 key = useCache ? computeModuleKey(builder, accessMask) : 0;
+		bool loadFailed;
+		mod = buildModuleCached(builder, moduleName, accessMask, key, startTicks, &loadFailed);
+		if (loadFailed)
 		{
-			return nullptr;
+			return createModuleFromMemory(moduleName, sectionName, srcCode, accessMask, false);
 		}
-		return builder.GetModule();
+		return mod;
+	}
+
+	ModuleHandle createModule(const char* moduleName, const char* filePath, bool allowReadFromArchive, u32 accessMask)
+	{
+		return createModuleFromFile(moduleName, filePath, allowReadFromArchive, accessMask, true);
+	}
+
+	ModuleHandle createModule(const char* moduleName, const char* sectionName, const char* srcCode, u32 accessMask)
+	{
+		return createModuleFromMemory(moduleName, sectionName, srcCode, accessMask, true);
 	}
 
 	FunctionHandle findScriptFuncByDecl(ModuleHandle modHandle, const char* funcDecl)
@@ -75,6 +75,8 @@ namespace TFE_ForceScript
 
 	// Allow other systems to access the underlying engine.
 	void* getEngine();
+	// Call after registering script API, the API hash is part of the bytecode cache key.
+	void updateApiHash();
 
 	// Compile module.
 	ModuleHandle getModule(const char* moduleName);
@@ -8,6 +8,7 @@
 #include <TFE_Editor/editor.h>
 #include <TFE_Editor/errorMessages.h>
 #include <TFE_ForceScript/forceScript.h>
+#include <TFE_FileSystem/paths.h>
 #include <TFE_Editor/LevelEditor/infoPanel.h>
 #include <TFE_Editor/EditorAsset/editorTexture.h>
 #include <TFE_Editor/EditorAsset/editorFrame.h>
@@ -78,6 +79,7 @@ namespace TFE_ScriptInterface
 				TFE_DarkForces::registerScriptFunctions(api);
 			} break;
 		}
+		TFE_ForceScript::updateApiHash();
 	}
 
 	template<typename... Args>
@@ -102,6 +104,8 @@ namespace TFE_ScriptInterface
 	{
 		// Delete the existing module if it exists.
 		TFE_ForceScript::deleteModule(scriptName);
+		// The script may have been added to a search path since it was last looked up.
+		TFE_Paths::clearFilePathCache();
 
 		char scriptPath[TFE_MAX_PATH];
 		TFE_ForceScript::ModuleHandle scriptMod = nullptr;
@@ -1253,6 +1253,18 @@ namespace TFE_FrontEndUI
 			gameSettings->df_jsonAiLogics = jsonAiLogics;
 		}
 
+		bool interpolateFrames = gameSettings->df_interpolateFrames;
+		if (ImGui::Checkbox("Fixed simulation rate with interpolated frames", &interpolateFrames))
+		{
+			gameSettings->df_interpolateFrames = interpolateFrames;
+		}
+		Tooltip("Run the game simulation at a fixed rate and draw blended frames in between, so that motion stays smooth at any refresh rate.");
+		if (gameSettings->df_interpolateFrames)
+		{
+			ImGui::SetNextItemWidth(196.0f * s_uiScale);
+			ImGui::SliderInt("Simulation Rate (Hz)", &gameSettings->df_simulationRate, 30, 145);
+		}
+
 		if (s_drawNoGameDataMsg)
 		{
 			ImGui::Separator();
@@ -3056,6 +3068,12 @@ namespace TFE_FrontEndUI
 			graphics->asyncFramebuffer = true;
 			graphics->gpuColorConvert = true;
 			ImGui::Checkbox("Extend Adjoin/Portal Limits", &graphics->extendAjoinLimits);
+			ImGui::Checkbox("Multithreaded Rendering", &graphics->softwareThreads);
+			if (graphics->softwareThreads)
+			{
+				ImGui::SetNextItemWidth(196 * s_uiScale);
+				ImGui::SliderInt("Threads (0 = auto)", &graphics->softwareThreadCount, 0, 32);
+			}
 		}
 		else if (graphics->rendererIndex == 1)
 		{
@@ -3398,8 +3416,15 @@ namespace TFE_FrontEndUI
 			sound->disableSoundInMenus = disableSoundInMenus;
 		}
 
+		ImGui::SetNextItemWidth(196.0f * s_uiScale);
+		ImGui::SliderInt("Music Render Ahead (ms)", &sound->musicRenderAhead, 0, 2000);
+		Tooltip("Synthesize the music ahead of time on the music thread instead of in the audio callback.\n"
+			"Helps avoid crackling with the software synthesizers on slower machines, but music changes are delayed by the same amount.\n"
+			"0 = disabled.");
+
 		TFE_Audio::setVolume(sound->soundFxVolume * sound->masterVolume);
 		TFE_MidiPlayer::setVolume(sound->musicVolume * sound->masterVolume);
+		TFE_MidiPlayer::setRenderAhead(sound->musicRenderAhead);
 	}
 
 	void configSystem()
@@ -3431,6 +3456,13 @@ namespace TFE_FrontEndUI
 		}
 		Tooltip("Appears in upper-left corner of screen. If disabled, a generic 'recording saved' message will be shown instead.");
 
+		bool backgroundSaves = system->backgroundSaves;
+		if (ImGui::Checkbox("Background saves", &backgroundSaves))
+		{
+			system->backgroundSaves = backgroundSaves;
+		}
+		Tooltip("Compress and write save games on a background thread to avoid a hitch when saving. Compressed saves cannot be loaded by older versions.");
+
 	#ifdef _WIN32
 		ImGui::Separator();
 		if (ImGui::Button("Open Log Folder"))
@@ -9,20 +9,47 @@
 #include <TFE_Ui/ui.h>
 #include <TFE_Ui/markdown.h>
 #include <TFE_System/parser.h>
+#include <TFE_FrontEndUI/console.h>
 
 #include <algorithm>
 
 namespace TFE_ProfilerView
 {
 	static bool s_open = false;
+	static bool s_traceOnExit = false;
+
+	void console_writeTrace(const ConsoleArgList& args);
+
+	static bool writeTrace(const char* fileName)
+	{
+		char filePath[TFE_MAX_PATH];
+		sprintf(filePath, "%s%s", TFE_Paths::getPath(PATH_USER_DOCUMENTS), fileName);
+		return TFE_Profiler::writeTrace(filePath);
+	}
 
 	bool init()
 	{
+		CVAR_BOOL(s_traceOnExit, "profilerTraceOnExit", CVFLAG_NONE, "Write the profiler trace to \"profilerTrace.json\" in the user documents folder on exit.");
+		CCMD("profilerTrace", console_writeTrace, 0, "Write recent profiler zones as Chrome Trace JSON, optionally pass the file name (default: profilerTrace.json).");
 		return true;
 	}
 
 	void destroy()
 	{
+		// The console has already been shutdown, the result is logged.
+		if (s_traceOnExit)
+		{
+			writeTrace("profilerTrace.json");
+		}
+	}
+
+	void console_writeTrace(const ConsoleArgList& args)
+	{
+		const char* fileName = args.size() > 1 ? args[1].c_str() : "profilerTrace.json";
+		char msg[TFE_MAX_PATH + 64];
+		sprintf(msg, writeTrace(fileName) ? "Profiler trace written to \"%s%s\"" : "Cannot write profiler trace to \"%s%s\"",
+			TFE_Paths::getPath(PATH_USER_DOCUMENTS), fileName);
+		TFE_Console::addToHistory(msg);
 	}
 
 	void update()
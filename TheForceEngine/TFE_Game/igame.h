@@ -26,6 +26,8 @@ struct IGame
 	virtual void pauseSound(bool pause) = 0;
 	virtual void restartMusic() = 0;
 	virtual void loopGame() {};
+	// TFE: Called instead of the tasks on frames where no simulation step is due.
+	virtual void drawInterpolatedFrame() {};
 	virtual bool serializeGameState(Stream* stream, const char* filename, bool writeState) { return false; };
 	virtual bool canSave() { return false; }
 	virtual bool isPaused() { return false; }
@@ -2,10 +2,14 @@
 #include <TFE_Input/inputMapping.h>
 #include <TFE_System/system.h>
 #include <TFE_Settings/gameSourceData.h>
+#include <TFE_Settings/settings.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_Archive/zstdCompression.h>
 
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Asset/imageAsset.h>
+#include <SDL_thread.h>
 #include <cassert>
 #include <cstring>
 
@@ -27,6 +31,24 @@ namespace TFE_SaveSystem
 		SVER_CUR = SVER_REPLAY
 	};
 
+	// Background saves store the game state compressed, following the (uncompressed) header
+	// so the save directory can still be read quickly:
+	// [Header][SAVE_COMPRESSED_TAG][u32 uncompressedSize][u32 compressedSize][compressed game state]
+	// The game state always begins with the game serialization version, which will never match the tag.
+	enum SaveCompression : u32
+	{
+		SAVE_COMPRESSED_TAG = 0x5a454654,	// "TFEZ"
+		SAVE_COMPRESSION_LEVEL = 3,
+	};
+
+	// The save currently being compressed and written on the save thread.
+	struct PendingSave
+	{
+		char filePath[TFE_MAX_PATH];
+		MemoryStream header;
+		MemoryStream state;
+	};
+
 	static SaveRequest s_req = SF_REQ_NONE;
 	static char s_reqFilename[TFE_MAX_PATH];
 	static char s_reqSavename[TFE_MAX_PATH];
@@ -37,6 +59,114 @@ namespace TFE_SaveSystem
 	static u32* s_imageBuffer[2] = { nullptr, nullptr };
 	static size_t s_imageBufferSize[2] = { 0 };
 
+	static PendingSave s_pendingSave;
+	static SDL_Thread* s_saveThread = nullptr;
+	static std::vector<u8> s_compressedState;
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static s32 saveThreadFunc(void* userData)
+	{
+		PendingSave* save = (PendingSave*)userData;
+		const u8* state = (const u8*)save->state.data();
+		const u32 stateSize = (u32)save->state.getSize();
+		if (!zstd_compress(s_compressedState, state, stateSize, SAVE_COMPRESSION_LEVEL))
+		{
+			TFE_System::logWrite(LOG_ERROR, "SaveSystem", "Failed to compress save '%s'.", save->filePath);
+			return 0;
+		}
+
+		FileStream stream;
+		if (!stream.open(save->filePath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "SaveSystem", "Failed to open '%s' for writing.", save->filePath);
+			return 0;
+		}
+		const u32 tag = SAVE_COMPRESSED_TAG;
+		const u32 compressedSize = (u32)s_compressedState.size();
+		stream.writeBuffer(save->header.data(), (u32)save->header.getSize());
+		stream.write(&tag);
+		stream.write(&stateSize);
+		stream.write(&compressedSize);
+		stream.writeBuffer(s_compressedState.data(), compressedSize);
+		stream.close();
+		return 1;
+	}
+
+	// Block until the previous background save has been written, so it can be read or replaced.
+	static void waitForPendingSave()
+	{
+		if (s_saveThread)
+		{
+			SDL_WaitThread(s_saveThread, nullptr);
+			s_saveThread = nullptr;
+		}
+	}
+
+	// Serialize the game state into memory on the game thread, then compress and write it in the background.
+	static bool saveGameBackground(const char* filePath, const char* filename, const char* saveName)
+	{
+		waitForPendingSave();
+
+		PendingSave* save = &s_pendingSave;
+		strcpy(save->filePath, filePath);
+		save->header.clear();
+		save->state.clear();
+		if (!save->header.open(Stream::MODE_WRITE) || !save->state.open(Stream::MODE_WRITE))
+		{
+			return false;
+		}
+
+		saveHeader(&save->header, saveName);
+		const bool ret = s_game->serializeGameState(&save->state, filename, true);
+		save->header.close();
+		save->state.close();
+		if (!ret) { return false; }
+
+		s_saveThread = SDL_CreateThread(saveThreadFunc, "TFE_SaveThread", save);
+		if (!s_saveThread)
+		{
+			// Fallback to writing the save immediately.
+			return saveThreadFunc(save) != 0;
+		}
+		return true;
+	}
+
+	// Load the game state which follows the header, decompressing it first if required.
+	static bool loadGameState(Stream* stream, const char* filename)
+	{
+		u32 tag = 0;
+		stream->read(&tag);
+		if (tag != SAVE_COMPRESSED_TAG)
+		{
+			stream->seek(-(s32)sizeof(u32), Stream::ORIGIN_CURRENT);
+			return s_game->serializeGameState(stream, filename, false);
+		}
+
+		u32 stateSize, compressedSize;
+		stream->read(&stateSize);
+		stream->read(&compressedSize);
+		s_compressedState.resize(compressedSize);
+		if (!stateSize || stream->readBuffer(s_compressedState.data(), compressedSize) != compressedSize)
+		{
+			return false;
+		}
+
+		MemoryStream state;
+		if (!state.allocate(stateSize) || !zstd_decompress((u8*)state.data(), stateSize, s_compressedState.data(), compressedSize))
+		{
+			TFE_System::logWrite(LOG_ERROR, "SaveSystem", "Failed to decompress save '%s'.", filename);
+			return false;
+		}
+		state.open(Stream::MODE_READ);
+		return s_game->serializeGameState(&state, filename, false);
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+
 	bool versionValid(s32 version)
 	{
 		return version == SVER_CUR;
@@ -190,6 +320,7 @@ namespace TFE_SaveSystem
 
 	void populateSaveDirectory(std::vector<SaveHeader>& dir)
 	{
+		waitForPendingSave();
 		dir.clear();
 		FileList fileList;
 		FileUtil::readDirectory(s_gameSavePath, "tfe", fileList);
@@ -210,6 +341,10 @@ namespace TFE_SaveSystem
 
 	void destroy()
 	{
+		waitForPendingSave();
+		s_compressedState.clear();
+		s_compressedState.shrink_to_fit();
+
 		for (s32 i = 0; i < 2; i++)
 		{
 			free(s_imageBuffer[i]);
@@ -222,6 +357,11 @@ namespace TFE_SaveSystem
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		if (TFE_Settings::getSystemSettings()->backgroundSaves)
+		{
+			return saveGameBackground(filePath, filename, saveName);
+		}
+		waitForPendingSave();
 
 		bool ret = false;
 		FileStream stream;
@@ -238,6 +378,7 @@ namespace TFE_SaveSystem
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		waitForPendingSave();
 
 		bool ret = false;
 		FileStream stream;
@@ -245,7 +386,7 @@ namespace TFE_SaveSystem
 		{
 			SaveHeader header;
 			loadHeader(&stream, &header, filename);
-			ret = s_game->serializeGameState(&stream, filename, false);
+			ret = loadGameState(&stream, filename);
 			stream.close();
 		}
 		return ret;
@@ -255,6 +396,7 @@ namespace TFE_SaveSystem
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		waitForPendingSave();
 
 		bool ret = false;
 		FileStream stream;
@@ -23,6 +23,7 @@
 #include <TFE_FrontEndUI/modLoader.h>
 #include <TFE_Game/saveSystem.h>
 #include <TFE_Input/inputMapping.h>
+#include <TFE_Input/replayBenchmark.h>
 #include <TFE_Jedi/Renderer/rcommon.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 #include <TFE_System/frameLimiter.h>
@@ -743,6 +744,14 @@ namespace TFE_Input
 
 	void handleFrameRate()
 	{
+		// Benchmarks always run as fast as possible.
+		if (replayBenchmark_enabled())
+		{
+			TFE_System::frameLimiter_set(0);
+			TFE_System::setVsync(false);
+			return;
+		}
+
 		// Set the frame rate for replay playback.
 		string framePlaybackStr = TFE_FrontEndUI::getPlaybackFramerate();
 
@@ -841,6 +850,10 @@ namespace TFE_Input
 		TFE_Settings_Graphics* graphicSetting = TFE_Settings::getGraphicsSettings();
 		replayGraphicsType = graphicSetting->rendererIndex;
 		graphicSetting->rendererIndex = 1;
+		if (replayBenchmark_enabled() && TFE_Settings::getTempSettings()->benchmark_renderer >= 0)
+		{
+			graphicSetting->rendererIndex = TFE_Settings::getTempSettings()->benchmark_renderer;
+		}
 		
 		// Preserve the original frame rate
 		gameFrameLimit = TFE_System::frameLimiter_get();
@@ -1073,6 +1086,7 @@ namespace TFE_Input
 
 		// Initialize Demo Playback
 		setDemoPlayback(true);
+		replayBenchmark_begin(vsyncEnabled);
 
 		// Reset the eye
 		TFE_DarkForces::player_clearEyeObject();
@@ -1126,6 +1140,9 @@ namespace TFE_Input
 
 	void endReplay()
 	{
+		// Report before the level state is torn down so the state hash is valid.
+		replayBenchmark_end();
+
 		replayInitialized = false;
 		replayFilehandler = -1;
 		setDemoPlayback(false);
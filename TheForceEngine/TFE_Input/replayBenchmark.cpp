@@ -0,0 +1,198 @@
+#include <cstdio>
+#include <TFE_Input/replayBenchmark.h>
+#include <TFE_Input/replay.h>
+#include <TFE_Settings/settings.h>
+#include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_DarkForces/player.h>
+#include <TFE_DarkForces/time.h>
+#include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/robject.h>
+
+using namespace TFE_Jedi;
+
+namespace TFE_Input
+{
+	enum BenchmarkConstants
+	{
+		BENCH_BUCKET_COUNT = 8,
+	};
+	// Upper bound of each frame time bucket in milliseconds, the last bucket holds everything else.
+	static const f64 c_bucketMaxMs[BENCH_BUCKET_COUNT - 1] = { 1.0, 2.0, 4.0, 8.0, 16.7, 33.3, 66.7 };
+	static const char* c_bucketNames[BENCH_BUCKET_COUNT] =
+	{
+		"   < 1.0 ms",
+		"   < 2.0 ms",
+		"   < 4.0 ms",
+		"   < 8.0 ms",
+		"  < 16.7 ms",
+		"  < 33.3 ms",
+		"  < 66.7 ms",
+		"  >= 66.7 ms",
+	};
+
+	struct ReplayBenchmark
+	{
+		bool active;
+		bool userVsync;
+		u64  startTime;
+		u64  frameStart;
+		Tick startTick;
+
+		u32  frameCount;
+		f64  minFrameMs;
+		f64  maxFrameMs;
+		u32  buckets[BENCH_BUCKET_COUNT];
+	};
+	static ReplayBenchmark s_bench = {};
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static void hashValue(u64* hash, s32 value)
+	{
+		*hash = TFE_Hash::hashValue64(*hash, value);
+	}
+
+	static void hashObject(u64* hash, SecObject* obj)
+	{
+		hashValue(hash, obj->type);
+		hashValue(hash, obj->posWS.x);
+		hashValue(hash, obj->posWS.y);
+		hashValue(hash, obj->posWS.z);
+		hashValue(hash, obj->yaw);
+		hashValue(hash, obj->pitch);
+		hashValue(hash, obj->roll);
+		hashValue(hash, obj->flags);
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+	bool replayBenchmark_enabled()
+	{
+		return TFE_Settings::getTempSettings()->replay_benchmark;
+	}
+
+	void replayBenchmark_begin(bool userVsync)
+	{
+		if (!replayBenchmark_enabled()) { return; }
+
+		s_bench = {};
+		s_bench.active = true;
+		// Vsync is stored in the settings, so it has to be restored before they are written.
+		s_bench.userVsync = userVsync;
+		TFE_System::setVsync(false);
+		s_bench.startTime = TFE_System::getCurrentTimeInTicks();
+		s_bench.frameStart = s_bench.startTime;
+		s_bench.startTick = TFE_DarkForces::s_curTick;
+		s_bench.minFrameMs = 1.0e9;
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "Replay benchmark started.");
+	}
+
+	void replayBenchmark_frame()
+	{
+		if (!s_bench.active || !isDemoPlayback()) { return; }
+
+		const u64 now = TFE_System::getCurrentTimeInTicks();
+		const f64 frameMs = TFE_System::convertFromTicksToMillis(now - s_bench.frameStart);
+		s_bench.frameStart = now;
+
+		s32 bucket = 0;
+		while (bucket < BENCH_BUCKET_COUNT - 1 && frameMs >= c_bucketMaxMs[bucket])
+		{
+			bucket++;
+		}
+		s_bench.buckets[bucket]++;
+		s_bench.frameCount++;
+		if (frameMs < s_bench.minFrameMs) { s_bench.minFrameMs = frameMs; }
+		if (frameMs > s_bench.maxFrameMs) { s_bench.maxFrameMs = frameMs; }
+	}
+
+	void replayBenchmark_end()
+	{
+		if (!s_bench.active) { return; }
+		s_bench.active = false;
+		TFE_System::setVsync(s_bench.userVsync);
+
+		const f64 seconds = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_bench.startTime);
+		const Tick ticks = TFE_DarkForces::s_curTick - s_bench.startTick;
+		const u32 frames = s_bench.frameCount;
+		const f64 safeSeconds = seconds > 0.0 ? seconds : 1.0e-6;
+		const u64 stateHash = replayBenchmark_computeStateHash();
+
+		char line[256];
+		sprintf(line, "Frames: %u, Ticks: %u, Time: %.3f sec", frames, ticks, seconds);
+		printf("[Benchmark] %s\n", line);
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "%s", line);
+
+		sprintf(line, "Ticks/sec: %.1f, Frames/sec: %.1f, Frame ms (min/ave/max): %.3f / %.3f / %.3f",
+			f64(ticks) / safeSeconds, f64(frames) / safeSeconds, frames ? s_bench.minFrameMs : 0.0,
+			frames ? seconds * 1000.0 / f64(frames) : 0.0, s_bench.maxFrameMs);
+		printf("[Benchmark] %s\n", line);
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "%s", line);
+
+		for (s32 i = 0; i < BENCH_BUCKET_COUNT; i++)
+		{
+			const f64 percent = frames ? 100.0 * f64(s_bench.buckets[i]) / f64(frames) : 0.0;
+			sprintf(line, "%s: %8u (%5.1f%%)", c_bucketNames[i], s_bench.buckets[i], percent);
+			printf("[Benchmark] %s\n", line);
+			TFE_System::logWrite(LOG_MSG, "Benchmark", "%s", line);
+		}
+
+		sprintf(line, "State Hash: %016llx", (unsigned long long)stateHash);
+		printf("[Benchmark] %s\n", line);
+		TFE_System::logWrite(LOG_MSG, "Benchmark", "%s", line);
+		fflush(stdout);
+	}
+
+	void replayBenchmark_abort()
+	{
+		if (!s_bench.active) { return; }
+		s_bench.active = false;
+		TFE_System::setVsync(s_bench.userVsync);
+		TFE_System::logWrite(LOG_WARNING, "Benchmark", "Replay benchmark aborted.");
+	}
+
+	u64 replayBenchmark_computeStateHash()
+	{
+		u64 hash = TFE_Hash::c_fnv64Offset;
+		hashValue(&hash, s32(TFE_DarkForces::s_curTick));
+
+		TFE_DarkForces::PlayerInfo* info = &TFE_DarkForces::s_playerInfo;
+		hashValue(&hash, info->health);
+		hashValue(&hash, info->healthFract);
+		hashValue(&hash, info->shields);
+		if (TFE_DarkForces::s_playerEye)
+		{
+			hashObject(&hash, TFE_DarkForces::s_playerEye);
+		}
+
+		const u32 sectorCount = s_levelState.sectorCount;
+		hashValue(&hash, s32(sectorCount));
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; sector && s < sectorCount; s++, sector++)
+		{
+			hashValue(&hash, sector->floorHeight);
+			hashValue(&hash, sector->ceilingHeight);
+			hashValue(&hash, sector->secHeight);
+			hashValue(&hash, s32(sector->flags1));
+
+			const vec2_fixed* vtx = sector->verticesWS;
+			for (s32 v = 0; vtx && v < sector->vertexCount; v++, vtx++)
+			{
+				hashValue(&hash, vtx->x);
+				hashValue(&hash, vtx->z);
+			}
+
+			hashValue(&hash, sector->objectCount);
+			for (s32 i = 0; i < sector->objectCapacity; i++)
+			{
+				SecObject* obj = sector->objectList[i];
+				if (!obj) { continue; }
+				hashObject(&hash, obj);
+			}
+		}
+		return hash;
+	}
+}
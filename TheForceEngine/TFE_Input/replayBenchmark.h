@@ -0,0 +1,28 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Replay Benchmark
+// Measures replay playback with the frame limiter and vsync disabled.
+// Since the game ticks are read back from the demo, the simulation is
+// deterministic regardless of how fast frames are produced - so the
+// final game state hash can be compared between runs and builds.
+//
+// Enabled with --replay_benchmark (implied by --headless).
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_Input
+{
+	bool replayBenchmark_enabled();
+
+	// Called when demo playback starts and ends.
+	// userVsync is the vsync setting from before playback, it is restored when the benchmark ends.
+	void replayBenchmark_begin(bool userVsync);
+	void replayBenchmark_end();
+	// Restores the user settings if the application exits while a benchmark is running.
+	void replayBenchmark_abort();
+	// Called once per frame from the main loop, does nothing unless a benchmark is running.
+	void replayBenchmark_frame();
+
+	// Hash of the deterministic game state: tick, player and sector/object state.
+	u64  replayBenchmark_computeStateHash();
+}
@@ -4,8 +4,12 @@
 #include <TFE_Jedi/Level/rwall.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Level/sectorGrid.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_System/system.h>
+#include <vector>
 // Merge player collision into collision
 #include <TFE_DarkForces/playerCollision.h>
 using namespace TFE_DarkForces;
@@ -54,6 +58,11 @@ namespace TFE_Jedi
 	static const fixed16_16 c_maxCollisionDist = COL_INFINITY;
 	static const fixed16_16 c_minTraversableOpening = HALF_16;
 
+	enum CollisionConstants
+	{
+		COL_MAX_RANGE_SECTORS = 256,	// maximum number of sectors gathered by the range query broadphase.
+	};
+
 	enum IntersectionResult
 	{
 		INTERSECT = 0xffffffff,
@@ -127,6 +136,9 @@ namespace TFE_Jedi
 	
 	static s32 s_colObjCount;
 	fixed16_16 s_colObjOverlap;
+
+	// TFE: Range query broadphase.
+	static JBool s_colRangeBroadphase = JTRUE;
 	
 	////////////////////////////////////////////////////////
 	// Forward Declarations
@@ -432,6 +444,17 @@ namespace TFE_Jedi
 		return (sector == sector1) ? JTRUE : JFALSE;
 	}
 
+	// TFE: Broadphase for the range queries below.
+	// Objects are always inside the bounds of the sector that contains them, so only sectors whose bounds overlap the
+	// query rectangle can contain objects in range. The sectors are returned in ascending order so that objects are
+	// visited in the same order as a linear scan over every sector.
+	// Returns the number of sectors in 'list' or -1 if every sector must be visited.
+	static s32 collision_getSectorsInRange(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1, s32* list)
+	{
+		if (!s_colRangeBroadphase) { return -1; }
+		return sectorGrid_getSectorsInRect(x0, z0, x1, z1, list, COL_MAX_RANGE_SECTORS);
+	}
+
 	// Determines if an object with the correct entityFlag(s) is in range (radius) of (x,y,z) in sector and is not skipObj.
 	// Note only objects with a clear line-of-sight are accepted.
 	JBool collision_isAnyObjectInRange(RSector* sector, fixed16_16 radius, vec3_fixed origin, SecObject* skipObj, u32 entityFlags)
@@ -450,29 +473,25 @@ namespace TFE_Jedi
 		fixed16_16 z1 = origin.z + radius;
 
 		fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* curSector = s_levelState.sectors;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, curSector++)
+		// TFE: These tests only depend on the start sector, so they are done once instead of per sector.
+		if (x0 > sector->boundsMax.x || x1 < sector->boundsMin.x || z0 > sector->boundsMax.z || z1 < sector->boundsMin.z)
 		{
-			///////////////////////////////////////////////
-			// These tests should only happen once I think,
-			// unless x0, x1, z0, z1 change over time.
-			///////////////////////////////////////////////
-			if (x0 > sector->boundsMax.x || x1 < sector->boundsMin.x || z0 > sector->boundsMax.z || z1 < sector->boundsMin.z)
-			{
-				continue;
-			}
-
-			fixed16_16 floorHeight, ceilHeight;
-			sector_calculateFloor(sector, origin.y, &floorHeight, &ceilHeight);
-			if (floorHeight < y0 || ceilHeight > y1)
-			{
-				continue;
-			}
-			/////////////////////////////////////////////
-			// End of checks to pull out of the loop.
-			/////////////////////////////////////////////
+			return JFALSE;
+		}
+		fixed16_16 floorHeight, ceilHeight;
+		sector_calculateFloor(sector, origin.y, &floorHeight, &ceilHeight);
+		if (floorHeight < y0 || ceilHeight > y1)
+		{
+			return JFALSE;
+		}
 
+		s32 sectorList[COL_MAX_RANGE_SECTORS];
+		const s32 listCount = collision_getSectorsInRange(x0, z0, x1, z1, sectorList);
+		const s32 sectorCount = listCount >= 0 ? listCount : s32(s_levelState.sectorCount);
+		for (s32 i = 0; i < sectorCount; i++)
+		{
+			RSector* curSector = &s_levelState.sectors[listCount >= 0 ? sectorList[i] : i];
 			s32 objCapacity = curSector->objectCapacity;
 			s32 objCount = curSector->objectCount;
 			for (s32 objListIndex = 0, objIndex = 0; objIndex < objCount && objListIndex < objCapacity; objListIndex++)
@@ -525,19 +544,22 @@ namespace TFE_Jedi
 		const fixed16_16 z1 = origin.z + range;
 
 		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		if (!s_levelState.sectorCount) { return; }
+		// TFE: The start sector bounds check does not depend on the loop, so it is done once.
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
+			return;
+		}
 
+		s32 sectorList[COL_MAX_RANGE_SECTORS];
+		const s32 listCount = collision_getSectorsInRange(x0, z0, x1, z1, sectorList);
+		const s32 sectorCount = listCount >= 0 ? listCount : s32(s_levelState.sectorCount);
+		for (s32 i = 0; i < sectorCount; i++)
+		{
+			RSector* sector = &s_levelState.sectors[listCount >= 0 ? sectorList[i] : i];
 			fixed16_16 floor, ceil;
 			sector_calculateFloor(sector, origin.y, &floor, &ceil);
 			if (y0 > floor || y1 < ceil) { continue; }
-			// End of start sector check.
 
 			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
 			{
@@ -585,21 +607,24 @@ namespace TFE_Jedi
 		const fixed16_16 z1 = origin.z + range;
 
 		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		// TFE: These tests only depend on the start sector, so they are done once instead of per sector.
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
-			fixed16_16 floor, ceil;
-			sector_calculateFloor(startSector, origin.y, &floor, &ceil);
-			if (y0 > floor || y1 < ceil)
-			{
-				continue;
-			}
-			// End of start sector check.
+			return;
+		}
+		fixed16_16 floor, ceil;
+		sector_calculateFloor(startSector, origin.y, &floor, &ceil);
+		if (y0 > floor || y1 < ceil)
+		{
+			return;
+		}
+
+		s32 sectorList[COL_MAX_RANGE_SECTORS];
+		const s32 listCount = collision_getSectorsInRange(x0, z0, x1, z1, sectorList);
+		const s32 sectorCount = listCount >= 0 ? listCount : s32(s_levelState.sectorCount);
+		for (s32 i = 0; i < sectorCount; i++)
+		{
+			RSector* sector = &s_levelState.sectors[listCount >= 0 ? sectorList[i] : i];
 
 			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
 			{
@@ -1243,4 +1268,104 @@ namespace TFE_Jedi
 
 		return handleCollisionFunc(sector);
 	}
-}
\ No newline at end of file
+
+	/////////////////////////////////////////////
+	// TFE: Range query benchmark
+	/////////////////////////////////////////////
+	static s32 s_benchHitCount = 0;
+
+	static void collision_benchEffect(SecObject* obj)
+	{
+		s_benchHitCount++;
+	}
+
+	static s32 collision_benchRandom(u32* seed, s32 range)
+	{
+		*seed = (*seed) * 1664525u + 1013904223u;
+		return range > 0 ? s32((*seed) % u32(range)) : 0;
+	}
+
+	static f64 collision_benchQueries(const std::vector<SecObject*>& origins, s32 queryCount, fixed16_16 range, s32* hits3D, s32* hitsXZ, s32* hitsAny)
+	{
+		*hits3D = 0;
+		*hitsXZ = 0;
+		*hitsAny = 0;
+
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 q = 0; q < queryCount; q++)
+		{
+			SecObject* origin = origins[q % origins.size()];
+			vec3_fixed pos = origin->posWS;
+			pos.y -= FIXED(2);
+
+			s_benchHitCount = 0;
+			collision_effectObjectsInRange3D(origin->sector, range, pos, collision_benchEffect, origin, ETFLAG_AI_ACTOR);
+			*hits3D += s_benchHitCount;
+
+			s_benchHitCount = 0;
+			collision_effectObjectsInRangeXZ(origin->sector, range, pos, collision_benchEffect, origin, ETFLAG_AI_ACTOR);
+			*hitsXZ += s_benchHitCount;
+
+			*hitsAny += collision_isAnyObjectInRange(origin->sector, range, pos, origin, ETFLAG_AI_ACTOR) ? 1 : 0;
+		}
+		return TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - start);
+	}
+
+	void collision_benchmark(s32 objectCount, s32 queryCount)
+	{
+		if (!s_levelState.sectors || !s_levelState.sectorCount)
+		{
+			TFE_Console::addToHistory("A level must be loaded to run the collision benchmark.");
+			return;
+		}
+		objectCount = max(1, objectCount);
+		queryCount = max(1, queryCount);
+
+		// Scatter test actors across the level, standing on the floor of random sectors.
+		u32 seed = 12345;
+		std::vector<SecObject*> objects;
+		objects.reserve(objectCount);
+		for (s32 i = 0; i < objectCount; i++)
+		{
+			RSector* sector = &s_levelState.sectors[collision_benchRandom(&seed, s32(s_levelState.sectorCount))];
+			const fixed16_16 dx = sector->boundsMax.x - sector->boundsMin.x;
+			const fixed16_16 dz = sector->boundsMax.z - sector->boundsMin.z;
+
+			SecObject* obj = allocateObject();
+			obj->posWS.x = sector->boundsMin.x + collision_benchRandom(&seed, dx + 1);
+			obj->posWS.z = sector->boundsMin.z + collision_benchRandom(&seed, dz + 1);
+			obj->posWS.y = sector->floorHeight;
+			obj->worldWidth = FIXED(1);
+			obj->worldHeight = FIXED(6);
+			obj->entityFlags = ETFLAG_AI_ACTOR;
+			sector_addObjectDirect(sector, obj);
+			objects.push_back(obj);
+		}
+
+		// Thermal detonator sized explosions, centered on the test actors.
+		const fixed16_16 range = FIXED(20);
+		const JBool prevBroadphase = s_colRangeBroadphase;
+		s32 linear3D, linearXZ, linearAny;
+		s32 grid3D, gridXZ, gridAny;
+		s_colRangeBroadphase = JFALSE;
+		const f64 linearMs = collision_benchQueries(objects, queryCount, range, &linear3D, &linearXZ, &linearAny);
+		s_colRangeBroadphase = JTRUE;
+		const f64 gridMs = collision_benchQueries(objects, queryCount, range, &grid3D, &gridXZ, &gridAny);
+		s_colRangeBroadphase = prevBroadphase;
+
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			freeObject(objects[i]);
+		}
+
+		const bool match = linear3D == grid3D && linearXZ == gridXZ && linearAny == gridAny;
+		char line[256];
+		sprintf(line, "Collision range queries: %d actors, %d sectors, %d queries.", objectCount, s_levelState.sectorCount, queryCount);
+		TFE_Console::addToHistory(line);
+		TFE_System::logWrite(LOG_MSG, "Collision", "%s", line);
+		sprintf(line, "linear %.3f ms, broadphase %.3f ms, speedup %.2fx, hits (3D/XZ/any) %d/%d/%d, results %s",
+			linearMs, gridMs, gridMs > 0.0 ? linearMs / gridMs : 0.0, grid3D, gridXZ, gridAny, match ? "identical" : "MISMATCH");
+		TFE_Console::addToHistory(line);
+		TFE_System::logWrite(LOG_MSG, "Collision", "%s", line);
+	}
+}
@@ -110,6 +110,9 @@ namespace TFE_Jedi
 
 	void collision_effectObjectsInRange3D(RSector* startSector, fixed16_16 range, vec3_fixed origin, CollisionEffectFunc effectFunc, SecObject* excludeObj, u32 entityFlags);
 	void collision_effectObjectsInRangeXZ(RSector* startSector, fixed16_16 range, vec3_fixed origin, CollisionEffectFunc effectFunc, SecObject* excludeObj, u32 entityFlags);
+	// TFE: Scatter 'objectCount' test actors across the current level, time the range queries above with and without
+	// the broadphase, then remove the actors.
+	void collision_benchmark(s32 objectCount, s32 queryCount);
 
 	JBool handleCollision(CollisionInfo* colInfo);
 	void handleCollisionResponseSimple(fixed16_16 dirX, fixed16_16 dirZ, fixed16_16* moveX, fixed16_16* moveZ);
@@ -16,9 +16,7 @@ namespace TFE_Jedi
 	#define MAX_SOUND_CHANNELS 16
 	#define DEFAULT_SOUND_CHANNELS 8
 	#define AUDIO_BUFFER_SIZE 512
-	
-	#define AUDIO_LOCK()   TFE_Audio::lock()
-	#define AUDIO_UNLOCK() TFE_Audio::unlock()
+	#define WAVE_CHUNK_SIZE 48
 
 	////////////////////////////////////////////////////
 	// Structures
@@ -55,6 +53,38 @@ namespace TFE_Jedi
 		s32 chunkIndex;
 	};
 
+	// TFE: The mixer's copy of a playing sound, only accessed on the audio thread.
+	// The client (game) side sounds are never touched by the audio thread, instead the client sends
+	// commands to start, stop and update voices and the mixer sends events back when a voice finishes,
+	// hits a marker or fails.
+	struct ImWaveVoice
+	{
+		ImWaveData data;		// data.sound identifies the client sound but is never dereferenced by the mixer.
+		ImSoundId soundId;		// IM_NULL_SOUNDID when the voice is idle.
+		u32 generation;			// Matches the client generation while the voice is playing the same sound.
+		s32 volume;
+		s32 pan;
+		JBool finished;			// The voice finished but the client has not been told yet.
+	};
+
+	struct ImWaveVoiceCmd
+	{
+		s32 voice;
+		u32 generation;
+		ImSoundId soundId;
+		s32 volume;
+		s32 pan;
+		ImWaveData data;
+	};
+
+	struct ImWaveVoiceEvent
+	{
+		s32 voice;
+		u32 generation;
+		s32 value;
+		char marker[WAVE_CHUNK_SIZE - 4];
+	};
+
 	/////////////////////////////////////////////////////
 	// Internal State
 	/////////////////////////////////////////////////////
@@ -63,7 +93,7 @@ namespace TFE_Jedi
 	static ImWaveSound* s_imWaveSoundList = nullptr;
 	static ImWaveSound  s_imWaveSound[MAX_SOUND_CHANNELS];
 	static ImWaveData   s_imWaveData[MAX_SOUND_CHANNELS];
-	static u8  s_imWaveChunkData[48];
+	static u32 s_imWaveGeneration[MAX_SOUND_CHANNELS];
 	static s32 s_imWaveMixCount = DEFAULT_SOUND_CHANNELS;
 	static s32 s_imWaveNanosecsPerSample;
 	static iMuseInitData* s_imDigitalData;
@@ -80,6 +110,8 @@ namespace TFE_Jedi
 	static s16 s_audioOut[AUDIO_BUFFER_SIZE + IM_AUDIO_OVERSAMPLE*2];	// Add 2 stereo samples from the next frame for interpolation.
 	static s32 s_audioOutSize;
 	static u8* s_audioData;
+	// Audio thread state.
+	static ImWaveVoice s_imWaveVoice[MAX_SOUND_CHANNELS];
 			
 	extern s32 ImWrapValue(s32 value, s32 a, s32 b);
 	extern s32 ImGetGroupVolume(s32 group);
@@ -93,8 +125,16 @@ namespace TFE_Jedi
 	s32 ImGetWaveParamIntern(ImSoundId soundId, s32 param);
 	s32 ImFreeWaveSoundByIdIntern(ImSoundId soundId);
 	s32 ImStartDigitalSoundIntern(ImSoundId soundId, s32 priority, s32 chunkIndex);
-	s32 audioPlaySoundFrame(ImWaveSound* sound);
+	s32 audioPlaySoundFrame(ImWaveVoice* voice);
 	s32 audioWriteToDriver(f32 systemVolume);
+	void ImWaveQueueVoiceCmd(AudioCommandFunc func, ImWaveSound* sound);
+	ImWaveVoiceEvent ImWaveMakeEvent(s32 voice, u32 generation, s32 value);
+	void ImWaveCmdStart(const void* data);
+	void ImWaveCmdStop(const void* data);
+	void ImWaveCmdSetParams(const void* data);
+	void ImWaveEventFinished(const void* data);
+	void ImWaveEventMailbox(const void* data);
+	void ImWaveEventTrigger(const void* data);
 		
 	/////////////////////////////////////////////////////////// 
 	// API
@@ -110,6 +150,7 @@ namespace TFE_Jedi
 		s_imWaveMixCount = initData->waveMixCount;
 		s_digitalPause = 0;
 		s_imWaveSoundList = nullptr;
+		memset(s_imWaveVoice, 0, sizeof(ImWaveVoice) * MAX_SOUND_CHANNELS);
 
 		if (initData->waveSpeed == IM_WAVE_11kHz) // <- this is the path taken by Dark Forces DOS
 		{
@@ -155,21 +196,17 @@ namespace TFE_Jedi
 		}
 		ImFreeAllWaveSounds();
 
-		AUDIO_LOCK();
+		s_imWaveMixCount = count;
+		ImWaveSound* sound = s_imWaveSound;
+		for (s32 i = 0; i < s_imWaveMixCount; i++, sound++)
 		{
-			s_imWaveMixCount = count;
-			ImWaveSound* sound = s_imWaveSound;
-			for (s32 i = 0; i < s_imWaveMixCount; i++, sound++)
-			{
-				sound->prev = nullptr;
-				sound->next = nullptr;
-				ImWaveData* data = ImGetWaveData(i);
-				sound->data = data;
-				data->sound = sound;
-				sound->soundId = IM_NULL_SOUNDID;
-			}
+			sound->prev = nullptr;
+			sound->next = nullptr;
+			ImWaveData* data = ImGetWaveData(i);
+			sound->data = data;
+			data->sound = sound;
+			sound->soundId = IM_NULL_SOUNDID;
 		}
-		AUDIO_UNLOCK();
 
 		return ImComputeAudioNormalization(count);
 	}
@@ -199,12 +236,22 @@ namespace TFE_Jedi
 		memset(s_audioOut, 0, 2*(bufferSize + IM_AUDIO_OVERSAMPLE) * sizeof(s16));
 
 		// Write sounds to s_audioOut.
-		ImWaveSound* sound = s_imWaveSoundList;
-		while (sound)
+		ImWaveVoice* voice = s_imWaveVoice;
+		for (s32 i = 0; i < MAX_SOUND_CHANNELS; i++, voice++)
 		{
-			ImWaveSound* next = sound->next;
-			audioPlaySoundFrame(sound);
-			sound = next;
+			// Keep trying to report finished voices until the event queue has room.
+			if (voice->finished)
+			{
+				ImWaveVoiceEvent event = ImWaveMakeEvent(i, voice->generation, 0);
+				if (TFE_Audio::queueEvent(ImWaveEventFinished, &event, sizeof(ImWaveVoiceEvent)))
+				{
+					voice->finished = JFALSE;
+				}
+			}
+			if (voice->soundId)
+			{
+				audioPlaySoundFrame(voice);
+			}
 		}
 
 		// Convert s_audioOut to "driver" buffer.
@@ -270,6 +317,7 @@ namespace TFE_Jedi
 					}
 					sound->volume = ((sound->baseVolume + 1) * ImGetGroupVolume(value)) >> 7;
 					sound->group = value;
+					ImWaveQueueVoiceCmd(ImWaveCmdSetParams, sound);
 					return imSuccess;
 				}
 				else if (param == soundPriority)
@@ -289,6 +337,7 @@ namespace TFE_Jedi
 					}
 					sound->baseVolume = value;
 					sound->volume = ((sound->baseVolume + 1) * ImGetGroupVolume(sound->group)) >> 7;
+					ImWaveQueueVoiceCmd(ImWaveCmdSetParams, sound);
 					return imSuccess;
 				}
 				else if (param == soundPan)
@@ -298,6 +347,7 @@ namespace TFE_Jedi
 						return imArgErr;
 					}
 					sound->pan = value;
+					ImWaveQueueVoiceCmd(ImWaveCmdSetParams, sound);
 					return imSuccess;
 				}
 				else if (param == soundDetune)
@@ -408,7 +458,6 @@ namespace TFE_Jedi
 			}
 		}
 
-		AUDIO_LOCK();
 		IM_DBG_MSG("ERR: no spare tracks...");
 		s32 minPriority = 127;
 		ImWaveSound* minPrioritySound = nullptr;
@@ -432,8 +481,6 @@ namespace TFE_Jedi
 				newSound = minPrioritySound;
 			}
 		}
-
-		AUDIO_UNLOCK();
 		return newSound;
 	}
 
@@ -444,11 +491,43 @@ namespace TFE_Jedi
 		return nullptr;
 	}
 
-	s32 ImSeekToNextChunk(ImWaveData* data)
+	// TFE: Sets the mailbox of the client sound, directly or through an event when called from the mixer.
+	void ImWaveSetMailbox(ImWaveData* data, ImWaveVoice* voice, s32 mailbox)
 	{
+		if (voice)
+		{
+			ImWaveVoiceEvent event = ImWaveMakeEvent(s32(data->sound - s_imWaveSound), voice->generation, mailbox);
+			TFE_Audio::queueEvent(ImWaveEventMailbox, &event, sizeof(ImWaveVoiceEvent));
+		}
+		else if (data->sound->mailbox == 0)
+		{
+			data->sound->mailbox = mailbox;
+		}
+	}
+
+	// TFE: Executes the sound triggers on the client, directly or through an event when called from the mixer.
+	void ImWaveSetTrigger(ImWaveData* data, ImWaveVoice* voice, u8* marker, s32 size)
+	{
+		if (voice)
+		{
+			ImWaveVoiceEvent event = ImWaveMakeEvent(s32(data->sound - s_imWaveSound), voice->generation, 0);
+			memcpy(event.marker, marker, min(size, (s32)sizeof(event.marker)));
+			TFE_Audio::queueEvent(ImWaveEventTrigger, &event, sizeof(ImWaveVoiceEvent));
+		}
+		else
+		{
+			ImSetSoundTrigger((ImSoundId)data->sound, marker);
+		}
+	}
+
+	// voice is the mixer voice when called on the audio thread, or null when called by the client.
+	s32 ImSeekToNextChunk(ImWaveData* data, ImWaveVoice* voice)
+	{
+		// TFE: The chunk header was read into a shared buffer, which is now local since the mixer and client both seek.
+		u8 chunkBuffer[WAVE_CHUNK_SIZE];
 		while (1)
 		{
-			u8* chunkData = s_imWaveChunkData;
+			u8* chunkData = chunkBuffer;
 			u8* sndData = nullptr;
 
 			if (data->chunkIndex)
@@ -465,20 +544,16 @@ namespace TFE_Jedi
 			}
 			else  // chunkIndex == 0
 			{
-				ImWaveSound* sound = data->sound;
-				sndData = ImInternalGetSoundData(sound->soundId);
+				sndData = ImInternalGetSoundData(voice ? voice->soundId : data->sound->soundId);
 				if (!sndData)
 				{
-					if (sound->mailbox == 0)
-					{
-						sound->mailbox = 8;
-					}
+					ImWaveSetMailbox(data, voice, 8);
 					IM_LOG_ERR("%s", "null sound addr in SeekToNextChunk()...");
 					return imFail;
 				}
 			}
 
-			memcpy(chunkData, sndData + data->offset, 48);
+			memcpy(chunkData, sndData + data->offset, WAVE_CHUNK_SIZE);
 			u8 id = *chunkData;
 			chunkData++;
 
@@ -497,11 +572,7 @@ namespace TFE_Jedi
 				data->chunkSize = chunkSize;
 				if (chunkSize > 220000)
 				{
-					ImWaveSound* sound = data->sound;
-					if (sound->mailbox == 0)
-					{
-						sound->mailbox = 9;
-					}
+					ImWaveSetMailbox(data, voice, 9);
 				}
 
 				data->offset += (id == 1) ? 6 : 4;
@@ -515,7 +586,7 @@ namespace TFE_Jedi
 			else if (id == 4)
 			{
 				chunkData += 3;
-				ImSetSoundTrigger((ImSoundId)data->sound, chunkData);
+				ImWaveSetTrigger(data, voice, chunkData, s32(chunkBuffer + WAVE_CHUNK_SIZE - chunkData));
 				data->offset += 6;
 			}
 			else if (id == 6)
@@ -541,7 +612,7 @@ namespace TFE_Jedi
 			{
 				if (chunkData[0] != 'r' || chunkData[1] != 'e' || chunkData[2] != 'a')
 				{
-					IM_LOG_ERR("ERR: Not a valid VOC sound %lu...", data->sound->soundId);
+					IM_LOG_ERR("ERR: Not a valid VOC sound %lu...", voice ? voice->soundId : data->sound->soundId);
 					return imFail;
 				}
 				data->offset += 26;
@@ -556,7 +627,7 @@ namespace TFE_Jedi
 				// dont warn on silence (3) and ascii text (5)
 				if ((id != 3) && (id != 5))
 				{
-					IM_LOG_ERR("ERR: Illegal chunk %d in sound %lu...", id, data->sound->soundId);
+					IM_LOG_ERR("ERR: Illegal chunk %d in sound %lu...", id, voice ? voice->soundId : data->sound->soundId);
 				}
 				return imFail;
 			}
@@ -578,7 +649,7 @@ namespace TFE_Jedi
 		}
 
 		data->chunkIndex = 0;
-		return ImSeekToNextChunk(data);
+		return ImSeekToNextChunk(data, nullptr);
 	}
 
 	s32 ImStartDigitalSoundIntern(ImSoundId soundId, s32 priority, s32 chunkIndex)
@@ -608,21 +679,23 @@ namespace TFE_Jedi
 			return imFail;
 		}
 
-		AUDIO_LOCK();
-		{
-			IM_LIST_ADD(s_imWaveSoundList, sound);
-		}
-		AUDIO_UNLOCK();
+		IM_LIST_ADD(s_imWaveSoundList, sound);
+		// TFE: Hand a copy of the sound over to the mixer.
+		s_imWaveGeneration[sound - s_imWaveSound]++;
+		ImWaveQueueVoiceCmd(ImWaveCmdStart, sound);
 
 		return imSuccess;
 	}
 
+	// TFE: The mixer may still read the sound data until the stop command has run, so code that frees the data
+	// afterward calls TFE_Audio::flushCommands() first.
 	void ImFreeWaveSound(ImWaveSound* sound)
 	{
 		IM_LIST_REM(s_imWaveSoundList, sound);
 		ImClearSoundFaders(sound->soundId, -1);
 		ImClearTrigger(sound->soundId, -1, -1);
 		sound->soundId = IM_NULL_SOUNDID;
+		ImWaveQueueVoiceCmd(ImWaveCmdStop, sound);
 	}
 
 	s32 ImFreeWaveSoundById(ImSoundId soundId)
@@ -632,17 +705,15 @@ namespace TFE_Jedi
 
 	s32 ImFreeAllWaveSounds()
 	{
-		AUDIO_LOCK();
+		ImWaveSound* sound = s_imWaveSoundList;
+		while (sound)
 		{
-			ImWaveSound* sound = s_imWaveSoundList;
-			while (sound)
-			{
-				ImWaveSound* next = sound->next;
-				ImFreeWaveSound(sound);
-				sound = next;
-			}
+			ImWaveSound* next = sound->next;
+			ImFreeWaveSound(sound);
+			sound = next;
 		}
-		AUDIO_UNLOCK();
+		// The sound data may be freed once this returns, so make sure the mixer has stopped reading it.
+		TFE_Audio::flushCommands();
 		return imSuccess;
 	}
 
@@ -705,9 +776,9 @@ namespace TFE_Jedi
 		digitalAudioOutput_Stereo(&s_audioOut[outOffset * 2], audioFrame, leftMapping, rightMapping, size);
 	}
 
-	s32 audioPlaySoundFrame(ImWaveSound* sound)
+	s32 audioPlaySoundFrame(ImWaveVoice* voice)
 	{
-		ImWaveData* data = sound->data;
+		ImWaveData* data = &voice->data;
 		s32 bufferSize = s_audioOutSize;
 		s32 offset = 0;
 		s32 res = imSuccess;
@@ -716,12 +787,14 @@ namespace TFE_Jedi
 			res = imSuccess;
 			if (!data->chunkSize)
 			{
-				res = ImSeekToNextChunk(data);
+				res = ImSeekToNextChunk(data, voice);
 				if (res != imSuccess)
 				{
 					if (res == imFail)  // Sound has finished playing.
 					{
-						ImFreeWaveSound(sound);
+						// TFE: The client frees the sound once it receives the event.
+						voice->soundId = IM_NULL_SOUNDID;
+						voice->finished = JTRUE;
 					}
 					break;
 				}
@@ -731,8 +804,8 @@ namespace TFE_Jedi
 			// This is required since the results might be interpolated on upsample.
 			const s32 baseReadSize = min(bufferSize, data->chunkSize);
 			const s32 readSize = min(bufferSize+IM_AUDIO_OVERSAMPLE, data->chunkSize);
-			s_audioData = ImInternalGetSoundData(sound->soundId) + data->offset;
-			audioProcessFrame(s_audioData, readSize, offset, sound->volume, sound->pan);
+			s_audioData = ImInternalGetSoundData(voice->soundId) + data->offset;
+			audioProcessFrame(s_audioData, readSize, offset, voice->volume, voice->pan);
 
 			offset += baseReadSize;
 			bufferSize -= baseReadSize;
@@ -763,23 +836,122 @@ namespace TFE_Jedi
 	{
 		s32 result = imInvalidSound;
 
-		AUDIO_LOCK();
+		ImWaveSound* sound = s_imWaveSoundList;
+		while (sound)
 		{
-			ImWaveSound* sound = s_imWaveSoundList;
-			while (sound)
+			ImWaveSound* next = sound->next;
+			if (sound->soundId == soundId)
 			{
-				ImWaveSound* next = sound->next;
-				if (sound->soundId == soundId)
-				{
-					ImFreeWaveSound(sound);
-					result = imSuccess;
-				}
-				sound = next;
+				ImFreeWaveSound(sound);
+				result = imSuccess;
 			}
+			sound = next;
 		}
-		AUDIO_UNLOCK();
 
 		return result;
 	}
 
+	////////////////////////////////////
+	// TFE: Mixer commands and events
+	////////////////////////////////////
+	void ImWaveQueueVoiceCmd(AudioCommandFunc func, ImWaveSound* sound)
+	{
+		const s32 index = s32(sound - s_imWaveSound);
+		ImWaveVoiceCmd cmd;
+		cmd.voice = index;
+		cmd.generation = s_imWaveGeneration[index];
+		cmd.soundId = sound->soundId;
+		cmd.volume = sound->volume;
+		cmd.pan = sound->pan;
+		cmd.data = *sound->data;
+		// Parameter changes to the same playback can be merged if the queue is full.
+		const u32 coalesceKey = (func == ImWaveCmdSetParams) ? ((cmd.generation << 4) | u32(index)) + 1 : 0;
+		TFE_Audio::queueCommand(func, &cmd, sizeof(ImWaveVoiceCmd), coalesceKey);
+	}
+
+	ImWaveVoiceEvent ImWaveMakeEvent(s32 voice, u32 generation, s32 value)
+	{
+		ImWaveVoiceEvent event;
+		memset(&event, 0, sizeof(ImWaveVoiceEvent));
+		event.voice = voice;
+		event.generation = generation;
+		event.value = value;
+		return event;
+	}
+
+	// Audio thread.
+	void ImWaveCmdStart(const void* data)
+	{
+		const ImWaveVoiceCmd* cmd = (const ImWaveVoiceCmd*)data;
+		ImWaveVoice* voice = &s_imWaveVoice[cmd->voice];
+		voice->data = cmd->data;
+		voice->soundId = cmd->soundId;
+		voice->generation = cmd->generation;
+		voice->volume = cmd->volume;
+		voice->pan = cmd->pan;
+		voice->finished = JFALSE;
+	}
+
+	void ImWaveCmdStop(const void* data)
+	{
+		const ImWaveVoiceCmd* cmd = (const ImWaveVoiceCmd*)data;
+		ImWaveVoice* voice = &s_imWaveVoice[cmd->voice];
+		if (voice->generation == cmd->generation)
+		{
+			voice->soundId = IM_NULL_SOUNDID;
+			voice->finished = JFALSE;
+		}
+	}
+
+	void ImWaveCmdSetParams(const void* data)
+	{
+		const ImWaveVoiceCmd* cmd = (const ImWaveVoiceCmd*)data;
+		ImWaveVoice* voice = &s_imWaveVoice[cmd->voice];
+		if (voice->generation == cmd->generation)
+		{
+			voice->volume = cmd->volume;
+			voice->pan = cmd->pan;
+		}
+	}
+
+	// Client thread, returns the sound if it is still the one the mixer was playing when the event was sent.
+	ImWaveSound* ImWaveGetEventSound(const ImWaveVoiceEvent* event)
+	{
+		ImWaveSound* sound = &s_imWaveSound[event->voice];
+		if (!sound->soundId || s_imWaveGeneration[event->voice] != event->generation)
+		{
+			return nullptr;
+		}
+		return sound;
+	}
+
+	void ImWaveEventFinished(const void* data)
+	{
+		ImWaveSound* sound = ImWaveGetEventSound((const ImWaveVoiceEvent*)data);
+		if (sound)
+		{
+			ImFreeWaveSound(sound);
+		}
+	}
+
+	void ImWaveEventMailbox(const void* data)
+	{
+		const ImWaveVoiceEvent* event = (const ImWaveVoiceEvent*)data;
+		ImWaveSound* sound = ImWaveGetEventSound(event);
+		if (sound && sound->mailbox == 0)
+		{
+			sound->mailbox = event->value;
+		}
+	}
+
+	void ImWaveEventTrigger(const void* data)
+	{
+		const ImWaveVoiceEvent* event = (const ImWaveVoiceEvent*)data;
+		ImWaveSound* sound = ImWaveGetEventSound(event);
+		if (sound)
+		{
+			ImSetSoundTrigger((ImSoundId)sound, (void*)event->marker);
+		}
+	}
+
 }  // namespace TFE_Jedi
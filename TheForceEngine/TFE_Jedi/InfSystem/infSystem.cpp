@@ -3122,6 +3122,9 @@ namespace TFE_Jedi
 		Allocator* adjoinCmds = stop->adjoinCmds;
 		if (adjoinCmds)
 		{
+			// TFE: Adjoins change what AI can see, so invalidate the cached visibility results.
+			s_sectorGeometryVersion++;
+
 			AdjoinCmd* cmd = (AdjoinCmd*)allocator_getHead(adjoinCmds);
 			while (cmd)
 			{
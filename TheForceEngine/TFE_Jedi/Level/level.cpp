@@ -3,9 +3,13 @@
 
 #include "level.h"
 #include "levelBin.h"
+#include "levelCache.h"
+#include "levelPreload.h"
 #include "levelData.h"
 #include "rwall.h"
 #include "rtexture.h"
+#include "sectorGrid.h"
+#include "sectorEdges.h"
 #include <TFE_Game/igame.h>
 #include <TFE_Asset/assetSystem.h>
 #include <TFE_Asset/dfKeywords.h>
@@ -46,6 +50,9 @@ namespace TFE_Jedi
 	static s32 s_dataIndex;
 	static char s_readBuffer[256];
 	static std::vector<char> s_buffer;
+	// TFE: Names gathered while parsing, used to write the level cache.
+	static std::vector<std::string> s_textureNames;
+	static std::vector<std::string> s_sectorNames;
 
 	JBool level_loadGeometry(const char* levelName);
 	JBool level_loadObjects(const char* levelName, u8 difficulty);
@@ -71,11 +78,19 @@ namespace TFE_Jedi
 		// TFE - Level Script, loading before INF
 		loadLevelScript();
 
+		// TFE: Load the level assets up front, so they can be decoded in parallel.
+		levelPreload_begin(levelName);
+
 		// Load level data.
-		if (!level_loadGeometry(levelName)) { return JFALSE; }
+		if (!level_loadGeometry(levelName))
+		{
+			levelPreload_end();
+			return JFALSE;
+		}
 		level_loadObjects(levelName, difficulty);
 		inf_load(levelName);
 		level_loadGoals(levelName);
+		levelPreload_end();
 
 		// TFE - Level Script Level Start
 		startLevelScript(levelName);
@@ -147,6 +162,10 @@ namespace TFE_Jedi
 		// Setup the control sector.
 		s_levelState.controlSector->id = s_levelState.sectorCount;
 		s_levelState.controlSector->index = s_levelState.controlSector->id;
+
+		// TFE: Build the spatial grid and edge tables used to accelerate sector_which3D().
+		sectorGrid_build();
+		sectorEdges_build();
 	}
 
 	JBool level_loadGeometry(const char* levelName)
@@ -168,26 +187,50 @@ namespace TFE_Jedi
 		strcpy(levelPath, levelName);
 		strcat(levelPath, ".LEV");
 
+		// TFE: Use the file data read by the level preload, if available.
+		const LevelPreloadFile* preloaded = levelPreload_getFile(levelPath);
 		FilePath filePath;
-		if (!TFE_Paths::getFilePath(levelPath, &filePath))
+		const char* levelData;
+		size_t len;
+		if (preloaded)
 		{
-			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot find level geometry '%s'.", levelName);
-			return false;
+			filePath = preloaded->filePath;
+			levelData = (const char*)preloaded->data.data();
+			len = preloaded->data.size();
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		else
 		{
-			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
-			return false;
+			if (!TFE_Paths::getFilePath(levelPath, &filePath))
+			{
+				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot find level geometry '%s'.", levelName);
+				return false;
+			}
+			FileStream file;
+			if (!file.open(&filePath, Stream::MODE_READ))
+			{
+				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot open level geometry '%s'.", levelName);
+				return false;
+			}
+			len = file.getSize();
+			s_buffer.resize(len);
+			file.readBuffer(s_buffer.data(), u32(len));
+			file.close();
+			levelData = s_buffer.data();
 		}
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
+
+		// TFE: Skip parsing if this exact level has been loaded before.
+		const u64 cacheKey = levelCache_computeKey(&filePath, levelData, len);
+		if (levelCache_loadGeometry(levelName, cacheKey))
+		{
+			level_postProcessGeometry();
+			return true;
+		}
+		s_textureNames.clear();
+		s_sectorNames.clear();
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(levelData, len);
 		parser.addCommentString("#");
 		parser.convertToUpperCase(true);
 
@@ -266,8 +309,12 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture name.");
 				*texture = bitmap_load("default.bm", 1);
 				(*texture)->flags |= ENABLE_MIP_MAPS;
+				s_textureNames.push_back("");
+				continue;
 			}
-			else if (strcasecmp(textureName, "<NoTexture>") == 0)
+			s_textureNames.push_back(textureName);
+
+			if (strcasecmp(textureName, "<NoTexture>") == 0)
 			{
 				*texture = nullptr;
 			}
@@ -328,8 +375,14 @@ namespace TFE_Jedi
 			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
 			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
 			char name[256];
-			if (sscanf(line, " NAME %s", name) == 1)
+			if (sscanf(line, " NAME %s", name) != 1)
+			{
+				s_sectorNames.push_back("");
+			}
+			else
 			{
+				s_sectorNames.push_back(name);
+
 				// Add the sector "address" for later use by the INF system.
 				message_addAddress(name, 0, 0, sector);
 
@@ -584,6 +637,8 @@ namespace TFE_Jedi
 			}
 		}
 
+		// TFE: Cache the geometry before post-processing modifies it.
+		levelCache_writeGeometry(levelName, cacheKey, s_textureNames, s_sectorNames);
 		level_postProcessGeometry();
 
 		return true;
@@ -730,27 +785,40 @@ namespace TFE_Jedi
 
 		s32 curDiff = s32(difficulty) + 1;
 
-		FilePath filePath;
-		if (!TFE_Paths::getFilePath(levelPath, &filePath))
+		// TFE: Use the file data read by the level preload, if available.
+		const LevelPreloadFile* preloaded = levelPreload_getFile(levelPath);
+		const char* objData;
+		size_t len;
+		if (preloaded)
 		{
-			TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot find level objects '%s'.", levelName);
-			return false;
+			objData = (const char*)preloaded->data.data();
+			len = preloaded->data.size();
 		}
-		FileStream file;
-		if (!file.open(&filePath, Stream::MODE_READ))
+		else
 		{
-			TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot open level objects '%s'.", levelName);
-			return false;
-		}
+			FilePath filePath;
+			if (!TFE_Paths::getFilePath(levelPath, &filePath))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot find level objects '%s'.", levelName);
+				return false;
+			}
+			FileStream file;
+			if (!file.open(&filePath, Stream::MODE_READ))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Level Load", "Cannot open level objects '%s'.", levelName);
+				return false;
+			}
 
-		size_t len = file.getSize();
-		s_buffer.resize(len);
-		file.readBuffer(s_buffer.data(), u32(len));
-		file.close();
+			len = file.getSize();
+			s_buffer.resize(len);
+			file.readBuffer(s_buffer.data(), u32(len));
+			file.close();
+			objData = s_buffer.data();
+		}
 
 		TFE_Parser parser;
 		size_t bufferPos = 0;
-		parser.init(s_buffer.data(), s_buffer.size());
+		parser.init(objData, len);
 		parser.enableBlockComments();
 		parser.addCommentString("//");
 		parser.addCommentString("#");
@@ -0,0 +1,538 @@
+#include <cstring>
+
+#include "levelCache.h"
+#include "level.h"
+#include "levelData.h"
+#include "rwall.h"
+#include "rtexture.h"
+#include <TFE_Game/igame.h>
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_System/cacheFile.h>
+
+#include <TFE_Jedi/InfSystem/infSystem.h>
+#include <TFE_Jedi/InfSystem/infTypesInternal.h>
+#include <TFE_Jedi/InfSystem/message.h>
+
+namespace TFE_Jedi
+{
+	enum LevelCacheConstants
+	{
+		LEVEL_CACHE_MAGIC   = 0x43564c54,	// "TLVC"
+		// Increment whenever the image layout or the way geometry is parsed changes.
+		LEVEL_CACHE_VERSION = 1,
+		LEVEL_CACHE_NO_NAME = 0xffffffff,
+		// Each edit of a level adds a new file, so only the most recently written levels are kept.
+		LEVEL_CACHE_MAX_FILES = 64,
+	};
+
+	// All offsets are in bytes from the start of the image, string offsets are from the start of the string table.
+	// The magic number, version and key are stored by TFE_CacheFile.
+	struct LevelCacheHeader
+	{
+		u32 imageSize;
+
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+		u32 paletteName;
+
+		u32 textureCount;
+		u32 textureOffset;		// u32 string offset per texture.
+		u32 sectorCount;
+		u32 sectorOffset;		// LevelCacheSector
+		u32 vertexCount;
+		u32 vertexOffset;		// vec2_fixed, world space.
+		u32 wallCount;
+		u32 wallOffset;			// LevelCacheWall
+		u32 stringOffset;
+		u32 stringSize;
+	};
+
+	struct LevelCacheSector
+	{
+		s32 id;
+		u32 name;
+		fixed16_16 ambient;
+		s32 floorTex;
+		vec2_fixed floorOffset;
+		fixed16_16 floorHeight;
+		s32 ceilTex;
+		vec2_fixed ceilOffset;
+		fixed16_16 ceilingHeight;
+		fixed16_16 secHeight;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 layer;
+		u32 firstVertex;
+		u32 vertexCount;
+		u32 firstWall;
+		u32 wallCount;
+	};
+
+	enum LevelCacheWallTex
+	{
+		WTEX_MID = 0,
+		WTEX_TOP,
+		WTEX_BOT,
+		WTEX_SIGN,
+		WTEX_COUNT
+	};
+
+	struct LevelCacheWall
+	{
+		s32 left;
+		s32 right;
+		s32 adjoin;
+		s32 mirror;
+		s32 tex[WTEX_COUNT];
+		vec2_fixed offset[WTEX_COUNT];
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		fixed16_16 light;
+	};
+
+	static std::vector<u8> s_cacheImage;
+
+	/////////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////////
+	static void getCacheName(const char* levelName, u64 key, char* name)
+	{
+		snprintf(name, TFE_MAX_PATH, "%s_%016llx.lvc", levelName, (unsigned long long)key);
+	}
+
+	static bool validTexture(s32 index, u32 textureCount)
+	{
+		return index >= -1 && index < s32(textureCount);
+	}
+
+	static bool validString(const LevelCacheHeader* header, u32 offset)
+	{
+		return offset == LEVEL_CACHE_NO_NAME || offset < header->stringSize;
+	}
+
+	static bool validRange(const LevelCacheHeader* header, u32 offset, u32 count, size_t elemSize)
+	{
+		return offset <= header->imageSize && u64(count) * elemSize <= u64(header->imageSize - offset);
+	}
+
+	// Check every offset and index before any level state is touched, so a bad image can fall back to parsing.
+	static bool validateImage(const u8* image, size_t size)
+	{
+		if (size < sizeof(LevelCacheHeader)) { return false; }
+		const LevelCacheHeader* header = (const LevelCacheHeader*)image;
+		if (header->imageSize != size)
+		{
+			return false;
+		}
+		if (!validRange(header, header->textureOffset, header->textureCount, sizeof(u32)) ||
+			!validRange(header, header->sectorOffset, header->sectorCount, sizeof(LevelCacheSector)) ||
+			!validRange(header, header->vertexOffset, header->vertexCount, sizeof(vec2_fixed)) ||
+			!validRange(header, header->wallOffset, header->wallCount, sizeof(LevelCacheWall)) ||
+			!validRange(header, header->stringOffset, header->stringSize, 1))
+		{
+			return false;
+		}
+		// The string table ends with a terminator, so any string that starts inside of it also ends inside of it.
+		if (header->stringSize == 0 || image[header->stringOffset + header->stringSize - 1] != 0) { return false; }
+		if (header->paletteName == LEVEL_CACHE_NO_NAME || !validString(header, header->paletteName)) { return false; }
+
+		const u32* textureNames = (const u32*)&image[header->textureOffset];
+		for (u32 i = 0; i < header->textureCount; i++)
+		{
+			if (!validString(header, textureNames[i])) { return false; }
+		}
+
+		const LevelCacheSector* sectors = (const LevelCacheSector*)&image[header->sectorOffset];
+		const LevelCacheSector* sector = sectors;
+		for (u32 s = 0; s < header->sectorCount; s++, sector++)
+		{
+			if (!validString(header, sector->name) || !validTexture(sector->floorTex, header->textureCount) || !validTexture(sector->ceilTex, header->textureCount) ||
+				sector->firstVertex > header->vertexCount || sector->vertexCount > header->vertexCount - sector->firstVertex ||
+				sector->firstWall > header->wallCount || sector->wallCount > header->wallCount - sector->firstWall)
+			{
+				return false;
+			}
+
+			const LevelCacheWall* wall = (const LevelCacheWall*)&image[header->wallOffset] + sector->firstWall;
+			for (u32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->left < 0 || wall->left >= s32(sector->vertexCount) || wall->right < 0 || wall->right >= s32(sector->vertexCount) ||
+					wall->adjoin < -1 || wall->adjoin >= s32(header->sectorCount))
+				{
+					return false;
+				}
+				// The mirror indexes into the walls of the adjoined sector.
+				if (wall->adjoin >= 0 && (wall->mirror < 0 || wall->mirror >= s32(sectors[wall->adjoin].wallCount)))
+				{
+					return false;
+				}
+				for (s32 t = 0; t < WTEX_COUNT; t++)
+				{
+					if (!validTexture(wall->tex[t], header->textureCount)) { return false; }
+				}
+			}
+		}
+		return true;
+	}
+
+	static bool loadTextures(const LevelCacheHeader* header, const u32* textureNames, const char* strings)
+	{
+		s_levelState.textureCount = s32(header->textureCount);
+		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
+		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
+
+		TextureData** texture = s_levelState.textures;
+		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
+		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		{
+			const char* textureName = textureNames[i] == LEVEL_CACHE_NO_NAME ? nullptr : &strings[textureNames[i]];
+			if (!textureName)
+			{
+				// The texture line could not be read when the level was parsed.
+				*texture = bitmap_load("default.bm", 1);
+				(*texture)->flags |= ENABLE_MIP_MAPS;
+			}
+			else if (strcasecmp(textureName, "<NoTexture>") == 0)
+			{
+				*texture = nullptr;
+			}
+			else
+			{
+				TextureData* tex = bitmap_load(textureName, 1);
+				if (!tex)
+				{
+					TFE_System::logWrite(LOG_WARNING, "levelCache_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
+					tex = bitmap_load("default.bm", 1);
+					if (!tex)
+					{
+						TFE_System::logWrite(LOG_ERROR, "levelCache_loadGeometry", "'default.bm' is not a valid BM file!");
+						assert(0);
+						return false;
+					}
+				}
+				tex->flags |= ENABLE_MIP_MAPS;
+				*texture = tex;
+				// This version never gets modified, so serialization is simpler.
+				*texBase = tex;
+
+				// Setup an animated texture.
+				if (tex->uvWidth == BM_ANIMATED_TEXTURE && !tex->animSetup)
+				{
+					bitmap_setupAnimatedTexture(texture, i);
+				}
+			}
+		}
+		return true;
+	}
+
+	static TextureData** getTexture(s32 index)
+	{
+		return index >= 0 ? &s_levelState.textures[index] : nullptr;
+	}
+
+	static void loadSector(RSector* sector, const LevelCacheSector* src, const vec2_fixed* vertices, const LevelCacheWall* walls, const char* strings)
+	{
+		sector->id = src->id;
+
+		if (src->name != LEVEL_CACHE_NO_NAME)
+		{
+			const char* name = &strings[src->name];
+			// Add the sector "address" for later use by the INF system.
+			message_addAddress(name, 0, 0, sector);
+
+			// Track special elevators.
+			if (!strcasecmp(name, "complete"))
+			{
+				s_levelState.completeSector = sector;
+			}
+			else if (!strcasecmp(name, "boss"))
+			{
+				s_levelState.bossSector = sector;
+			}
+			else if (!strcasecmp(name, "mohc"))
+			{
+				s_levelState.mohcSector = sector;
+			}
+		}
+
+		sector->ambient = src->ambient;
+		sector->floorTex = getTexture(src->floorTex);
+		sector->floorOffset = src->floorOffset;
+		sector->floorHeight = src->floorHeight;
+		sector->ceilTex = getTexture(src->ceilTex);
+		sector->ceilOffset = src->ceilOffset;
+		sector->ceilingHeight = src->ceilingHeight;
+		sector->secHeight = src->secHeight;
+		sector->flags1 = src->flags1;
+		sector->flags2 = src->flags2;
+		sector->flags3 = src->flags3;
+
+		// Create a door if needed.
+		if (sector->flags1 & SEC_FLAGS1_DOOR)
+		{
+			InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
+			if (elev) { elev->flags |= INF_EFLAG_DOOR; }
+		}
+		// Create an exploding wall if needed.
+		if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
+		{
+			inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
+		}
+		// Add secrets.
+		if (sector->flags1 & SEC_FLAGS1_SECRET)
+		{
+			s_levelState.secretCount++;
+		}
+
+		sector->layer = src->layer;
+		s_levelState.minLayer = min(s_levelState.minLayer, sector->layer);
+		s_levelState.maxLayer = max(s_levelState.maxLayer, sector->layer);
+
+		// Vertices
+		const size_t vtxSize = src->vertexCount * sizeof(vec2_fixed);
+		sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
+		sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
+		sector->vertexCount = s32(src->vertexCount);
+		memcpy(sector->verticesWS, &vertices[src->firstVertex], vtxSize);
+
+		// Walls
+		sector->walls = (RWall*)level_alloc(src->wallCount * sizeof(RWall));
+		sector->wallCount = s32(src->wallCount);
+		memset(sector->walls, 0, src->wallCount * sizeof(RWall));
+
+		const LevelCacheWall* srcWall = &walls[src->firstWall];
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++, srcWall++)
+		{
+			wall->id = w;
+			wall->sector = sector;
+			wall->flags1 = srcWall->flags1;
+			wall->flags2 = srcWall->flags2;
+			wall->flags3 = srcWall->flags3;
+
+			vec2_fixed* leftVtxWS = &sector->verticesWS[srcWall->left];
+			vec2_fixed* rightVtxWS = &sector->verticesWS[srcWall->right];
+			wall->w0 = leftVtxWS;
+			wall->w1 = rightVtxWS;
+			wall->v0 = &sector->verticesVS[srcWall->left];
+			wall->v1 = &sector->verticesVS[srcWall->right];
+			// Store the original position 0 in the wall since it is used by the sector rotation INF.
+			wall->worldPos0.x = leftVtxWS->x;
+			wall->worldPos0.z = leftVtxWS->z;
+
+			wall->mirror = -1;
+			if (srcWall->adjoin != -1)
+			{
+				wall->nextSector = &s_levelState.sectors[srcWall->adjoin];
+				wall->mirror = srcWall->mirror;
+			}
+			wall->wallLight = srcWall->light;
+
+			wall->midTex  = getTexture(srcWall->tex[WTEX_MID]);
+			wall->topTex  = getTexture(srcWall->tex[WTEX_TOP]);
+			wall->botTex  = getTexture(srcWall->tex[WTEX_BOT]);
+			wall->signTex = getTexture(srcWall->tex[WTEX_SIGN]);
+			wall->midOffset  = srcWall->offset[WTEX_MID];
+			wall->topOffset  = srcWall->offset[WTEX_TOP];
+			wall->botOffset  = srcWall->offset[WTEX_BOT];
+			wall->signOffset = srcWall->offset[WTEX_SIGN];
+
+			fixed16_16 dx = rightVtxWS->x - leftVtxWS->x;
+			fixed16_16 dz = rightVtxWS->z - leftVtxWS->z;
+			wall->angle  = vec2ToAngle(dx, dz);
+			wall->length = vec2Length(dx, dz);
+			wall_computeDirectionVector(wall);
+			wall->texelLength = wall->length * 8;
+		}
+	}
+
+	static s32 getTextureIndex(TextureData** texture)
+	{
+		return texture ? s32(texture - s_levelState.textures) : -1;
+	}
+
+	static u32 addString(std::vector<char>& strings, const char* str)
+	{
+		const u32 offset = u32(strings.size());
+		strings.insert(strings.end(), str, str + strlen(str) + 1);
+		return offset;
+	}
+
+	template <typename T>
+	static void appendData(std::vector<u8>& image, const T* data, size_t count)
+	{
+		const u8* bytes = (const u8*)data;
+		image.insert(image.end(), bytes, bytes + count * sizeof(T));
+	}
+
+	/////////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////////
+	u64 levelCache_computeKey(const FilePath* sourcePath, const char* source, size_t sourceSize)
+	{
+		u64 key = TFE_Hash::hashValue64(TFE_Hash::c_fnv64Offset, u32(LEVEL_CACHE_VERSION));
+		// Include where the level came from, so identically named levels in different mods do not collide.
+		const char* location = sourcePath->archive ? sourcePath->archive->getPath() : sourcePath->path;
+		key = TFE_Hash::hashString64(key, location);
+		if (sourcePath->archive)
+		{
+			key = TFE_Hash::hashString64(key, sourcePath->path);
+		}
+		return TFE_Hash::hash64(key, source, sourceSize);
+	}
+
+	bool levelCache_loadGeometry(const char* levelName, u64 key)
+	{
+		char cacheName[TFE_MAX_PATH];
+		getCacheName(levelName, key, cacheName);
+		if (!TFE_CacheFile::read("LevelCache/", cacheName, LEVEL_CACHE_MAGIC, LEVEL_CACHE_VERSION, key, s_cacheImage))
+		{
+			return false;
+		}
+
+		const u8* image = s_cacheImage.data();
+		if (!validateImage(image, s_cacheImage.size()))
+		{
+			TFE_System::logWrite(LOG_WARNING, "levelCache_loadGeometry", "Ignoring invalid level cache '%s'.", cacheName);
+			return false;
+		}
+
+		const LevelCacheHeader* header = (const LevelCacheHeader*)image;
+		const char* strings = (const char*)&image[header->stringOffset];
+		strncpy(s_levelState.levelPaletteName, &strings[header->paletteName], sizeof(s_levelState.levelPaletteName) - 1);
+		s_levelState.levelPaletteName[sizeof(s_levelState.levelPaletteName) - 1] = 0;
+		level_loadPalette();
+		s_levelState.parallax0 = header->parallax0;
+		s_levelState.parallax1 = header->parallax1;
+
+		if (!loadTextures(header, (const u32*)&image[header->textureOffset], strings))
+		{
+			// The caller falls back to parsing the level, which allocates the texture list again.
+			level_free(s_levelState.textures);
+			s_levelState.textures = nullptr;
+			s_levelState.textureCount = 0;
+			return false;
+		}
+
+		s_levelState.sectorCount = header->sectorCount;
+		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
+		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
+
+		const LevelCacheSector* srcSector = (const LevelCacheSector*)&image[header->sectorOffset];
+		const vec2_fixed* vertices = (const vec2_fixed*)&image[header->vertexOffset];
+		const LevelCacheWall* walls = (const LevelCacheWall*)&image[header->wallOffset];
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, srcSector++)
+		{
+			RSector* sector = &s_levelState.sectors[i];
+			sector_clear(sector);
+			sector->index = i;
+			loadSector(sector, srcSector, vertices, walls, strings);
+		}
+		return true;
+	}
+
+	void levelCache_writeGeometry(const char* levelName, u64 key, const std::vector<std::string>& textureNames, const std::vector<std::string>& sectorNames)
+	{
+		if (textureNames.size() != size_t(s_levelState.textureCount) || sectorNames.size() != size_t(s_levelState.sectorCount))
+		{
+			return;
+		}
+
+		std::vector<char> strings;
+		std::vector<u32> textureOffsets(textureNames.size());
+		std::vector<LevelCacheSector> sectors(s_levelState.sectorCount);
+		std::vector<vec2_fixed> vertices;
+		std::vector<LevelCacheWall> walls;
+
+		const u32 paletteName = addString(strings, s_levelState.levelPaletteName);
+		for (size_t i = 0; i < textureNames.size(); i++)
+		{
+			textureOffsets[i] = textureNames[i].empty() ? LEVEL_CACHE_NO_NAME : addString(strings, textureNames[i].c_str());
+		}
+
+		const RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			LevelCacheSector* dst = &sectors[s];
+			dst->id = sector->id;
+			dst->name = sectorNames[s].empty() ? LEVEL_CACHE_NO_NAME : addString(strings, sectorNames[s].c_str());
+			dst->ambient = sector->ambient;
+			dst->floorTex = getTextureIndex(sector->floorTex);
+			dst->floorOffset = sector->floorOffset;
+			dst->floorHeight = sector->floorHeight;
+			dst->ceilTex = getTextureIndex(sector->ceilTex);
+			dst->ceilOffset = sector->ceilOffset;
+			dst->ceilingHeight = sector->ceilingHeight;
+			dst->secHeight = sector->secHeight;
+			dst->flags1 = sector->flags1;
+			dst->flags2 = sector->flags2;
+			dst->flags3 = sector->flags3;
+			dst->layer = sector->layer;
+			dst->firstVertex = u32(vertices.size());
+			dst->vertexCount = u32(sector->vertexCount);
+			dst->firstWall = u32(walls.size());
+			dst->wallCount = u32(sector->wallCount);
+			vertices.insert(vertices.end(), sector->verticesWS, sector->verticesWS + sector->vertexCount);
+
+			const RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				LevelCacheWall dstWall = {};
+				dstWall.left = s32(wall->w0 - sector->verticesWS);
+				dstWall.right = s32(wall->w1 - sector->verticesWS);
+				dstWall.adjoin = wall->nextSector ? s32(wall->nextSector - s_levelState.sectors) : -1;
+				dstWall.mirror = wall->mirror;
+				dstWall.tex[WTEX_MID]  = getTextureIndex(wall->midTex);
+				dstWall.tex[WTEX_TOP]  = getTextureIndex(wall->topTex);
+				dstWall.tex[WTEX_BOT]  = getTextureIndex(wall->botTex);
+				dstWall.tex[WTEX_SIGN] = getTextureIndex(wall->signTex);
+				// Offsets are only read for walls that have the matching texture.
+				if (wall->midTex)  { dstWall.offset[WTEX_MID]  = wall->midOffset; }
+				if (wall->topTex)  { dstWall.offset[WTEX_TOP]  = wall->topOffset; }
+				if (wall->botTex)  { dstWall.offset[WTEX_BOT]  = wall->botOffset; }
+				if (wall->signTex) { dstWall.offset[WTEX_SIGN] = wall->signOffset; }
+				dstWall.flags1 = wall->flags1;
+				dstWall.flags2 = wall->flags2;
+				dstWall.flags3 = wall->flags3;
+				dstWall.light = wall->wallLight;
+				walls.push_back(dstWall);
+			}
+		}
+
+		// Build the image: header, texture names, sectors, vertices, walls and finally the strings.
+		LevelCacheHeader header = {};
+		header.parallax0 = s_levelState.parallax0;
+		header.parallax1 = s_levelState.parallax1;
+		header.paletteName = paletteName;
+		header.textureCount = u32(textureOffsets.size());
+		header.sectorCount = u32(sectors.size());
+		header.vertexCount = u32(vertices.size());
+		header.wallCount = u32(walls.size());
+		header.stringSize = u32(strings.size());
+
+		std::vector<u8>& image = s_cacheImage;
+		image.clear();
+		appendData(image, &header, 1);
+		header.textureOffset = u32(image.size());
+		appendData(image, textureOffsets.data(), textureOffsets.size());
+		header.sectorOffset = u32(image.size());
+		appendData(image, sectors.data(), sectors.size());
+		header.vertexOffset = u32(image.size());
+		appendData(image, vertices.data(), vertices.size());
+		header.wallOffset = u32(image.size());
+		appendData(image, walls.data(), walls.size());
+		header.stringOffset = u32(image.size());
+		appendData(image, strings.data(), strings.size());
+		header.imageSize = u32(image.size());
+		memcpy(image.data(), &header, sizeof(LevelCacheHeader));
+
+		char cacheName[TFE_MAX_PATH];
+		getCacheName(levelName, key, cacheName);
+		TFE_CacheFile::write("LevelCache/", cacheName, LEVEL_CACHE_MAGIC, LEVEL_CACHE_VERSION, key, image.data(), image.size(), LEVEL_CACHE_MAX_FILES);
+	}
+}
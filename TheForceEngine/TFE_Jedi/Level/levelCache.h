@@ -0,0 +1,30 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// LevelCache
+// Added for TFE: binary cache of parsed level geometry.
+//
+// Parsing the .LEV text is most of the geometry load time for large
+// levels. After a level is parsed, its sectors, walls and vertices
+// are written to a flat, offset based image in the program data
+// cache directory. The image is keyed by a hash of the source file
+// and the archive it came from, so any change to the level produces
+// a new cache entry. Later loads read the image and fix up pointers
+// instead of parsing text.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_FileSystem/paths.h>
+#include <vector>
+#include <string>
+
+namespace TFE_Jedi
+{
+	// Computes the cache key for the level source data.
+	u64  levelCache_computeKey(const FilePath* sourcePath, const char* source, size_t sourceSize);
+	// Loads the level geometry from the cache, returns false if there is no valid cache entry for the key.
+	// On failure no level state has been modified.
+	bool levelCache_loadGeometry(const char* levelName, u64 key);
+	// Writes the currently loaded level geometry to the cache, before post-processing.
+	// textureNames: the texture names in level order, an empty name if the texture line could not be read.
+	// sectorNames: the sector names in level order, an empty name if the sector is unnamed.
+	void levelCache_writeGeometry(const char* levelName, u64 key, const std::vector<std::string>& textureNames, const std::vector<std::string>& sectorNames);
+}
@@ -5,6 +5,9 @@
 #include "rsector.h"
 #include "rwall.h"
 #include "robjData.h"
+#include "sectorGrid.h"
+#include "sectorEdges.h"
+#include "levelInterp.h"
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
@@ -54,6 +57,9 @@ namespace TFE_Jedi
 		sector_clear(s_levelState.controlSector);
 
 		objData_clear();
+		sectorGrid_clear();
+		sectorEdges_clear();
+		levelInterp_clear();
 	}
 
 	void level_serializeFixupMirrors()
@@ -219,6 +225,8 @@ namespace TFE_Jedi
 			}
 
 			level_serializeFixupMirrors();
+			sectorGrid_build();
+			sectorEdges_build();
 		}
 
 		// Serialize objects.
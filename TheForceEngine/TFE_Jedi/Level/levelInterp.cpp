@@ -0,0 +1,433 @@
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+
+#include "levelInterp.h"
+#include "levelData.h"
+#include "rsector.h"
+#include "rwall.h"
+#include "robject.h"
+#include "sectorEdges.h"
+
+namespace TFE_Jedi
+{
+	// Objects, vertices and texture offsets that move further than this between steps are snapped rather than blended.
+	static const fixed16_16 c_maxInterpDist = FIXED(32);
+
+	enum InterpFlags
+	{
+		INTERP_HEIGHTS      = FLAG_BIT(0),
+		INTERP_VERTICES     = FLAG_BIT(1),
+		INTERP_FLAT_OFFSETS = FLAG_BIT(2),
+		INTERP_WALL_OFFSETS = FLAG_BIT(3),
+	};
+
+	struct InterpObject
+	{
+		SecObject* obj;
+		RSector* sector;
+		vec3_fixed pos;
+		angle14_16 pitch;
+		angle14_16 yaw;
+		angle14_16 roll;
+	};
+
+	struct InterpSector
+	{
+		fixed16_16 floorHeight;
+		fixed16_16 ceilingHeight;
+		fixed16_16 secHeight;
+		vec2_fixed floorOffset;
+		vec2_fixed ceilOffset;
+		s32 vertexStart;
+		s32 wallStart;
+		u32 flags;	// InterpFlags, only used by the saved state.
+	};
+
+	struct InterpWall
+	{
+		vec2_fixed topOffset;
+		vec2_fixed midOffset;
+		vec2_fixed botOffset;
+		vec2_fixed signOffset;
+	};
+
+	struct InterpSnapshot
+	{
+		RSector* sectorList = nullptr;
+		u32 sectorCount = 0;
+		std::vector<InterpSector> sectors;
+		std::vector<vec2_fixed> vertices;
+		std::vector<InterpWall> walls;
+		std::vector<InterpObject> objects;
+		std::unordered_map<SecObject*, s32> objectMap;
+	};
+
+	// The state at the end of the previous step and at the end of the current step.
+	static InterpSnapshot s_prevState;
+	static InterpSnapshot s_curState;
+
+	// Current state, saved while the blended state is being rendered.
+	static InterpSnapshot s_savedState;
+	static JBool s_applied = JFALSE;
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static fixed16_16 interpValue(fixed16_16 prev, fixed16_16 cur, fixed16_16 alpha)
+	{
+		return prev + mul16(cur - prev, alpha);
+	}
+
+	static vec2_fixed interpVec2(vec2_fixed prev, vec2_fixed cur, fixed16_16 alpha)
+	{
+		return { interpValue(prev.x, cur.x, alpha), interpValue(prev.z, cur.z, alpha) };
+	}
+
+	static angle14_16 interpAngle(angle14_16 prev, angle14_16 cur, fixed16_16 alpha)
+	{
+		// Take the shortest path around the circle.
+		const s32 delta = ((s32(cur) - s32(prev) + ANGLE_MAX / 2) & ANGLE_MASK) - ANGLE_MAX / 2;
+		return angle14_16(s32(prev) + mul16(delta, alpha));
+	}
+
+	static JBool vec2Equal(vec2_fixed a, vec2_fixed b)
+	{
+		return a.x == b.x && a.z == b.z;
+	}
+
+	static JBool vec2Near(vec2_fixed a, vec2_fixed b)
+	{
+		return TFE_Jedi::abs(a.x - b.x) <= c_maxInterpDist && TFE_Jedi::abs(a.z - b.z) <= c_maxInterpDist;
+	}
+
+	static void saveObject(InterpObject* entry, SecObject* obj)
+	{
+		entry->obj = obj;
+		entry->sector = obj->sector;
+		entry->pos = obj->posWS;
+		entry->pitch = obj->pitch;
+		entry->yaw = obj->yaw;
+		entry->roll = obj->roll;
+	}
+
+	static void setObject(SecObject* obj, const vec3_fixed& pos, angle14_16 pitch, angle14_16 yaw, angle14_16 roll)
+	{
+		obj->posWS = pos;
+		obj->pitch = pitch;
+		obj->yaw = yaw;
+		obj->roll = roll;
+		// 3D objects are drawn using the transform built from their angles.
+		if (obj->type == OBJ_TYPE_3D)
+		{
+			obj3d_computeTransform(obj);
+		}
+	}
+
+	static void saveSector(InterpSnapshot* snapshot, InterpSector* entry, const RSector* sector)
+	{
+		entry->floorHeight = sector->floorHeight;
+		entry->ceilingHeight = sector->ceilingHeight;
+		entry->secHeight = sector->secHeight;
+		entry->floorOffset = sector->floorOffset;
+		entry->ceilOffset = sector->ceilOffset;
+		entry->vertexStart = s32(snapshot->vertices.size());
+		entry->wallStart = s32(snapshot->walls.size());
+		entry->flags = 0;
+
+		snapshot->vertices.insert(snapshot->vertices.end(), sector->verticesWS, sector->verticesWS + sector->vertexCount);
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			snapshot->walls.push_back({ wall->topOffset, wall->midOffset, wall->botOffset, wall->signOffset });
+		}
+	}
+
+	static void saveSectors(InterpSnapshot* snapshot)
+	{
+		const u32 sectorCount = s_levelState.sectorCount;
+		snapshot->sectorList = s_levelState.sectors;
+		snapshot->sectorCount = sectorCount;
+		snapshot->sectors.resize(sectorCount);
+		snapshot->vertices.clear();
+		snapshot->walls.clear();
+
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			saveSector(snapshot, &snapshot->sectors[s], sector);
+		}
+	}
+
+	static void saveObjects(InterpSnapshot* snapshot)
+	{
+		snapshot->objects.clear();
+		snapshot->objectMap.clear();
+
+		const u32 sectorCount = s_levelState.sectorCount;
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			SecObject** objList = sector->objectList;
+			for (s32 i = 0, objIndex = 0; i < sector->objectCapacity && objIndex < sector->objectCount; i++)
+			{
+				SecObject* obj = objList[i];
+				if (!obj) { continue; }
+				objIndex++;
+
+				InterpObject entry;
+				saveObject(&entry, obj);
+				snapshot->objectMap[obj] = s32(snapshot->objects.size());
+				snapshot->objects.push_back(entry);
+			}
+		}
+	}
+
+	static JBool snapshotMatchesLevel(const InterpSnapshot* snapshot)
+	{
+		return snapshot->sectorList && snapshot->sectorList == s_levelState.sectors && snapshot->sectorCount == s_levelState.sectorCount;
+	}
+
+	static const InterpObject* findObject(const InterpSnapshot* snapshot, SecObject* obj)
+	{
+		std::unordered_map<SecObject*, s32>::const_iterator iter = snapshot->objectMap.find(obj);
+		return iter != snapshot->objectMap.end() ? &snapshot->objects[iter->second] : nullptr;
+	}
+
+	// Change the sector heights without moving the objects it contains, which are blended separately.
+	static void setSectorHeights(RSector* sector, fixed16_16 floorHeight, fixed16_16 ceilingHeight, fixed16_16 secHeight)
+	{
+		sector->floorHeight = floorHeight;
+		sector->ceilingHeight = ceilingHeight;
+		sector->secHeight = secHeight;
+		sector->dirtyFlags |= SDF_HEIGHTS;
+
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			if (wall->nextSector)
+			{
+				wall_setupAdjoinDrawFlags(wall);
+				wall_computeTexelHeights(wall->mirrorWall);
+			}
+			wall_computeTexelHeights(wall);
+		}
+	}
+
+	// Update the walls and bounds after the sector vertices change, without moving the objects it contains.
+	static void updateSectorVertices(RSector* sector)
+	{
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			sector_computeWallDirAndLength(wall);
+		}
+		sector_computeBounds(sector);
+		sector->dirtyFlags |= (SDF_VERTICES | SDF_WALL_SHAPE);
+		sectorEdges_markDirty(sector);
+	}
+
+	static void setWallOffsets(RSector* sector, const InterpWall* walls)
+	{
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++, walls++)
+		{
+			wall->topOffset = walls->topOffset;
+			wall->midOffset = walls->midOffset;
+			wall->botOffset = walls->botOffset;
+			wall->signOffset = walls->signOffset;
+		}
+		sector->dirtyFlags |= SDF_WALL_OFFSETS;
+	}
+
+	static void blendSectorVertices(RSector* sector, const vec2_fixed* prev, const vec2_fixed* cur, fixed16_16 alpha)
+	{
+		const s32 count = sector->vertexCount;
+		if (memcmp(prev, cur, sizeof(vec2_fixed) * count) == 0) { return; }
+		for (s32 v = 0; v < count; v++)
+		{
+			if (!vec2Near(prev[v], cur[v])) { return; }
+		}
+
+		vec2_fixed* vtx = sector->verticesWS;
+		for (s32 v = 0; v < count; v++)
+		{
+			vtx[v] = interpVec2(prev[v], cur[v], alpha);
+		}
+		updateSectorVertices(sector);
+		s_savedState.sectors[sector->index].flags |= INTERP_VERTICES;
+	}
+
+	static void blendWallOffsets(RSector* sector, const InterpWall* prev, const InterpWall* cur, fixed16_16 alpha)
+	{
+		const s32 count = sector->wallCount;
+		if (memcmp(prev, cur, sizeof(InterpWall) * count) == 0) { return; }
+
+		JBool changed = JFALSE;
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < count; w++, wall++)
+		{
+			const InterpWall* p = &prev[w];
+			const InterpWall* c = &cur[w];
+			// Offsets that jump (resets, large scroll steps) are left alone.
+			if (!vec2Near(p->topOffset, c->topOffset) || !vec2Near(p->midOffset, c->midOffset) ||
+				!vec2Near(p->botOffset, c->botOffset) || !vec2Near(p->signOffset, c->signOffset))
+			{
+				continue;
+			}
+			wall->topOffset = interpVec2(p->topOffset, c->topOffset, alpha);
+			wall->midOffset = interpVec2(p->midOffset, c->midOffset, alpha);
+			wall->botOffset = interpVec2(p->botOffset, c->botOffset, alpha);
+			wall->signOffset = interpVec2(p->signOffset, c->signOffset, alpha);
+			changed = JTRUE;
+		}
+		if (changed)
+		{
+			sector->dirtyFlags |= SDF_WALL_OFFSETS;
+			s_savedState.sectors[sector->index].flags |= INTERP_WALL_OFFSETS;
+		}
+	}
+
+	static void blendSector(RSector* sector, const InterpSector* prev, const InterpSector* cur, fixed16_16 alpha)
+	{
+		InterpSector* saved = &s_savedState.sectors[sector->index];
+		if (prev->floorHeight != cur->floorHeight || prev->ceilingHeight != cur->ceilingHeight || prev->secHeight != cur->secHeight)
+		{
+			setSectorHeights(sector, interpValue(prev->floorHeight, cur->floorHeight, alpha),
+				interpValue(prev->ceilingHeight, cur->ceilingHeight, alpha), interpValue(prev->secHeight, cur->secHeight, alpha));
+			saved->flags |= INTERP_HEIGHTS;
+		}
+
+		const JBool floorMoved = !vec2Equal(prev->floorOffset, cur->floorOffset) && vec2Near(prev->floorOffset, cur->floorOffset);
+		const JBool ceilMoved = !vec2Equal(prev->ceilOffset, cur->ceilOffset) && vec2Near(prev->ceilOffset, cur->ceilOffset);
+		if (floorMoved || ceilMoved)
+		{
+			if (floorMoved) { sector->floorOffset = interpVec2(prev->floorOffset, cur->floorOffset, alpha); }
+			if (ceilMoved) { sector->ceilOffset = interpVec2(prev->ceilOffset, cur->ceilOffset, alpha); }
+			sector->dirtyFlags |= SDF_FLAT_OFFSETS;
+			saved->flags |= INTERP_FLAT_OFFSETS;
+		}
+
+		blendSectorVertices(sector, s_prevState.vertices.data() + prev->vertexStart, s_curState.vertices.data() + cur->vertexStart, alpha);
+		blendWallOffsets(sector, s_prevState.walls.data() + prev->wallStart, s_curState.walls.data() + cur->wallStart, alpha);
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+	void levelInterp_clear()
+	{
+		s_prevState = {};
+		s_curState = {};
+		s_savedState = {};
+		s_applied = JFALSE;
+	}
+
+	void levelInterp_capture()
+	{
+		if (s_applied) { levelInterp_end(); }
+
+		// The state at the end of the last step becomes the previous state.
+		std::swap(s_prevState, s_curState);
+		saveSectors(&s_curState);
+		saveObjects(&s_curState);
+	}
+
+	JBool levelInterp_begin(fixed16_16 alpha)
+	{
+		if (s_applied) { levelInterp_end(); }
+		// Nothing to blend if the level has changed since the last two captures.
+		if (!snapshotMatchesLevel(&s_prevState) || !snapshotMatchesLevel(&s_curState))
+		{
+			return JFALSE;
+		}
+		alpha = clamp(alpha, 0, ONE_16);
+
+		saveSectors(&s_savedState);
+		s_savedState.objects.clear();
+
+		const u32 sectorCount = s_levelState.sectorCount;
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			blendSector(sector, &s_prevState.sectors[s], &s_curState.sectors[s], alpha);
+
+			SecObject** objList = sector->objectList;
+			for (s32 i = 0, objIndex = 0; i < sector->objectCapacity && objIndex < sector->objectCount; i++)
+			{
+				SecObject* obj = objList[i];
+				if (!obj) { continue; }
+				objIndex++;
+
+				const InterpObject* prevObj = findObject(&s_prevState, obj);
+				const InterpObject* curObj = findObject(&s_curState, obj);
+				if (!prevObj || !curObj || prevObj->sector != obj->sector || curObj->sector != obj->sector) { continue; }
+
+				const vec3_fixed* prevPos = &prevObj->pos;
+				const vec3_fixed* curPos = &curObj->pos;
+				if (TFE_Jedi::abs(curPos->x - prevPos->x) > c_maxInterpDist || TFE_Jedi::abs(curPos->y - prevPos->y) > c_maxInterpDist ||
+					TFE_Jedi::abs(curPos->z - prevPos->z) > c_maxInterpDist)
+				{
+					continue;
+				}
+
+				InterpObject saved;
+				saveObject(&saved, obj);
+				s_savedState.objects.push_back(saved);
+
+				const vec3_fixed pos =
+				{
+					interpValue(prevPos->x, curPos->x, alpha),
+					interpValue(prevPos->y, curPos->y, alpha),
+					interpValue(prevPos->z, curPos->z, alpha)
+				};
+				setObject(obj, pos, interpAngle(prevObj->pitch, curObj->pitch, alpha), interpAngle(prevObj->yaw, curObj->yaw, alpha),
+					interpAngle(prevObj->roll, curObj->roll, alpha));
+			}
+		}
+		s_applied = JTRUE;
+		return JTRUE;
+	}
+
+	void levelInterp_end()
+	{
+		if (!s_applied) { return; }
+		s_applied = JFALSE;
+
+		const size_t objCount = s_savedState.objects.size();
+		const InterpObject* saved = s_savedState.objects.data();
+		for (size_t i = 0; i < objCount; i++, saved++)
+		{
+			setObject(saved->obj, saved->pos, saved->pitch, saved->yaw, saved->roll);
+		}
+
+		if (!snapshotMatchesLevel(&s_savedState)) { return; }
+		const u32 sectorCount = s_levelState.sectorCount;
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < sectorCount; s++, sector++)
+		{
+			const InterpSector* cur = &s_savedState.sectors[s];
+			if (!cur->flags) { continue; }
+
+			if (cur->flags & INTERP_HEIGHTS)
+			{
+				setSectorHeights(sector, cur->floorHeight, cur->ceilingHeight, cur->secHeight);
+			}
+			if (cur->flags & INTERP_FLAT_OFFSETS)
+			{
+				sector->floorOffset = cur->floorOffset;
+				sector->ceilOffset = cur->ceilOffset;
+				sector->dirtyFlags |= SDF_FLAT_OFFSETS;
+			}
+			if (cur->flags & INTERP_VERTICES)
+			{
+				memcpy(sector->verticesWS, s_savedState.vertices.data() + cur->vertexStart, sizeof(vec2_fixed) * sector->vertexCount);
+				updateSectorVertices(sector);
+			}
+			if (cur->flags & INTERP_WALL_OFFSETS)
+			{
+				setWallOffsets(sector, s_savedState.walls.data() + cur->wallStart);
+			}
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Interpolation
+// Added for TFE: allows frames to be rendered between simulation
+// steps when the simulation runs at a fixed rate below the display
+// refresh rate.
+//
+// The level state is captured at the end of every simulation step
+// (object transforms, sector heights and vertices, and flat and wall
+// texture offsets), keeping the previous and current captures. When
+// a frame is drawn, the level state is temporarily replaced by a
+// blend of the two captures, rendered and then restored - so the
+// simulation only ever sees its own state.
+//
+// Objects that changed sectors or moved too far (teleports, respawns)
+// snap to their current state instead of being blended.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+namespace TFE_Jedi
+{
+	void levelInterp_clear();
+	// Capture the state at the end of a simulation step, the previous capture becomes the previous state.
+	void levelInterp_capture();
+	// Blend the level state between the previous step (alpha = 0) and the current step (alpha = ONE_16).
+	// Returns JFALSE if two steps have not been captured, in which case the level state is unchanged.
+	JBool levelInterp_begin(fixed16_16 alpha);
+	// Restore the current state after rendering.
+	void levelInterp_end();
+}
@@ -0,0 +1,344 @@
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <SDL_cpuinfo.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
+#include "levelPreload.h"
+#include "rtexture.h"
+#include <TFE_Asset/modelAsset_jedi.h>
+#include <TFE_Asset/spriteAsset_Jedi.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_System/parser.h>
+#include <TFE_System/system.h>
+
+namespace TFE_Jedi
+{
+	enum PreloadAssetType
+	{
+		PRELOAD_TEXTURE = 0,
+		PRELOAD_WAX,
+		PRELOAD_FRAME,
+		PRELOAD_MODEL,
+		PRELOAD_LEVEL_FILE,		// The .LEV and .O files, read while gathering the asset names.
+		PRELOAD_COUNT
+	};
+
+	enum
+	{
+		PRELOAD_MAX_THREADS = 8,
+	};
+
+	struct PreloadAsset
+	{
+		std::string name;
+		PreloadAssetType type;
+		LevelPreloadFile file;
+	};
+
+	static std::vector<PreloadAsset> s_preloadAssets;
+	static std::unordered_map<std::string, s32> s_preloadMap;
+	static atomic_s32 s_nextDecodeJob(0);
+	static bool s_preloadActive = false;
+
+	// The decode workers are created on the first level load and reused afterward.
+	static SDL_Thread* s_decodeWorkers[PRELOAD_MAX_THREADS];
+	static s32 s_decodeWorkerCount = 0;
+	static SDL_sem* s_decodeStart = nullptr;
+	static SDL_sem* s_decodeDone = nullptr;
+	static bool s_exitWorkers = false;
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static void addAsset(const char* name, PreloadAssetType type, LevelPreloadFile* file = nullptr)
+	{
+		if (s_preloadMap.find(name) != s_preloadMap.end()) { return; }
+		s_preloadMap[name] = s32(s_preloadAssets.size());
+
+		PreloadAsset asset;
+		asset.name = name;
+		asset.type = type;
+		if (file)
+		{
+			asset.file = std::move(*file);
+		}
+		s_preloadAssets.push_back(std::move(asset));
+	}
+
+	static bool readFile(const char* fileName, LevelPreloadFile* file)
+	{
+		FileStream stream;
+		if (!TFE_Paths::getFilePath(fileName, &file->filePath) || !stream.open(&file->filePath, Stream::MODE_READ))
+		{
+			return false;
+		}
+		file->data.resize(stream.getSize());
+		stream.readBuffer(file->data.data(), u32(file->data.size()));
+		stream.close();
+		return true;
+	}
+
+	// Gather the texture names, reading the LEV file the same way as level_loadGeometry() so the names match exactly.
+	static void collectLevelTextures(const char* levelName)
+	{
+		char levelPath[TFE_MAX_PATH];
+		sprintf(levelPath, "%s.LEV", levelName);
+		LevelPreloadFile levelFile;
+		if (!readFile(levelPath, &levelFile)) { return; }
+
+		TFE_Parser parser;
+		size_t bufferPos = 0;
+		parser.init((const char*)levelFile.data.data(), levelFile.data.size());
+		parser.addCommentString("#");
+		parser.convertToUpperCase(true);
+
+		const char* line;
+		char name[256];
+		while (nullptr != (line = parser.readLine(bufferPos)))
+		{
+			if (sscanf(line, " TEXTURE: %s ", name) == 1)
+			{
+				if (strcasecmp(name, "<NoTexture>") != 0)
+				{
+					addAsset(name, PRELOAD_TEXTURE);
+				}
+			}
+			// The texture list is done once the sectors start.
+			else if (strncmp(line, "NUMSECTORS", 10) == 0)
+			{
+				break;
+			}
+		}
+		// Keep the file data so level_loadGeometry() doesn't have to read it again.
+		addAsset(levelPath, PRELOAD_LEVEL_FILE, &levelFile);
+	}
+
+	// Gather the pod, sprite and frame names, reading the O file the same way as level_loadObjects().
+	static void collectLevelObjects(const char* levelName)
+	{
+		char objPath[TFE_MAX_PATH];
+		sprintf(objPath, "%s.O", levelName);
+		LevelPreloadFile objFile;
+		if (!readFile(objPath, &objFile)) { return; }
+
+		TFE_Parser parser;
+		size_t bufferPos = 0;
+		parser.init((const char*)objFile.data.data(), objFile.data.size());
+		parser.enableBlockComments();
+		parser.addCommentString("//");
+		parser.addCommentString("#");
+		parser.convertToUpperCase(true);
+
+		const char* line;
+		char name[32];
+		while (nullptr != (line = parser.readLine(bufferPos)))
+		{
+			if (sscanf(line, " POD: %31s", name) == 1)
+			{
+				addAsset(name, PRELOAD_MODEL);
+			}
+			else if (sscanf(line, " SPR: %31s ", name) == 1)
+			{
+				addAsset(name, PRELOAD_WAX);
+			}
+			else if (sscanf(line, " FME: %31s ", name) == 1)
+			{
+				addAsset(name, PRELOAD_FRAME);
+			}
+			// The asset lists are done once the objects start.
+			else if (strncmp(line, "OBJECTS", 7) == 0)
+			{
+				break;
+			}
+		}
+		// Keep the file data so level_loadObjects() doesn't have to read it again.
+		addAsset(objPath, PRELOAD_LEVEL_FILE, &objFile);
+	}
+
+	static void decodeAssets()
+	{
+		const s32 count = s32(s_preloadAssets.size());
+		while (1)
+		{
+			const s32 index = s_nextDecodeJob.fetch_add(1);
+			if (index >= count) { break; }
+
+			PreloadAsset* asset = &s_preloadAssets[index];
+			if (asset->type == PRELOAD_TEXTURE && !asset->file.data.empty())
+			{
+				if (!bitmap_decompressImage(asset->file.data.data(), asset->file.data.size(), asset->file.image))
+				{
+					asset->file.image.clear();
+				}
+			}
+		}
+	}
+
+	static int decodeWorkerFunc(void* userData)
+	{
+		while (1)
+		{
+			SDL_SemWait(s_decodeStart);
+			if (s_exitWorkers) { break; }
+
+			decodeAssets();
+			SDL_SemPost(s_decodeDone);
+		}
+		return 0;
+	}
+
+	// The main thread decodes as well, so only count - 1 workers are required.
+	static s32 createDecodeWorkers(s32 count)
+	{
+		if (!s_decodeStart)
+		{
+			s_decodeStart = SDL_CreateSemaphore(0);
+			if (!s_decodeStart) { return 0; }
+		}
+		if (!s_decodeDone)
+		{
+			s_decodeDone = SDL_CreateSemaphore(0);
+			if (!s_decodeDone) { return 0; }
+		}
+		while (s_decodeWorkerCount < count - 1)
+		{
+			SDL_Thread* thread = SDL_CreateThread(decodeWorkerFunc, "TFE_LevelPreload", nullptr);
+			if (!thread) { break; }
+			s_decodeWorkers[s_decodeWorkerCount++] = thread;
+		}
+		return min(s_decodeWorkerCount, count - 1);
+	}
+
+	/////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////
+	void levelPreload_begin(const char* levelName)
+	{
+		levelPreload_end();
+		u64 phaseStart = TFE_System::getCurrentTimeInTicks();
+
+		// Gather the asset names.
+		collectLevelTextures(levelName);
+		collectLevelObjects(levelName);
+		const f64 collectTime = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - phaseStart);
+		if (s_preloadAssets.empty()) { return; }
+
+		// Read the file data, missing assets are skipped and left to the level loading code to report.
+		phaseStart = TFE_System::getCurrentTimeInTicks();
+		size_t totalSize = 0;
+		s32 counts[PRELOAD_COUNT] = { 0 };
+		for (size_t i = 0; i < s_preloadAssets.size(); i++)
+		{
+			PreloadAsset* asset = &s_preloadAssets[i];
+			if (asset->type != PRELOAD_LEVEL_FILE && !readFile(asset->name.c_str(), &asset->file))
+			{
+				continue;
+			}
+			totalSize += asset->file.data.size();
+			counts[asset->type]++;
+		}
+		const f64 readTime = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - phaseStart);
+
+		// Decode on the worker threads and the main thread.
+		phaseStart = TFE_System::getCurrentTimeInTicks();
+		const s32 threadCount = clamp(min(SDL_GetCPUCount(), counts[PRELOAD_TEXTURE]), 1, (s32)PRELOAD_MAX_THREADS);
+		const s32 workerCount = createDecodeWorkers(threadCount);
+		s_nextDecodeJob = 0;
+		for (s32 t = 0; t < workerCount; t++)
+		{
+			SDL_SemPost(s_decodeStart);
+		}
+		decodeAssets();
+		for (s32 t = 0; t < workerCount; t++)
+		{
+			SDL_SemWait(s_decodeDone);
+		}
+		const f64 decodeTime = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - phaseStart);
+
+		// Add the assets to the level pool, the preloaded data is picked up by the asset loaders.
+		phaseStart = TFE_System::getCurrentTimeInTicks();
+		s_preloadActive = true;
+		for (size_t i = 0; i < s_preloadAssets.size(); i++)
+		{
+			const PreloadAsset* asset = &s_preloadAssets[i];
+			if (asset->file.data.empty()) { continue; }
+
+			const char* name = asset->name.c_str();
+			switch (asset->type)
+			{
+				case PRELOAD_TEXTURE:
+				{
+					bitmap_load(name, 1, POOL_LEVEL);
+				} break;
+				case PRELOAD_WAX:
+				{
+					TFE_Sprite_Jedi::getWax(name, POOL_LEVEL);
+				} break;
+				case PRELOAD_FRAME:
+				{
+					TFE_Sprite_Jedi::getFrame(name, POOL_LEVEL);
+				} break;
+				case PRELOAD_MODEL:
+				{
+					TFE_Model_Jedi::get(name, POOL_LEVEL);
+				} break;
+				default:
+					break;
+			}
+		}
+		const f64 cacheTime = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - phaseStart);
+
+		TFE_System::logWrite(LOG_MSG, "Level Preload", "Preloaded %d textures, %d sprites, %d frames and %d 3D objects (%u KB).",
+			counts[PRELOAD_TEXTURE], counts[PRELOAD_WAX], counts[PRELOAD_FRAME], counts[PRELOAD_MODEL], u32(totalSize / 1024));
+		TFE_System::logWrite(LOG_MSG, "Level Preload", "Collect: %.2f ms, Read: %.2f ms, Decode: %.2f ms (%d threads), Cache: %.2f ms.",
+			collectTime, readTime, decodeTime, workerCount + 1, cacheTime);
+	}
+
+	void levelPreload_end()
+	{
+		s_preloadActive = false;
+		s_preloadAssets.clear();
+		s_preloadMap.clear();
+	}
+
+	void levelPreload_destroy()
+	{
+		levelPreload_end();
+
+		s_exitWorkers = true;
+		for (s32 t = 0; t < s_decodeWorkerCount; t++)
+		{
+			SDL_SemPost(s_decodeStart);
+		}
+		for (s32 t = 0; t < s_decodeWorkerCount; t++)
+		{
+			SDL_WaitThread(s_decodeWorkers[t], nullptr);
+			s_decodeWorkers[t] = nullptr;
+		}
+		if (s_decodeStart)
+		{
+			SDL_DestroySemaphore(s_decodeStart);
+			s_decodeStart = nullptr;
+		}
+		if (s_decodeDone)
+		{
+			SDL_DestroySemaphore(s_decodeDone);
+			s_decodeDone = nullptr;
+		}
+		s_decodeWorkerCount = 0;
+		s_exitWorkers = false;
+	}
+
+	const LevelPreloadFile* levelPreload_getFile(const char* name)
+	{
+		if (!s_preloadActive) { return nullptr; }
+		std::unordered_map<std::string, s32>::const_iterator iAsset = s_preloadMap.find(name);
+		if (iAsset == s_preloadMap.end()) { return nullptr; }
+
+		const LevelPreloadFile* file = &s_preloadAssets[iAsset->second].file;
+		return file->data.empty() ? nullptr : file;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Level Preload
+// Added for TFE: loads the textures, sprites, frames and 3D objects
+// referenced by a level before the level itself is loaded.
+//
+// The asset names are gathered from the .LEV and .O files, the file
+// data is read in one pass and then compressed textures are decoded
+// in parallel. Finally the assets are added to the POOL_LEVEL caches,
+// so the regular level loading code finds them already loaded. The
+// .LEV and .O data is kept as well, so each file is read only once.
+//
+// Archives share a single file handle, so reading stays on the
+// main thread. Sprites and frames stay RLE compressed in memory and
+// only need to be copied and fixed up, while 3D objects allocate from
+// the level memory region and load their textures, so both are added
+// to the caches on the main thread.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_FileSystem/paths.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	struct LevelPreloadFile
+	{
+		FilePath filePath;
+		std::vector<u8> data;		// File contents.
+		std::vector<u8> image;		// Decompressed BM image, empty if the file is not a compressed BM.
+	};
+
+	// Gathers, reads and decodes the assets referenced by the level and adds them to the level pool.
+	void levelPreload_begin(const char* levelName);
+	// Frees the preloaded file data.
+	void levelPreload_end();
+	// Frees the preloaded file data and stops the decode worker threads.
+	void levelPreload_destroy();
+
+	// Returns the preloaded file data while the level is loading, or null if the file was not preloaded.
+	const LevelPreloadFile* levelPreload_getFile(const char* name);
+}
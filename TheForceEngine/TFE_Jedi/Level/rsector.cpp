@@ -1,13 +1,17 @@
 #include <climits>
 #include <cstring>
+#include <vector>
 
 #include "rsector.h"
 #include "rwall.h"
 #include "robject.h"
 #include "level.h"
 #include "levelData.h"
+#include "sectorGrid.h"
+#include "sectorEdges.h"
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
+#include <TFE_FrontEndUI/console.h>
 #include <TFE_DarkForces/player.h>
 #include <TFE_DarkForces/projectile.h>
 #include <TFE_Jedi/Collision/collision.h>
@@ -34,6 +38,8 @@ namespace TFE_Jedi
 	void sector_moveObjects(RSector* sector, u32 flags, fixed16_16 offsetX, fixed16_16 offsetZ);
 
 	f32 isLeft(Vec2f p0, Vec2f p1, Vec2f p2);
+
+	u32 s_sectorGeometryVersion = 0;
 	
 	/////////////////////////////////////////////////
 	// API Implementation
@@ -104,6 +110,7 @@ namespace TFE_Jedi
 	void sector_adjustHeights(RSector* sector, fixed16_16 floorOffset, fixed16_16 ceilOffset, fixed16_16 secondHeightOffset)
 	{
 		sector->dirtyFlags |= SDF_HEIGHTS;
+		s_sectorGeometryVersion++;
 
 		// Adjust objects.
 		if (sector->objectCount)
@@ -213,6 +220,9 @@ namespace TFE_Jedi
 		sector->boundsMax.x = maxX;
 		sector->boundsMin.z = minZ;
 		sector->boundsMax.z = maxZ;
+
+		// TFE: Keep the sector grid in sync with the bounds.
+		sectorGrid_updateSector(sector);
 	}
 
 	fixed16_16 sector_getMaxObjectHeight(RSector* sector)
@@ -508,41 +518,63 @@ namespace TFE_Jedi
 		}
 	}
 	
+	// Returns JTRUE if the point is inside of the sector and the sector area is smaller than the previous best.
+	JBool sector_which3D_testSector(RSector* sector, fixed16_16 ix, fixed16_16 iz, s32* prevSectorUnitArea)
+	{
+		const fixed16_16 sectorMaxX = sector->boundsMax.x;
+		const fixed16_16 sectorMinX = sector->boundsMin.x;
+		const fixed16_16 sectorMaxZ = sector->boundsMax.z;
+		const fixed16_16 sectorMinZ = sector->boundsMin.z;
+
+		const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
+		const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
+		const s32 sectorUnitArea = dzInt * dxInt;
+
+		if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+		{
+			// pick the containing sector with the smallest area.
+			if (sectorUnitArea < *prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
+			{
+				*prevSectorUnitArea = sectorUnitArea;
+				return JTRUE;
+			}
+		}
+		return JFALSE;
+	}
+
 	RSector* sector_which3D(fixed16_16 dx, fixed16_16 dy, fixed16_16 dz)
 	{
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 		fixed16_16 y = dy;
 		
-		RSector* sector = s_levelState.sectors;
 		RSector* foundSector = nullptr;
-		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		// TFE: Only test the sectors overlapping the grid cell containing the point.
+		// Candidates are visited in sector order, so the result matches the full scan.
+		const s32* candidates;
+		s32 candidateCount;
+		if (sectorGrid_getCandidates(ix, iz, &candidates, &candidateCount))
 		{
-			if (y >= sector->ceilingHeight && y <= sector->floorHeight)
+			for (s32 i = 0; i < candidateCount; i++)
 			{
-				const fixed16_16 sectorMaxX = sector->boundsMax.x;
-				const fixed16_16 sectorMinX = sector->boundsMin.x;
-				const fixed16_16 sectorMaxZ = sector->boundsMax.z;
-				const fixed16_16 sectorMinZ = sector->boundsMin.z;
-
-				const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
-				const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
-				sectorUnitArea = dzInt * dxInt;
-				
-				s32 insideBounds = 0;
-				if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+				RSector* sector = &s_levelState.sectors[candidates[i]];
+				if (y >= sector->ceilingHeight && y <= sector->floorHeight && sector_which3D_testSector(sector, ix, iz, &prevSectorUnitArea))
 				{
-					// pick the containing sector with the smallest area.
-					if (sectorUnitArea < prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
-					{
-						prevSectorUnitArea = sectorUnitArea;
-						foundSector = sector;
-					}
+					foundSector = sector;
 				}
 			}
+			return foundSector;
+		}
+
+		RSector* sector = s_levelState.sectors;
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		{
+			if (y >= sector->ceilingHeight && y <= sector->floorHeight && sector_which3D_testSector(sector, ix, iz, &prevSectorUnitArea))
+			{
+				foundSector = sector;
+			}
 		}
 
 		return foundSector;
@@ -553,35 +585,31 @@ namespace TFE_Jedi
 		fixed16_16 ix = dx;
 		fixed16_16 iz = dz;
 
-		RSector* sector = s_levelState.sectors;
 		RSector* foundSector = nullptr;
-		s32 sectorUnitArea = 0;
 		s32 prevSectorUnitArea = INT_MAX;
 
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		const s32* candidates;
+		s32 candidateCount;
+		if (sectorGrid_getCandidates(ix, iz, &candidates, &candidateCount))
 		{
-			if (sector->layer == layer)
+			for (s32 i = 0; i < candidateCount; i++)
 			{
-				const fixed16_16 sectorMaxX = sector->boundsMax.x;
-				const fixed16_16 sectorMinX = sector->boundsMin.x;
-				const fixed16_16 sectorMaxZ = sector->boundsMax.z;
-				const fixed16_16 sectorMinZ = sector->boundsMin.z;
-
-				const s32 dxInt = floor16(sectorMaxX - sectorMinX) + 1;
-				const s32 dzInt = floor16(sectorMaxZ - sectorMinZ) + 1;
-				sectorUnitArea = dzInt * dxInt;
-
-				s32 insideBounds = 0;
-				if (ix >= sectorMinX && ix <= sectorMaxX && iz >= sectorMinZ && iz <= sectorMaxZ)
+				RSector* sector = &s_levelState.sectors[candidates[i]];
+				if (sector->layer == layer && sector_which3D_testSector(sector, ix, iz, &prevSectorUnitArea))
 				{
-					// pick the containing sector with the smallest area.
-					if (sectorUnitArea < prevSectorUnitArea && sector_pointInsideDF(sector, ix, iz))
-					{
-						prevSectorUnitArea = sectorUnitArea;
-						foundSector = sector;
-					}
+					foundSector = sector;
 				}
 			}
+			return foundSector;
+		}
+
+		RSector* sector = s_levelState.sectors;
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		{
+			if (sector->layer == layer && sector_which3D_testSector(sector, ix, iz, &prevSectorUnitArea))
+			{
+				foundSector = sector;
+			}
 		}
 
 		return foundSector;
@@ -671,7 +699,7 @@ namespace TFE_Jedi
 	}
 
 	// The original DF algorithm.
-	JBool sector_pointInsideDF(RSector* sector, fixed16_16 x, fixed16_16 z)
+	static JBool sector_pointInsideDF_walls(RSector* sector, fixed16_16 x, fixed16_16 z)
 	{
 		const fixed16_16 xFrac = fract16(x);
 		const fixed16_16 zFrac = fract16(z);
@@ -744,6 +772,140 @@ namespace TFE_Jedi
 		return (crossings & 1) ? JTRUE : JFALSE;
 	}
 
+	// TFE: The original DF algorithm using the sector edge table.
+	// Edges rejected by sectorEdges_getCandidates() return PS_INSIDE or are skipped by the original loop, so only the
+	// candidates are tested - in the same order, producing the same result and errors. The only state carried between
+	// edges is dzLast, which does not depend on the point and is stored per edge.
+	JBool sector_pointInsideDF(RSector* sector, fixed16_16 x, fixed16_16 z)
+	{
+		const SectorEdgeTable* table = sectorEdges_get(sector);
+		if (!table)
+		{
+			return sector_pointInsideDF_walls(sector, x, z);
+		}
+
+		const s32* candidates;
+		const s32 candidateCount = sectorEdges_getCandidates(table, x, z, &candidates);
+		s32 crossings = 0;
+		for (s32 i = 0; i < candidateCount; i++)
+		{
+			const s32 e = candidates[i];
+			const fixed16_16 x0 = table->x0[e];
+			const fixed16_16 z0 = table->z0[e];
+			const fixed16_16 x1 = table->x1[e];
+			const fixed16_16 z1 = table->z1[e];
+			const fixed16_16 dz = z1 - z0;
+
+			if (dz != 0)
+			{
+				if (z == z0 && x == x0)
+				{
+					TFE_System::logWrite(LOG_ERROR, "Sector", "Sector_Which3D: Object at (%d.%d, %d.%d) lies on a vertex of Sector #%d", floor16(x), fract16(x), floor16(z), fract16(z), sector->id);
+					return JTRUE;
+				}
+				else if (z != z0)
+				{
+					if (z != z1)
+					{
+						PointSegSide side = lineSegmentSide(x, z, x0, z0, x1, z1);
+						if (side == PS_OUTSIDE)
+						{
+							crossings++;
+						}
+						else if (side == PS_ON_LINE)
+						{
+							TFE_System::logWrite(LOG_ERROR, "Sector", "Sector_Which3D: Object at (%d.%d, %d.%d) lies on wall of Sector #%d", floor16(x), fract16(x), floor16(z), fract16(z), sector->id);
+							return JTRUE;
+						}
+					}
+				}
+				else if (x < x0)
+				{
+					const fixed16_16 dzLast = table->dzPrev[e];
+					if ((dz ^ dzLast) >= 0 || dzLast == 0)
+					{
+						crossings++;
+					}
+				}
+			}
+			else if (lineSegmentSide(x, z, x0, z0, x1, z1) == PS_ON_LINE)
+			{
+				TFE_System::logWrite(LOG_ERROR, "Sector", "Sector_Which3D: Object at (%d.%d, %d.%d) lies on wall of Sector #%d", floor16(x), fract16(x), floor16(z), fract16(z), sector->id);
+				return JTRUE;
+			}
+		}
+
+		return (crossings & 1) ? JTRUE : JFALSE;
+	}
+
+	/////////////////////////////////////////////
+	// TFE: Point in sector benchmark
+	/////////////////////////////////////////////
+	static s32 sector_benchRandom(u32* seed, s32 range)
+	{
+		*seed = (*seed) * 1664525u + 1013904223u;
+		return range > 0 ? s32((*seed) % u32(range)) : 0;
+	}
+
+	static f64 sector_benchQueries(const std::vector<vec2_fixed>& points, const std::vector<s32>& sectors, JBool useTable, std::vector<u8>& results)
+	{
+		RSector* levelSectors = s_levelState.sectors;
+		const size_t count = points.size();
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		for (size_t q = 0; q < count; q++)
+		{
+			RSector* sector = &levelSectors[sectors[q]];
+			const vec2_fixed* p = &points[q];
+			results[q] = useTable ? sector_pointInsideDF(sector, p->x, p->z) : sector_pointInsideDF_walls(sector, p->x, p->z);
+		}
+		return TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - start);
+	}
+
+	void sector_benchmarkPointInside(s32 queryCount)
+	{
+		if (!s_levelState.sectors || !s_levelState.sectorCount)
+		{
+			TFE_Console::addToHistory("A level must be loaded to run the point in sector benchmark.");
+			return;
+		}
+		queryCount = max(1, queryCount);
+
+		// Random points inside of the bounds of random sectors, so most edges pass the z range test.
+		u32 seed = 12345;
+		std::vector<vec2_fixed> points(queryCount);
+		std::vector<s32> sectors(queryCount);
+		for (s32 q = 0; q < queryCount; q++)
+		{
+			const s32 index = sector_benchRandom(&seed, s32(s_levelState.sectorCount));
+			const RSector* sector = &s_levelState.sectors[index];
+			const fixed16_16 dx = sector->boundsMax.x - sector->boundsMin.x;
+			const fixed16_16 dz = sector->boundsMax.z - sector->boundsMin.z;
+			sectors[q] = index;
+			points[q].x = sector->boundsMin.x + sector_benchRandom(&seed, dx + 1);
+			points[q].z = sector->boundsMin.z + sector_benchRandom(&seed, dz + 1);
+		}
+
+		std::vector<u8> wallResults(queryCount), tableResults(queryCount);
+		const f64 wallMs = sector_benchQueries(points, sectors, JFALSE, wallResults);
+		const f64 tableMs = sector_benchQueries(points, sectors, JTRUE, tableResults);
+
+		s32 inside = 0, mismatches = 0;
+		for (s32 q = 0; q < queryCount; q++)
+		{
+			inside += tableResults[q] ? 1 : 0;
+			mismatches += (tableResults[q] != wallResults[q]) ? 1 : 0;
+		}
+
+		char line[256];
+		sprintf(line, "Point in sector: %d sectors, %d queries, %d inside.", s_levelState.sectorCount, queryCount, inside);
+		TFE_Console::addToHistory(line);
+		TFE_System::logWrite(LOG_MSG, "Sector", "%s", line);
+		sprintf(line, "walls %.3f ms, edge tables %.3f ms, speedup %.2fx, results %s (%d mismatches)",
+			wallMs, tableMs, tableMs > 0.0 ? wallMs / tableMs : 0.0, mismatches ? "MISMATCH" : "identical", mismatches);
+		TFE_Console::addToHistory(line);
+		TFE_System::logWrite(LOG_MSG, "Sector", "%s", line);
+	}
+
 	// Uses the "Winding Number" test for a point in polygon.
 	// The point is considered inside if the winding number is greater than 0.
 	// Note that this is different than DF's "crossing" algorithm.
@@ -911,6 +1073,9 @@ namespace TFE_Jedi
 
 	void sector_rotateWall(RWall* wall, fixed16_16 cosAngle, fixed16_16 sinAngle, fixed16_16 centerX, fixed16_16 centerZ)
 	{
+		s_sectorGeometryVersion++;
+		// TFE: The renderers clear dirtyFlags, so flag the edge table separately.
+		sectorEdges_markDirty(wall->sector);
 		fixed16_16 x0 = wall->worldPos0.x - centerX;
 		fixed16_16 z0 = wall->worldPos0.z - centerZ;
 		wall->w0->x = mul16(x0, cosAngle) - mul16(z0, sinAngle) + centerX;
@@ -1088,6 +1253,8 @@ namespace TFE_Jedi
 
 	void sector_moveWallVertex(RWall* wall, fixed16_16 offsetX, fixed16_16 offsetZ)
 	{
+		s_sectorGeometryVersion++;
+		sectorEdges_markDirty(wall->sector);
 		// Offset vertex 0.
 		wall->w0->x += offsetX;
 		wall->w0->z += offsetZ;
@@ -137,10 +137,16 @@ struct RSector
 
 namespace TFE_Jedi
 {
+	// Added for TFE: incremented whenever the simulation changes sector heights, wall positions or adjoins,
+	// so cached collision queries can tell when they are out of date.
+	// The render-frame blends in levelInterp restore the simulated state afterward, so they leave it alone.
+	extern u32 s_sectorGeometryVersion;
+
 	void sector_clear(RSector* sector);
 	void sector_setupWallDrawFlags(RSector* sector);
 	void sector_adjustHeights(RSector* sector, fixed16_16 floorOffset, fixed16_16 ceilOffset, fixed16_16 secondHeightOffset);
 	void sector_computeBounds(RSector* sector);
+	void sector_computeWallDirAndLength(RWall* wall);
 
 	fixed16_16 sector_getMaxObjectHeight(RSector* sector);
 	JBool sector_canMoveWalls(RSector* sector, fixed16_16 delta, fixed16_16 dirX, fixed16_16 dirZ, u32 flags);
@@ -158,6 +164,8 @@ namespace TFE_Jedi
 	RSector* sector_which3D_Map(fixed16_16 dx, fixed16_16 dz, s32 layer);
 	bool sector_pointInside(RSector* sector, fixed16_16 x, fixed16_16 z);
 	JBool sector_pointInsideDF(RSector* sector, fixed16_16 x, fixed16_16 z);
+	// TFE: Times sector_pointInsideDF() with and without the edge tables and compares the results.
+	void sector_benchmarkPointInside(s32 queryCount);
 
 	void sector_getFloorAndCeilHeight(RSector* sector, fixed16_16* floorHeight, fixed16_16* ceilHeight);
 	void sector_getObjFloorAndCeilHeight(RSector* sector, fixed16_16 y, fixed16_16* floorHeight, fixed16_16* ceilHeight);
@@ -10,6 +10,7 @@
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_Jedi/Task/task.h>
 #include <TFE_Jedi/Serialization/serialization.h>
+#include "levelPreload.h"
 #include <TFE_System/math.h>
 #include <TFE_Settings/settings.h>
 #include <unordered_map>
@@ -327,27 +328,40 @@ namespace TFE_Jedi
 			return s_textureList[pool][iTex->second].texture;
 		}
 
+		// TFE: Use the data read by the level preload, if available.
+		const LevelPreloadFile* preloaded = levelPreload_getFile(name);
 		FilePath filepath;
-		if (!TFE_Paths::getFilePath(name, &filepath))
+		const u8* data;
+		size_t size;
+		if (preloaded)
 		{
-			return nullptr;
+			filepath = preloaded->filePath;
+			data = preloaded->data.data();
+			size = preloaded->data.size();
 		}
-
-		FileStream file;
-		if (!file.open(&filepath, Stream::MODE_READ))
+		else
 		{
-			return nullptr;
-		}
+			if (!TFE_Paths::getFilePath(name, &filepath))
+			{
+				return nullptr;
+			}
 
-		size_t size = file.getSize();
-		s_buffer.resize(size);
-		file.readBuffer(s_buffer.data(), (u32)size);
-		file.close();
+			FileStream file;
+			if (!file.open(&filepath, Stream::MODE_READ))
+			{
+				return nullptr;
+			}
+
+			size = file.getSize();
+			s_buffer.resize(size);
+			file.readBuffer(s_buffer.data(), (u32)size);
+			file.close();
+			data = s_buffer.data();
+		}
 
 		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
 		memset(texture, 0, sizeof(TextureData));
 
-		const u8* data = s_buffer.data();
 		const u8* end = data + size;
 		const u8* fheader = data;
 		data += 3;
@@ -399,7 +413,12 @@ namespace TFE_Jedi
 				data += sizeof(u32) * texture->width;
 				assert(data <= end);
 
-				if (texture->compressed == 1)
+				// TFE: The level preload may have already decompressed the image.
+				if (preloaded && preloaded->image.size() == texture->dataSize)
+				{
+					memcpy(texture->image, preloaded->image.data(), texture->dataSize);
+				}
+				else if (texture->compressed == 1)
 				{
 					u8* dst = texture->image;
 					for (s32 i = 0; i < texture->width; i++, dst += texture->height)
@@ -490,6 +509,46 @@ namespace TFE_Jedi
 		return texture;
 	}
 
+	bool bitmap_decompressImage(const u8* data, size_t size, std::vector<u8>& image)
+	{
+		// Header (16 bytes) + compressed size and padding (16 bytes).
+		if (size < 32 || strncmp((const char*)data, "BM ", 3) || data[3] != DF_BM_VERSION) { return false; }
+		const u8* end = data + size;
+		data += 4;
+
+		const s32 width = readUShort(data);
+		const s32 height = readUShort(data);
+		data += 2 * sizeof(s16) + 2;	// uvWidth, uvHeight, flags, logSizeY
+		const u8 compressed = readByte(data);
+		data++;
+		if (compressed != 1 && compressed != 2) { return false; }
+
+		const u32 inSize = (u32)readInt(data);
+		data += 12;
+		const u8* inBuffer = data;
+		if (inSize > u32(end - inBuffer) || u32(end - inBuffer) - inSize < width * sizeof(u32)) { return false; }
+		const u32* columns = (const u32*)(inBuffer + inSize);
+		for (s32 i = 0; i < width; i++)
+		{
+			if (columns[i] >= inSize) { return false; }
+		}
+
+		image.resize(width * height);
+		u8* dst = image.data();
+		for (s32 i = 0; i < width; i++, dst += height)
+		{
+			if (compressed == 1)
+			{
+				decompressColumn_Type1(&inBuffer[columns[i]], dst, height);
+			}
+			else
+			{
+				decompressColumn_Type2(&inBuffer[columns[i]], dst, height);
+			}
+		}
+		return true;
+	}
+
 	TextureData* bitmap_loadFromMemory(const u8* data, size_t size, u32 decompress)
 	{
 		TextureData* texture = (TextureData*)malloc(sizeof(TextureData));
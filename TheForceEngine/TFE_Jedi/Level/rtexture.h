@@ -115,6 +115,9 @@ namespace TFE_Jedi
 
 	// Used for tools.
 	TextureData* bitmap_loadFromMemory(const u8* data, size_t size, u32 decompress);
+	// TFE: Decompress the image of a compressed BM file (width * height, column major).
+	// Returns false if the data is not a valid compressed BM. Does not access shared state, so it is safe to call from any thread.
+	bool bitmap_decompressImage(const u8* data, size_t size, std::vector<u8>& image);
 	Allocator* bitmap_getAnimTextureAlloc();
 
 	// Serialization.
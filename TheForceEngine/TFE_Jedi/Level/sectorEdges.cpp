@@ -0,0 +1,209 @@
+#include <climits>
+#include <cstring>
+
+#include "sectorEdges.h"
+#include "levelData.h"
+#include "rwall.h"
+#include <TFE_Game/igame.h>
+
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2))
+	#include <emmintrin.h>
+	#define SECTOR_EDGES_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define SECTOR_EDGES_NEON 1
+#endif
+
+namespace TFE_Jedi
+{
+	struct SectorEdgeState
+	{
+		RSector* sectors;		// sector list the tables were built for.
+		u32 sectorCount;
+		SectorEdgeTable* tables;
+		s32* candidates;		// candidate list returned by sectorEdges_getCandidates(), sized to the largest sector.
+	};
+	static SectorEdgeState s_edges = {};
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static void sectorEdges_alloc(SectorEdgeTable* table, s32 wallCount)
+	{
+		const s32 paddedCount = (wallCount + SECTOR_EDGE_LANES - 1) & ~(SECTOR_EDGE_LANES - 1);
+		fixed16_16* data = (fixed16_16*)level_alloc(sizeof(fixed16_16) * paddedCount * 8);
+
+		table->count = wallCount;
+		table->paddedCount = paddedCount;
+		table->dirty = JTRUE;
+		table->x0 = data;
+		table->z0 = table->x0 + paddedCount;
+		table->x1 = table->z0 + paddedCount;
+		table->z1 = table->x1 + paddedCount;
+		table->dzPrev = table->z1 + paddedCount;
+		table->minZ = table->dzPrev + paddedCount;
+		table->maxZ = table->minZ + paddedCount;
+		table->maxX = table->maxZ + paddedCount;
+	}
+
+	static void sectorEdges_fill(SectorEdgeTable* table, RSector* sector)
+	{
+		const s32 count = table->count;
+		RWall* wall = sector->walls;
+		for (s32 w = 0; w < count; w++, wall++)
+		{
+			const fixed16_16 x0 = wall->w0->x, z0 = wall->w0->z;
+			const fixed16_16 x1 = wall->w1->x, z1 = wall->w1->z;
+			table->x0[w] = x0;
+			table->z0[w] = z0;
+			table->x1[w] = x1;
+			table->z1[w] = z1;
+			table->minZ[w] = min(z0, z1);
+			table->maxZ[w] = max(z0, z1);
+			table->maxX[w] = max(x0, x1);
+		}
+
+		// Replay how the original loop updates dzLast, which does not depend on the point.
+		fixed16_16 dzPrev = count ? table->z1[count - 1] - table->z0[count - 1] : 0;
+		for (s32 w = 0; w < count; w++)
+		{
+			const fixed16_16 dz = table->z1[w] - table->z0[w];
+			table->dzPrev[w] = dzPrev;
+			if (dz != 0) { dzPrev = dz; }
+		}
+
+		// Padding, minZ > maxZ so it never passes.
+		for (s32 w = count; w < table->paddedCount; w++)
+		{
+			table->x0[w] = 0;
+			table->z0[w] = 0;
+			table->x1[w] = 0;
+			table->z1[w] = 0;
+			table->dzPrev[w] = 0;
+			table->minZ[w] = INT_MAX;
+			table->maxZ[w] = INT_MIN;
+			table->maxX[w] = INT_MIN;
+		}
+		table->dirty = JFALSE;
+	}
+
+	static SectorEdgeTable* sectorEdges_getTable(RSector* sector)
+	{
+		if (!s_edges.tables || s_edges.sectors != s_levelState.sectors || s_edges.sectorCount != s_levelState.sectorCount)
+		{
+			return nullptr;
+		}
+		// The control sector and sectors from other lists are not part of the tables.
+		if (sector->index < 0 || sector->index >= s32(s_edges.sectorCount) || &s_edges.sectors[sector->index] != sector)
+		{
+			return nullptr;
+		}
+		return &s_edges.tables[sector->index];
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+	void sectorEdges_clear()
+	{
+		s_edges = {};
+	}
+
+	void sectorEdges_build()
+	{
+		sectorEdges_clear();
+
+		const u32 sectorCount = s_levelState.sectorCount;
+		RSector* sectors = s_levelState.sectors;
+		if (!sectorCount || !sectors) { return; }
+
+		s_edges.sectors = sectors;
+		s_edges.sectorCount = sectorCount;
+		s_edges.tables = (SectorEdgeTable*)level_alloc(sizeof(SectorEdgeTable) * sectorCount);
+
+		s32 maxWallCount = 0;
+		for (u32 i = 0; i < sectorCount; i++)
+		{
+			sectorEdges_alloc(&s_edges.tables[i], sectors[i].wallCount);
+			maxWallCount = max(maxWallCount, sectors[i].wallCount);
+		}
+		s_edges.candidates = (s32*)level_alloc(sizeof(s32) * max(maxWallCount, 1));
+	}
+
+	void sectorEdges_markDirty(RSector* sector)
+	{
+		SectorEdgeTable* table = sectorEdges_getTable(sector);
+		if (table)
+		{
+			table->dirty = JTRUE;
+		}
+	}
+
+	const SectorEdgeTable* sectorEdges_get(RSector* sector)
+	{
+		SectorEdgeTable* table = sectorEdges_getTable(sector);
+		if (!table || table->count != sector->wallCount)
+		{
+			return nullptr;
+		}
+		if (table->dirty)
+		{
+			sectorEdges_fill(table, sector);
+		}
+		return table;
+	}
+
+	s32 sectorEdges_getCandidates(const SectorEdgeTable* table, fixed16_16 x, fixed16_16 z, const s32** list)
+	{
+		s32* candidates = s_edges.candidates;
+		s32 count = 0;
+		*list = candidates;
+
+	#if defined(SECTOR_EDGES_SSE2)
+		const __m128i px = _mm_set1_epi32(x);
+		const __m128i pz = _mm_set1_epi32(z);
+		for (s32 i = 0; i < table->paddedCount; i += SECTOR_EDGE_LANES)
+		{
+			const __m128i minZ = _mm_loadu_si128((const __m128i*)&table->minZ[i]);
+			const __m128i maxZ = _mm_loadu_si128((const __m128i*)&table->maxZ[i]);
+			const __m128i maxX = _mm_loadu_si128((const __m128i*)&table->maxX[i]);
+			// Reject if minZ > z, z > maxZ or x > maxX.
+			const __m128i reject = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(minZ, pz), _mm_cmpgt_epi32(pz, maxZ)), _mm_cmpgt_epi32(px, maxX));
+			const s32 mask = ~_mm_movemask_ps(_mm_castsi128_ps(reject)) & 0xf;
+			if (!mask) { continue; }
+
+			for (s32 l = 0; l < SECTOR_EDGE_LANES; l++)
+			{
+				if (mask & (1 << l)) { candidates[count++] = i + l; }
+			}
+		}
+	#elif defined(SECTOR_EDGES_NEON)
+		const int32x4_t px = vdupq_n_s32(x);
+		const int32x4_t pz = vdupq_n_s32(z);
+		for (s32 i = 0; i < table->paddedCount; i += SECTOR_EDGE_LANES)
+		{
+			const int32x4_t minZ = vld1q_s32(&table->minZ[i]);
+			const int32x4_t maxZ = vld1q_s32(&table->maxZ[i]);
+			const int32x4_t maxX = vld1q_s32(&table->maxX[i]);
+			// Accept if minZ <= z, z <= maxZ and x <= maxX.
+			const uint32x4_t accept = vandq_u32(vandq_u32(vcleq_s32(minZ, pz), vcleq_s32(pz, maxZ)), vcleq_s32(px, maxX));
+			u32 lanes[SECTOR_EDGE_LANES];
+			vst1q_u32(lanes, accept);
+
+			for (s32 l = 0; l < SECTOR_EDGE_LANES; l++)
+			{
+				if (lanes[l]) { candidates[count++] = i + l; }
+			}
+		}
+	#else
+		for (s32 i = 0; i < table->count; i++)
+		{
+			if (table->minZ[i] <= z && z <= table->maxZ[i] && x <= table->maxX[i])
+			{
+				candidates[count++] = i;
+			}
+		}
+	#endif
+		return count;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Sector Edges
+// Added for TFE: flattened per-sector edge tables used to accelerate
+// sector_pointInsideDF().
+//
+// Each sector stores its wall vertices as a structure of arrays along
+// with the bounds used to reject edges that cannot affect the crossing
+// test, which lets the rejection run 4 edges at a time with SIMD.
+// The arrays are padded to a multiple of SECTOR_EDGE_LANES entries,
+// the padding always fails the test.
+// Tables are rebuilt lazily, after sectorEdges_markDirty() is called
+// for a sector whose vertices have moved.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "rsector.h"
+
+namespace TFE_Jedi
+{
+	enum SectorEdgeConstants
+	{
+		SECTOR_EDGE_LANES = 4,
+	};
+
+	struct SectorEdgeTable
+	{
+		s32 count;			// edge (wall) count.
+		s32 paddedCount;	// count rounded up to a multiple of SECTOR_EDGE_LANES.
+		JBool dirty;
+
+		// Edge vertices.
+		fixed16_16* x0;
+		fixed16_16* z0;
+		fixed16_16* x1;
+		fixed16_16* z1;
+		// z1 - z0 of the closest previous edge where it is not zero, wrapping to the last edge.
+		// This is the 'dzLast' value sector_pointInsideDF() sees when it reaches the edge.
+		fixed16_16* dzPrev;
+		// Rejection bounds: only edges where minZ <= z <= maxZ and x <= maxX can change the result.
+		fixed16_16* minZ;
+		fixed16_16* maxZ;
+		fixed16_16* maxX;
+	};
+
+	void sectorEdges_clear();
+	// Allocate the tables for the current level, called once the level geometry is loaded or restored.
+	void sectorEdges_build();
+	// Flag the sector table for rebuilding, called whenever the sector vertices move.
+	void sectorEdges_markDirty(RSector* sector);
+	// Get the edge table for the sector, rebuilding it if needed.
+	// Returns null if the tables have not been built, in which case the caller should use the walls directly.
+	const SectorEdgeTable* sectorEdges_get(RSector* sector);
+	// Get the indices (in ascending order) of the edges that pass the rejection test for the point (x, z).
+	// The list is valid until the next call, returns the number of indices.
+	s32 sectorEdges_getCandidates(const SectorEdgeTable* table, fixed16_16 x, fixed16_16 z, const s32** list);
+}
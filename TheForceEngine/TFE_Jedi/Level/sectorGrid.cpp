@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include "sectorGrid.h"
+#include "levelData.h"
+#include <TFE_Game/igame.h>
+
+namespace TFE_Jedi
+{
+	enum SectorGridConstants
+	{
+		GRID_MAX_DIM   = 128,
+		GRID_MIN_CELL  = FIXED(4),
+		GRID_CELL_PAD  = 4,	// extra slots allocated per cell to absorb small INF movements.
+	};
+
+	struct GridCell
+	{
+		s32 count;
+		s32 capacity;
+		s32* sectors;
+	};
+
+	struct GridRect
+	{
+		s32 x0, z0;
+		s32 x1, z1;
+	};
+
+	struct SectorGrid
+	{
+		fixed16_16 originX;
+		fixed16_16 originZ;
+		fixed16_16 cellSize;
+		s32 width;
+		s32 height;
+		u32 sectorCount;
+
+		GridCell* cells;
+		GridRect* rects;	// current cell rectangle of each sector.
+		u32* queryStamp;	// last rectangle query that added each sector, used to remove duplicates.
+		u32  queryId;
+	};
+	static SectorGrid s_grid = {};
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static s32 sectorGrid_cellCoord(fixed16_16 value, fixed16_16 origin, s32 dim)
+	{
+		const s64 offset = s64(value) - s64(origin);
+		if (offset <= 0) { return 0; }
+
+		const s64 cell = offset / s64(s_grid.cellSize);
+		return cell >= dim ? dim - 1 : s32(cell);
+	}
+
+	static void sectorGrid_computeRect(RSector* sector, GridRect* rect)
+	{
+		rect->x0 = sectorGrid_cellCoord(sector->boundsMin.x, s_grid.originX, s_grid.width);
+		rect->x1 = sectorGrid_cellCoord(sector->boundsMax.x, s_grid.originX, s_grid.width);
+		rect->z0 = sectorGrid_cellCoord(sector->boundsMin.z, s_grid.originZ, s_grid.height);
+		rect->z1 = sectorGrid_cellCoord(sector->boundsMax.z, s_grid.originZ, s_grid.height);
+	}
+
+	// Insert the sector index, keeping the list sorted so iteration order matches a linear scan.
+	static void sectorGrid_cellInsert(GridCell* cell, s32 index)
+	{
+		if (cell->count >= cell->capacity)
+		{
+			s32 newCapacity = cell->capacity + GRID_CELL_PAD;
+			cell->sectors = (s32*)level_realloc(cell->sectors, sizeof(s32) * newCapacity);
+			cell->capacity = newCapacity;
+		}
+
+		s32 pos = cell->count;
+		while (pos > 0 && cell->sectors[pos - 1] > index)
+		{
+			cell->sectors[pos] = cell->sectors[pos - 1];
+			pos--;
+		}
+		cell->sectors[pos] = index;
+		cell->count++;
+	}
+
+	static void sectorGrid_cellRemove(GridCell* cell, s32 index)
+	{
+		for (s32 i = 0; i < cell->count; i++)
+		{
+			if (cell->sectors[i] == index)
+			{
+				cell->count--;
+				if (i < cell->count)
+				{
+					memmove(&cell->sectors[i], &cell->sectors[i + 1], sizeof(s32) * (cell->count - i));
+				}
+				break;
+			}
+		}
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+	void sectorGrid_clear()
+	{
+		s_grid = {};
+	}
+
+	void sectorGrid_build()
+	{
+		sectorGrid_clear();
+
+		const u32 sectorCount = s_levelState.sectorCount;
+		RSector* sectors = s_levelState.sectors;
+		if (!sectorCount || !sectors) { return; }
+
+		// Compute the level bounds.
+		fixed16_16 minX = sectors[0].boundsMin.x, maxX = sectors[0].boundsMax.x;
+		fixed16_16 minZ = sectors[0].boundsMin.z, maxZ = sectors[0].boundsMax.z;
+		for (u32 i = 1; i < sectorCount; i++)
+		{
+			minX = min(minX, sectors[i].boundsMin.x);
+			minZ = min(minZ, sectors[i].boundsMin.z);
+			maxX = max(maxX, sectors[i].boundsMax.x);
+			maxZ = max(maxZ, sectors[i].boundsMax.z);
+		}
+
+		// Aim for roughly 4 cells per sector, with the longest axis clamped to GRID_MAX_DIM cells.
+		const s32 dim = clamp(s32(sqrtf(f32(sectorCount)) * 2.0f), 1, (s32)GRID_MAX_DIM);
+		const s64 extentX = s64(maxX) - s64(minX);
+		const s64 extentZ = s64(maxZ) - s64(minZ);
+		s64 cellSize = (extentX > extentZ ? extentX : extentZ) / dim + 1;
+		if (cellSize < GRID_MIN_CELL) { cellSize = GRID_MIN_CELL; }
+
+		s_grid.originX = minX;
+		s_grid.originZ = minZ;
+		s_grid.cellSize = fixed16_16(cellSize);
+		s_grid.width  = clamp(s32(extentX / cellSize) + 1, 1, (s32)GRID_MAX_DIM);
+		s_grid.height = clamp(s32(extentZ / cellSize) + 1, 1, (s32)GRID_MAX_DIM);
+		s_grid.sectorCount = sectorCount;
+
+		const s32 cellCount = s_grid.width * s_grid.height;
+		s_grid.cells = (GridCell*)level_alloc(sizeof(GridCell) * cellCount);
+		s_grid.rects = (GridRect*)level_alloc(sizeof(GridRect) * sectorCount);
+		s_grid.queryStamp = (u32*)level_alloc(sizeof(u32) * sectorCount);
+		memset(s_grid.cells, 0, sizeof(GridCell) * cellCount);
+		memset(s_grid.queryStamp, 0, sizeof(u32) * sectorCount);
+
+		// First pass: count the sectors per cell so each cell is allocated once.
+		for (u32 i = 0; i < sectorCount; i++)
+		{
+			GridRect* rect = &s_grid.rects[i];
+			sectorGrid_computeRect(&sectors[i], rect);
+			for (s32 z = rect->z0; z <= rect->z1; z++)
+			{
+				GridCell* cell = &s_grid.cells[z * s_grid.width + rect->x0];
+				for (s32 x = rect->x0; x <= rect->x1; x++, cell++)
+				{
+					cell->capacity++;
+				}
+			}
+		}
+		GridCell* cell = s_grid.cells;
+		for (s32 c = 0; c < cellCount; c++, cell++)
+		{
+			if (cell->capacity)
+			{
+				cell->capacity += GRID_CELL_PAD;
+				cell->sectors = (s32*)level_alloc(sizeof(s32) * cell->capacity);
+			}
+		}
+
+		// Second pass: fill in the cells, sectors are added in index order so no sorting is required.
+		for (u32 i = 0; i < sectorCount; i++)
+		{
+			const GridRect* rect = &s_grid.rects[i];
+			for (s32 z = rect->z0; z <= rect->z1; z++)
+			{
+				cell = &s_grid.cells[z * s_grid.width + rect->x0];
+				for (s32 x = rect->x0; x <= rect->x1; x++, cell++)
+				{
+					cell->sectors[cell->count++] = s32(i);
+				}
+			}
+		}
+	}
+
+	void sectorGrid_updateSector(RSector* sector)
+	{
+		if (!s_grid.cells || !sector) { return; }
+		const s32 index = s32(sector - s_levelState.sectors);
+		if (index < 0 || index >= s32(s_grid.sectorCount)) { return; }
+
+		GridRect newRect;
+		sectorGrid_computeRect(sector, &newRect);
+		GridRect* rect = &s_grid.rects[index];
+		if (newRect.x0 == rect->x0 && newRect.x1 == rect->x1 && newRect.z0 == rect->z0 && newRect.z1 == rect->z1)
+		{
+			return;
+		}
+
+		// Remove from cells that are no longer overlapped.
+		for (s32 z = rect->z0; z <= rect->z1; z++)
+		{
+			for (s32 x = rect->x0; x <= rect->x1; x++)
+			{
+				if (x < newRect.x0 || x > newRect.x1 || z < newRect.z0 || z > newRect.z1)
+				{
+					sectorGrid_cellRemove(&s_grid.cells[z * s_grid.width + x], index);
+				}
+			}
+		}
+		// Add to newly overlapped cells.
+		for (s32 z = newRect.z0; z <= newRect.z1; z++)
+		{
+			for (s32 x = newRect.x0; x <= newRect.x1; x++)
+			{
+				if (x < rect->x0 || x > rect->x1 || z < rect->z0 || z > rect->z1)
+				{
+					sectorGrid_cellInsert(&s_grid.cells[z * s_grid.width + x], index);
+				}
+			}
+		}
+		*rect = newRect;
+	}
+
+	JBool sectorGrid_getCandidates(fixed16_16 x, fixed16_16 z, const s32** list, s32* count)
+	{
+		if (!s_grid.cells || s_grid.sectorCount != s_levelState.sectorCount)
+		{
+			return JFALSE;
+		}
+
+		const s32 cx = sectorGrid_cellCoord(x, s_grid.originX, s_grid.width);
+		const s32 cz = sectorGrid_cellCoord(z, s_grid.originZ, s_grid.height);
+		const GridCell* cell = &s_grid.cells[cz * s_grid.width + cx];
+		*list = cell->sectors;
+		*count = cell->count;
+		return JTRUE;
+	}
+
+	s32 sectorGrid_getSectorsInRect(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1, s32* list, s32 maxCount)
+	{
+		if (!s_grid.cells || s_grid.sectorCount != s_levelState.sectorCount)
+		{
+			return -1;
+		}
+
+		const s32 cx0 = sectorGrid_cellCoord(x0, s_grid.originX, s_grid.width);
+		const s32 cx1 = sectorGrid_cellCoord(x1, s_grid.originX, s_grid.width);
+		const s32 cz0 = sectorGrid_cellCoord(z0, s_grid.originZ, s_grid.height);
+		const s32 cz1 = sectorGrid_cellCoord(z1, s_grid.originZ, s_grid.height);
+
+		// Reset the stamps when the id wraps around, so stale stamps are never mistaken for the current query.
+		s_grid.queryId++;
+		if (s_grid.queryId == 0)
+		{
+			memset(s_grid.queryStamp, 0, sizeof(u32) * s_grid.sectorCount);
+			s_grid.queryId = 1;
+		}
+
+		s32 count = 0;
+		for (s32 z = cz0; z <= cz1; z++)
+		{
+			const GridCell* cell = &s_grid.cells[z * s_grid.width + cx0];
+			for (s32 x = cx0; x <= cx1; x++, cell++)
+			{
+				for (s32 i = 0; i < cell->count; i++)
+				{
+					const s32 index = cell->sectors[i];
+					if (s_grid.queryStamp[index] == s_grid.queryId) { continue; }
+					if (count >= maxCount) { return -1; }
+
+					s_grid.queryStamp[index] = s_grid.queryId;
+					list[count++] = index;
+				}
+			}
+		}
+		// Sectors from different cells are interleaved, so sort to match the order of a linear scan.
+		std::sort(list, list + count);
+		return count;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Sector Grid
+// Added for TFE: a uniform 2D grid over the sector bounds, used to
+// accelerate point queries such as sector_which3D().
+//
+// Each cell stores the indices of every sector whose bounds overlap
+// it, in ascending order - so walking a cell visits sectors in the
+// same order as a linear scan over s_levelState.sectors.
+// Sectors and points outside of the grid are clamped to the edge
+// cells, which keeps queries correct after INF moves walls outside of
+// the initial level bounds.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "rsector.h"
+
+namespace TFE_Jedi
+{
+	void sectorGrid_clear();
+	// Build the grid from the current sector bounds, called once the level geometry is loaded or restored.
+	void sectorGrid_build();
+	// Update the cells overlapped by the sector, called whenever the sector bounds change.
+	void sectorGrid_updateSector(RSector* sector);
+	// Get the list of sector indices (in ascending order) that potentially contain the point (x, z).
+	// Returns JFALSE if the grid has not been built, in which case the caller should fall back to a linear search.
+	JBool sectorGrid_getCandidates(fixed16_16 x, fixed16_16 z, const s32** list, s32* count);
+	// Get the indices (in ascending order) of the sectors that potentially overlap the rectangle [x0, x1] x [z0, z1].
+	// Returns the number of sectors written to 'list', or -1 if the grid has not been built or more than 'maxCount'
+	// sectors overlap, in which case the caller should fall back to visiting every sector.
+	s32 sectorGrid_getSectorsInRect(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1, s32* list, s32 maxCount);
+}
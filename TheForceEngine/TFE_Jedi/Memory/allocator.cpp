@@ -2,14 +2,41 @@
 #include <TFE_System/system.h>
 #include <TFE_Game/igame.h>
 #include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// TFE: Items are stored in chunks (slabs) rather than being allocated individually.
+// The linked list is kept so iteration order and iterator behavior match the original
+// allocator exactly, but each item also stores its position in the list so that
+// index <-> pointer lookups are O(1) instead of walking the list.
+struct AllocChunk;
 
 struct AllocHeader
 {
 	AllocHeader* prev;
 	AllocHeader* next;
+	// TFE
+	AllocChunk* chunk;	// chunk that owns the item.
+	s32 slot;			// slot within the chunk.
+	s32 index;			// position in the list, valid when < Allocator::orderValid.
 	char data[];		// actual data storage area.
 };
 
+struct AllocChunk
+{
+	AllocChunk* prev;
+	AllocChunk* next;
+	AllocChunk* prevPartial;	// list of chunks with free slots.
+	AllocChunk* nextPartial;
+	void* mem;					// unaligned allocation.
+	u8* items;					// cache line aligned item storage.
+	u64 used;					// occupancy bitmap, one bit per slot.
+	s32 capacity;				// number of slots.
+	s32 liveCount;
+	JBool partial;
+};
+
 struct Allocator
 {
 	Allocator*   self;
@@ -24,6 +51,19 @@ struct Allocator
 	// TFE
 	AllocHeader* iterSave;
 	AllocHeader* iterPrevSave;
+
+	// Slab storage.
+	AllocChunk* chunks;
+	AllocChunk* partialChunks;
+	s32 stride;				// item size including the header, rounded up to the cache line size.
+	s32 maxItemsPerChunk;
+	s32 nextChunkItems;		// size of the next chunk, chunks start small and grow geometrically.
+
+	// List order, order[i] is the i-th item in the list.
+	AllocHeader** order;
+	s32 count;
+	s32 orderCapacity;
+	s32 orderValid;			// order[] and AllocHeader::index are valid below this position.
 };
 
 // given an "item" (=allocheader->data), get the "AllocHeader" it belongs to.
@@ -42,6 +82,181 @@ namespace TFE_Jedi
 {
 	#define MAX_ALLOC_SIZE (8*1024*1024)  // 8MB
 
+	enum AllocatorConstants
+	{
+		ALLOC_CACHE_LINE     = 64,
+		ALLOC_CHUNK_SIZE     = 16 * 1024,	// target chunk size, large items get one item per chunk.
+		ALLOC_CHUNK_MAX_ITEM = 64,			// limited by the size of the occupancy bitmap.
+		ALLOC_CHUNK_MIN_ITEM = 4,			// many allocators only ever hold a few items.
+		ALLOC_ORDER_MIN      = 16,
+	};
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static s32 findFirstZeroBit(u64 bits)
+	{
+		const u64 free = ~bits;
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, free);
+		return s32(index);
+	#else
+		return s32(__builtin_ctzll(free));
+	#endif
+	}
+
+	static void addPartialChunk(Allocator* alloc, AllocChunk* chunk)
+	{
+		chunk->prevPartial = nullptr;
+		chunk->nextPartial = alloc->partialChunks;
+		if (alloc->partialChunks) { alloc->partialChunks->prevPartial = chunk; }
+		alloc->partialChunks = chunk;
+		chunk->partial = JTRUE;
+	}
+
+	static void removePartialChunk(Allocator* alloc, AllocChunk* chunk)
+	{
+		if (chunk->prevPartial) { chunk->prevPartial->nextPartial = chunk->nextPartial; }
+		else { alloc->partialChunks = chunk->nextPartial; }
+		if (chunk->nextPartial) { chunk->nextPartial->prevPartial = chunk->prevPartial; }
+		chunk->prevPartial = nullptr;
+		chunk->nextPartial = nullptr;
+		chunk->partial = JFALSE;
+	}
+
+	static AllocChunk* createChunk(Allocator* alloc)
+	{
+		const s32 capacity = alloc->nextChunkItems;
+		const size_t itemBytes = size_t(alloc->stride) * size_t(capacity);
+		void* mem = TFE_Memory::region_alloc(alloc->region, sizeof(AllocChunk) + itemBytes + ALLOC_CACHE_LINE - 1);
+		if (!mem) { return nullptr; }
+
+		AllocChunk* chunk = (AllocChunk*)mem;
+		memset(chunk, 0, sizeof(AllocChunk));
+		chunk->mem = mem;
+		chunk->capacity = capacity;
+		const size_t itemAddr = (size_t)mem + sizeof(AllocChunk);
+		chunk->items = (u8*)((itemAddr + ALLOC_CACHE_LINE - 1) & ~size_t(ALLOC_CACHE_LINE - 1));
+		// Mark slots past the end of the chunk as used, so they are never handed out.
+		if (capacity < ALLOC_CHUNK_MAX_ITEM)
+		{
+			chunk->used = ~((1ull << capacity) - 1ull);
+		}
+		alloc->nextChunkItems = min(capacity * 2, alloc->maxItemsPerChunk);
+
+		chunk->next = alloc->chunks;
+		if (alloc->chunks) { alloc->chunks->prev = chunk; }
+		alloc->chunks = chunk;
+		addPartialChunk(alloc, chunk);
+		return chunk;
+	}
+
+	static void freeChunk(Allocator* alloc, AllocChunk* chunk)
+	{
+		if (chunk->partial) { removePartialChunk(alloc, chunk); }
+		if (chunk->prev) { chunk->prev->next = chunk->next; }
+		else { alloc->chunks = chunk->next; }
+		if (chunk->next) { chunk->next->prev = chunk->prev; }
+		TFE_Memory::region_free(alloc->region, chunk->mem);
+	}
+
+	static AllocHeader* allocSlot(Allocator* alloc)
+	{
+		AllocChunk* chunk = alloc->partialChunks;
+		if (!chunk)
+		{
+			chunk = createChunk(alloc);
+			if (!chunk) { return nullptr; }
+		}
+
+		const s32 slot = findFirstZeroBit(chunk->used);
+		chunk->used |= (1ull << slot);
+		chunk->liveCount++;
+		if (chunk->liveCount == chunk->capacity)
+		{
+			removePartialChunk(alloc, chunk);
+		}
+
+		AllocHeader* header = (AllocHeader*)(chunk->items + size_t(slot) * size_t(alloc->stride));
+		memset(header, 0, alloc->size);
+		header->chunk = chunk;
+		header->slot = slot;
+		return header;
+	}
+
+	static void freeSlot(Allocator* alloc, AllocHeader* header)
+	{
+		AllocChunk* chunk = header->chunk;
+		chunk->used &= ~(1ull << header->slot);
+		chunk->liveCount--;
+		// Empty chunks are released right away, since many allocators only hold a few items.
+		if (chunk->liveCount == 0)
+		{
+			freeChunk(alloc, chunk);
+		}
+		else if (!chunk->partial)
+		{
+			addPartialChunk(alloc, chunk);
+		}
+	}
+
+	static bool reserveOrder(Allocator* alloc, s32 count)
+	{
+		if (count <= alloc->orderCapacity) { return true; }
+
+		s32 newCapacity = alloc->orderCapacity ? alloc->orderCapacity * 2 : ALLOC_ORDER_MIN;
+		while (newCapacity < count) { newCapacity *= 2; }
+		AllocHeader** order = (AllocHeader**)TFE_Memory::region_realloc(alloc->region, alloc->order, sizeof(AllocHeader*) * newCapacity);
+		if (!order) { return false; }
+
+		alloc->order = order;
+		alloc->orderCapacity = newCapacity;
+		return true;
+	}
+
+	// Rebuild the part of the order table invalidated by deletions.
+	static void updateOrder(Allocator* alloc)
+	{
+		if (alloc->orderValid >= alloc->count) { return; }
+		if (!reserveOrder(alloc, alloc->count)) { return; }
+
+		s32 index = alloc->orderValid;
+		AllocHeader* header = index > 0 ? alloc->order[index - 1]->next : alloc->head;
+		while (header)
+		{
+			header->index = index;
+			alloc->order[index] = header;
+			index++;
+			header = header->next;
+		}
+		alloc->orderValid = index;
+	}
+
+	// Get the list position of a header, or -1 if it does not belong to the allocator.
+	static s32 getHeaderIndex(Allocator* alloc, AllocHeader* header)
+	{
+		if (!header) { return -1; }
+		updateOrder(alloc);
+
+		const s32 index = header->index;
+		if (index < 0 || index >= alloc->orderValid || alloc->order[index] != header)
+		{
+			return -1;
+		}
+		return index;
+	}
+
+	static AllocHeader* getHeaderByIndex(Allocator* alloc, s32 index)
+	{
+		if (index < 0 || index >= alloc->count) { return nullptr; }
+		updateOrder(alloc);
+		return index < alloc->orderValid ? alloc->order[index] : nullptr;
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
 	// Create and free an allocator.
 	Allocator* allocator_create(s32 allocSize, MemoryRegion* region)
 	{
@@ -63,6 +278,10 @@ namespace TFE_Jedi
 		res->size = allocSize + sizeof(AllocHeader);
 		res->refCount = 0;
 
+		res->stride = (res->size + ALLOC_CACHE_LINE - 1) & ~(ALLOC_CACHE_LINE - 1);
+		res->maxItemsPerChunk = max(1, min(ALLOC_CHUNK_SIZE / res->stride, (s32)ALLOC_CHUNK_MAX_ITEM));
+		res->nextChunkItems = min((s32)ALLOC_CHUNK_MIN_ITEM, res->maxItemsPerChunk);
+
 		return res;
 	}
 
@@ -70,12 +289,14 @@ namespace TFE_Jedi
 	{
 		if (!alloc) { return; }
 
-		void* item = allocator_getHead(alloc);
-		while (item)
+		AllocChunk* chunk = alloc->chunks;
+		while (chunk)
 		{
-			allocator_deleteItem(alloc, item);
-			item = allocator_getNext(alloc);
+			AllocChunk* next = chunk->next;
+			TFE_Memory::region_free(alloc->region, chunk->mem);
+			chunk = next;
 		}
+		TFE_Memory::region_free(alloc->region, alloc->order);
 
 		alloc->self = nullptr;
 		TFE_Memory::region_free(alloc->region, alloc);
@@ -91,13 +312,12 @@ namespace TFE_Jedi
 	{
 		if (!alloc) { return nullptr; }
 
-		AllocHeader* header = (AllocHeader*)TFE_Memory::region_alloc(alloc->region, alloc->size);
+		AllocHeader* header = allocSlot(alloc);
 		if (!header)
 		{
 			TFE_System::logWrite(LOG_ERROR, "Allocator", "allocator_newItem - cannot allocate header of size %d", alloc->size);
 			return nullptr;
 		}
-		memset(header, 0, alloc->size);
 
 		header->next = nullptr;
 		header->prev = alloc->tail;
@@ -113,6 +333,15 @@ namespace TFE_Jedi
 			alloc->head = header;
 		}
 
+		// New items are always added at the end, so the order stays valid if it was already up to date.
+		if (alloc->orderValid == alloc->count && reserveOrder(alloc, alloc->count + 1))
+		{
+			header->index = alloc->count;
+			alloc->order[alloc->count] = header;
+			alloc->orderValid++;
+		}
+		alloc->count++;
+
 		return GET_DATA(header);
 	}
 
@@ -123,6 +352,14 @@ namespace TFE_Jedi
 		AllocHeader* header = AllocHeader_of(item);
 		if (header == nullptr) { return; }
 
+		// Items after the deleted item move down one position. If the item is past the valid range
+		// there is nothing to invalidate, so deleting never has to rebuild the order.
+		const s32 index = header->index;
+		if (index >= 0 && index < alloc->orderValid && alloc->order[index] == header)
+		{
+			alloc->orderValid = index;
+		}
+
 		AllocHeader* prev = header->prev;
 		AllocHeader* next = header->next;
 
@@ -141,128 +378,57 @@ namespace TFE_Jedi
 			alloc->iterPrev = header->next;
 		}
 
-		TFE_Memory::region_free(alloc->region, header);
+		alloc->count--;
+		freeSlot(alloc, header);
 	}
 
 	// Random access.
 	s32 allocator_getCount(Allocator* alloc)
 	{
-		if (!alloc) { return 0; }
-
-		s32 count = 0;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			count++;
-			header = header->next;
-		}
-		return count;
+		return alloc ? alloc->count : 0;
 	}
-		
+
 	s32 allocator_getCurPos(Allocator* alloc)
 	{
 		if (!alloc) { return -1; }
-
-		s32 index = 0;
-		AllocHeader* iter = alloc->iter;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			if (header == iter)
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return getHeaderIndex(alloc, alloc->iter);
 	}
 
 	void allocator_setPos(Allocator* alloc, s32 pos)
 	{
 		if (!alloc) { return; }
-
-		s32 index = 0;
-		AllocHeader* header = alloc->head;
-		alloc->iter = nullptr;
-		while (header)
-		{
-			if (index == pos)
-			{
-				alloc->iter = header;
-				break;
-			}
-			index++;
-			header = header->next;
-		}
+		alloc->iter = getHeaderByIndex(alloc, pos);
 	}
-		
+
 	s32 allocator_getPrevPos(Allocator* alloc)
 	{
 		if (!alloc) { return -1; }
-
-		s32 index = 0;
-		AllocHeader* iterPrev = alloc->iterPrev;
-		AllocHeader* header = alloc->head;
-		while (header)
-		{
-			if (header == iterPrev)
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return getHeaderIndex(alloc, alloc->iterPrev);
 	}
 
 	void allocator_setPrevPos(Allocator* alloc, s32 pos)
 	{
 		if (!alloc) { return; }
 
-		s32 index = 0;
-		AllocHeader* header = alloc->head;
-		while (header)
+		AllocHeader* header = getHeaderByIndex(alloc, pos);
+		if (header)
 		{
-			if (index == pos)
-			{
-				alloc->iterPrev = header;
-				break;
-			}
-			index++;
-			header = header->next;
+			alloc->iterPrev = header;
 		}
 	}
 
 	s32 allocator_getIndex(Allocator* alloc, void* item)
 	{
 		if (!item || !alloc) { return -1; }
-
-		AllocHeader* header = alloc->head;
-		s32 index = 0;
-		while (header)
-		{
-			if (item == &(header->data))
-			{
-				return index;
-			}
-			index++;
-			header = header->next;
-		}
-		return -1;
+		return getHeaderIndex(alloc, AllocHeader_of(item));
 	}
 
 	void* allocator_getByIndex(Allocator* alloc, s32 index)
 	{
 		if (!alloc) { return nullptr; }
 
-		AllocHeader* header = alloc->head;
-		while (index > 0 && header)
-		{
-			index--;
-			header = header->next;
-		}
-
+		// Negative indices return the head, matching the original list walk.
+		AllocHeader* header = getHeaderByIndex(alloc, index < 0 ? 0 : index);
 		alloc->iterPrev = header;
 		alloc->iter = header;
 		return GET_DATA(header);
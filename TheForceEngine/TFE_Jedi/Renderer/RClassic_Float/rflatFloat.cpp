@@ -6,6 +6,7 @@
 #include "redgePairFloat.h"
 #include "rclassicFloat.h"
 #include "rclassicFloatSharedState.h"
+#include "rstripFloat.h"
 #include "fixedPoint20.h"
 #include "../rscanline.h"
 #include "../rsectorRender.h"
@@ -77,74 +78,40 @@ namespace RClassic_Float
 		}
 	}
 				
-	// This produces functionally identical results to the original but splits apart the U/V and dUdx/dVdx into seperate variables
-	// to account for C vs ASM differences.
+	static void submitScanline(StripFunc func)
+	{
+		StripCommand cmd = {};
+		cmd.func = func;
+		cmd.out = s_scanlineOut;
+		cmd.count = s_scanlineWidth;
+		cmd.tex = s_ftexImage;
+		cmd.texMask = s_ftexDataEnd;
+		cmd.colorMap = s_scanlineLight;
+		cmd.u = s_scanlineU0;
+		cmd.v = s_scanlineV0;
+		cmd.du = s_scanline_dUdX;
+		cmd.dv = s_scanline_dVdX;
+		strip_draw(&cmd);
+	}
+
 	void drawScanline()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
-		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			s_scanlineOut[i] = s_scanlineLight[s_ftexImage[texel]];
-		}
+		submitScanline(SFUNC_SCANLINE_LIT);
 	}
 
 	void drawScanline_Fullbright()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
-		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			s_scanlineOut[i] = s_ftexImage[texel];
-		}
+		submitScanline(SFUNC_SCANLINE_FULLBRIGHT);
 	}
 
 	void drawScanline_Trans()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
-		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			const u8 baseColor = s_ftexImage[texel];
-
-			if (baseColor) { s_scanlineOut[i] = s_scanlineLight[baseColor]; }
-		}
+		submitScanline(SFUNC_SCANLINE_TRANS);
 	}
 
 	void drawScanline_Fullbright_Trans()
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
-
-		// Note this produces a distorted mapping if the texture is not 64x64.
-		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
-		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			const u8 baseColor = s_ftexImage[texel];
-
-			if (baseColor) { s_scanlineOut[i] = baseColor; }
-		}
+		submitScanline(SFUNC_SCANLINE_FULLBRIGHT_TRANS);
 	}
 			   
 	bool flat_setTexture(TextureData* tex)
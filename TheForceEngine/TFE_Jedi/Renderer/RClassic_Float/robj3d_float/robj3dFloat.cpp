@@ -12,6 +12,7 @@
 #include "robj3dFloat_Clipping.h"
 #include "robj3dFloat_PolygonDraw.h"
 #include "../rclassicFloatSharedState.h"
+#include "../rstripFloat.h"
 #include "../../rcommon.h"
 
 namespace TFE_Jedi
@@ -111,7 +112,11 @@ namespace RClassic_Float
 			{
 				const s32 x = clamp(pixel_x - halfSize + (i % size), s_minScreenX_Pixels, s_maxScreenX_Pixels);
 				const s32 y = clamp(pixel_y - halfSize + (i / size), s_windowMinY_Pixels, s_windowMaxY_Pixels);
-				s_display[y*s_width + x] = color;
+				StripCommand cmd = {};
+				cmd.func = SFUNC_PIXEL;
+				cmd.out = &s_display[y*s_width + x];
+				cmd.color = color;
+				strip_draw(&cmd);
 			}
 		}
 	}
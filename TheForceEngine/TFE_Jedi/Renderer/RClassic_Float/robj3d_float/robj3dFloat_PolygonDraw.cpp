@@ -13,6 +13,7 @@
 #include "../fixedPoint20.h"
 #include "../rsectorFloat.h"
 #include "../rflatFloat.h"
+#include "../rstripFloat.h"
 #include "../rclassicFloatSharedState.h"
 #include "../rlightingFloat.h"
 #include "../../rcommon.h"
@@ -0,0 +1,844 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <SDL_cpuinfo.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_Asset/spriteAsset_Jedi.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "rstripFloat.h"
+#include "../rcommon.h"
+
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2))
+	#include <emmintrin.h>
+	#define STRIP_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define STRIP_SIMD_NEON 1
+#endif
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	enum StripConstants
+	{
+		STRIP_MAX = 32,
+		STRIP_MIN_WIDTH = 64,	// narrower strips are not worth the overhead.
+	};
+
+	struct Strip
+	{
+		s32 x0, x1;
+		std::vector<StripCommand> commands;
+		u8 workBuffer[WAX_DECOMPRESS_SIZE];
+
+		SDL_Thread* thread;
+		SDL_sem* start;
+	};
+
+	typedef void(*StripFunction)(const StripCommand*, s32, u8*);
+
+	static Strip s_strips[STRIP_MAX];
+	static s32 s_stripCount = 0;
+	static s32 s_stripWidth = 0;
+	static s32 s_workerCount = 0;
+	static s32 s_stride = 0;
+	static u8* s_stripDisplay = nullptr;
+	static bool s_recording = false;
+	static bool s_exitWorkers = false;
+	static SDL_sem* s_stripDone = nullptr;
+
+	static bool s_simdSpans = true;
+	static bool s_simdSupported = false;
+
+	/////////////////////////////////////////////
+	// Column and scanline functions.
+	/////////////////////////////////////////////
+	static void drawColumn_Fullbright(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* tex = cmd->tex;
+		if (cmd->compressedHeight)
+		{
+			sprite_decompressColumn(tex, workBuffer, cmd->compressedHeight);
+			tex = workBuffer;
+		}
+		fixed44_20 vCoordFixed = cmd->v;
+		const s32 end = cmd->count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoordFixed += cmd->dv)
+		{
+			const s32 v = floor20(vCoordFixed) & cmd->texMask;
+			cmd->out[offset] = tex[v];
+		}
+	}
+
+	static void drawColumn_Lit(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* tex = cmd->tex;
+		if (cmd->compressedHeight)
+		{
+			sprite_decompressColumn(tex, workBuffer, cmd->compressedHeight);
+			tex = workBuffer;
+		}
+		const u8* light = cmd->colorMap;
+		fixed44_20 vCoordFixed = cmd->v;
+		const s32 end = cmd->count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoordFixed += cmd->dv)
+		{
+			const s32 v = floor20(vCoordFixed) & cmd->texMask;
+			cmd->out[offset] = light[tex[v]];
+		}
+	}
+
+	static void drawColumn_Fullbright_Trans(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* tex = cmd->tex;
+		if (cmd->compressedHeight)
+		{
+			sprite_decompressColumn(tex, workBuffer, cmd->compressedHeight);
+			tex = workBuffer;
+		}
+		fixed44_20 vCoordFixed = cmd->v;
+		const s32 end = cmd->count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoordFixed += cmd->dv)
+		{
+			const s32 v = floor20(vCoordFixed) & cmd->texMask;
+			const u8 c = tex[v];
+			if (c) { cmd->out[offset] = c; }
+		}
+	}
+
+	static void drawColumn_Lit_Trans(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* tex = cmd->tex;
+		if (cmd->compressedHeight)
+		{
+			sprite_decompressColumn(tex, workBuffer, cmd->compressedHeight);
+			tex = workBuffer;
+		}
+		const u8* light = cmd->colorMap;
+		fixed44_20 vCoordFixed = cmd->v;
+		const s32 end = cmd->count - 1;
+
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride, vCoordFixed += cmd->dv)
+		{
+			const s32 v = floor20(vCoordFixed) & cmd->texMask;
+			const u8 c = tex[v];
+			if (c) { cmd->out[offset] = light[c]; }
+		}
+	}
+
+	// This produces functionally identical results to the original but splits apart the U/V and dUdx/dVdx into seperate variables
+	// to account for C vs ASM differences.
+	// Note this produces a distorted mapping if the texture is not 64x64.
+	// This behavior matches the original.
+	static void drawScanline_Lit(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* image = cmd->tex;
+		const u8* light = cmd->colorMap;
+		fixed44_20 V = cmd->v;
+		fixed44_20 U = cmd->u;
+
+		for (s32 i = cmd->count - 1; i >= 0; i--, U += cmd->du, V += cmd->dv)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & cmd->texMask;
+			cmd->out[i] = light[image[texel]];
+		}
+	}
+
+	static void drawScanline_Fullbright(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* image = cmd->tex;
+		fixed44_20 V = cmd->v;
+		fixed44_20 U = cmd->u;
+
+		for (s32 i = cmd->count - 1; i >= 0; i--, U += cmd->du, V += cmd->dv)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & cmd->texMask;
+			cmd->out[i] = image[texel];
+		}
+	}
+
+	static void drawScanline_Trans(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* image = cmd->tex;
+		const u8* light = cmd->colorMap;
+		fixed44_20 V = cmd->v;
+		fixed44_20 U = cmd->u;
+
+		for (s32 i = cmd->count - 1; i >= 0; i--, U += cmd->du, V += cmd->dv)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & cmd->texMask;
+			const u8 baseColor = image[texel];
+
+			if (baseColor) { cmd->out[i] = light[baseColor]; }
+		}
+	}
+
+	static void drawScanline_Fullbright_Trans(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* image = cmd->tex;
+		fixed44_20 V = cmd->v;
+		fixed44_20 U = cmd->u;
+
+		for (s32 i = cmd->count - 1; i >= 0; i--, U += cmd->du, V += cmd->dv)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & cmd->texMask;
+			const u8 baseColor = image[texel];
+
+			if (baseColor) { cmd->out[i] = baseColor; }
+		}
+	}
+
+	static void drawPolyColumn_FlatColor(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		s32 end = cmd->count - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			cmd->out[offset] = cmd->color;
+		}
+	}
+
+	static void drawPolyColumn_ShadedColor(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* colorMap = cmd->colorMap;
+
+		fixed44_20 intensity = cmd->i;
+		u8  colorIndex = cmd->color;
+		s32 dither = cmd->dither;
+
+		s32 end = cmd->count - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			s32 pixelIntensity = floor20(intensity);
+			if (dither)
+			{
+				const fixed44_20 iOffset = intensity - cmd->ditherOffset;
+				if (iOffset >= 0)
+				{
+					pixelIntensity = floor20(iOffset);
+				}
+			}
+			cmd->out[offset] = colorMap[(pixelIntensity&31)*256 + colorIndex];
+
+			intensity += cmd->di;
+			dither = !dither;
+		}
+	}
+
+	static void drawPolyColumn_FlatTexture(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* colorMap = cmd->colorMap;
+		const u8* textureData = cmd->tex;
+		const s32 texHeight = cmd->texHeight;
+		const s32 texWidthMask = cmd->texMask;
+		const s32 texHeightMask = texHeight - 1;
+
+		fixed44_20 U = cmd->u;
+		fixed44_20 V = cmd->v;
+
+		s32 end = cmd->count - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			const u8 colorIndex = textureData[(floor20(U)&texWidthMask)*texHeight + (floor20(V)&texHeightMask)];
+			cmd->out[offset] = colorMap[colorIndex];
+
+			U += cmd->du;
+			V += cmd->dv;
+		}
+	}
+
+	static void drawPolyColumn_ShadedTexture(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* colorMap = cmd->colorMap;
+		const u8* textureData = cmd->tex;
+		const s32 texHeight = cmd->texHeight;
+		const s32 texWidthMask = cmd->texMask;
+		const s32 texHeightMask = texHeight - 1;
+
+		fixed44_20 U = cmd->u;
+		fixed44_20 V = cmd->v;
+		fixed44_20 I = cmd->i;
+
+		s32 end = cmd->count - 1;
+		s32 offset = end * stride;
+		for (s32 i = end; i >= 0; i--, offset -= stride)
+		{
+			const u8 colorIndex = textureData[(floor20(U)&texWidthMask)*texHeight + (floor20(V)&texHeightMask)];
+			const s32 pixelIntensity = floor20(I)&31;
+			cmd->out[offset] = colorMap[pixelIntensity*256 + colorIndex];
+
+			I += cmd->di;
+			U += cmd->du;
+			V += cmd->dv;
+		}
+	}
+
+	static void drawPixel(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		*cmd->out = cmd->color;
+	}
+
+	static const StripFunction c_stripFunc[SFUNC_COUNT] =
+	{
+		drawColumn_Fullbright,			// SFUNC_COLUMN_FULLBRIGHT
+		drawColumn_Lit,					// SFUNC_COLUMN_LIT
+		drawColumn_Fullbright_Trans,	// SFUNC_COLUMN_FULLBRIGHT_TRANS
+		drawColumn_Lit_Trans,			// SFUNC_COLUMN_LIT_TRANS
+		drawScanline_Lit,				// SFUNC_SCANLINE_LIT
+		drawScanline_Fullbright,		// SFUNC_SCANLINE_FULLBRIGHT
+		drawScanline_Trans,				// SFUNC_SCANLINE_TRANS
+		drawScanline_Fullbright_Trans,	// SFUNC_SCANLINE_FULLBRIGHT_TRANS
+		drawPolyColumn_FlatColor,		// SFUNC_POLY_FLAT_COLOR
+		drawPolyColumn_ShadedColor,		// SFUNC_POLY_SHADED_COLOR
+		drawPolyColumn_FlatTexture,		// SFUNC_POLY_FLAT_TEXTURE
+		drawPolyColumn_ShadedTexture,	// SFUNC_POLY_SHADED_TEXTURE
+		drawPixel,						// SFUNC_PIXEL
+	};
+
+	/////////////////////////////////////////////
+	// SIMD column and scanline functions.
+	// Texture coordinates are stepped four pixels at a time in 64-bit
+	// lanes. Each lane adds the same integer values as the scalar loop,
+	// so the texel indices, and the output, are identical.
+	// Only the low 32 bits of floor20() are ever used (after masking), so
+	// a logical shift gives the same result as the arithmetic shift.
+	/////////////////////////////////////////////
+#if defined(STRIP_SIMD_SSE2)
+	// Four 44.20 fixed point coordinates: lanes 0,1 in lo and 2,3 in hi.
+	struct Coord4
+	{
+		__m128i lo, hi;
+	};
+
+	static inline Coord4 coord4_set(fixed44_20 base, fixed44_20 step)
+	{
+		Coord4 c;
+		c.lo = _mm_set_epi64x(base + step, base);
+		c.hi = _mm_set_epi64x(base + step * 3, base + step * 2);
+		return c;
+	}
+
+	static inline void coord4_add(Coord4* c, fixed44_20 value)
+	{
+		const __m128i v = _mm_set1_epi64x(value);
+		c->lo = _mm_add_epi64(c->lo, v);
+		c->hi = _mm_add_epi64(c->hi, v);
+	}
+
+	// Returns floor20(c) & mask for each lane as four 32-bit integers.
+	static inline __m128i coord4_floorMask(const Coord4& c, s32 mask)
+	{
+		const __m128i mask64 = _mm_set1_epi64x(mask);
+		const __m128i lo = _mm_and_si128(_mm_srli_epi64(c.lo, 20), mask64);
+		const __m128i hi = _mm_and_si128(_mm_srli_epi64(c.hi, 20), mask64);
+		return _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	static inline void texel4_column(const Coord4& v, s32 texMask, u32* texel)
+	{
+		_mm_storeu_si128((__m128i*)texel, coord4_floorMask(v, texMask));
+	}
+
+	static inline void texel4_scanline(const Coord4& u, const Coord4& v, s32 dataEnd, u32* texel)
+	{
+		const __m128i t = _mm_add_epi32(_mm_slli_epi32(coord4_floorMask(u, 63), 6), coord4_floorMask(v, 63));
+		_mm_storeu_si128((__m128i*)texel, _mm_and_si128(t, _mm_set1_epi32(dataEnd)));
+	}
+#elif defined(STRIP_SIMD_NEON)
+	struct Coord4
+	{
+		int64x2_t lo, hi;
+	};
+
+	static inline Coord4 coord4_set(fixed44_20 base, fixed44_20 step)
+	{
+		const int64_t lo[] = { base, base + step };
+		const int64_t hi[] = { base + step * 2, base + step * 3 };
+		Coord4 c;
+		c.lo = vld1q_s64(lo);
+		c.hi = vld1q_s64(hi);
+		return c;
+	}
+
+	static inline void coord4_add(Coord4* c, fixed44_20 value)
+	{
+		const int64x2_t v = vdupq_n_s64(value);
+		c->lo = vaddq_s64(c->lo, v);
+		c->hi = vaddq_s64(c->hi, v);
+	}
+
+	static inline int32x4_t coord4_floorMask(const Coord4& c, s32 mask)
+	{
+		const int64x2_t mask64 = vdupq_n_s64(mask);
+		const int64x2_t lo = vandq_s64(vshrq_n_s64(c.lo, 20), mask64);
+		const int64x2_t hi = vandq_s64(vshrq_n_s64(c.hi, 20), mask64);
+		return vcombine_s32(vmovn_s64(lo), vmovn_s64(hi));
+	}
+
+	static inline void texel4_column(const Coord4& v, s32 texMask, u32* texel)
+	{
+		vst1q_u32(texel, vreinterpretq_u32_s32(coord4_floorMask(v, texMask)));
+	}
+
+	static inline void texel4_scanline(const Coord4& u, const Coord4& v, s32 dataEnd, u32* texel)
+	{
+		const int32x4_t t = vaddq_s32(vshlq_n_s32(coord4_floorMask(u, 63), 6), coord4_floorMask(v, 63));
+		vst1q_u32(texel, vreinterpretq_u32_s32(vandq_s32(t, vdupq_n_s32(dataEnd))));
+	}
+#endif
+
+#if defined(STRIP_SIMD_SSE2) || defined(STRIP_SIMD_NEON)
+	#define STRIP_SIMD 1
+
+	static void drawColumn_Lit_Simd(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* tex = cmd->tex;
+		if (cmd->compressedHeight)
+		{
+			sprite_decompressColumn(tex, workBuffer, cmd->compressedHeight);
+			tex = workBuffer;
+		}
+		const u8* light = cmd->colorMap;
+		const s32 end = cmd->count - 1;
+		u8* out = cmd->out;
+
+		Coord4 vCoord = coord4_set(cmd->v, cmd->dv);
+		u32 texel[4];
+		s32 i = end;
+		s32 offset = end * stride;
+		for (; i >= 3; i -= 4, offset -= stride * 4)
+		{
+			texel4_column(vCoord, cmd->texMask, texel);
+			out[offset]              = light[tex[texel[0]]];
+			out[offset - stride]     = light[tex[texel[1]]];
+			out[offset - stride * 2] = light[tex[texel[2]]];
+			out[offset - stride * 3] = light[tex[texel[3]]];
+			coord4_add(&vCoord, cmd->dv * 4);
+		}
+
+		fixed44_20 vCoordFixed = cmd->v + cmd->dv * (end - i);
+		for (; i >= 0; i--, offset -= stride, vCoordFixed += cmd->dv)
+		{
+			const s32 v = floor20(vCoordFixed) & cmd->texMask;
+			out[offset] = light[tex[v]];
+		}
+	}
+
+	static void drawColumn_Lit_Trans_Simd(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* tex = cmd->tex;
+		if (cmd->compressedHeight)
+		{
+			sprite_decompressColumn(tex, workBuffer, cmd->compressedHeight);
+			tex = workBuffer;
+		}
+		const u8* light = cmd->colorMap;
+		const s32 end = cmd->count - 1;
+		u8* out = cmd->out;
+
+		Coord4 vCoord = coord4_set(cmd->v, cmd->dv);
+		u32 texel[4];
+		s32 i = end;
+		s32 offset = end * stride;
+		for (; i >= 3; i -= 4, offset -= stride * 4)
+		{
+			texel4_column(vCoord, cmd->texMask, texel);
+			u8 c = tex[texel[0]];
+			if (c) { out[offset] = light[c]; }
+			c = tex[texel[1]];
+			if (c) { out[offset - stride] = light[c]; }
+			c = tex[texel[2]];
+			if (c) { out[offset - stride * 2] = light[c]; }
+			c = tex[texel[3]];
+			if (c) { out[offset - stride * 3] = light[c]; }
+			coord4_add(&vCoord, cmd->dv * 4);
+		}
+
+		fixed44_20 vCoordFixed = cmd->v + cmd->dv * (end - i);
+		for (; i >= 0; i--, offset -= stride, vCoordFixed += cmd->dv)
+		{
+			const s32 v = floor20(vCoordFixed) & cmd->texMask;
+			const u8 c = tex[v];
+			if (c) { out[offset] = light[c]; }
+		}
+	}
+
+	static void drawScanline_Lit_Simd(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* image = cmd->tex;
+		const u8* light = cmd->colorMap;
+		const s32 end = cmd->count - 1;
+		u8* out = cmd->out;
+
+		Coord4 U4 = coord4_set(cmd->u, cmd->du);
+		Coord4 V4 = coord4_set(cmd->v, cmd->dv);
+		u32 texel[4];
+		s32 i = end;
+		for (; i >= 3; i -= 4)
+		{
+			texel4_scanline(U4, V4, cmd->texMask, texel);
+			out[i]     = light[image[texel[0]]];
+			out[i - 1] = light[image[texel[1]]];
+			out[i - 2] = light[image[texel[2]]];
+			out[i - 3] = light[image[texel[3]]];
+			coord4_add(&U4, cmd->du * 4);
+			coord4_add(&V4, cmd->dv * 4);
+		}
+
+		fixed44_20 U = cmd->u + cmd->du * (end - i);
+		fixed44_20 V = cmd->v + cmd->dv * (end - i);
+		for (; i >= 0; i--, U += cmd->du, V += cmd->dv)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & cmd->texMask;
+			out[i] = light[image[texel]];
+		}
+	}
+
+	static void drawScanline_Trans_Simd(const StripCommand* cmd, s32 stride, u8* workBuffer)
+	{
+		const u8* image = cmd->tex;
+		const u8* light = cmd->colorMap;
+		const s32 end = cmd->count - 1;
+		u8* out = cmd->out;
+
+		Coord4 U4 = coord4_set(cmd->u, cmd->du);
+		Coord4 V4 = coord4_set(cmd->v, cmd->dv);
+		u32 texel[4];
+		s32 i = end;
+		for (; i >= 3; i -= 4)
+		{
+			texel4_scanline(U4, V4, cmd->texMask, texel);
+			u8 c = image[texel[0]];
+			if (c) { out[i] = light[c]; }
+			c = image[texel[1]];
+			if (c) { out[i - 1] = light[c]; }
+			c = image[texel[2]];
+			if (c) { out[i - 2] = light[c]; }
+			c = image[texel[3]];
+			if (c) { out[i - 3] = light[c]; }
+			coord4_add(&U4, cmd->du * 4);
+			coord4_add(&V4, cmd->dv * 4);
+		}
+
+		fixed44_20 U = cmd->u + cmd->du * (end - i);
+		fixed44_20 V = cmd->v + cmd->dv * (end - i);
+		for (; i >= 0; i--, U += cmd->du, V += cmd->dv)
+		{
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & cmd->texMask;
+			const u8 baseColor = image[texel];
+			if (baseColor) { out[i] = light[baseColor]; }
+		}
+	}
+
+	static const StripFunction c_stripFuncSimd[SFUNC_COUNT] =
+	{
+		drawColumn_Fullbright,			// SFUNC_COLUMN_FULLBRIGHT
+		drawColumn_Lit_Simd,			// SFUNC_COLUMN_LIT
+		drawColumn_Fullbright_Trans,	// SFUNC_COLUMN_FULLBRIGHT_TRANS
+		drawColumn_Lit_Trans_Simd,		// SFUNC_COLUMN_LIT_TRANS
+		drawScanline_Lit_Simd,			// SFUNC_SCANLINE_LIT
+		drawScanline_Fullbright,		// SFUNC_SCANLINE_FULLBRIGHT
+		drawScanline_Trans_Simd,		// SFUNC_SCANLINE_TRANS
+		drawScanline_Fullbright_Trans,	// SFUNC_SCANLINE_FULLBRIGHT_TRANS
+		drawPolyColumn_FlatColor,		// SFUNC_POLY_FLAT_COLOR
+		drawPolyColumn_ShadedColor,		// SFUNC_POLY_SHADED_COLOR
+		drawPolyColumn_FlatTexture,		// SFUNC_POLY_FLAT_TEXTURE
+		drawPolyColumn_ShadedTexture,	// SFUNC_POLY_SHADED_TEXTURE
+		drawPixel,						// SFUNC_PIXEL
+	};
+#endif
+
+	/////////////////////////////////////////////
+	// Internal
+	/////////////////////////////////////////////
+	static const StripFunction* s_stripFunc = c_stripFunc;
+
+	static void strip_selectFunctions()
+	{
+	#ifdef STRIP_SIMD
+		s_stripFunc = (s_simdSpans && s_simdSupported) ? c_stripFuncSimd : c_stripFunc;
+	#endif
+	}
+
+	static bool isScanline(const StripCommand* cmd)
+	{
+		return cmd->func >= SFUNC_SCANLINE_LIT && cmd->func <= SFUNC_SCANLINE_FULLBRIGHT_TRANS;
+	}
+
+	static void strip_rasterize(Strip* strip)
+	{
+		const s32 count = (s32)strip->commands.size();
+		const StripCommand* cmd = strip->commands.data();
+		for (s32 c = 0; c < count; c++, cmd++)
+		{
+			// Columns and pixels only belong to a single strip, but scanlines may have to be clipped.
+			if (isScanline(cmd))
+			{
+				const s32 x0 = s32(cmd->out - s_stripDisplay) % s_stride;
+				const s32 x1 = x0 + cmd->count - 1;
+				if (x0 < strip->x0 || x1 > strip->x1)
+				{
+					const s32 left  = max(x0, strip->x0);
+					const s32 right = min(x1, strip->x1);
+					// Scanlines are drawn from right to left, so skipping pixels on the right
+					// means stepping the texture coordinates forward - which is exact in fixed point.
+					const s32 skip = x1 - right;
+
+					StripCommand clipped = *cmd;
+					clipped.out += left - x0;
+					clipped.count = right - left + 1;
+					clipped.u += cmd->du * skip;
+					clipped.v += cmd->dv * skip;
+					s_stripFunc[clipped.func](&clipped, s_stride, strip->workBuffer);
+					continue;
+				}
+			}
+			s_stripFunc[cmd->func](cmd, s_stride, strip->workBuffer);
+		}
+		strip->commands.clear();
+	}
+
+	static int strip_workerFunc(void* userData)
+	{
+		Strip* strip = (Strip*)userData;
+		while (1)
+		{
+			SDL_SemWait(strip->start);
+			if (s_exitWorkers) { break; }
+
+			strip_rasterize(strip);
+			SDL_SemPost(s_stripDone);
+		}
+		return 0;
+	}
+
+	// Strip 0 is always rasterized on the calling thread, so only count - 1 workers are required.
+	static bool strip_createWorkers(s32 count)
+	{
+		if (!s_stripDone)
+		{
+			s_stripDone = SDL_CreateSemaphore(0);
+			if (!s_stripDone) { return false; }
+		}
+
+		for (s32 s = s_workerCount + 1; s < count; s++)
+		{
+			Strip* strip = &s_strips[s];
+			strip->start = SDL_CreateSemaphore(0);
+			strip->thread = strip->start ? SDL_CreateThread(strip_workerFunc, "TFE_StripRender", strip) : nullptr;
+			if (!strip->thread)
+			{
+				if (strip->start) { SDL_DestroySemaphore(strip->start); }
+				strip->start = nullptr;
+				return false;
+			}
+			s_workerCount++;
+		}
+		return true;
+	}
+
+	// Fills a buffer with pseudo-random bytes, roughly 1 in 8 are zero (transparent).
+	static void bench_fillRandom(u8* buffer, s32 size, u32* seed)
+	{
+		for (s32 i = 0; i < size; i++)
+		{
+			*seed = (*seed) * 1664525u + 1013904223u;
+			const u8 value = u8((*seed) >> 24);
+			buffer[i] = (value & 7) ? value : 0;
+		}
+	}
+
+	static f64 bench_run(const StripFunction* funcTable, const StripCommand* commands, s32 count, s32 iterations, s32 stride, u8* workBuffer)
+	{
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		for (s32 it = 0; it < iterations; it++)
+		{
+			for (s32 c = 0; c < count; c++)
+			{
+				funcTable[commands[c].func](&commands[c], stride, workBuffer);
+			}
+		}
+		return TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - start);
+	}
+
+	// Compares the scalar and SIMD span functions on synthetic textures, usage: rbenchSpans [iterations]
+	static void console_benchSpans(const ConsoleArgList& args)
+	{
+	#ifdef STRIP_SIMD
+		enum { BENCH_WIDTH = 1024, BENCH_HEIGHT = 256, BENCH_TEX_SIZE = 64 * 64 };
+		const s32 iterations = args.size() > 1 ? max(1, atoi(args[1].c_str())) : 20;
+
+		u32 seed = 12345;
+		std::vector<u8> texture(BENCH_TEX_SIZE), light(256);
+		bench_fillRandom(texture.data(), BENCH_TEX_SIZE, &seed);
+		bench_fillRandom(light.data(), 256, &seed);
+
+		std::vector<u8> outScalar(BENCH_WIDTH * BENCH_HEIGHT), outSimd(BENCH_WIDTH * BENCH_HEIGHT);
+		static const u8 c_funcs[] = { SFUNC_COLUMN_LIT, SFUNC_COLUMN_LIT_TRANS, SFUNC_SCANLINE_LIT, SFUNC_SCANLINE_TRANS };
+		static const char* c_names[] = { "Column Lit", "Column Lit Trans", "Scanline Lit", "Scanline Trans" };
+
+		char line[256];
+		for (s32 f = 0; f < s32(TFE_ARRAYSIZE(c_funcs)); f++)
+		{
+			const bool column = c_funcs[f] == SFUNC_COLUMN_LIT || c_funcs[f] == SFUNC_COLUMN_LIT_TRANS;
+			const s32 count = column ? BENCH_WIDTH : BENCH_HEIGHT;
+
+			std::vector<StripCommand> commands(count);
+			for (s32 c = 0; c < count; c++)
+			{
+				StripCommand* cmd = &commands[c];
+				*cmd = {};
+				seed = seed * 1664525u + 1013904223u;
+				cmd->func = c_funcs[f];
+				cmd->tex = texture.data();
+				cmd->colorMap = light.data();
+				cmd->u = fixed44_20(seed & 0xffffff) - 0x800000;
+				cmd->v = fixed44_20((seed >> 8) & 0xffffff) - 0x800000;
+				cmd->du = fixed44_20(seed % (ONE_20 * 2)) - ONE_20;
+				cmd->dv = fixed44_20((seed >> 3) % (ONE_20 * 2)) - ONE_20;
+				// Vary the span lengths so the scalar tail is exercised as well.
+				cmd->count = (column ? BENCH_HEIGHT : BENCH_WIDTH) - s32(seed & 7);
+				cmd->texMask = BENCH_TEX_SIZE - 1;
+				cmd->out = column ? &outScalar[c] : &outScalar[c * BENCH_WIDTH];
+			}
+
+			memset(outScalar.data(), 0, outScalar.size());
+			const f64 scalarMs = bench_run(c_stripFunc, commands.data(), count, iterations, BENCH_WIDTH, s_strips[0].workBuffer);
+
+			const ptrdiff_t outOffset = outSimd.data() - outScalar.data();
+			for (s32 c = 0; c < count; c++) { commands[c].out += outOffset; }
+			memset(outSimd.data(), 0, outSimd.size());
+			const f64 simdMs = bench_run(c_stripFuncSimd, commands.data(), count, iterations, BENCH_WIDTH, s_strips[0].workBuffer);
+
+			const bool match = memcmp(outScalar.data(), outSimd.data(), outScalar.size()) == 0;
+			sprintf(line, "%-16s scalar %8.3f ms, simd %8.3f ms, speedup %.2fx, output %s", c_names[f], scalarMs, simdMs,
+				simdMs > 0.0 ? scalarMs / simdMs : 0.0, match ? "identical" : "MISMATCH");
+			TFE_Console::addToHistory(line);
+			TFE_System::logWrite(LOG_MSG, "Renderer", "%s", line);
+		}
+	#else
+		TFE_Console::addToHistory("SIMD span functions are not available on this platform.");
+	#endif
+	}
+
+	/////////////////////////////////////////////
+	// API Implementation
+	/////////////////////////////////////////////
+	void strip_init()
+	{
+	#if defined(STRIP_SIMD_SSE2)
+		s_simdSupported = SDL_HasSSE2() == SDL_TRUE;
+	#elif defined(STRIP_SIMD_NEON)
+		s_simdSupported = SDL_HasNEON() == SDL_TRUE;
+	#endif
+		strip_selectFunctions();
+
+		CVAR_BOOL(s_simdSpans, "r_simdSpans", CVFLAG_DO_NOT_SERIALIZE, "Use the SIMD column and scanline functions in the software renderer, if supported.");
+		CCMD("rbenchSpans", console_benchSpans, 0, "Compare the scalar and SIMD software renderer span functions, optionally pass the iteration count.");
+	}
+
+	void strip_destroy()
+	{
+		s_recording = false;
+		s_exitWorkers = true;
+		for (s32 s = 1; s <= s_workerCount; s++)
+		{
+			SDL_SemPost(s_strips[s].start);
+		}
+		for (s32 s = 1; s <= s_workerCount; s++)
+		{
+			SDL_WaitThread(s_strips[s].thread, nullptr);
+			SDL_DestroySemaphore(s_strips[s].start);
+			s_strips[s].thread = nullptr;
+			s_strips[s].start = nullptr;
+		}
+		for (s32 s = 0; s < STRIP_MAX; s++)
+		{
+			std::vector<StripCommand>().swap(s_strips[s].commands);
+		}
+		if (s_stripDone)
+		{
+			SDL_DestroySemaphore(s_stripDone);
+			s_stripDone = nullptr;
+		}
+		s_workerCount = 0;
+		s_exitWorkers = false;
+	}
+
+	void strip_begin(u8* display, s32 width, s32 threadCount)
+	{
+		s_recording = false;
+		strip_selectFunctions();
+
+		s32 count = threadCount > 0 ? threadCount : SDL_GetCPUCount();
+		count = min(count, min((s32)STRIP_MAX, width / STRIP_MIN_WIDTH));
+		if (count <= 1 || !strip_createWorkers(count))
+		{
+			return;
+		}
+
+		s_stripDisplay = display;
+		s_stride = width;
+		s_stripWidth = (width + count - 1) / count;
+		s_stripCount = (width + s_stripWidth - 1) / s_stripWidth;
+		for (s32 s = 0; s < s_stripCount; s++)
+		{
+			s_strips[s].x0 = s * s_stripWidth;
+			s_strips[s].x1 = min(width, s_strips[s].x0 + s_stripWidth) - 1;
+			s_strips[s].commands.clear();
+		}
+		s_recording = true;
+	}
+
+	void strip_end()
+	{
+		if (!s_recording) { return; }
+		s_recording = false;
+
+		TFE_ZONE("Strip Rasterize");
+		for (s32 s = 1; s < s_stripCount; s++)
+		{
+			SDL_SemPost(s_strips[s].start);
+		}
+		strip_rasterize(&s_strips[0]);
+		for (s32 s = 1; s < s_stripCount; s++)
+		{
+			SDL_SemWait(s_stripDone);
+		}
+	}
+
+	void strip_draw(const StripCommand* cmd)
+	{
+		if (!s_recording)
+		{
+			s_stripFunc[cmd->func](cmd, s_width, s_strips[0].workBuffer);
+			return;
+		}
+
+		const s32 x0 = s32(cmd->out - s_stripDisplay) % s_stride;
+		const s32 first = x0 / s_stripWidth;
+		const s32 last = isScanline(cmd) ? (x0 + cmd->count - 1) / s_stripWidth : first;
+		for (s32 s = first; s <= last; s++)
+		{
+			s_strips[s].commands.push_back(*cmd);
+		}
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
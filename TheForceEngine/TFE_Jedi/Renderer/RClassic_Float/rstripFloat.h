@@ -0,0 +1,80 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Strip Rendering
+// Added for TFE: column and scanline rasterization for the floating
+// point sub-renderer, optionally split across threads.
+//
+// Sector traversal, clipping and span setup always run on the main
+// thread. When strip rendering is enabled, the resulting columns and
+// scanlines are recorded instead of drawn; once the traversal is done
+// the view is split into vertical strips and each strip replays the
+// commands that touch it, in the original order, on its own thread.
+// Every pixel receives exactly the same writes in the same order, so
+// the output is identical to single threaded rendering.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include "fixedPoint20.h"
+
+namespace TFE_Jedi
+{
+	namespace RClassic_Float
+	{
+		enum StripFunc
+		{
+			// Textured columns - walls, signs, sky and sprites.
+			SFUNC_COLUMN_FULLBRIGHT = 0,
+			SFUNC_COLUMN_LIT,
+			SFUNC_COLUMN_FULLBRIGHT_TRANS,
+			SFUNC_COLUMN_LIT_TRANS,
+			// Flat scanlines - floors, ceilings and 3D object planes.
+			SFUNC_SCANLINE_LIT,
+			SFUNC_SCANLINE_FULLBRIGHT,
+			SFUNC_SCANLINE_TRANS,
+			SFUNC_SCANLINE_FULLBRIGHT_TRANS,
+			// 3D object polygon columns.
+			SFUNC_POLY_FLAT_COLOR,
+			SFUNC_POLY_SHADED_COLOR,
+			SFUNC_POLY_FLAT_TEXTURE,
+			SFUNC_POLY_SHADED_TEXTURE,
+			// Single pixel - 3D object vertices.
+			SFUNC_PIXEL,
+
+			SFUNC_COUNT
+		};
+
+		// Everything required to draw a single column, scanline or pixel, captured by value.
+		struct StripCommand
+		{
+			u8* out;				// Top of the column or left side of the scanline.
+			const u8* tex;			// Texture column or image; compressed column data if compressedHeight > 0.
+			const u8* colorMap;		// Light level, polygon colormap or null.
+
+			fixed44_20 u, v;		// Texture coordinates at the bottom of the column or right side of the scanline.
+			fixed44_20 du, dv;		// Per pixel steps, moving up the column or left along the scanline.
+			fixed44_20 i, di;		// Polygon intensity.
+			fixed44_20 ditherOffset;
+
+			s32 count;				// Column height or scanline width in pixels.
+			s32 texMask;			// Column height mask, scanline data end or polygon width mask.
+			s32 texHeight;			// Polygon texture height.
+			s32 compressedHeight;	// Sprite height if the column is compressed and must be decompressed before drawing.
+			s32 dither;
+			u8  func;				// StripFunc
+			u8  color;
+		};
+
+		// Registers the console variables and selects the column and scanline functions for the current CPU.
+		void strip_init();
+		void strip_destroy();
+
+		// Starts recording at the beginning of the frame if more than one strip is requested,
+		// otherwise commands are drawn immediately.
+		// threadCount: number of strips (and threads) used to rasterize, 0 = one per logical CPU, 1 = disabled.
+		void strip_begin(u8* display, s32 width, s32 threadCount);
+		// Draws the recorded commands (if any) and waits for all of the strips to finish.
+		void strip_end();
+
+		// Draws the command immediately or records it, depending on whether strip rendering is active.
+		void strip_draw(const StripCommand* cmd);
+	}
+}
@@ -11,6 +11,7 @@
 #include "rlightingFloat.h"
 #include "rsectorFloat.h"
 #include "redgePairFloat.h"
+#include "rstripFloat.h"
 #include "rclassicFloatSharedState.h"
 #include "../rcommon.h"
 #include "../jediRenderer.h"
@@ -36,7 +37,7 @@ namespace RClassic_Float
 	static const u8* s_columnLight;
 	static u8* s_texImage;
 	static u8* s_columnOut;
-	static u8  s_workBuffer[WAX_DECOMPRESS_SIZE];
+	static s32 s_columnCompressedHeight;	// non-zero if s_texImage points to compressed sprite column data.
 
 	s32 segmentCrossesLine(f32 ax0, f32 ay0, f32 ax1, f32 ay1, f32 bx0, f32 by0, f32 bx1, f32 by1);
 	f32 solveForZ_Numerator(RWallSegmentFloat* wallSegment);
@@ -2140,62 +2141,39 @@ namespace RClassic_Float
 		return z;
 	}
 
-	void drawColumn_Fullbright()
+	static void submitColumn(StripFunc func)
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
+		StripCommand cmd = {};
+		cmd.func = func;
+		cmd.out = s_columnOut;
+		cmd.count = s_yPixelCount;
+		cmd.tex = s_texImage;
+		cmd.texMask = s_texHeightMask;
+		cmd.compressedHeight = s_columnCompressedHeight;
+		cmd.colorMap = s_columnLight;
+		cmd.v = s_vCoordFixed;
+		cmd.dv = s_vCoordStep;
+		strip_draw(&cmd);
+	}
 
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
-		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			s_columnOut[offset] = tex[v];
-		}
+	void drawColumn_Fullbright()
+	{
+		submitColumn(SFUNC_COLUMN_FULLBRIGHT);
 	}
 
 	void drawColumn_Lit()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
-		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			s_columnOut[offset] = s_columnLight[tex[v]];
-		}
+		submitColumn(SFUNC_COLUMN_LIT);
 	}
 
 	void drawColumn_Fullbright_Trans()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
-		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			const u8 c = tex[v];
-			if (c) { s_columnOut[offset] = c; }
-		}
+		submitColumn(SFUNC_COLUMN_FULLBRIGHT_TRANS);
 	}
 
 	void drawColumn_Lit_Trans()
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
-
-		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
-		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			const u8 c = tex[v];
-			if (c) { s_columnOut[offset] = s_columnLight[c]; }
-		}
+		submitColumn(SFUNC_COLUMN_LIT_TRANS);
 	}
 
 	void wall_addAdjoinSegment(s32 length, s32 x0, f32 top_dydx, f32 y1, f32 bot_dydx, f32 y0, RWallSegmentFloat* wallSegment)
@@ -2362,16 +2340,15 @@ namespace RClassic_Float
 
 					if (compressed)
 					{
-						const u8* colPtr = (u8*)cell + columnOffset[texelU];
-
-						// Decompress the column into "work buffer."
-						assert(cell->sizeY <= 1024 && texelU >= 0 && texelU < cell->sizeX);
-						sprite_decompressColumn(colPtr, s_workBuffer, cell->sizeY);
-						s_texImage = (u8*)s_workBuffer;
+						// The column is decompressed into a work buffer when it is drawn.
+						assert(cell->sizeY <= WAX_DECOMPRESS_SIZE && texelU >= 0 && texelU < cell->sizeX);
+						s_texImage = (u8*)cell + columnOffset[texelU];
+						s_columnCompressedHeight = cell->sizeY;
 					}
 					else
 					{
 						s_texImage = (u8*)image + columnOffset[texelU];
+						s_columnCompressedHeight = 0;
 					}
 					// Output.
 					s_columnOut = &s_display[y0 * s_width + x];
@@ -2381,6 +2358,7 @@ namespace RClassic_Float
 				}
 			}
 		}
+		s_columnCompressedHeight = 0;
 
 		if (drawn && s_drawnObjCount < MAX_DRAWN_OBJ_STORE)
 		{
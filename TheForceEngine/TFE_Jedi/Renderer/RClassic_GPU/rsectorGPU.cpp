@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include <TFE_System/profiler.h>
 #include <TFE_System/math.h>
@@ -99,7 +101,19 @@ namespace TFE_Jedi
 		s32 skyParam1Id;
 	};
 
+	// Range of GPU source data elements (Vec4f) modified this frame - [start, end).
+	struct UploadRange
+	{
+		s32 start;
+		s32 end;
+	};
+	// Ranges closer than this (in elements) are merged into a single upload.
+	static const s32 c_uploadMergeGap = 64;
+
 	static GPUSourceData s_gpuSourceData = { 0 };
+	static std::vector<UploadRange> s_sectorUploadRanges;
+	static std::vector<UploadRange> s_wallUploadRanges;
+	static s32 s_gpuUploadBytes = 0;
 
 	TextureGpu* s_trueColorMapping = nullptr;
 	static TextureGpu*  s_colormapTex = nullptr;
@@ -617,6 +631,7 @@ namespace TFE_Jedi
 		return deltaSq.x * scaleMetric.x + deltaSq.y * scaleMetric.y + deltaSq.z * scaleMetric.z;
 	}
 
+	// Brute force search, this is the reference for getClosestColorGrid().
 	s32 getClosestColor(const u8 rgb6[3], const Vec3f* linPal)
 	{
 		const f32 scale = 1.0f / 63.0f;
@@ -651,6 +666,118 @@ namespace TFE_Jedi
 		return closestIndex;
 	}
 
+	/////////////////////////////////////////////
+	// True color to palette table
+	// The closest color search uses a bucket grid
+	// over linear color space, visiting cells in
+	// rings around the query color until no closer
+	// entry can exist. The result matches the brute
+	// force search exactly, including ties, which
+	// resolve to the lowest palette index.
+	/////////////////////////////////////////////
+	enum TrueColorTableConstants
+	{
+		TC_GRID_DIM   = 8,
+		TC_GRID_CELLS = TC_GRID_DIM * TC_GRID_DIM * TC_GRID_DIM,
+	};
+
+	struct TrueColorGrid
+	{
+		s32 cellStart[TC_GRID_CELLS + 1];
+		u8  entries[256];	// palette indices sorted by cell, ascending within each cell.
+	};
+
+	static TrueColorGrid s_trueColorGrid;
+
+	s32 getColorGridCoord(f32 value)
+	{
+		return clamp(s32(value * f32(TC_GRID_DIM)), 0, TC_GRID_DIM - 1);
+	}
+
+	void buildColorGrid(const Vec3f* linPal)
+	{
+		s32 cellIndex[256];
+		s32 cellCount[TC_GRID_CELLS] = { 0 };
+		for (s32 i = 32; i < 256; i++)
+		{
+			cellIndex[i] = getColorGridCoord(linPal[i].x) + getColorGridCoord(linPal[i].y) * TC_GRID_DIM + getColorGridCoord(linPal[i].z) * TC_GRID_DIM * TC_GRID_DIM;
+			cellCount[cellIndex[i]]++;
+		}
+		s_trueColorGrid.cellStart[0] = 0;
+		for (s32 c = 0; c < TC_GRID_CELLS; c++)
+		{
+			s_trueColorGrid.cellStart[c + 1] = s_trueColorGrid.cellStart[c] + cellCount[c];
+			cellCount[c] = s_trueColorGrid.cellStart[c];
+		}
+		for (s32 i = 32; i < 256; i++)
+		{
+			s_trueColorGrid.entries[cellCount[cellIndex[i]]++] = u8(i);
+		}
+	}
+
+	// Same as getClosestColor() but only visits the grid cells that can hold a closer entry.
+	s32 getClosestColorGrid(const u8 rgb6[3], const Vec3f* linPal)
+	{
+		const f32 scale = 1.0f / 63.0f;
+		Vec3f srgb = { f32(rgb6[0]) * scale, f32(rgb6[1]) * scale, f32(rgb6[2]) * scale };
+		Vec3f lin = computeLinearColor(srgb);
+		bool nonZero = lin.x > 0.0f || lin.y > 0.0f || lin.z > 0.0f;
+
+		const s32 cx = getColorGridCoord(lin.x);
+		const s32 cy = getColorGridCoord(lin.y);
+		const s32 cz = getColorGridCoord(lin.z);
+		const f32 cellSize = 1.0f / f32(TC_GRID_DIM);
+
+		f32 closestDist = FLT_MAX;
+		s32 closestIndex = -1;
+		for (s32 r = 0; r < TC_GRID_DIM; r++)
+		{
+			// Every cell in ring r is at least (r - 1) cells away on some axis and the metric weights are all >= 2.
+			// The bound is scaled down slightly so rounding can never skip an equal or closer entry.
+			if (closestIndex >= 0 && r > 1)
+			{
+				const f32 gap = f32(r - 1) * cellSize;
+				if (2.0f * gap * gap * 0.99f > closestDist) { break; }
+			}
+
+			const s32 z0 = max(0, cz - r), z1 = min(TC_GRID_DIM - 1, cz + r);
+			const s32 y0 = max(0, cy - r), y1 = min(TC_GRID_DIM - 1, cy + r);
+			const s32 x0 = max(0, cx - r), x1 = min(TC_GRID_DIM - 1, cx + r);
+			for (s32 z = z0; z <= z1; z++)
+			{
+				for (s32 y = y0; y <= y1; y++)
+				{
+					for (s32 x = x0; x <= x1; x++)
+					{
+						// Only the cells on the ring itself, the inner cells have already been visited.
+						if (max(TFE_Jedi::abs(x - cx), max(TFE_Jedi::abs(y - cy), TFE_Jedi::abs(z - cz))) != r) { continue; }
+
+						const s32 cell = x + y * TC_GRID_DIM + z * TC_GRID_DIM * TC_GRID_DIM;
+						for (s32 e = s_trueColorGrid.cellStart[cell]; e < s_trueColorGrid.cellStart[cell + 1]; e++)
+						{
+							const s32 i = s_trueColorGrid.entries[e];
+							// Same filters as getClosestColor().
+							if (nonZero && (lin.x*linPal[i].x + lin.y*linPal[i].y + lin.z*linPal[i].z == 0.0f)) { continue; }
+							if ((lin.x > FLT_EPSILON && linPal[i].x <= FLT_EPSILON) || (lin.y > FLT_EPSILON && linPal[i].y <= FLT_EPSILON) ||
+								(lin.z > FLT_EPSILON && linPal[i].z <= FLT_EPSILON))
+							{
+								continue;
+							}
+
+							const f32 dist = getColorDistSq(lin, linPal[i]);
+							if (dist < closestDist || (dist == closestDist && i < closestIndex))
+							{
+								closestDist = dist;
+								closestIndex = i;
+							}
+						}
+					}
+				}
+			}
+		}
+		return closestIndex;
+	}
+
 	void generateTrueColorMapping2()
 	{
 		// First generate colors from the palette.
@@ -662,6 +789,7 @@ namespace TFE_Jedi
 			srgbPal[i] = computeSrgbColor(pal[i]);
 			linPal[i] = computeLinearColor(srgbPal[i]);
 		}
+		buildColorGrid(linPal);
 
 		// Now build the table itself...
 		const u32 count = 64 * 64 * 64;
@@ -678,7 +806,8 @@ namespace TFE_Jedi
 			};
 
 			const f32 scale = 1.0f / 63.0f;
-			s32 index = getClosestColor(rgb, linPal);
+			// Entries without a valid match use index 0 (indices below 32 are never used otherwise).
+			s32 index = max(0, getClosestColorGrid(rgb, linPal));
 			Vec3f p = srgbPal[index];
 			Vec3f c = { f32(rgb[0]) * scale, f32(rgb[1]) * scale, f32(rgb[2]) * scale };
 			Vec3f m = { 1.0f, 1.0f, 1.0f };
@@ -811,6 +940,7 @@ namespace TFE_Jedi
 		if (!m_gpuInit)
 		{
 			TFE_COUNTER(s_wallSegGenerated, "Wall Segments");
+			TFE_COUNTER(s_gpuUploadBytes, "Sector Upload Bytes");
 			
 			m_gpuInit = true;
 			s_gpuFrame = 1;
@@ -854,6 +984,8 @@ namespace TFE_Jedi
 			m_levelInit = true;
 
 			// Let's just cache the current data.
+			s_sectorUploadRanges.clear();
+			s_wallUploadRanges.clear();
 			s_cachedSectors = (GPUCachedSector*)level_alloc(sizeof(GPUCachedSector) * s_levelState.sectorCount);
 			memset(s_cachedSectors, 0, sizeof(GPUCachedSector) * s_levelState.sectorCount);
 
@@ -1022,16 +1154,63 @@ namespace TFE_Jedi
 		renderDebug_enable(s_enableDebug);
 	}
 	
-	void updateCachedWalls(RSector* srcSector, u32 flags, u32& uploadFlags)
+	static bool sortUploadRanges(const UploadRange& a, const UploadRange& b)
 	{
-		GPUCachedSector* cached = &s_cachedSectors[srcSector->index];
-		if (flags & (SDF_HEIGHTS | SDF_AMBIENT))
+		return a.start < b.start;
+	}
+
+	// Upload the modified ranges of the source data, merging ranges that overlap or are close together.
+	// If most of the buffer has changed, it is uploaded in one go instead.
+	static void uploadModifiedRanges(ShaderBuffer* buffer, const Vec4f* data, u32 dataSize, std::vector<UploadRange>& ranges)
+	{
+		if (ranges.empty()) { return; }
+		std::sort(ranges.begin(), ranges.end(), sortUploadRanges);
+
+		s32 mergedCount = 0;
+		s32 elementCount = 0;
+		UploadRange* merged = ranges.data();
+		for (size_t i = 1; i < ranges.size(); i++)
 		{
-			uploadFlags |= UPLOAD_WALLS;
+			if (ranges[i].start <= merged[mergedCount].end + c_uploadMergeGap)
+			{
+				merged[mergedCount].end = max(merged[mergedCount].end, ranges[i].end);
+			}
+			else
+			{
+				elementCount += merged[mergedCount].end - merged[mergedCount].start;
+				merged[++mergedCount] = ranges[i];
+			}
+		}
+		elementCount += merged[mergedCount].end - merged[mergedCount].start;
+		mergedCount++;
+
+		const u32 uploadSize = u32(elementCount) * sizeof(Vec4f);
+		if (uploadSize >= dataSize / 2)
+		{
+			buffer->update(data, dataSize);
+			s_gpuUploadBytes += s32(dataSize);
+		}
+		else
+		{
+			for (s32 i = 0; i < mergedCount; i++)
+			{
+				const size_t offset = size_t(merged[i].start) * sizeof(Vec4f);
+				const size_t size = size_t(merged[i].end - merged[i].start) * sizeof(Vec4f);
+				buffer->updateRange(&data[merged[i].start], offset, size);
+			}
+			s_gpuUploadBytes += s32(uploadSize);
 		}
+		ranges.clear();
+	}
+
+	void updateCachedWalls(RSector* srcSector, u32 flags, u32& uploadFlags)
+	{
+		GPUCachedSector* cached = &s_cachedSectors[srcSector->index];
+		// Note: the wall data does not depend on the sector heights or ambient, so those changes do not need an upload.
 		if (flags & (SDF_VERTICES | SDF_WALL_CHANGE | SDF_WALL_OFFSETS | SDF_WALL_SHAPE))
 		{
 			uploadFlags |= UPLOAD_WALLS;
+			s_wallUploadRanges.push_back({ cached->wallStart * 3, (cached->wallStart + srcSector->wallCount) * 3 });
 			Vec4f* wallData = &s_gpuSourceData.walls[cached->wallStart*3];
 			const RWall* srcWall = srcSector->walls;
 			for (s32 w = 0; w < srcSector->wallCount; w++, wallData+=3, srcWall++)
@@ -1094,6 +1273,7 @@ namespace TFE_Jedi
 			s_gpuSourceData.sectors[srcSector->index*2+1].w = fixed16ToFloat(srcSector->ceilOffset.z);
 
 			uploadFlags |= UPLOAD_SECTORS;
+			s_sectorUploadRanges.push_back({ srcSector->index * 2, srcSector->index * 2 + 2 });
 		}
 		updateCachedWalls(srcSector, flags, uploadFlags);
 		srcSector->dirtyFlags = SDF_NONE;
@@ -1745,6 +1925,7 @@ namespace TFE_Jedi
 		s_portalsTraversed = 0;
 		s_portalListCount = 0;
 		s_wallSegGenerated = 0;
+		s_gpuUploadBytes = 0;
 		Vec2f startView[] = { {0,0}, {0,0} };
 
 		// Compute an XZ direction for sprite culling.
@@ -1794,13 +1975,14 @@ namespace TFE_Jedi
 		s_scaledAmbient = (s_sectorAmbient >> 1) + (s_sectorAmbient >> 2) + (s_sectorAmbient >> 3);
 		s_sectorAmbientFraction = s_sectorAmbient << 11;	// fraction of ambient compared to max.
 
+		// Only upload the parts of the sector and wall data that changed this frame.
 		if (uploadFlags & UPLOAD_SECTORS)
 		{
-			s_sectorGpuBuffer.update(s_gpuSourceData.sectors, s_gpuSourceData.sectorSize);
+			uploadModifiedRanges(&s_sectorGpuBuffer, s_gpuSourceData.sectors, s_gpuSourceData.sectorSize, s_sectorUploadRanges);
 		}
 		if (uploadFlags & UPLOAD_WALLS)
 		{
-			s_wallGpuBuffer.update(s_gpuSourceData.walls, s_gpuSourceData.wallSize);
+			uploadModifiedRanges(&s_wallGpuBuffer, s_gpuSourceData.walls, s_gpuSourceData.wallSize, s_wallUploadRanges);
 		}
 
 		return sdisplayList_getSize() > 0;
@@ -12,6 +12,7 @@
 #include "RClassic_Float/rclassicFloat.h"
 #include "RClassic_Float/rsectorFloat.h"
 #include "RClassic_Float/rclassicFloatSharedState.h"
+#include "RClassic_Float/rstripFloat.h"
 
 #include "RClassic_GPU/rclassicGPU.h"
 #include "RClassic_GPU/rsectorGPU.h"
@@ -116,6 +117,7 @@ namespace TFE_Jedi
 		CVAR_INT(s_maxDepthCount, "d_maxDepthCount", CVFLAG_DO_NOT_SERIALIZE, "Maximum adjoin depth count.");
 		CVAR_INT(s_sectorAmbient, "d_sectorAmbient", CVFLAG_DO_NOT_SERIALIZE, "Current Sector Ambient.");
 		CVAR_BOOL(s_showWireframe, "d_enableWireframe", CVFLAG_DO_NOT_SERIALIZE, "Enable wireframe rendering.");
+		RClassic_Float::strip_init();
 
 		// Remove temporarily until they do something useful again.
 		CCMD("rsetSubRenderer", console_setSubRenderer, 1, "Set the sub-renderer - valid values are: Classic_Fixed, Classic_Float, Classic_GPU.");
@@ -137,6 +139,7 @@ namespace TFE_Jedi
 	{
 		renderer_resetState();
 		screenGPU_destroy();
+		RClassic_Float::strip_destroy();
 	}
 
 	void renderer_reset()
@@ -562,8 +565,18 @@ namespace TFE_Jedi
 		// Recursively draws sectors and their contents (sprites, 3D objects).
 		{
 			TFE_ZONE("Sector Draw");
+			if (s_subRenderer == TSR_CLASSIC_FLOAT)
+			{
+				// Columns and scanlines are recorded during the traversal and split across threads at the end.
+				const TFE_Settings_Graphics* graphics = TFE_Settings::getGraphicsSettings();
+				RClassic_Float::strip_begin(display, s_width, graphics->softwareThreads ? graphics->softwareThreadCount : 1);
+			}
 			s_sectorRenderer->prepare();
 			s_sectorRenderer->draw(sector);
+			if (s_subRenderer == TSR_CLASSIC_FLOAT)
+			{
+				RClassic_Float::strip_end();
+			}
 		}
 	}
 
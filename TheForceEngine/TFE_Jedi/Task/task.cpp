@@ -545,6 +545,17 @@ namespace TFE_Jedi
 		s_prevTime = TFE_System::getTime();
 	}
 
+	// TFE: How far the current time is between the last step and the next, in the range [0, 1].
+	f64 task_getStepAlpha()
+	{
+		if (s_minIntervalInSec <= 0.0)
+		{
+			return 1.0;
+		}
+		const f64 alpha = (TFE_System::getTime() - s_prevTime) / s_minIntervalInSec;
+		return alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha);
+	}
+
 	// Called once per frame to run all of the tasks.
 	// Returns JFALSE if it cannot be run due to the time interval.
 	JBool task_run()
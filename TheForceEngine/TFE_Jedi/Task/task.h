@@ -76,6 +76,8 @@ namespace TFE_Jedi
 
 	void task_updateTime();
 	s32 task_getCount();
+	// TFE: Returns the fraction of the minimum step interval that has elapsed since the last step, in the range [0, 1].
+	f64 task_getStepAlpha();
 }
 ////////////////////////////////////////////////////////////////////////
 // Task Function API:
@@ -11,6 +11,14 @@
 #include <string>
 #include <vector>
 
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2))
+	#include <emmintrin.h>
+	#define POLY_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define POLY_SIMD_NEON 1
+#endif
+
 #define USE_POLY_ASSERT 0
 
 namespace TFE_Polygon
@@ -422,6 +430,130 @@ namespace TFE_Polygon
 		return edgeIndex;
 	}
 
+	enum
+	{
+		EDGE_TABLE_LANES = 4,
+	};
+
+	void buildEdgeTable(Polygon* poly)
+	{
+		PolygonEdgeTable* table = &poly->edgeTable;
+		const s32 edgeCount = (s32)poly->edge.size();
+		const s32 paddedCount = (edgeCount + EDGE_TABLE_LANES - 1) & ~(EDGE_TABLE_LANES - 1);
+		// Padding entries have minZ > maxZ so they never pass.
+		table->count = edgeCount;
+		table->minZ.assign(paddedCount, FLT_MAX);
+		table->maxZ.assign(paddedCount, -FLT_MAX);
+		table->maxX.assign(paddedCount, -FLT_MAX);
+		table->dzPrev.assign(paddedCount, 0.0f);
+		if (!edgeCount) { return; }
+
+		const Edge* edge = poly->edge.data();
+		const Vec2f* vtx = poly->vtx.data();
+		f32 dzPrev = vtx[edge[edgeCount - 1].i1].z - vtx[edge[edgeCount - 1].i0].z;
+		for (s32 e = 0; e < edgeCount; e++)
+		{
+			const Vec2f v0 = vtx[edge[e].i0];
+			const Vec2f v1 = vtx[edge[e].i1];
+			const f32 dz = v1.z - v0.z;
+			table->minZ[e] = std::min(v0.z, v1.z);
+			table->maxZ[e] = std::max(v0.z, v1.z);
+			table->maxX[e] = std::max(v0.x, v1.x);
+			table->dzPrev[e] = dzPrev;
+			if (dz != 0) { dzPrev = dz; }
+		}
+	}
+
+	// Returns a bit per edge in [e, e + EDGE_TABLE_LANES) that can affect the crossing test:
+	// minZ <= p.z <= maxZ and p.x <= maxX. Edges that fail are skipped or return PS_INSIDE in the original loop.
+	u32 edgeTableMask(const PolygonEdgeTable* table, s32 e, Vec2f p)
+	{
+	#if defined(POLY_SIMD_SSE2)
+		const __m128 px = _mm_set1_ps(p.x);
+		const __m128 pz = _mm_set1_ps(p.z);
+		const __m128 accept = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&table->minZ[e]), pz), _mm_cmple_ps(pz, _mm_loadu_ps(&table->maxZ[e]))),
+			_mm_cmple_ps(px, _mm_loadu_ps(&table->maxX[e])));
+		return u32(_mm_movemask_ps(accept));
+	#elif defined(POLY_SIMD_NEON)
+		const float32x4_t px = vdupq_n_f32(p.x);
+		const float32x4_t pz = vdupq_n_f32(p.z);
+		const uint32x4_t accept = vandq_u32(vandq_u32(vcleq_f32(vld1q_f32(&table->minZ[e]), pz), vcleq_f32(pz, vld1q_f32(&table->maxZ[e]))),
+			vcleq_f32(px, vld1q_f32(&table->maxX[e])));
+		u32 lanes[EDGE_TABLE_LANES];
+		vst1q_u32(lanes, accept);
+		return (lanes[0] & 1) | (lanes[1] & 2) | (lanes[2] & 4) | (lanes[3] & 8);
+	#else
+		u32 mask = 0;
+		for (s32 l = 0; l < EDGE_TABLE_LANES; l++)
+		{
+			if (table->minZ[e + l] <= p.z && p.z <= table->maxZ[e + l] && p.x <= table->maxX[e + l])
+			{
+				mask |= 1u << l;
+			}
+		}
+		return mask;
+	#endif
+	}
+
+	// The original DF algorithm, only visiting the edges that pass the edge table test.
+	bool pointInsidePolygonEdgeTable(const Polygon* poly, Vec2f p)
+	{
+		const PolygonEdgeTable* table = &poly->edgeTable;
+		const s32 paddedCount = (s32)table->minZ.size();
+		const Edge* edge = poly->edge.data();
+		const Vec2f* vtx = poly->vtx.data();
+		s32 crossings = 0;
+
+		for (s32 i = 0; i < paddedCount; i += EDGE_TABLE_LANES)
+		{
+			u32 mask = edgeTableMask(table, i, p);
+			for (s32 e = i; mask; e++, mask >>= 1)
+			{
+				if (!(mask & 1)) { continue; }
+
+				const Vec2f v0 = vtx[edge[e].i0];
+				const Vec2f v1 = vtx[edge[e].i1];
+				const f32 dz = v1.z - v0.z;
+				if (dz != 0)
+				{
+					if (p.z == v0.z && p.x == v0.x)
+					{
+						return true;
+					}
+					else if (p.z != v0.z)
+					{
+						if (p.z != v1.z)
+						{
+							PointSegSide side = lineSegmentSide(p, v0, v1);
+							if (side == PS_OUTSIDE)
+							{
+								crossings++;
+							}
+							else if (side == PS_ON_LINE)
+							{
+								return true;
+							}
+						}
+					}
+					else if (p.x < v0.x)
+					{
+						const f32 dzLast = table->dzPrev[e];
+						if (sign(dz) == sign(dzLast) || dzLast == 0)
+						{
+							crossings++;
+						}
+					}
+				}
+				else if (lineSegmentSide(p, v0, v1) == PS_ON_LINE)
+				{
+					return true;
+				}
+			}
+		}
+
+		return (crossings & 1) != 0;
+	}
+
 	bool pointInsidePolygon(const Polygon* poly, Vec2f p)
 	{
 		if (p.x < poly->bounds[0].x + eps || p.x > poly->bounds[1].x - eps || p.z < poly->bounds[0].z + eps || p.z > poly->bounds[1].z - eps)
@@ -430,6 +562,10 @@ namespace TFE_Polygon
 		}
 
 		const s32 edgeCount = (s32)poly->edge.size();
+		if (edgeCount > 0 && poly->edgeTable.count == edgeCount)
+		{
+			return pointInsidePolygonEdgeTable(poly, p);
+		}
 		const Edge* edge = poly->edge.data();
 		const Edge* last = &edge[edgeCount - 1];
 		const Vec2f* vtx = poly->vtx.data();
@@ -666,6 +802,7 @@ namespace TFE_Polygon
 
 		poly->triVtx.clear();
 		poly->triIdx.clear();
+		buildEdgeTable(poly);
 
 		const size_t edgeCount = poly->edge.size();
 		if (edgeCount < 3)
@@ -8,6 +8,17 @@ struct Edge
 	s32 i0, i1;
 };
 
+// Per-edge values used to reject edges in pointInsidePolygon(), stored as a structure of arrays
+// padded to a multiple of 4 entries.
+struct PolygonEdgeTable
+{
+	s32 count = 0;
+	std::vector<f32> minZ;
+	std::vector<f32> maxZ;
+	std::vector<f32> maxX;
+	std::vector<f32> dzPrev;	// dz of the closest previous edge where it is not zero, wrapping to the last edge.
+};
+
 // Complex polygon and cached triangle list.
 struct Polygon
 {
@@ -18,6 +29,8 @@ struct Polygon
 	// Cached triangles - every 3 indices = 1 triangle.
 	std::vector<Vec2f> triVtx;
 	std::vector<s32> triIdx;
+	// Cached edge table, built by computeTriangulation().
+	PolygonEdgeTable edgeTable;
 };
 
 enum PolyDebug
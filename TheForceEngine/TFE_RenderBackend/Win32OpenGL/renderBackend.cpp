@@ -116,6 +116,10 @@ namespace TFE_RenderBackend
 			y = monitorInfo.y;
 			windowFlags |= SDL_WINDOW_BORDERLESS;
 		}
+		if (state.flags & WINFLAG_HIDDEN)
+		{
+			windowFlags |= SDL_WINDOW_HIDDEN;
+		}
 
 		SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, true);
 
@@ -60,6 +60,14 @@ void ShaderBuffer::update(const void* buffer, size_t size)
 	glBindBuffer(GL_TEXTURE_BUFFER, 0);
 }
 
+void ShaderBuffer::updateRange(const void* buffer, size_t offset, size_t size)
+{
+	if (!size || offset + size > m_size) { return; }
+	glBindBuffer(GL_TEXTURE_BUFFER, m_gpuHandle[0]);
+	glBufferSubData(GL_TEXTURE_BUFFER, offset, size, buffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
 void ShaderBuffer::bind(s32 bindPoint) const
 {
 	if (bindPoint < 0) { return; }
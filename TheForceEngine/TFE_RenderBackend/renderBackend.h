@@ -18,6 +18,7 @@ enum WindowFlags
 {
 	WINFLAG_FULLSCREEN = 1 << 0,
 	WINFLAG_VSYNC = 1 << 1,
+	WINFLAG_HIDDEN = 1 << 2,	// Create the window hidden, used by headless mode.
 };
 
 enum DisplayMode
@@ -34,6 +34,8 @@ public:
 	void destroy();
 
 	void update(const void* buffer, size_t size);
+	// Update part of the buffer in place, offset and size are in bytes.
+	void updateRange(const void* buffer, size_t offset, size_t size);
 	void bind(s32 bindPoint) const;
 	void unbind(s32 bindPoint) const;
 
@@ -1,7 +1,11 @@
 #include <cstring>
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
 
 #include <TFE_System/profiler.h>
 #include <TFE_System/math.h>
+#include <TFE_System/hash.h>
+#include <TFE_System/cacheFile.h>
 #include <TFE_Asset/modelAsset_jedi.h>
 #include <TFE_Game/igame.h>
 #include <TFE_Jedi/Level/level.h>
@@ -22,6 +26,7 @@
 #include <TFE_Settings/settings.h>
 
 #include <TFE_Asset/imageAsset.h>
+#include <TFE_FileSystem/paths.h>
 #include <TFE_Memory/chunkedArray.h>
 
 #include <map>
@@ -54,9 +59,77 @@ namespace TFE_Jedi
 		PALETTE_SIZE = 256,
 		PALETTE_DEFAULT_IDX = 1,
 		COLOR_INDEX_COUNT = 8,
+		PACK_MAX_THREADS = 8,
 	};
 	static const f32 c_satLimit = 0.2f;
 
+	enum PackJobType
+	{
+		PACK_JOB_TEXTURE = 0,
+		PACK_JOB_DELT_TEX,
+		PACK_JOB_WAX_CELL,
+	};
+
+	// Copies a texture or wax cell into its place on a page, see runPackJob().
+	struct PackJob
+	{
+		PackJobType type = PACK_JOB_TEXTURE;
+		Vec4ui rect = { 0 };
+		s32 page = 0;
+		s32 tableIndex = 0;
+
+		TextureData* texData = nullptr;
+		const TextureData* hdSrc = nullptr;
+		s32 frameIndex = 0;
+
+		const void* basePtr = nullptr;
+		const WaxCell* cell = nullptr;
+		const HdWax* hdWax = nullptr;
+
+		s32 paddingX = 0;
+		s32 paddingY = 0;
+		s32 mipCount = 1;
+	};
+
+	enum PackCacheConstants
+	{
+		PACK_CACHE_MAGIC   = 0x4b415054,	// "TPAK"
+		// Increment whenever the packing algorithm or the file layout changes.
+		PACK_CACHE_VERSION = 1,
+		// Each new set of textures adds a file, so only the most recently written layouts are kept.
+		PACK_CACHE_MAX_FILES = 64,
+
+		PACK_NODE_SPLIT = FLAG_BIT(0),
+		PACK_NODE_FULL  = FLAG_BIT(1),
+		PACK_NODE_EMPTY = FLAG_BIT(2),	// The page has no tree.
+
+		PACK_ENTRY_MISSING = 0xffffffff,
+		PACK_ENTRY_PACKED  = 0xfffffffe,
+	};
+
+	// The magic number, version and key are stored by TFE_CacheFile.
+	struct PackCacheHeader
+	{
+		u32 placementCount;
+		u32 nodeCount;
+		s32 firstPage;
+		s32 pageCount;
+	};
+
+	// The result of each insertion attempt in order, page is -1 if the texture did not fit.
+	struct PackPlacement
+	{
+		s32 page;
+		Vec4ui rect;
+	};
+
+	// Page trees are stored in depth first order.
+	struct PackCacheNode
+	{
+		Vec4ui rect;
+		u32 flags;
+	};
+
 	static std::vector<TextureNode*> s_nodes;
 	static TextureNode* s_root;
 	static TexturePacker* s_texturePacker;
@@ -76,6 +149,18 @@ namespace TFE_Jedi
 
 	static u32 s_conversionPal[PALETTE_COUNT][PALETTE_SIZE];
 
+	static std::vector<PackJob> s_packJobs;
+	static std::vector<s32> s_mipPages;
+	static std::vector<PackPlacement> s_packPlacements;
+	static std::vector<PackCacheNode> s_packNodes;
+	static atomic_s32 s_nextPackJob(0);
+	static atomic_s32 s_nextMipPage(0);
+	static size_t s_packReplayIndex = 0;
+	static bool s_packReplay = false;
+	static bool s_packReplayFailed = false;
+	static s32 s_packCachePageCount = 0;
+	static u8 s_cachedNodeTex = 0;
+
 	// Global Packer
 	static const char* c_globalTexturePackerName = "GameTextures";
 	static const s32   c_globalPageWidth = 4096;
@@ -731,15 +816,15 @@ namespace TFE_Jedi
 		}
 	}
 
-	void generateTrueColorMips(const TextureNode* node, const TextureData* texData, s32 scaleFactor, s32 paddingX, s32 paddingY, s32 mipCount, u32* output)
+	void generateTrueColorMips(const Vec4ui* rect, s32 page, const TextureData* texData, s32 scaleFactor, s32 paddingX, s32 paddingY, s32 mipCount)
 	{
-		const u32* source = (u32*)getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+		const u32* source = (u32*)getWritePointer(page, rect->x, rect->y, 0);
 		u32 w = texData->width  * scaleFactor + paddingX;
 		u32 h = texData->height * scaleFactor + paddingY;
 		u32 stride = s_texturePacker->width;
 		for (s32 m = 1; m < mipCount; m++)
 		{
-			output = (u32*)getWritePointer(s_currentPage, node->rect.x, node->rect.y, m);
+			u32* output = (u32*)getWritePointer(page, rect->x, rect->y, m);
 			generateMipmap(source, output, w, h, stride);
 
 			stride >>= 1;
@@ -763,7 +848,8 @@ namespace TFE_Jedi
 		}
 	}
 
-	void packNode(const TextureNode* node, const TextureData* texData, Vec4i* tableEntry, s32 paddingX, s32 paddingY, s32 mipCount, const TextureData* hdSrc, s32 frameIndex)
+	// Mipmaps are generated separately, once all of the textures on the page have been copied.
+	void packNode(const Vec4ui* rect, s32 page, const TextureData* texData, Vec4i* tableEntry, s32 paddingX, s32 paddingY, const TextureData* hdSrc, s32 frameIndex)
 	{
 		// Copy the texture into place.
 		const s32 offsetX = paddingX / 2;
@@ -775,7 +861,7 @@ namespace TFE_Jedi
 		Vec3f halfTint = { 1.0f, 1.0f, 1.0f };
 		if (s_texturePacker->trueColor)
 		{
-			u32* output = (u32*)getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+			u32* output = (u32*)getWritePointer(page, rect->x, rect->y, 0);
 			if (isHdTex)
 			{
 				const u32* srcImageHd = (u32*)hdSrc->hdAssetData;
@@ -785,23 +871,20 @@ namespace TFE_Jedi
 			{
 				copy8BitToTrueColorTexture(texData, srcImage, paddingX, paddingY, offsetX, offsetY, output, halfTint);
 			}
-			generateTrueColorMips(node, texData, scaleFactor, paddingX, paddingY, mipCount, output);
 		}
 		else
 		{
-			u8* output = getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+			u8* output = getWritePointer(page, rect->x, rect->y, 0);
 			copy8BitTo8BitTexture(texData, srcImage, output);
 		}
-		s_usedTexels += texData->width * texData->height;
-
 		// Copy the mapping into the texture table.
-		tableEntry->x = (s32)node->rect.x + offsetX;
-		tableEntry->y = (s32)node->rect.y + offsetY;
+		tableEntry->x = (s32)rect->x + offsetX;
+		tableEntry->y = (s32)rect->y + offsetY;
 		tableEntry->z = (s32)texData->width  * scaleFactor;
 		tableEntry->w = (s32)texData->height * scaleFactor;
 
 		// Page the page index into the x offset.
-		tableEntry->x |= (s_currentPage << 12);
+		tableEntry->x |= (page << 12);
 		tableEntry->y |= (scaleFactor << 12);
 
 		// Half color tint packed.
@@ -812,7 +895,7 @@ namespace TFE_Jedi
 		tableEntry->w |= (b << 15);
 	}
 
-	void packNodeDeltaTex(const TextureNode* node, const TextureData* texData, Vec4i* tableEntry, s32 paddingX, s32 paddingY)
+	void packNodeDeltaTex(const Vec4ui* rect, s32 page, const TextureData* texData, Vec4i* tableEntry, s32 paddingX, s32 paddingY)
 	{
 		// Copy the texture into place.
 		s32 offsetX = paddingX / 2;
@@ -822,7 +905,7 @@ namespace TFE_Jedi
 		{
 			const u32* pal = getPalette(texData->palIndex);
 
-			u32* output = (u32*)getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+			u32* output = (u32*)getWritePointer(page, rect->x, rect->y, 0);
 			for (s32 y = 0; y < texData->height + paddingY; y++, output += s_texturePacker->width)
 			{
 				const s32 ySrc = y - offsetY;
@@ -839,7 +922,7 @@ namespace TFE_Jedi
 		}
 		else
 		{
-			u8* output = getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+			u8* output = getWritePointer(page, rect->x, rect->y, 0);
 			for (s32 y = 0; y < texData->height; y++, output += s_texturePacker->width)
 			{
 				for (s32 x = 0; x < texData->width; x++)
@@ -848,21 +931,19 @@ namespace TFE_Jedi
 				}
 			}
 		}
-		s_usedTexels += texData->width * texData->height;
-
 		// Copy the mapping into the texture table.
-		tableEntry->x = (s32)node->rect.x + offsetX;
-		tableEntry->y = (s32)node->rect.y + offsetY;
+		tableEntry->x = (s32)rect->x + offsetX;
+		tableEntry->y = (s32)rect->y + offsetY;
 		tableEntry->z = (s32)texData->width;
 		tableEntry->w = (s32)texData->height;
 
 		// Page the page index into the x offset.
 		s32 scaleFactor = 1;
-		tableEntry->x |= (s_currentPage << 12);
+		tableEntry->x |= (page << 12);
 		tableEntry->y |= (scaleFactor << 12);
 	}
 		
-	void packNodeCell(const TextureNode* node, const void* basePtr, const WaxCell* cell, const HdWax* hdWax, Vec4i* tableEntry, s32 paddingX, s32 paddingY)
+	void packNodeCell(const Vec4ui* rect, s32 page, const void* basePtr, const WaxCell* cell, const HdWax* hdWax, Vec4i* tableEntry, s32 paddingX, s32 paddingY)
 	{
 		// Copy the texture into place.
 		s32 offsetX = paddingX / 2;
@@ -883,7 +964,7 @@ namespace TFE_Jedi
 			const u32* pal = getPalette(PALETTE_DEFAULT_IDX);
 			const u8* remap = &TFE_DarkForces::s_levelColorMap[31 << 8];
 
-			u32* output = (u32*)getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+			u32* output = (u32*)getWritePointer(page, rect->x, rect->y, 0);
 
 			for (s32 x = 0; x < w + paddingX; x++)
 			{
@@ -938,7 +1019,7 @@ namespace TFE_Jedi
 		}
 		else
 		{
-			u8* output = getWritePointer(s_currentPage, node->rect.x, node->rect.y, 0);
+			u8* output = getWritePointer(page, rect->x, rect->y, 0);
 			for (s32 x = 0; x < w; x++)
 			{
 				u8* column = (u8*)image + columnOffset[x];
@@ -955,16 +1036,14 @@ namespace TFE_Jedi
 				}
 			}
 		}
-		s_usedTexels += w * h;
-
 		// Copy the mapping into the texture table.
-		tableEntry->x = (s32)node->rect.x + offsetX;
-		tableEntry->y = (s32)node->rect.y + offsetY;
+		tableEntry->x = (s32)rect->x + offsetX;
+		tableEntry->y = (s32)rect->y + offsetY;
 		tableEntry->z = (s32)w;
 		tableEntry->w = (s32)h;
 
 		// Page the page index into the x offset.
-		tableEntry->x |= (s_currentPage << 12);
+		tableEntry->x |= (page << 12);
 		tableEntry->y |= (scaleFactor << 12);
 	}
 
@@ -1039,6 +1118,45 @@ namespace TFE_Jedi
 		}
 	}
 
+	// Finds room for the texture on the current page and returns its rectangle.
+	// When replaying a cached layout, the recorded placement is used instead of searching the tree.
+	bool placeTexture(void* tex, u32 width, u32 height, Vec4ui* rect)
+	{
+		if (s_packReplay)
+		{
+			// A placement that does not match the request means the cache does not belong to this texture set,
+			// the replay is then abandoned and the layout computed from scratch.
+			if (s_packReplayFailed || s_packReplayIndex >= s_packPlacements.size())
+			{
+				s_packReplayFailed = true;
+				return false;
+			}
+			const PackPlacement* placement = &s_packPlacements[s_packReplayIndex++];
+			if (placement->page < 0) { return false; }
+			if (placement->page != s_currentPage || placement->rect.z != width || placement->rect.w != height)
+			{
+				s_packReplayFailed = true;
+				return false;
+			}
+			*rect = placement->rect;
+			return true;
+		}
+
+		TextureNode* node = insertNode(s_root, tex, width, height);
+		PackPlacement placement = { -1 };
+		if (node)
+		{
+			placement.page = s_currentPage;
+			placement.rect = node->rect;
+		}
+		s_packPlacements.push_back(placement);
+		if (!node) { return false; }
+
+		assert(node->tex == tex);
+		*rect = node->rect;
+		return true;
+	}
+
 	bool insertTexture(TextureData* tex, bool packHdTextures, TextureData* baseFrame, s32 frameIndex)
 	{
 		if (!tex || isTextureInMap(tex)) { return true; }
@@ -1050,18 +1168,32 @@ namespace TFE_Jedi
 		s32 paddingX, paddingY;
 		getTexturePadding(paddingX, paddingY, scale, tex);
 
-		TextureNode* node = insertNode(s_root, tex, w + paddingX, h + paddingY);
-		if (!node)
+		Vec4ui rect;
+		if (!placeTexture(tex, w + paddingX, h + paddingY, &rect))
 		{
 			return false;
 		}
 
 		s_totalTexels += w * h;
+		s_usedTexels += tex->width * tex->height;
 		insertTextureIntoMap(tex, s_texturePacker->texturesPacked);
 
-		assert(node->tex == tex && s_texturePacker->texturesPacked < MAX_TEXTURE_COUNT);
+		assert(s_texturePacker->texturesPacked < MAX_TEXTURE_COUNT);
 		tex->textureId = s_texturePacker->texturesPacked;
-		packNode(node, tex, &s_texturePacker->textureTable[s_texturePacker->texturesPacked], paddingX, paddingY, (tex->flags & ENABLE_MIP_MAPS) ? s_texturePacker->mipCount : 1, packHdTextures ? baseFrame : nullptr, frameIndex);
+
+		PackJob job;
+		job.type = PACK_JOB_TEXTURE;
+		job.rect = rect;
+		job.page = s_currentPage;
+		job.tableIndex = s_texturePacker->texturesPacked;
+		job.texData = tex;
+		job.hdSrc = packHdTextures ? baseFrame : nullptr;
+		job.frameIndex = frameIndex;
+		job.paddingX = paddingX;
+		job.paddingY = paddingY;
+		job.mipCount = (tex->flags & ENABLE_MIP_MAPS) ? s_texturePacker->mipCount : 1;
+		s_packJobs.push_back(job);
+
 		s_texturePacker->texturesPacked++;
 		return true;
 	}
@@ -1070,18 +1202,29 @@ namespace TFE_Jedi
 	{
 		if (!tex || isTextureInMap(tex)) { return true; }
 		s32 padding = (s_texturePacker->trueColor) ? FILTER_PADDING : 0;
-		TextureNode* node = insertNode(s_root, tex, tex->width + padding, tex->height + padding);
-		if (!node)
+		Vec4ui rect;
+		if (!placeTexture(tex, tex->width + padding, tex->height + padding, &rect))
 		{
 			return false;
 		}
 
 		s_totalTexels += tex->width * tex->height;
+		s_usedTexels += tex->width * tex->height;
 		insertTextureIntoMap(tex, s_texturePacker->texturesPacked);
 
-		assert(node->tex == tex && s_texturePacker->texturesPacked < MAX_TEXTURE_COUNT);
+		assert(s_texturePacker->texturesPacked < MAX_TEXTURE_COUNT);
 		tex->textureId = s_texturePacker->texturesPacked;
-		packNodeDeltaTex(node, tex, &s_texturePacker->textureTable[s_texturePacker->texturesPacked], padding, padding);
+
+		PackJob job;
+		job.type = PACK_JOB_DELT_TEX;
+		job.rect = rect;
+		job.page = s_currentPage;
+		job.tableIndex = s_texturePacker->texturesPacked;
+		job.texData = tex;
+		job.paddingX = padding;
+		job.paddingY = padding;
+		s_packJobs.push_back(job);
+
 		s_texturePacker->texturesPacked++;
 		return true;
 	}
@@ -1098,18 +1241,31 @@ namespace TFE_Jedi
 		const s32 h = cell->sizeY * scale;
 		
 		s32 padding = (s_texturePacker->trueColor) ? FILTER_PADDING : 0;
-		TextureNode* node = insertNode(s_root, cell, w + padding, h + padding);
-		if (!node)
+		Vec4ui rect;
+		if (!placeTexture(cell, w + padding, h + padding, &rect))
 		{
 			return false;
 		}
 
 		s_totalTexels += w * h;
+		s_usedTexels += w * h;
 		insertWaxCellIntoMap(cell, s_texturePacker->texturesPacked);
 
-		assert(node->tex == cell && s_texturePacker->texturesPacked < MAX_TEXTURE_COUNT);
+		assert(s_texturePacker->texturesPacked < MAX_TEXTURE_COUNT);
 		cell->textureId = s_texturePacker->texturesPacked;
-		packNodeCell(node, basePtr, cell, hdWax, &s_texturePacker->textureTable[s_texturePacker->texturesPacked], padding, padding);
+
+		PackJob job;
+		job.type = PACK_JOB_WAX_CELL;
+		job.rect = rect;
+		job.page = s_currentPage;
+		job.tableIndex = s_texturePacker->texturesPacked;
+		job.basePtr = basePtr;
+		job.cell = cell;
+		job.hdWax = hdWax;
+		job.paddingX = padding;
+		job.paddingY = padding;
+		s_packJobs.push_back(job);
+
 		s_texturePacker->texturesPacked++;
 		return true;
 	}
@@ -1126,7 +1282,394 @@ namespace TFE_Jedi
 		}
 		return true;
 	}
-		
+
+	/////////////////////////////////////////////
+	// Pack jobs
+	// The layout is computed on the main thread,
+	// the texels are copied and converted to the
+	// page format on worker threads afterward.
+	/////////////////////////////////////////////
+	void runPackJob(const PackJob* job)
+	{
+		Vec4i* tableEntry = &s_texturePacker->textureTable[job->tableIndex];
+		switch (job->type)
+		{
+			case PACK_JOB_TEXTURE:
+			{
+				packNode(&job->rect, job->page, job->texData, tableEntry, job->paddingX, job->paddingY, job->hdSrc, job->frameIndex);
+			} break;
+			case PACK_JOB_DELT_TEX:
+			{
+				packNodeDeltaTex(&job->rect, job->page, job->texData, tableEntry, job->paddingX, job->paddingY);
+			} break;
+			case PACK_JOB_WAX_CELL:
+			{
+				packNodeCell(&job->rect, job->page, job->basePtr, job->cell, job->hdWax, tableEntry, job->paddingX, job->paddingY);
+			} break;
+		}
+	}
+
+	// Node rectangles do not overlap, so the jobs can be run in any order.
+	void runPackJobs()
+	{
+		const s32 count = s32(s_packJobs.size());
+		while (1)
+		{
+			const s32 index = s_nextPackJob.fetch_add(1);
+			if (index >= count) { break; }
+			runPackJob(&s_packJobs[index]);
+		}
+	}
+
+	// Each texture's mips only read and write its own footprint at each level, since
+	// (x >> 1) + (w >> 1) <= (x + w) >> 1, and level 0 is complete before any mips are
+	// built - so the result does not depend on the order. Whole pages are handed out
+	// so each thread writes to a single page.
+	void runMipJobs()
+	{
+		const s32 pageCount = s32(s_mipPages.size());
+		const s32 jobCount = s32(s_packJobs.size());
+		while (1)
+		{
+			const s32 index = s_nextMipPage.fetch_add(1);
+			if (index >= pageCount) { break; }
+
+			const s32 page = s_mipPages[index];
+			const PackJob* job = s_packJobs.data();
+			for (s32 i = 0; i < jobCount; i++, job++)
+			{
+				if (job->page != page || job->type != PACK_JOB_TEXTURE || job->mipCount <= 1) { continue; }
+
+				const s32 scaleFactor = (job->hdSrc && job->hdSrc->hdAssetData) ? job->hdSrc->scaleFactor : 1;
+				generateTrueColorMips(&job->rect, page, job->texData, scaleFactor, job->paddingX, job->paddingY, job->mipCount);
+			}
+		}
+	}
+
+	int packWorkerFunc(void* userData)
+	{
+		runPackJobs();
+		return 0;
+	}
+
+	int mipWorkerFunc(void* userData)
+	{
+		runMipJobs();
+		return 0;
+	}
+
+	// Runs the work on the main thread and up to PACK_MAX_THREADS - 1 worker threads, returns the number of threads used.
+	s32 runOnWorkers(SDL_ThreadFunction workerFunc, void(*work)(), s32 workCount)
+	{
+		const s32 threadCount = clamp(min(SDL_GetCPUCount(), workCount), 1, (s32)PACK_MAX_THREADS);
+		SDL_Thread* workers[PACK_MAX_THREADS];
+		s32 workerCount = 0;
+		for (s32 t = 1; t < threadCount; t++)
+		{
+			workers[workerCount] = SDL_CreateThread(workerFunc, "TFE_TexturePacker", nullptr);
+			if (workers[workerCount]) { workerCount++; }
+		}
+		work();
+		for (s32 t = 0; t < workerCount; t++)
+		{
+			SDL_WaitThread(workers[t], nullptr);
+		}
+		return workerCount + 1;
+	}
+
+	/////////////////////////////////////////////
+	// Packing cache
+	// The layout only depends on the size of each
+	// texture and the packing order, so it is stored
+	// on disk keyed by a hash of those and of the
+	// starting page state. A cache hit skips the tree
+	// search and only rebuilds the final trees, so
+	// later pack calls continue from the same state.
+	/////////////////////////////////////////////
+	void getPackCacheName(u64 key, char* name)
+	{
+		snprintf(name, TFE_MAX_PATH, "%s_%016llx.tpc", s_texturePacker->name, (unsigned long long)key);
+	}
+
+	void writeNodeTree(const TextureNode* node, std::vector<PackCacheNode>& nodes)
+	{
+		PackCacheNode cacheNode = {};
+		if (!node)
+		{
+			cacheNode.flags = PACK_NODE_EMPTY;
+			nodes.push_back(cacheNode);
+			return;
+		}
+
+		cacheNode.rect = node->rect;
+		cacheNode.flags = (node->child[0] ? PACK_NODE_SPLIT : 0) | (node->tex ? PACK_NODE_FULL : 0);
+		nodes.push_back(cacheNode);
+		if (node->child[0])
+		{
+			writeNodeTree(node->child[0], nodes);
+			writeNodeTree(node->child[1], nodes);
+		}
+	}
+
+	TextureNode* readNodeTree(const PackCacheNode*& node, const PackCacheNode* end)
+	{
+		if (node >= end) { return nullptr; }
+		const PackCacheNode* cacheNode = node++;
+		if (cacheNode->flags & PACK_NODE_EMPTY) { return nullptr; }
+
+		TextureNode* newNode = allocateNode();
+		newNode->rect = cacheNode->rect;
+		// Only the fact that the node is used matters for later insertions.
+		newNode->tex = (cacheNode->flags & PACK_NODE_FULL) ? &s_cachedNodeTex : nullptr;
+		if (cacheNode->flags & PACK_NODE_SPLIT)
+		{
+			newNode->child[0] = readNodeTree(node, end);
+			newNode->child[1] = readNodeTree(node, end);
+		}
+		return newNode;
+	}
+
+	// Entries are identified by the order they are first seen, which is stable across runs unlike their addresses.
+	// Entries that are already packed or missing are skipped by the packer, but still change its flow.
+	u64 hashPackEntry(u64 hash, const void* ptr, bool inMap, s32 width, s32 height, std::map<const void*, u32>& entryIds)
+	{
+		u32 entry[3] = { PACK_ENTRY_MISSING, u32(width), u32(height) };
+		if (ptr && inMap)
+		{
+			entry[0] = PACK_ENTRY_PACKED;
+		}
+		else if (ptr)
+		{
+			std::map<const void*, u32>::iterator iEntry = entryIds.find(ptr);
+			if (iEntry == entryIds.end())
+			{
+				entry[0] = u32(entryIds.size());
+				entryIds[ptr] = entry[0];
+			}
+			else
+			{
+				entry[0] = iEntry->second;
+			}
+		}
+		return TFE_Hash::hash64(hash, entry, sizeof(entry));
+	}
+
+	u64 hashTextureEntry(u64 hash, TextureData* tex, bool packHdTextures, TextureData* baseFrame, std::map<const void*, u32>& entryIds)
+	{
+		if (!tex) { return hashPackEntry(hash, nullptr, false, 0, 0, entryIds); }
+
+		const s32 scale = packHdTextures ? baseFrame->scaleFactor : 1;
+		s32 paddingX, paddingY;
+		getTexturePadding(paddingX, paddingY, scale, tex);
+		return hashPackEntry(hash, tex, isTextureInMap(tex), tex->width * scale + paddingX, tex->height * scale + paddingY, entryIds);
+	}
+
+	u64 hashAnimatedTextureEntry(u64 hash, AnimatedTexture* animTex, bool packHdTextures, std::map<const void*, u32>& entryIds)
+	{
+		if (!animTex) { return hashPackEntry(hash, nullptr, false, 0, 0, entryIds); }
+		for (s32 f = 0; f < animTex->count; f++)
+		{
+			hash = hashTextureEntry(hash, animTex->frameList[f], packHdTextures, animTex->baseFrame, entryIds);
+		}
+		return hash;
+	}
+
+	u64 computePackKey(const TextureInfo* list, s32 count, bool packHdTextures, bool packHdSprites)
+	{
+		u64 key = TFE_Hash::c_fnv64Offset;
+		const s32 params[] =
+		{
+			PACK_CACHE_VERSION, s_texturePacker->width, s_texturePacker->height, s_texturePacker->trueColor ? 1 : 0,
+			s32(s_texturePacker->mipCount), s32(s_texturePacker->mipPadding), s_texturePacker->reservedPages,
+			s_texturePacker->pageCount, packHdTextures ? 1 : 0, packHdSprites ? 1 : 0, count
+		};
+		key = TFE_Hash::hash64(key, params, sizeof(params));
+
+		// The state of the pages that packing starts from.
+		s_packNodes.clear();
+		for (s32 p = s_texturePacker->reservedPages; p < s_texturePacker->pageCount; p++)
+		{
+			writeNodeTree(s_texturePacker->pages[p]->root, s_packNodes);
+		}
+		key = TFE_Hash::hash64(key, s_packNodes.data(), s_packNodes.size() * sizeof(PackCacheNode));
+
+		// The size of everything that will be inserted, in packing order.
+		std::map<const void*, u32> entryIds;
+		for (s32 i = 0; i < count; i++)
+		{
+			const TextureInfo* info = &list[i];
+			const u32 type = u32(info->type);
+			key = TFE_Hash::hash64(key, &type, sizeof(type));
+			switch (info->type)
+			{
+				case TEXINFO_DF_TEXTURE_DATA:
+				{
+					if (info->texData->uvWidth == BM_ANIMATED_TEXTURE)
+					{
+						key = hashAnimatedTextureEntry(key, (AnimatedTexture*)info->texData->image, packHdTextures, entryIds);
+					}
+					else
+					{
+						key = hashTextureEntry(key, info->texData, packHdTextures, info->texData, entryIds);
+					}
+				} break;
+				case TEXINFO_DF_DELT_TEX:
+				{
+					const s32 padding = (s_texturePacker->trueColor) ? FILTER_PADDING : 0;
+					TextureData* tex = info->texData;
+					key = tex ? hashPackEntry(key, tex, isTextureInMap(tex), tex->width + padding, tex->height + padding, entryIds) :
+						hashPackEntry(key, nullptr, false, 0, 0, entryIds);
+				} break;
+				case TEXINFO_DF_ANIM_TEX:
+				{
+					key = hashAnimatedTextureEntry(key, info->animTex, packHdTextures, entryIds);
+				} break;
+				case TEXINFO_DF_WAX_CELL:
+				{
+					WaxCell* cell = (info->basePtr && info->frame) ? WAX_CellPtr(info->basePtr, info->frame) : nullptr;
+					if (!cell)
+					{
+						key = hashPackEntry(key, nullptr, false, 0, 0, entryIds);
+						break;
+					}
+					const HdWax* hdWax = packHdSprites ? TFE_Sprite_Jedi::getHdWaxData(info->basePtr) : nullptr;
+					const s32 scale = hdWax ? 2 : 1;
+					const s32 padding = (s_texturePacker->trueColor) ? FILTER_PADDING : 0;
+					key = hashPackEntry(key, cell, isWaxCellInMap(cell), cell->sizeX * scale + padding, cell->sizeY * scale + padding, entryIds);
+				} break;
+			}
+		}
+		return key;
+	}
+
+	bool packRectInPage(const Vec4ui& rect)
+	{
+		return rect.z > 0 && rect.w > 0 && u64(rect.x) + u64(rect.z) <= u64(s_texturePacker->width) &&
+			u64(rect.y) + u64(rect.w) <= u64(s_texturePacker->height);
+	}
+
+	bool packRectInRect(const Vec4ui& rect, const Vec4ui& parent)
+	{
+		return rect.x >= parent.x && rect.y >= parent.y && u64(rect.x) + u64(rect.z) <= u64(parent.x) + u64(parent.z) &&
+			u64(rect.y) + u64(rect.w) <= u64(parent.y) + u64(parent.w) && (rect.z < parent.z || rect.w < parent.w);
+	}
+
+	// Children must be strictly inside their parent, which also bounds the depth of the tree.
+	bool validateNodeTree(const PackCacheNode*& node, const PackCacheNode* end, const Vec4ui* parent)
+	{
+		if (node >= end) { return false; }
+		const PackCacheNode* cacheNode = node++;
+		if (cacheNode->flags & PACK_NODE_EMPTY) { return !parent; }
+		if (!packRectInPage(cacheNode->rect) || (parent && !packRectInRect(cacheNode->rect, *parent))) { return false; }
+		if (cacheNode->flags & PACK_NODE_SPLIT)
+		{
+			return validateNodeTree(node, end, &cacheNode->rect) && validateNodeTree(node, end, &cacheNode->rect);
+		}
+		return true;
+	}
+
+	// Make sure the cached placements and trees fit in the pages, so a corrupt cache cannot cause writes outside of page memory.
+	bool validatePackCache(s32 firstPage, s32 pageCount)
+	{
+		const size_t placementCount = s_packPlacements.size();
+		const PackPlacement* placement = s_packPlacements.data();
+		for (size_t i = 0; i < placementCount; i++, placement++)
+		{
+			if (placement->page == -1) { continue; }
+			if (placement->page < firstPage || placement->page >= pageCount || !packRectInPage(placement->rect))
+			{
+				return false;
+			}
+		}
+
+		// Each page from firstPage on has exactly one tree.
+		const PackCacheNode* node = s_packNodes.data();
+		const PackCacheNode* end = node + s_packNodes.size();
+		for (s32 p = firstPage; p < pageCount; p++)
+		{
+			if (!validateNodeTree(node, end, nullptr)) { return false; }
+		}
+		return node == end;
+	}
+
+	bool readPackCache(u64 key)
+	{
+		char cacheName[TFE_MAX_PATH];
+		getPackCacheName(key, cacheName);
+
+		std::vector<u8> data;
+		if (!TFE_CacheFile::read("TexturePackCache/", cacheName, PACK_CACHE_MAGIC, PACK_CACHE_VERSION, key, data))
+		{
+			return false;
+		}
+		PackCacheHeader header = {};
+		if (data.size() >= sizeof(PackCacheHeader))
+		{
+			memcpy(&header, data.data(), sizeof(PackCacheHeader));
+		}
+		const size_t expectedSize = sizeof(PackCacheHeader) + header.placementCount * sizeof(PackPlacement) + header.nodeCount * sizeof(PackCacheNode);
+		if (data.size() != expectedSize || header.firstPage != s_texturePacker->reservedPages || header.pageCount < header.firstPage || header.pageCount > MAX_TEXTURE_PAGES)
+		{
+			TFE_System::logWrite(LOG_WARNING, "TexturePacker", "Ignoring invalid texture packing cache '%s'.", cacheName);
+			return false;
+		}
+
+		const u8* placements = data.data() + sizeof(PackCacheHeader);
+		const u8* nodes = placements + header.placementCount * sizeof(PackPlacement);
+		s_packPlacements.resize(header.placementCount);
+		s_packNodes.resize(header.nodeCount);
+		memcpy(s_packPlacements.data(), placements, header.placementCount * sizeof(PackPlacement));
+		memcpy(s_packNodes.data(), nodes, header.nodeCount * sizeof(PackCacheNode));
+
+		if (!validatePackCache(header.firstPage, header.pageCount))
+		{
+			TFE_System::logWrite(LOG_WARNING, "TexturePacker", "Ignoring corrupt texture packing cache '%s'.", cacheName);
+			s_packPlacements.clear();
+			s_packNodes.clear();
+			return false;
+		}
+		s_packCachePageCount = header.pageCount;
+		return true;
+	}
+
+	void writePackCache(u64 key, s32 firstPage)
+	{
+		s_packNodes.clear();
+		for (s32 p = firstPage; p < s_texturePacker->pageCount; p++)
+		{
+			writeNodeTree(s_texturePacker->pages[p]->root, s_packNodes);
+		}
+
+		PackCacheHeader header = {};
+		header.placementCount = u32(s_packPlacements.size());
+		header.nodeCount = u32(s_packNodes.size());
+		header.firstPage = firstPage;
+		header.pageCount = s_texturePacker->pageCount;
+
+		std::vector<u8> data;
+		const u8* headerBytes = (const u8*)&header;
+		const u8* placements = (const u8*)s_packPlacements.data();
+		const u8* nodes = (const u8*)s_packNodes.data();
+		data.insert(data.end(), headerBytes, headerBytes + sizeof(PackCacheHeader));
+		data.insert(data.end(), placements, placements + header.placementCount * sizeof(PackPlacement));
+		data.insert(data.end(), nodes, nodes + header.nodeCount * sizeof(PackCacheNode));
+
+		char cacheName[TFE_MAX_PATH];
+		getPackCacheName(key, cacheName);
+		TFE_CacheFile::write("TexturePackCache/", cacheName, PACK_CACHE_MAGIC, PACK_CACHE_VERSION, key, data.data(), data.size(), PACK_CACHE_MAX_FILES);
+	}
+
+	// Replace the page trees with the final trees stored in the cache.
+	void restorePackCacheTrees(s32 firstPage)
+	{
+		const PackCacheNode* node = s_packNodes.data();
+		const PackCacheNode* end = node + s_packNodes.size();
+		for (s32 p = firstPage; p < s_texturePacker->pageCount; p++)
+		{
+			s_texturePacker->pages[p]->root = readNodeTree(node, end);
+		}
+	}
+
 	s32 textureSort(const void* a, const void* b)
 	{
 		const TextureInfo* texA = (TextureInfo*)a;
@@ -1258,6 +1801,153 @@ namespace TFE_Jedi
 		#endif
 	}
 		
+	void insertTextureList(TextureInfo* list, s32 count, bool packHdTextures, bool packHdSprites)
+	{
+		// Put all textures into the unpacked list.
+		s_unpackedTextures[0].resize(count);
+		TextureInfo** unpackedList = s_unpackedTextures[0].data();
+		for (s32 i = 0; i < count; i++)
+		{
+			unpackedList[i] = &list[i];
+		}
+
+		// Insert each texture into the tree, adding pages as needed.
+		s_currentPage = s_texturePacker->reservedPages;
+		if (s_currentPage >= s_texturePacker->pageCount)
+		{
+			s_texturePacker->pages[s_texturePacker->pageCount] = allocateTexturePage(s_texturePacker->pageSize);
+			s_texturePacker->pageCount++;
+
+			s_root = nullptr;
+			insertNode(nullptr, nullptr, 0, 0);
+			s_texturePacker->pages[s_currentPage]->root = s_root;
+		}
+		else
+		{
+			s_root = s_texturePacker->pages[s_currentPage]->root;
+			if (!s_root)
+			{
+				insertNode(nullptr, nullptr, 0, 0);
+				s_texturePacker->pages[s_currentPage]->root = s_root;
+			}
+		}
+
+		s_unpackedBuffer = 0;
+		while (!s_unpackedTextures[s_unpackedBuffer].empty() && !s_packReplayFailed)
+		{
+			count = (s32)s_unpackedTextures[s_unpackedBuffer].size();
+			unpackedList = s_unpackedTextures[s_unpackedBuffer].data();
+
+			s_unpackedBuffer = (s_unpackedBuffer + 1)&1;
+			s_unpackedTextures[s_unpackedBuffer].clear();
+
+			for (s32 i = 0; i < count; i++)
+			{
+				switch (unpackedList[i]->type)
+				{
+					case TEXINFO_DF_TEXTURE_DATA:
+					{
+						if (unpackedList[i]->texData->uvWidth == BM_ANIMATED_TEXTURE)
+						{
+							AnimatedTexture* animTex = (AnimatedTexture*)unpackedList[i]->texData->image;
+							if (!insertAnimatedTextureFrames(animTex, packHdTextures))
+							{
+								s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
+							}
+						}
+						else
+						{
+							if (!insertTexture(unpackedList[i]->texData, packHdTextures, unpackedList[i]->texData, 0))
+							{
+								s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
+							}
+						}
+					} break;
+					case TEXINFO_DF_DELT_TEX:
+					{
+						if (!insertDeltTexture(unpackedList[i]->texData))
+						{
+							s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
+						}
+					} break;
+					case TEXINFO_DF_ANIM_TEX:
+					{
+						if (!insertAnimatedTextureFrames(unpackedList[i]->animTex, packHdTextures))
+						{
+							s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
+						}
+					} break;
+					case TEXINFO_DF_WAX_CELL:
+					{
+						if (!insertWaxFrame(unpackedList[i]->basePtr, unpackedList[i]->frame, packHdSprites))
+						{
+							s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
+						}
+					} break;
+				}
+			}
+
+			// Allocate another page...
+			if (!s_unpackedTextures[s_unpackedBuffer].empty() && !s_packReplayFailed)
+			{
+				if (s_currentPage + 1 >= MAX_TEXTURE_PAGES)
+				{
+					TFE_System::logWrite(LOG_ERROR, "TexturePacker", "Out of texture pages, %d textures were not packed.", (s32)s_unpackedTextures[s_unpackedBuffer].size());
+					s_unpackedTextures[s_unpackedBuffer].clear();
+					break;
+				}
+				s_currentPage++;
+				if (s_currentPage >= s_texturePacker->pageCount)
+				{
+					s_texturePacker->pages[s_texturePacker->pageCount] = allocateTexturePage(s_texturePacker->pageSize);
+					s_texturePacker->pageCount++;
+
+					s_root = nullptr;
+					insertNode(nullptr, nullptr, 0, 0);
+					s_texturePacker->pages[s_currentPage]->root = s_root;
+				}
+				else
+				{
+					s_root = s_texturePacker->pages[s_currentPage]->root;
+					if (!s_root)
+					{
+						insertNode(nullptr, nullptr, 0, 0);
+						s_texturePacker->pages[s_currentPage]->root = s_root;
+					}
+				}
+			}
+		}
+	}
+
+	// Undo the insertions of an abandoned cache replay, so the textures can be packed again.
+	void discardPackedTextures(s32 texturesPackedStart, s32 pageCountStart)
+	{
+		const size_t jobCount = s_packJobs.size();
+		const PackJob* job = s_packJobs.data();
+		for (size_t i = 0; i < jobCount; i++, job++)
+		{
+			if (job->type == PACK_JOB_WAX_CELL)
+			{
+				s_waxDataMap.erase((WaxCell*)job->cell);
+			}
+			else
+			{
+				s_textureDataMap.erase(job->texData);
+			}
+		}
+		s_packJobs.clear();
+		s_texturePacker->texturesPacked = texturesPackedStart;
+
+		// Replaying does not change the existing trees, so only the new pages need to be removed.
+		for (s32 p = pageCountStart; p < s_texturePacker->pageCount; p++)
+		{
+			free(s_texturePacker->pages[p]->backingMemory);
+			free(s_texturePacker->pages[p]);
+			s_texturePacker->pages[p] = nullptr;
+		}
+		s_texturePacker->pageCount = pageCountStart;
+	}
+
 	s32 texturepacker_pack(TextureListCallback getList, AssetPool pool)
 	{
 		if (!getList) { return 0; }
@@ -1268,6 +1958,8 @@ namespace TFE_Jedi
 
 		// Get textures.
 		s_texInfoPool.clear();
+		s_packJobs.clear();
+		s_packPlacements.clear();
 		if (getList(s_texInfoPool, pool))
 		{
 			s32 count = (s32)s_texInfoPool.size();
@@ -1327,114 +2019,63 @@ namespace TFE_Jedi
 			// 2. Sort textures by perimeter from largest to smallest - simplified to w+h
 			std::qsort(list, size_t(count), sizeof(TextureInfo), textureSort);
 
-			// 3. Put all textures into the unpacked list.
-			s_unpackedTextures[0].resize(count);
-			TextureInfo** unpackedList = s_unpackedTextures[0].data();
-			for (s32 i = 0; i < count; i++)
+			// 3. Look for a cached layout of the same texture set.
+			u64 phaseStart = TFE_System::getCurrentTimeInTicks();
+			const s32 firstPage = s_texturePacker->reservedPages;
+			const s32 texturesPackedStart = s_texturePacker->texturesPacked;
+			const u64 key = computePackKey(list, count, packHdTextures, packHdSprites);
+			s_packReplay = readPackCache(key);
+			s_packReplayIndex = 0;
+
+			// 4. Insert each texture into the pages.
+			const s32 pageCountStart = s_texturePacker->pageCount;
+			const s32 usedTexelsStart = s_usedTexels;
+			const s32 totalTexelsStart = s_totalTexels;
+			s_packReplayFailed = false;
+			insertTextureList(list, count, packHdTextures, packHdSprites);
+			if (s_packReplay && (s_packReplayFailed || s_packReplayIndex != s_packPlacements.size() || s_texturePacker->pageCount != s_packCachePageCount))
 			{
-				unpackedList[i] = &list[i];
+				TFE_System::logWrite(LOG_WARNING, "TexturePacker", "The cached texture layout does not match the texture set, discarding it.");
+				discardPackedTextures(texturesPackedStart, pageCountStart);
+				s_usedTexels = usedTexelsStart;
+				s_totalTexels = totalTexelsStart;
+				s_packReplay = false;
+				s_packReplayFailed = false;
+				s_packPlacements.clear();
+				insertTextureList(list, count, packHdTextures, packHdSprites);
 			}
 
-			// 4. Insert each texture into the tree, adding pages as needed.
-			s_currentPage = s_texturePacker->reservedPages;
-			if (s_currentPage >= s_texturePacker->pageCount)
+			const bool layoutCached = s_packReplay;
+			if (s_packReplay)
 			{
-				s_texturePacker->pages[s_texturePacker->pageCount] = allocateTexturePage(s_texturePacker->pageSize);
-				s_texturePacker->pageCount++;
-
-				s_root = nullptr;
-				insertNode(nullptr, nullptr, 0, 0);
-				s_texturePacker->pages[s_currentPage]->root = s_root;
+				restorePackCacheTrees(firstPage);
+				s_packReplay = false;
 			}
 			else
 			{
-				s_root = s_texturePacker->pages[s_currentPage]->root;
-				if (!s_root)
-				{
-					insertNode(nullptr, nullptr, 0, 0);
-					s_texturePacker->pages[s_currentPage]->root = s_root;
-				}
+				writePackCache(key, firstPage);
 			}
+			const f64 layoutTime = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - phaseStart);
 
-			s_unpackedBuffer = 0;
-			while (!s_unpackedTextures[s_unpackedBuffer].empty())
+			// 5. Copy the textures into the pages, converting to true color if needed, then generate the mipmaps.
+			phaseStart = TFE_System::getCurrentTimeInTicks();
+			s_nextPackJob = 0;
+			const s32 threadCount = runOnWorkers(packWorkerFunc, runPackJobs, (s32)s_packJobs.size());
+			if (s_texturePacker->trueColor && s_texturePacker->mipCount > 1)
 			{
-				count = (s32)s_unpackedTextures[s_unpackedBuffer].size();
-				TextureInfo** unpackedList = s_unpackedTextures[s_unpackedBuffer].data();
-
-				s_unpackedBuffer = (s_unpackedBuffer + 1)&1;
-				s_unpackedTextures[s_unpackedBuffer].clear();
-
-				for (s32 i = 0; i < count; i++)
-				{
-					switch (unpackedList[i]->type)
-					{
-						case TEXINFO_DF_TEXTURE_DATA:
-						{
-							if (unpackedList[i]->texData->uvWidth == BM_ANIMATED_TEXTURE)
-							{
-								AnimatedTexture* animTex = (AnimatedTexture*)unpackedList[i]->texData->image;
-								if (!insertAnimatedTextureFrames(animTex, packHdTextures))
-								{
-									s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
-								}
-							}
-							else
-							{
-								if (!insertTexture(unpackedList[i]->texData, packHdTextures, unpackedList[i]->texData, 0))
-								{
-									s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
-								}
-							}
-						} break;
-						case TEXINFO_DF_DELT_TEX:
-						{
-							if (!insertDeltTexture(unpackedList[i]->texData))
-							{
-								s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
-							}
-						} break;
-						case TEXINFO_DF_ANIM_TEX:
-						{
-							if (!insertAnimatedTextureFrames(unpackedList[i]->animTex, packHdTextures))
-							{
-								s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
-							}
-						} break;
-						case TEXINFO_DF_WAX_CELL:
-						{
-							if (!insertWaxFrame(unpackedList[i]->basePtr, unpackedList[i]->frame, packHdSprites))
-							{
-								s_unpackedTextures[s_unpackedBuffer].push_back(unpackedList[i]);
-							}
-						} break;
-					}
-				}
-
-				// Allocate another page...
-				if (!s_unpackedTextures[s_unpackedBuffer].empty())
+				s_mipPages.clear();
+				for (s32 p = firstPage; p < s_texturePacker->pageCount; p++)
 				{
-					s_currentPage++;
-					if (s_currentPage >= s_texturePacker->pageCount)
-					{
-						s_texturePacker->pages[s_texturePacker->pageCount] = allocateTexturePage(s_texturePacker->pageSize);
-						s_texturePacker->pageCount++;
-
-						s_root = nullptr;
-						insertNode(nullptr, nullptr, 0, 0);
-						s_texturePacker->pages[s_currentPage]->root = s_root;
-					}
-					else
-					{
-						s_root = s_texturePacker->pages[s_currentPage]->root;
-						if (!s_root)
-						{
-							insertNode(nullptr, nullptr, 0, 0);
-							s_texturePacker->pages[s_currentPage]->root = s_root;
-						}
-					}
+					s_mipPages.push_back(p);
 				}
+				s_nextMipPage = 0;
+				runOnWorkers(mipWorkerFunc, runMipJobs, (s32)s_mipPages.size());
 			}
+			const f64 copyTime = TFE_System::convertFromTicksToMillis(TFE_System::getCurrentTimeInTicks() - phaseStart);
+
+			TFE_System::logWrite(LOG_MSG, "TexturePacker", "Packed %d textures into %d pages, Layout: %.2f ms (%s), Copy: %.2f ms (%d threads).",
+				s_texturePacker->texturesPacked - texturesPackedStart, s_texturePacker->pageCount, layoutTime, layoutCached ? "cached" : "computed", copyTime, threadCount);
+			s_packJobs.clear();
 		}
 		return s_texturePacker->texturesPacked;
 	}
@@ -5,6 +5,8 @@
 #include <TFE_System/system.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <assert.h>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #define TRI3D_MAX_DRAW_COUNT 65536
@@ -15,25 +17,6 @@
 
 namespace TFE_RenderShared
 {
-	// Vertex Definition
-	struct Tri3dVertex
-	{
-		Vec3f pos;		// 2D position.
-		Vec2f uv;		// UV coordinates.
-		Vec2f uv1;
-		Vec2f uv2;
-		u32   color;	// color + opacity.
-	};
-	struct Tri3dDraw
-	{
-		TextureGpu* texture;
-		DrawMode mode;
-		u32 drawFlags;
-		s32 vtxOffset;
-		s32 idxOffset;
-		s32 vtxCount;
-		s32 idxCount;
-	};
 	static const AttributeMapping c_tri3dAttrMapping[]=
 	{
 		{ATTR_POS,   ATYPE_FLOAT, 3, 0, false},
@@ -72,6 +55,23 @@ namespace TFE_RenderShared
 
 	static DrawMode s_lastDrawMode = TRIMODE_COUNT;
 	static Grid s_gridDef = {};
+	static bool s_overflow = false;
+
+	// While capturing, the draw list above points at the capture buffers and the frame list is saved here.
+	struct Tri3dDrawList
+	{
+		Tri3dVertex* vertices;
+		s32* indices;
+		u32 vtxCount;
+		u32 idxCount;
+		Tri3dDraw* draws[TRIMODE_COUNT];
+		u32 drawCount[TRIMODE_COUNT];
+		u32 drawCapacity[TRIMODE_COUNT];
+		DrawMode lastDrawMode;
+	};
+	static Tri3dDrawList s_captureList = {};
+	static Tri3dDrawList s_savedList = {};
+	static bool s_capturing = false;
 
 	bool canMergeDraws(DrawMode mode, TextureGpu* texture, u32 drawFlags = TFLAG_NONE);
 	u32 setDrawFlags(bool showGrid, bool sky);
@@ -145,6 +145,14 @@ namespace TFE_RenderShared
 			free(s_triDraw[i]);
 			s_triDraw[i] = nullptr;
 		}
+
+		delete[] s_captureList.vertices;
+		delete[] s_captureList.indices;
+		for (s32 i = 0; i < TRIMODE_COUNT; i++)
+		{
+			free(s_captureList.draws[i]);
+		}
+		s_captureList = {};
 	}
 	
 	void triDraw3d_begin(const Grid* gridDef)
@@ -152,6 +160,7 @@ namespace TFE_RenderShared
 		s_idxCount = 0;
 		s_vtxCount = 0;
 		s_lastDrawMode = TRIMODE_COUNT;
+		s_overflow = false;
 		if (gridDef)
 		{
 			s_gridDef = *gridDef;
@@ -181,7 +190,11 @@ namespace TFE_RenderShared
 	{
 		if (s_triDrawCount[pass] >= s_triDrawCapacity[pass])
 		{
-			if (!triDraw3d_expand(pass)) { return nullptr; }
+			if (!triDraw3d_expand(pass))
+			{
+				s_overflow = true;
+				return nullptr;
+			}
 		}
 		Tri3dDraw* draw = &s_triDraw[pass][s_triDrawCount[pass]];
 		s_triDrawCount[pass]++;
@@ -214,6 +227,7 @@ namespace TFE_RenderShared
 		// Do we have enough room for the vertices and indices?
 		if (s_vtxCount + 4 > VTX3D_MAX || s_idxCount + 6 > IDX3D_MAX)
 		{
+			s_overflow = true;
 			return;
 		}
 
@@ -294,6 +308,7 @@ namespace TFE_RenderShared
 		// Do we have enough room for the vertices and indices?
 		if (s_vtxCount + vtxCount > VTX3D_MAX || s_idxCount + idxCount > IDX3D_MAX)
 		{
+			s_overflow = true;
 			return;
 		}
 
@@ -380,6 +395,7 @@ namespace TFE_RenderShared
 		// Do we have enough room for the vertices and indices?
 		if (s_vtxCount + 4 > VTX3D_MAX || s_idxCount + 6 > IDX3D_MAX)
 		{
+			s_overflow = true;
 			return;
 		}
 
@@ -455,6 +471,7 @@ namespace TFE_RenderShared
 		// Do we have enough room for the vertices and indices?
 		if (s_vtxCount + vtxCount > VTX3D_MAX || s_idxCount + idxCount > IDX3D_MAX)
 		{
+			s_overflow = true;
 			return;
 		}
 
@@ -520,6 +537,139 @@ namespace TFE_RenderShared
 		s_idxCount += idxCount;
 	}
 
+	static void triDraw3d_getList(Tri3dDrawList* list)
+	{
+		list->vertices = s_vertices;
+		list->indices = s_indices;
+		list->vtxCount = s_vtxCount;
+		list->idxCount = s_idxCount;
+		for (s32 i = 0; i < TRIMODE_COUNT; i++)
+		{
+			list->draws[i] = s_triDraw[i];
+			list->drawCount[i] = s_triDrawCount[i];
+			list->drawCapacity[i] = s_triDrawCapacity[i];
+		}
+		list->lastDrawMode = s_lastDrawMode;
+	}
+
+	static void triDraw3d_setList(const Tri3dDrawList* list)
+	{
+		s_vertices = list->vertices;
+		s_indices = list->indices;
+		s_vtxCount = list->vtxCount;
+		s_idxCount = list->idxCount;
+		for (s32 i = 0; i < TRIMODE_COUNT; i++)
+		{
+			s_triDraw[i] = list->draws[i];
+			s_triDrawCount[i] = list->drawCount[i];
+			s_triDrawCapacity[i] = list->drawCapacity[i];
+		}
+		s_lastDrawMode = list->lastDrawMode;
+	}
+
+	void triDraw3d_beginCapture()
+	{
+		if (s_capturing) { return; }
+		// The capture buffers are CPU only and allocated on first use.
+		if (!s_captureList.vertices)
+		{
+			s_captureList.vertices = new Tri3dVertex[VTX3D_MAX];
+			s_captureList.indices = new s32[IDX3D_MAX];
+			for (s32 i = 0; i < TRIMODE_COUNT; i++)
+			{
+				s_captureList.draws[i] = (Tri3dDraw*)malloc(sizeof(Tri3dDraw) * TRI3D_DRAW_COUNT_RES);
+				s_captureList.drawCapacity[i] = TRI3D_DRAW_COUNT_RES;
+			}
+		}
+		s_captureList.vtxCount = 0;
+		s_captureList.idxCount = 0;
+		for (s32 i = 0; i < TRIMODE_COUNT; i++)
+		{
+			s_captureList.drawCount[i] = 0;
+		}
+		s_captureList.lastDrawMode = TRIMODE_COUNT;
+
+		triDraw3d_getList(&s_savedList);
+		triDraw3d_setList(&s_captureList);
+		s_overflow = false;
+		s_capturing = true;
+	}
+
+	bool triDraw3d_endCapture(Tri3dBatch* batch)
+	{
+		if (!s_capturing) { return false; }
+		batch->vertices.assign(s_vertices, s_vertices + s_vtxCount);
+		batch->indices.assign(s_indices, s_indices + s_idxCount);
+		batch->draws.clear();
+		for (s32 i = 0; i < TRIMODE_COUNT; i++)
+		{
+			batch->draws.insert(batch->draws.end(), s_triDraw[i], s_triDraw[i] + s_triDrawCount[i]);
+		}
+		// Each draw covers a contiguous index range, so sorting by offset restores the order they were added in.
+		std::sort(batch->draws.begin(), batch->draws.end(), [](const Tri3dDraw& a, const Tri3dDraw& b) { return a.idxOffset < b.idxOffset; });
+		const bool complete = !s_overflow;
+
+		// The draw arrays may have been reallocated while capturing.
+		triDraw3d_getList(&s_captureList);
+		// The frame list is untouched while capturing, so it can keep merging into its last draw.
+		triDraw3d_setList(&s_savedList);
+		s_overflow = false;
+		s_capturing = false;
+		return complete;
+	}
+
+	void triDraw3d_addBatch(const Tri3dBatch* batch)
+	{
+		if (!s_vertices || batch->draws.empty()) { return; }
+		const u32 vtxCount = (u32)batch->vertices.size();
+		const u32 idxCount = (u32)batch->indices.size();
+
+		// Do we have enough room for the vertices and indices?
+		if (s_vtxCount + vtxCount > VTX3D_MAX || s_idxCount + idxCount > IDX3D_MAX)
+		{
+			s_overflow = true;
+			return;
+		}
+
+		const s32 vtxOffset = s_vtxCount;
+		const s32 idxOffset = s_idxCount;
+		memcpy(&s_vertices[vtxOffset], batch->vertices.data(), sizeof(Tri3dVertex) * vtxCount);
+
+		const s32* srcIdx = batch->indices.data();
+		s32* outIdx = &s_indices[idxOffset];
+		for (u32 i = 0; i < idxCount; i++)
+		{
+			outIdx[i] = srcIdx[i] + vtxOffset;
+		}
+
+		// Add the draws in order, so each one can still be merged into the previous draw of the same pass.
+		const size_t drawCount = batch->draws.size();
+		const Tri3dDraw* srcDraw = batch->draws.data();
+		for (size_t d = 0; d < drawCount; d++, srcDraw++)
+		{
+			const DrawMode pass = srcDraw->mode;
+			if (canMergeDraws(pass, srcDraw->texture, srcDraw->drawFlags))
+			{
+				// Append to the previous draw call.
+				s_triDraw[pass][s_triDrawCount[pass] - 1].vtxCount += srcDraw->vtxCount;
+				s_triDraw[pass][s_triDrawCount[pass] - 1].idxCount += srcDraw->idxCount;
+			}
+			else
+			{
+				// Too many draw calls?
+				Tri3dDraw* draw = getTriDraw(pass);
+				if (!draw) { break; }
+
+				*draw = *srcDraw;
+				draw->vtxOffset += vtxOffset;
+				draw->idxOffset += idxOffset;
+			}
+		}
+
+		s_vtxCount += vtxCount;
+		s_idxCount += idxCount;
+	}
+
 	void triDraw3d_draw(const Camera3d* camera, f32 width, f32 height, f32 gridScale, f32 gridOpacity, bool depthTest, bool culling)
 	{
 		if (s_vtxCount < 1 || s_idxCount < 1) { return; }
@@ -7,6 +7,7 @@
 #include <TFE_RenderBackend/renderBackend.h>
 #include "camera3d.h"
 #include "gridDef.h"
+#include <vector>
 
 namespace TFE_RenderShared
 {
@@ -24,6 +25,33 @@ namespace TFE_RenderShared
 		TFLAG_SKY = FLAG_BIT(1),
 	};
 
+	// Vertex Definition
+	struct Tri3dVertex
+	{
+		Vec3f pos;		// 2D position.
+		Vec2f uv;		// UV coordinates.
+		Vec2f uv1;
+		Vec2f uv2;
+		u32   color;	// color + opacity.
+	};
+	struct Tri3dDraw
+	{
+		TextureGpu* texture;
+		DrawMode mode;
+		u32 drawFlags;
+		s32 vtxOffset;
+		s32 idxOffset;
+		s32 vtxCount;
+		s32 idxCount;
+	};
+	// Triangles captured once and added to the draw list each frame, see triDraw3d_beginCapture().
+	struct Tri3dBatch
+	{
+		std::vector<Tri3dVertex> vertices;
+		std::vector<s32> indices;		// relative to the batch vertices.
+		std::vector<Tri3dDraw> draws;	// in the order they were added.
+	};
+
 	bool tri3d_init();
 	void tri3d_destroy();
 
@@ -35,5 +63,13 @@ namespace TFE_RenderShared
 	void triDraw3d_addQuadTextured(DrawMode pass, Vec3f* corners, const Vec2f* uvCorners, const u32 color, TextureGpu* texture, bool sky = false);
 	void triDraw3d_addTextured(DrawMode pass, u32 idxCount, u32 vtxCount, const Vec3f* vertices, const Vec2f* uv, const s32* indices, const u32 color, bool invSide, TextureGpu* texture, bool showGrid = true, bool sky = false);
 
+	// Capture the triangles added until triDraw3d_endCapture() into a batch instead of the draw list.
+	// The grid definition from the last triDraw3d_begin() is baked into the vertices.
+	// Capturing only needs CPU memory, so it works without a render context.
+	void triDraw3d_beginCapture();
+	// Returns false if the batch ran out of space and is incomplete.
+	bool triDraw3d_endCapture(Tri3dBatch* batch);
+	void triDraw3d_addBatch(const Tri3dBatch* batch);
+
 	void triDraw3d_draw(const Camera3d* camera, f32 width, f32 height, f32 gridScale, f32 gridOpacity, bool depthTest = true, bool culling = true);
 }
@@ -408,6 +408,8 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "colorCorrection", s_graphicsSettings.colorCorrection);
 		writeKeyValue_Bool(settings, "perspectiveCorrect3DO", s_graphicsSettings.perspectiveCorrectTexturing);
 		writeKeyValue_Bool(settings, "extendAjoinLimits", s_graphicsSettings.extendAjoinLimits);
+		writeKeyValue_Bool(settings, "softwareThreads", s_graphicsSettings.softwareThreads);
+		writeKeyValue_Int(settings, "softwareThreadCount", s_graphicsSettings.softwareThreadCount);
 		writeKeyValue_Bool(settings, "vsync", s_graphicsSettings.vsync);
 		writeKeyValue_Bool(settings, "show_fps", s_graphicsSettings.showFps);
 		writeKeyValue_Bool(settings, "3doNormalFix", s_graphicsSettings.fix3doNormalOverflow);
@@ -475,6 +477,7 @@ namespace TFE_Settings
 		writeKeyValue_Int(settings, "midiType", s_soundSettings.midiType);
 		writeKeyValue_Bool(settings, "use16Channels", s_soundSettings.use16Channels);
 		writeKeyValue_Bool(settings, "disableSoundInMenus", s_soundSettings.disableSoundInMenus);
+		writeKeyValue_Int(settings, "musicRenderAhead", s_soundSettings.musicRenderAhead);
 	}
 
 	void writeSystemSettings(FileStream& settings)
@@ -484,6 +487,7 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "returnToModLoader", s_systemSettings.returnToModLoader);
 		writeKeyValue_Float(settings, "gifRecordingFramerate", s_systemSettings.gifRecordingFramerate);
 		writeKeyValue_Bool(settings, "showGifPathConfirmation", s_systemSettings.showGifPathConfirmation);
+		writeKeyValue_Bool(settings, "backgroundSaves", s_systemSettings.backgroundSaves);
 	}
 
 	void writeA11ySettings(FileStream& settings)
@@ -543,6 +547,8 @@ namespace TFE_Settings
 		writeKeyValue_Bool(settings, "df_enableRecording", s_gameSettings.df_enableRecording);
 		writeKeyValue_Bool(settings, "df_enableRecordingAll", s_gameSettings.df_enableRecordingAll);
 		writeKeyValue_Bool(settings, "df_demologging", s_gameSettings.df_demologging);
+		writeKeyValue_Bool(settings, "df_interpolateFrames", s_gameSettings.df_interpolateFrames);
+		writeKeyValue_Int(settings,  "df_simulationRate", s_gameSettings.df_simulationRate);
 	}
 
 	void writePerGameSettings(FileStream& settings)
@@ -752,6 +758,14 @@ namespace TFE_Settings
 		{
 			s_graphicsSettings.extendAjoinLimits = parseBool(value);
 		}
+		else if (strcasecmp("softwareThreads", key) == 0)
+		{
+			s_graphicsSettings.softwareThreads = parseBool(value);
+		}
+		else if (strcasecmp("softwareThreadCount", key) == 0)
+		{
+			s_graphicsSettings.softwareThreadCount = parseInt(value);
+		}
 		else if (strcasecmp("vsync", key) == 0)
 		{
 			s_graphicsSettings.vsync = parseBool(value);
@@ -966,6 +980,10 @@ namespace TFE_Settings
 		{
 			s_soundSettings.disableSoundInMenus = parseBool(value);
 		}
+		else if (strcasecmp("musicRenderAhead", key) == 0)
+		{
+			s_soundSettings.musicRenderAhead = parseInt(value);
+		}
 	}
 
 	void parseSystemSettings(const char* key, const char* value)
@@ -986,6 +1004,10 @@ namespace TFE_Settings
 		{
 			s_systemSettings.showGifPathConfirmation = parseBool(value);
 		}
+		else if (strcasecmp("backgroundSaves", key) == 0)
+		{
+			s_systemSettings.backgroundSaves = parseBool(value);
+		}
 	}
 	
 	void parseA11ySettings(const char* key, const char* value)
@@ -1196,6 +1218,14 @@ namespace TFE_Settings
 		{
 			s_gameSettings.df_demologging = parseBool(value);
 		}
+		else if (strcasecmp("df_interpolateFrames", key) == 0)
+		{
+			s_gameSettings.df_interpolateFrames = parseBool(value);
+		}
+		else if (strcasecmp("df_simulationRate", key) == 0)
+		{
+			s_gameSettings.df_simulationRate = parseInt(value);
+		}
 	}
 
 	void parseOutlawsSettings(const char* key, const char* value)
@@ -43,6 +43,9 @@ struct TFE_Settings_Temp
 	bool forceFullscreen = false;
 	bool df_demologging = false;
 	bool exit_after_replay = false;
+	bool replay_benchmark = false;		// Run replays with no frame limit and report timing and a state hash at the end.
+	bool headless = false;				// Hidden window, no audio output; implies replay_benchmark and exit_after_replay.
+	s32  benchmark_renderer = -1;		// Renderer used for replay benchmarks, -1 = default (GPU).
 };
 
 struct TFE_Settings_Window
@@ -71,6 +74,8 @@ struct TFE_Settings_Graphics
 	bool  ignore3doLimits = true;
 	bool  forceGouraudShading = false;
 	bool  overrideLighting = false;
+	bool  softwareThreads = false;		// Split software rendering of the 3D view across threads.
+	s32   softwareThreadCount = 0;		// Number of software rendering threads, 0 = one per logical CPU.
 	s32   frameRateLimit = 240;
 	f32   brightness = 1.0f;
 	f32   contrast = 1.0f;
@@ -188,6 +193,7 @@ struct TFE_Settings_Sound
 	s32 midiType = MIDI_TYPE_DEFAULT;
 	bool use16Channels = false;
 	bool disableSoundInMenus = false;
+	s32 musicRenderAhead = 0;		// Milliseconds of music synthesized ahead on the midi thread, 0 = synthesize in the audio callback.
 };
 
 struct TFE_Game
@@ -228,6 +234,8 @@ struct TFE_Settings_Game
 	bool df_demologging = false;        // Log the record/playback logging
 	s32  df_recordFrameRate = 4;        // Recording Framerate value
 	s32  df_playbackFrameRate = 2;      // Playback Framerate value
+	bool df_interpolateFrames = false;  // Run the simulation at a fixed rate and draw blended frames between steps.
+	s32  df_simulationRate = 60;        // Simulation steps per second when df_interpolateFrames is enabled; range = [30, 145]
 	PitchLimit df_pitchLimit  = PITCH_VANILLA_PLUS;
 };
 
@@ -237,6 +245,7 @@ struct TFE_Settings_System
 	bool returnToModLoader = true;			// Return to the Mod Loader if running a mod.
 	f32 gifRecordingFramerate = 18;			// Used with GIF recording (Alt-F2)
 	bool showGifPathConfirmation = true;	// Used with GIF recording (Alt-F2)
+	bool backgroundSaves = true;			// Compress and write save games on a background thread.
 };
 
 struct TFE_Settings_A11y
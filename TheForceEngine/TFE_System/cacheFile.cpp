@@ -0,0 +1,136 @@
+#include <cstring>
+
+#include "cacheFile.h"
+#include "system.h"
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <algorithm>
+
+namespace TFE_CacheFile
+{
+	struct CacheFileHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 key;
+		u64 dataSize;
+	};
+
+	struct CacheFileEntry
+	{
+		std::string path;
+		u64 modifiedTime;
+	};
+
+	static void getCacheDir(const char* dir, char* cacheDir)
+	{
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, dir, cacheDir);
+		TFE_Paths::fixupPathAsDirectory(cacheDir);
+	}
+
+	// Removes the oldest files with the same extension as name, so that adding it leaves at most maxFiles in the directory.
+	static void evictFiles(const char* cacheDir, const char* name, s32 maxFiles)
+	{
+		char ext[TFE_MAX_PATH] = { 0 };
+		FileUtil::getFileExtension(name, ext);
+
+		FileList fileList;
+		FileUtil::readDirectory(cacheDir, ext, fileList);
+		if ((s32)fileList.size() < maxFiles) { return; }
+
+		std::vector<CacheFileEntry> entries;
+		entries.reserve(fileList.size());
+		for (size_t i = 0; i < fileList.size(); i++)
+		{
+			if (strcasecmp(fileList[i].c_str(), name) == 0) { continue; }
+
+			CacheFileEntry entry;
+			entry.path = std::string(cacheDir) + fileList[i];
+			entry.modifiedTime = FileUtil::getModifiedTime(entry.path.c_str());
+			entries.push_back(entry);
+		}
+		std::sort(entries.begin(), entries.end(), [](const CacheFileEntry& a, const CacheFileEntry& b)
+		{
+			return a.modifiedTime < b.modifiedTime;
+		});
+
+		// Leave room for the file about to be written.
+		const s32 removeCount = s32(entries.size()) - (maxFiles - 1);
+		for (s32 i = 0; i < removeCount; i++)
+		{
+			FileUtil::deleteFile(entries[i].path.c_str());
+		}
+	}
+
+	void getPath(const char* dir, const char* name, char* path)
+	{
+		char cacheDir[TFE_MAX_PATH];
+		getCacheDir(dir, cacheDir);
+		snprintf(path, TFE_MAX_PATH, "%s%s", cacheDir, name);
+	}
+
+	bool read(const char* dir, const char* name, u32 magic, u32 version, u64 key, std::vector<u8>& data)
+	{
+		data.clear();
+
+		char path[TFE_MAX_PATH];
+		getPath(dir, name, path);
+		FileStream file;
+		if (!file.open(path, Stream::MODE_READ))
+		{
+			return false;
+		}
+
+		CacheFileHeader header;
+		const size_t fileSize = file.getSize();
+		if (fileSize < sizeof(CacheFileHeader) || file.readBuffer(&header, sizeof(CacheFileHeader)) != sizeof(CacheFileHeader) ||
+			header.magic != magic || header.version != version || header.key != key || header.dataSize != fileSize - sizeof(CacheFileHeader))
+		{
+			file.close();
+			return false;
+		}
+
+		data.resize(header.dataSize);
+		if (!data.empty() && file.readBuffer(data.data(), u32(data.size())) != data.size())
+		{
+			data.clear();
+			file.close();
+			return false;
+		}
+		file.close();
+		return true;
+	}
+
+	bool write(const char* dir, const char* name, u32 magic, u32 version, u64 key, const void* data, size_t size, s32 maxFiles)
+	{
+		char cacheDir[TFE_MAX_PATH];
+		getCacheDir(dir, cacheDir);
+		if (!FileUtil::directoryExits(cacheDir))
+		{
+			FileUtil::makeDirectory(cacheDir);
+		}
+		else if (maxFiles > 0)
+		{
+			evictFiles(cacheDir, name, maxFiles);
+		}
+
+		char path[TFE_MAX_PATH];
+		snprintf(path, TFE_MAX_PATH, "%s%s", cacheDir, name);
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Cache", "Cannot write cache file '%s'.", path);
+			return false;
+		}
+
+		CacheFileHeader header = { magic, version, key, u64(size) };
+		file.writeBuffer(&header, sizeof(CacheFileHeader));
+		if (size)
+		{
+			file.writeBuffer(data, u32(size));
+		}
+		file.close();
+		return true;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Cache Files
+// Derived data (packing layouts, compiled scripts, parsed levels...)
+// stored in the program data directory, so it does not have to be
+// rebuilt on the next run.
+//
+// Each file starts with a header holding the magic number, version
+// and key of the cache, and the payload size. Files that do not match
+// are ignored. The key should be a hash of everything the data was
+// built from (see TFE_System/hash.h).
+//////////////////////////////////////////////////////////////////////
+
+#include "types.h"
+#include <vector>
+
+namespace TFE_CacheFile
+{
+	// Gets the path of a file in the cache directory, the directory is relative to the program data directory and ends with '/'.
+	void getPath(const char* dir, const char* name, char* path);
+
+	// Reads the payload of a cache file into data.
+	// Returns false if the file does not exist or its header does not match.
+	bool read(const char* dir, const char* name, u32 magic, u32 version, u64 key, std::vector<u8>& data);
+
+	// Writes a cache file, creating the directory if needed.
+	// If maxFiles > 0, the oldest files in the directory with the same extension are removed so it holds at most maxFiles.
+	bool write(const char* dir, const char* name, u32 magic, u32 version, u64 key, const void* data, size_t size, s32 maxFiles = 0);
+}
@@ -0,0 +1,75 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Hashing
+// FNV-1a hashes, used for cache keys and for detecting changes in
+// runtime state. These are fast, not cryptographic.
+//
+// Hashes are built incrementally: start from the offset basis and
+// pass the result of each call into the next.
+//////////////////////////////////////////////////////////////////////
+
+#include "types.h"
+#include <ctype.h>
+
+namespace TFE_Hash
+{
+	static const u64 c_fnv64Offset = 14695981039346656037ull;
+	static const u64 c_fnv64Prime  = 1099511628211ull;
+	static const u32 c_fnv32Offset = 2166136261u;
+	static const u32 c_fnv32Prime  = 16777619u;
+
+	inline u64 hash64(u64 hash, const void* data, size_t size)
+	{
+		const u8* bytes = (const u8*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= u64(bytes[i]);
+			hash *= c_fnv64Prime;
+		}
+		return hash;
+	}
+
+	// Hashes 32 bits at a time instead of a byte at a time, for state that is hashed every frame.
+	// This does not produce the same values as hash64() and ignores any trailing bytes past the last full word.
+	inline u64 hash64Words(u64 hash, const void* data, size_t size)
+	{
+		const u32* words = (const u32*)data;
+		const size_t count = size / sizeof(u32);
+		for (size_t i = 0; i < count; i++)
+		{
+			hash = (hash ^ words[i]) * c_fnv64Prime;
+		}
+		return hash;
+	}
+
+	// Includes the terminator so that adjacent strings cannot run together, a null string hashes as an empty string.
+	inline u64 hashString64(u64 hash, const char* str)
+	{
+		if (!str) { str = ""; }
+		for (;; str++)
+		{
+			hash ^= u64((u8)*str);
+			hash *= c_fnv64Prime;
+			if (!*str) { break; }
+		}
+		return hash;
+	}
+
+	template <typename T>
+	inline u64 hashValue64(u64 hash, const T& value)
+	{
+		return hash64(hash, &value, sizeof(T));
+	}
+
+	// Case-insensitive, matches the folding done by strcasecmp(). The terminator is not included.
+	inline u32 hashStringNoCase32(const char* str)
+	{
+		u32 hash = c_fnv32Offset;
+		for (; *str; str++)
+		{
+			hash ^= u32(tolower((u8)*str));
+			hash *= c_fnv32Prime;
+		}
+		return hash;
+	}
+}
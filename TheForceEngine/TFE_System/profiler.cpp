@@ -1,25 +1,25 @@
 #include <cstring>
 
 #include "profiler.h"
+#include <TFE_FileSystem/filestream.h>
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <map>
 
-// TODO: Support call "paths" - with seperate time per path.
-
 namespace TFE_Profiler
 {
 	#define ZONE_BUFFER_COUNT 2
 	#define MAX_ZONE_STACK 256
+	#define TRACE_EVENT_COUNT (1 << 16)		// Must be a power of 2.
 	
 	struct Zone
 	{
 		u32  id;
 		u32  level = 0;
 		u32  parent = NULL_ZONE;
-		u64  path;
 		u64  frame;
 		char name[64];
 		char func[64];
@@ -42,12 +42,42 @@ namespace TFE_Profiler
 		char name[64];
 	};
 
+	// Zone stack entry, each thread has its own stack.
+	struct ZoneStackEntry
+	{
+		u32 id;				// NULL_ZONE if the zone is not part of the zone tree.
+		const char* name;
+		const char* func;
+	};
+
+	struct ThreadZoneStack
+	{
+		u32 threadId;		// 0 until the thread begins its first zone.
+		u32 level;
+		ZoneStackEntry entries[MAX_ZONE_STACK];
+	};
+
+	// A completed zone. Zones are recorded when they end, so a wrapped buffer never holds
+	// unmatched begin and end events.
+	struct TraceEvent
+	{
+		std::atomic<u64> sequence;	// Event index + 1 once written, 0 while being written.
+		u64 start;
+		u64 duration;
+		const char* name;
+		const char* func;
+		u32 threadId;
+	};
+
+	// Zones are identified by their parent zone and name, so each call path has its own zone.
+	typedef std::pair<u32, std::string> ZoneKey;
+	typedef std::map<ZoneKey, u32> ZonePathMap;
 	typedef std::map<std::string, u32> ZoneMap;
 	typedef std::vector<Zone> ZoneList;
 	typedef std::vector<u32> SortedZoneList;
 	typedef std::vector<Counter> CounterList;
 
-	static ZoneMap  s_zoneMap;
+	static ZonePathMap s_zoneMap;
 	static ZoneList s_zoneList;
 	static SortedZoneList s_sortedZoneList;
 	static SortedZoneList s_roots;
@@ -59,11 +89,57 @@ namespace TFE_Profiler
 	static f64 s_frameTime;
 	static u32 s_readBuffer = 0;
 	static u32 s_writeBuffer = 1;
-	static u32 s_level;
 	static u32 s_maxLevel;
-	static u32 s_zoneStack[MAX_ZONE_STACK];
 	static u64 s_currentFrame = 1;
-	static u64 s_currentPath;
+
+	static thread_local ThreadZoneStack s_zoneStack = {};
+	static std::atomic<u32> s_nextThreadId(1);
+	static std::atomic<u32> s_mainThreadId(0);
+
+	static TraceEvent s_traceEvents[TRACE_EVENT_COUNT];
+	static std::atomic<u64> s_traceWriteIndex(0);
+	static std::atomic<bool> s_traceEnabled(true);
+
+	static u32 getThreadId()
+	{
+		if (!s_zoneStack.threadId)
+		{
+			s_zoneStack.threadId = s_nextThreadId.fetch_add(1);
+		}
+		return s_zoneStack.threadId;
+	}
+
+	// Lock-free, any number of threads may record events at the same time.
+	static void recordTraceEvent(const char* name, const char* func, u64 start, u64 duration)
+	{
+		const u64 index = s_traceWriteIndex.fetch_add(1, std::memory_order_relaxed);
+		TraceEvent* ev = &s_traceEvents[index & (TRACE_EVENT_COUNT - 1)];
+		ev->sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		ev->start = start;
+		ev->duration = duration;
+		ev->name = name;
+		ev->func = func;
+		ev->threadId = getThreadId();
+		ev->sequence.store(index + 1, std::memory_order_release);
+	}
+
+	// Reads an event, returns false if it has been overwritten or is still being written.
+	static bool readTraceEvent(u64 index, u64* start, u64* duration, const char** name, const char** func, u32* threadId)
+	{
+		const TraceEvent* ev = &s_traceEvents[index & (TRACE_EVENT_COUNT - 1)];
+		if (ev->sequence.load(std::memory_order_acquire) != index + 1) { return false; }
+
+		*start = ev->start;
+		*duration = ev->duration;
+		*name = ev->name;
+		*func = ev->func;
+		*threadId = ev->threadId;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return ev->sequence.load(std::memory_order_relaxed) == index + 1;
+	}
 
 	void addZoneChild(u32 parentId, u32 zoneId)
 	{
@@ -102,9 +178,10 @@ namespace TFE_Profiler
 		}
 	}
 
-	u32 beginZone(const char* name, const char* func, u32 lineNumber)
+	static u32 beginTreeZone(const char* name, const char* func, u32 lineNumber, u32 parent, u32 level)
 	{
-		ZoneMap::iterator iZone = s_zoneMap.find(name);
+		const ZoneKey key(parent, name);
+		ZonePathMap::iterator iZone = s_zoneMap.find(key);
 		u32 id = 0;
 
 		if (iZone == s_zoneMap.end())
@@ -113,15 +190,16 @@ namespace TFE_Profiler
 
 			Zone zone;
 			zone.id = id;
-			zone.path = s_currentPath;
 			zone.timeInZone[s_readBuffer]  = 0;
 			zone.timeInZone[s_writeBuffer] = 0;
 			zone.timeInZoneAve = 0.0;
 			zone.fractOfParentAve = 0.0;
 			zone.frame = 0;
+			strcpy(zone.name, name);
+			strcpy(zone.func, func);
 			
 			s_zoneList.push_back(zone);
-			s_zoneMap[name] = id;
+			s_zoneMap[key] = id;
 		}
 		else
 		{
@@ -129,12 +207,9 @@ namespace TFE_Profiler
 		}
 
 		Zone& zone = s_zoneList[id];
-		strcpy(zone.name, name);
-		strcpy(zone.func, func);
 		zone.lineNumber = lineNumber;
-		zone.level = s_level;
-
-		zone.parent = s_level > 0 ? s_zoneStack[s_level - 1] : NULL_ZONE;
+		zone.level = level;
+		zone.parent = parent;
 		if (zone.parent == NULL_ZONE)
 		{
 			s_roots.push_back(id);
@@ -143,17 +218,52 @@ namespace TFE_Profiler
 		{
 			addZoneChild(zone.parent, zone.id);
 		}
-
-		s_zoneStack[s_level] = id;
-		s_level++;
+		s_maxLevel = std::max(s_maxLevel, level);
 
 		return id;
 	}
 
-	void endZone(u32 id, u64 dt)
+	u32 beginZone(const char* name, const char* func, u32 lineNumber)
+	{
+		ThreadZoneStack* stack = &s_zoneStack;
+		const u32 level = stack->level;
+		stack->level++;
+		if (level >= MAX_ZONE_STACK) { return NULL_ZONE; }
+
+		ZoneStackEntry* entry = &stack->entries[level];
+		entry->id = NULL_ZONE;
+		entry->name = name;
+		entry->func = func;
+
+		// Only the main thread contributes to the zone tree, other threads are only traced.
+		if (getThreadId() == s_mainThreadId.load(std::memory_order_relaxed))
+		{
+			const u32 parent = level > 0 ? stack->entries[level - 1].id : NULL_ZONE;
+			// Skip the subtree if its parent is not part of the tree.
+			if (level == 0 || parent != NULL_ZONE)
+			{
+				entry->id = beginTreeZone(name, func, lineNumber, parent, level);
+			}
+		}
+		return entry->id;
+	}
+
+	void endZone(u32 id, u64 startTime, u64 dt)
 	{
-		s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
-		s_level--;
+		ThreadZoneStack* stack = &s_zoneStack;
+		if (!stack->level) { return; }
+		stack->level--;
+		if (stack->level >= MAX_ZONE_STACK) { return; }
+
+		if (id != NULL_ZONE)
+		{
+			s_zoneList[id].timeInZone[s_writeBuffer] += TFE_System::convertFromTicksToSeconds(dt);
+		}
+		if (s_traceEnabled.load(std::memory_order_relaxed))
+		{
+			const ZoneStackEntry* entry = &stack->entries[stack->level];
+			recordTraceEvent(entry->name, entry->func, startTime, dt);
+		}
 	}
 
 	void addCounter(const char* name, s32* counter)
@@ -182,7 +292,9 @@ namespace TFE_Profiler
 		s_readBuffer  %= ZONE_BUFFER_COUNT;
 		s_writeBuffer %= ZONE_BUFFER_COUNT;
 
-		s_level = 0;
+		// The thread that runs the frame owns the zone tree.
+		s_mainThreadId.store(getThreadId(), std::memory_order_relaxed);
+		s_zoneStack.level = 0;
 		s_maxLevel = 0;
 		s_roots.clear();
 
@@ -231,7 +343,12 @@ namespace TFE_Profiler
 
 	void frameEnd()
 	{
-		s_frameTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_frameBegin);
+		const u64 frameTicks = TFE_System::getCurrentTimeInTicks() - s_frameBegin;
+		s_frameTime = TFE_System::convertFromTicksToSeconds(frameTicks);
+		if (s_traceEnabled.load(std::memory_order_relaxed))
+		{
+			recordTraceEvent("Frame", "frame", s_frameBegin, frameTicks);
+		}
 		const size_t zoneCount = s_zoneList.size();
 		const f64 expBlend = 0.99;
 
@@ -306,4 +423,53 @@ namespace TFE_Profiler
 		info->name = counter.name;
 		info->value = counter.prevValue;
 	}
+
+	void setTraceEnabled(bool enable)
+	{
+		s_traceEnabled.store(enable, std::memory_order_relaxed);
+	}
+
+	bool isTraceEnabled()
+	{
+		return s_traceEnabled.load(std::memory_order_relaxed);
+	}
+
+	bool writeTrace(const char* filePath)
+	{
+		FileStream file;
+		if (!file.open(filePath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Profiler", "Cannot write trace file \"%s\".", filePath);
+			return false;
+		}
+
+		const u64 end = s_traceWriteIndex.load(std::memory_order_acquire);
+		const u64 begin = end > TRACE_EVENT_COUNT ? end - TRACE_EVENT_COUNT : 0;
+
+		file.writeString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		file.writeString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Main\"}}",
+			s_mainThreadId.load(std::memory_order_relaxed));
+
+		u32 eventCount = 0;
+		for (u64 i = begin; i < end; i++)
+		{
+			u64 start, duration;
+			const char* name;
+			const char* func;
+			u32 threadId;
+			if (!readTraceEvent(i, &start, &duration, &name, &func, &threadId)) { continue; }
+
+			// Timestamps are in microseconds.
+			const f64 ts  = TFE_System::convertFromTicksToMillis(start) * 1000.0;
+			const f64 dur = TFE_System::convertFromTicksToMillis(duration) * 1000.0;
+			file.writeString(",\n{\"name\":\"%s\",\"cat\":\"zone\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"func\":\"%s\"}}",
+				name, ts, dur, threadId, func);
+			eventCount++;
+		}
+		file.writeString("\n]}\n");
+		file.close();
+
+		TFE_System::logWrite(LOG_MSG, "Profiler", "Wrote %u trace events to \"%s\".", eventCount, filePath);
+		return true;
+	}
 }
@@ -3,7 +3,13 @@
 // The Force Engine Profiler
 // Simple "zone" based profiler.
 // Add TFE_PROFILE_ENABLED to preprocessor defines in the build to enable.
-// Currently does not respect the call path, that is TODO.
+// Zones are tracked per call path, so the same zone name used under
+// different parents is reported separately. Each thread has its own
+// zone stack, the zone tree is only built for the main thread (the
+// thread that calls frameBegin()).
+// Every zone, from every thread, is also recorded into a lock-free
+// ring buffer that can be written out as a Chrome Trace / Perfetto
+// JSON file for offline analysis.
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
@@ -54,13 +60,20 @@ namespace TFE_Profiler
 {
 	// The main profiling API is used through Macros which can be disabled based on build flags.
 	u32  beginZone(const char* name, const char* func, u32 lineNumber);
-	void endZone(u32 id, u64 dt);
+	void endZone(u32 id, u64 startTime, u64 dt);
 		
 	void frameBegin();
 	void frameEnd();
 
 	void addCounter(const char* name, s32* counter);
 
+	// Trace API, holds the most recent zones from all threads.
+	void setTraceEnabled(bool enable);
+	bool isTraceEnabled();
+	// Writes the contents of the trace buffer as Chrome Trace Event JSON, which can be loaded into
+	// chrome://tracing or ui.perfetto.dev
+	bool writeTrace(const char* filePath);
+
 	// Profile data API, this is used directly.
 	f64  getTimeInFrame();
 
@@ -83,7 +96,7 @@ public:
 	~TFE_Profiler_Zone()
 	{
 		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id, m_time, deltaTime);
 	}
 private:
 	u64 m_time;
@@ -102,7 +115,7 @@ public:
 	void end()
 	{
 		const u64 deltaTime = TFE_System::getCurrentTimeInTicks() - m_time;
-		TFE_Profiler::endZone(m_id, deltaTime);
+		TFE_Profiler::endZone(m_id, m_time, deltaTime);
 	}
 private:
 	u64 m_time;
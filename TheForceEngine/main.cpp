@@ -36,6 +36,7 @@
 #include <TFE_DarkForces/hud.h>
 #include <TFE_DarkForces/mission.h>
 #include <TFE_Input/replay.h>
+#include <TFE_Input/replayBenchmark.h>
 
 #if ENABLE_EDITOR == 1
 #include <TFE_Editor/editor.h>
@@ -211,11 +212,22 @@ void handleEvent(SDL_Event& Event)
 
 bool sdlInit()
 {
+	if (TFE_Settings::getTempSettings()->headless)
+	{
+		// Prefer drivers that do not require a display or audio device, the environment variables still take priority.
+	#ifdef SDL_HINT_VIDEODRIVER  // SDL 2.0.22+
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+	#endif
+	#ifdef SDL_HINT_AUDIODRIVER  // SDL 2.0.22+
+		SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+	#endif
+	}
+
 	const int code = SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMECONTROLLER | SDL_INIT_AUDIO);
 	if (code != 0) { return false; }
 
 	TFE_Settings_Window* windowSettings = TFE_Settings::getWindowSettings();
-	bool fullscreen    = windowSettings->fullscreen || TFE_Settings::getTempSettings()->forceFullscreen;
+	bool fullscreen    = (windowSettings->fullscreen || TFE_Settings::getTempSettings()->forceFullscreen) && !TFE_Settings::getTempSettings()->headless;
 	s_displayWidth     = windowSettings->width;
 	s_displayHeight    = windowSettings->height;
 	s_baseWindowWidth  = windowSettings->baseWidth;
@@ -589,12 +601,20 @@ int main(int argc, char* argv[])
 
 	// Setup the GPU Device and Window.
 	u32 windowFlags = 0;
-	if (windowSettings->fullscreen || TFE_Settings::getTempSettings()->forceFullscreen)
+	if (TFE_Settings::getTempSettings()->headless)
+	{
+		TFE_System::logWrite(LOG_MSG, "Display", "Headless mode enabled.");
+		windowFlags |= WINFLAG_HIDDEN;
+	}
+	else
 	{
-		TFE_System::logWrite(LOG_MSG, "Display", "Fullscreen enabled.");
-		windowFlags |= WINFLAG_FULLSCREEN;
+		if (windowSettings->fullscreen || TFE_Settings::getTempSettings()->forceFullscreen)
+		{
+			TFE_System::logWrite(LOG_MSG, "Display", "Fullscreen enabled.");
+			windowFlags |= WINFLAG_FULLSCREEN;
+		}
+		if (graphics->vsync) { TFE_System::logWrite(LOG_MSG, "Display", "Vertical Sync enabled."); windowFlags |= WINFLAG_VSYNC; }
 	}
-	if (graphics->vsync) { TFE_System::logWrite(LOG_MSG, "Display", "Vertical Sync enabled."); windowFlags |= WINFLAG_VSYNC; }
 	
 	WindowState windowState =
 	{
@@ -880,6 +900,9 @@ int main(int argc, char* argv[])
 			}
 		}
 
+		// Handle events sent back from the audio thread.
+		TFE_Audio::update();
+
 		const bool isConsoleOpen = TFE_FrontEndUI::isConsoleOpen();
 		bool endInputFrame = true;
 		if (s_curState == APP_STATE_EDITOR)
@@ -902,6 +925,10 @@ int main(int argc, char* argv[])
 				TFE_SaveSystem::update();
 				s_curGame->loopGame();
 				endInputFrame = TFE_Jedi::task_run() != 0;
+				if (!endInputFrame)
+				{
+					s_curGame->drawInterpolatedFrame();
+				}
 			}
 		}
 		else
@@ -935,6 +962,7 @@ int main(int argc, char* argv[])
 
 		// Handle framerate limiter.
 		TFE_System::frameLimiter_end();
+		TFE_Input::replayBenchmark_frame();
 
 		// Clear transitory input state.
 		if (endInputFrame)
@@ -984,6 +1012,8 @@ int main(int argc, char* argv[])
 	}
 #endif
 
+	// Restore the settings changed by a benchmark that did not finish, before they are saved.
+	TFE_Input::replayBenchmark_abort();
 	if (s_curGame)
 	{
 		freeGame(s_curGame);
@@ -1080,5 +1110,36 @@ void parseOption(const char* name, const std::vector<const char*>& values, bool
 		{
 			TFE_Settings::getTempSettings()->exit_after_replay = true;
 		}
+		else if (strcasecmp(name, "replay_benchmark") == 0)
+		{
+			// --replay_benchmark
+			TFE_Settings::getTempSettings()->replay_benchmark = true;
+		}
+		else if (strcasecmp(name, "headless") == 0)
+		{
+			// --headless -r<replay_path>
+			TFE_Settings_Temp* tempSettings = TFE_Settings::getTempSettings();
+			tempSettings->headless = true;
+			tempSettings->replay_benchmark = true;
+			tempSettings->exit_after_replay = true;
+			s_nullAudioDevice = true;
+		}
+		else if (strcasecmp(name, "benchmark_renderer") == 0 && values.size() >= 1)
+		{
+			// --benchmark_renderer software|gpu
+			const char* renderer = values[0];
+			if (!strcasecmp(renderer, "software"))
+			{
+				TFE_Settings::getTempSettings()->benchmark_renderer = 0;
+			}
+			else if (!strcasecmp(renderer, "gpu"))
+			{
+				TFE_Settings::getTempSettings()->benchmark_renderer = 1;
+			}
+			else
+			{
+				TFE_System::logWrite(LOG_WARNING, "CommandLine", "Unknown benchmark renderer: %s", renderer);
+			}
+		}
 	}
 }
\ No newline at end of file